@@ -14,6 +14,7 @@
 #include "src/helplesson/helplesson.h"
 #include "src/loadingscreen/LoadingScreen.h"
 #include "src/race_data/RaceData.h"
+#include "src/combat/CombatEngine.h"
 
 // Qt Includes
 #include <QVBoxLayout>
@@ -27,6 +28,8 @@
 #include <QFileDialog>
 #include <QDir>
 #include <QPainter>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
 
 GameMenu::GameMenu(QWidget *parent)
     : QWidget(parent)
@@ -37,6 +40,10 @@ GameMenu::GameMenu(QWidget *parent)
     gameStateManager::instance()->loadFontSprite("resources/images/font_spritesheet_transparent.png");
     gameStateManager::instance()->incrementPartyAge(1);
     EventManager::instance()->loadEvents("./data/events-json");
+    if (qEnvironmentVariableIsSet("BLACKLANDS_BENCH")) {
+        EventManager::benchmarkDispatch("./data/events-json");
+        CombatEngine::benchmark(gameStateManager::instance()->monsterData(), 100000);
+    }
     
     // 2. Window Styling and Palette
     QPalette pal = this->palette();
@@ -191,6 +198,8 @@ void GameMenu::loadGame() {
 }
 
 void GameMenu::onCharacterCreated(const QString &characterName) {
+    // A new character gets a dungeon of their own
+    gameStateManager::instance()->setStateValue(GameState::Key::WorldSeed, QRandomGenerator::global()->bounded(1u, 0xFFFFFFFFu));
     if (gameStateManager::instance()->saveCharacterToFile(0)) {
         emit logMessageTriggered(QString("Character %1 saved.").arg(characterName));
         toggleMenuState(true);
@@ -242,11 +251,14 @@ GameMenu::~GameMenu() {
 int main(int argc, char *argv[]) {
     // Force X11 for Wayland compatibility
     qputenv("QT_QPA_PLATFORM", "xcb");
+    QElapsedTimer startupTimer;
+    startupTimer.start();
     QApplication a(argc, argv);
 
     // Initial sequence
     LoadingScreen loadingScreen; 
     loadingScreen.exec(); 
+    qInfo() << "Startup to end of loading screen:" << startupTimer.elapsed() << "ms";
 
     storyDialog story;
     story.exec();
@@ -2,7 +2,7 @@
 # Configuration
 #--------------------------------------------------
 PRECOMPILED_HEADER = stable.h
-QT += core gui widgets multimedia network
+QT += core gui widgets multimedia network concurrent
 TARGET = blacklands
 
 # Qt 6 & Silent mode (only outputs warnings/errors)
@@ -33,12 +33,20 @@ INCLUDEPATH += _PRO_FILE_PWD_/include
 #--------------------------------------------------
 SOURCES += \
     src/core/savegameUtils.cpp \
+    src/core/GameDataCache.cpp \
+    src/core/SaveContainer.cpp \
+    src/core/CharacterJournal.cpp \
+    src/core/LuaDataLoader.cpp \
+    src/core/LuaScriptCache.cpp \
+    src/scripting/ScriptScheduler.cpp \
+    src/combat/CombatEngine.cpp \
     gameStateManager.cpp \
     src/partymanager/PartyManager.cpp \
     audioManager.cpp \
     blacklands.cpp \
     theCity.cpp \
     src/network_manager/NetworkManager.cpp \
+    src/network_manager/WireProtocol.cpp \
     src/hall_of_records/hallofrecordsdialog.cpp \
     src/create_character/createcharacterdialog.cpp \
     src/about_dialog/AboutDialog.cpp \
@@ -67,7 +75,11 @@ SOURCES += \
     src/bank_dialog/TradeDialog.cpp \
     src/game_resources.cpp \
     src/dungeon_dialog/DungeonMinimap.cpp \
+    src/dungeon_dialog/DungeonWireframe.cpp \
+    src/dungeon_dialog/DungeonViewAtlas.cpp \
     src/dungeon_dialog/DungeonHandlers.cpp \
+    src/dungeon_dialog/DungeonScripts.cpp \
+    src/dungeon_dialog/LevelGenerator.cpp \
     src/event/EventManager.cpp \
     src/update/UpdateManager.cpp \
     src/update/UpdateDialog.cpp \
@@ -78,14 +90,25 @@ SOURCES += \
 #--------------------------------------------------
 HEADERS += \
     src/core/savegameUtils.h \
+    src/core/Crc32.h \
+    src/core/SaveContainer.h \
+    src/core/CharacterJournal.h \
+    src/core/GameDataCache.h \
+    src/core/LuaDataLoader.h \
+    src/core/LuaRecords.h \
+    src/core/LuaScriptCache.h \
+    src/scripting/ScriptScheduler.h \
+    src/combat/CombatEngine.h \
     gameStateManager.h \
     src/partymanager/PartyManager.h \
     src/core/GameConstants.h \
+    src/core/GameStateStore.h \
     audioManager.h \
     blacklands.h \
     theCity.h \
     storyDialog.h \
     src/network_manager/NetworkManager.h \
+    src/network_manager/WireProtocol.h \
     src/hall_of_records/hallofrecordsdialog.h \
     src/create_character/createcharacterdialog.h \
     src/about_dialog/AboutDialog.h \
@@ -114,6 +137,10 @@ HEADERS += \
     src/bank_dialog/TradeDialog.h \
     src/core/game_resources.h \
     src/dungeon_dialog/DungeonHandlers.h \
+    src/dungeon_dialog/DungeonScripts.h \
+    src/dungeon_dialog/DungeonViewAtlas.h \
+    src/dungeon_dialog/DungeonGrid.h \
+    src/dungeon_dialog/LevelGenerator.h \
     src/event/EventManager.h \
     src/dungeon_dialog/MinimapDialog.h \
     src/update/UpdateManager.h \
@@ -27,6 +27,7 @@ QVariantMap Character::toMap() const {
     map["DungeonY"]     = dungeonY;
     map["Inventory"]    = inventory;
     map["row"]          = row;
+    map["WorldSeed"]    = worldSeed;
     return map;
 }
 
@@ -61,6 +62,7 @@ void Character::loadFromMap(const QVariantMap &map) {
     dungeonY     = map.value("DungeonY", 0).toInt();
 
     row          = map.value("row", 0).toInt();
+    worldSeed    = map.value("WorldSeed", 0).toUInt();
     inventory    = map.value("Inventory").toStringList();
 }
 
@@ -42,6 +42,7 @@ struct Character {
     int dungeonX = 0;
     int dungeonY = 0;
     int row = 0;
+    uint worldSeed = 0; // The dungeon this character's saves were made in; 0 is the legacy fixed dungeon
 
     // --- Inventory ---
     //QStringList inventory;
@@ -1,5 +1,5 @@
 #include "MLoader.h" 
-#include "RecordReader.h"
+#include "MdrSchema.h"
 #include <QDebug>
 #include <QFile>
 #include <QDataStream>
@@ -15,7 +15,7 @@
 // ----------------------------------------------------------------------
 
 Spells loadSpells(const QString& filename) {
-    RecordReader<75> buff(filename);
+    RecordReader<mdr::MDATA2_SCHEMA.recordLength> buff(filename);
     Spells spells;
 
 // Define the spells we are searching for and their expected levels
@@ -29,129 +29,68 @@ Spells loadSpells(const QString& filename) {
     int foundCount = 0;
 
     try {
-        // --- 1. Load Header and Verify Version (Offset 0 - 74) ---
-        buff.read(); 
-        
-        // Byte 0-1: File ID (uint16_t)
-        uint16_t fileId = buff.getWord(); 
-        UNUSED(fileId); 
-        
-        // Byte 2-5: Version String (4 bytes). Read as uint32_t for QDataStream alignment.
-        uint32_t versionBytes = buff.getDword();
-        QString version = QString::fromLatin1(QByteArray((const char*)&versionBytes, 4)).trimmed(); 
-        
-        assert(version == "1.17"); 
-        
-        // Skip the remaining 69 bytes of padding in the current 75-byte buffer (up to offset 75).
-        buff.getString(69); 
+        // Field order and types come from mdr::SPELL_FIELDS; this only says which member gets which field
+        static const auto binding = mdr::Binding<Spell>(mdr::SPELL_FIELDS)
+            .field("Name", &Spell::name)
+            .field("ID", &Spell::ID)
+            .field("Class", &Spell::category)
+            .field("Level", &Spell::level)
+            .field("U4", &Spell::u4)
+            .field("AlwaysZero", &Spell::u5)
+            .field("KillEffect", &Spell::killEffect)
+            .field("AffectMonster", &Spell::affectMonster)
+            .field("AffectGroup", &Spell::affectGroup)
+            .field("Damage1", &Spell::damage1)
+            .field("Damage2", &Spell::damage2)
+            .field("SpecialEffect", &Spell::specialEffect)
+            .field("Required", &Spell::required)
+            .field("ResistedBy", &Spell::resistedBy);
 
+        // --- 1. Header: version (record 0) and spell count (record 1) ---
+        const std::string version = mdr::headerValue<std::string>(mdr::MDATA2_SCHEMA, "Version", buff.bytes());
+        assert(version == "1.1");
+        UNUSED(version);
 
-        // --- 2. Load Next Block and Read Spell Count (Offset 75) ---
-        
-        buff.read(); 
-        
-        // Byte 75-76: Read the number of spells (CONFIRMED LOCATION: 105)
-        uint16_t numSpells = buff.getWord();
-        
+        const uint16_t numSpells = mdr::headerValue<uint16_t>(mdr::MDATA2_SCHEMA, "Count", buff.bytes());
         qDebug() << "Total Spells to load (Count at Offset 75):" << numSpells; 
-        
-        // Initialize the vector with the count
-        spells.clear();
-        spells.reserve(numSpells); // This assumes Spells is a QList or std::vector wrapper.
-        
-        // Skip the remaining 73 bytes of padding in the current 75-byte buffer.
-        buff.getString(73); 
-        
-
-        // --- 3. Loop and Load Spell Records (Starts at Offset 150) ---
-        for (size_t i = 0; i < numSpells; i++) {
-            buff.read(); // Load the next 75-byte record (the actual Spell data)
-int consumedBytes = 0;
-
-            // --- A. vbstring spellname (Variable Length) ---
-            uint16_t nameLength = buff.getWord(); // 2 bytes for length
-            QString spellname = buff.getString(nameLength).trimmed(); // N bytes for string
-            
-            consumedBytes += 2 + nameLength;
-
-            // --- B. 11 Fixed Short Fields (22 bytes) ---
-            uint16_t m_ID = buff.getWord();
-            uint16_t m_class = buff.getWord();
-            uint16_t m_spellLevel = buff.getWord();
-            uint16_t m_u4 = buff.getWord();
-            uint16_t m_alwaysZero = buff.getWord();
-            uint16_t m_killEffect = buff.getWord();
-            uint16_t m_affectMonster = buff.getWord();
-            uint16_t m_affectGroup = buff.getWord();
-            uint16_t m_damage1 = buff.getWord();
-            uint16_t m_damage2 = buff.getWord();
-            uint16_t m_specialEffect = buff.getWord();
-            consumedBytes += 22;
-
-            // --- C. m_required array (7 shorts = 14 bytes) ---
-            uint16_t m_required[7];
-            for (int j = 0; j < 7; j++) {
-                m_required[j] = buff.getWord();
-            }
-            consumedBytes += 14;
 
-            // --- D. Final Short Field (2 bytes) ---
-            uint16_t m_resistedBy = buff.getWord();
-            consumedBytes += 2;
-            
-            // --- E. Calculate and Consume Padding ---
-            int paddingBytes = 75 - consumedBytes;
+        // --- 2. Spell records, from record 2 on ---
+        const std::vector<Spell> decoded = mdr::decodeSection(mdr::MDATA2_SCHEMA, "Spells", buff.bytes(), binding);
+        spells = Spells(decoded.begin(), decoded.end());
 
+        for (qsizetype i = 0; i < spells.size(); i++) {
+            const Spell& s = spells.at(i);
+            const QString spellname = s.name.trimmed();
 
-            if (paddingBytes < 0) {
-                qCritical() << "Error: Record size exceeds 75 bytes for spell:" << spellname;
-            } else if (paddingBytes > 0) {
-                buff.getString(paddingBytes); // Consume remaining padding
-            }
-
-// --- F. TARGETED CHECK: Print if name matches ---
+// --- TARGETED CHECK: Print if name matches ---
             if (spellsToFind.contains(spellname)) {
                 foundCount++;
                 uint16_t expectedLevel = spellsToFind.value(spellname);
                 
                 qDebug() << "----------------------------------------------------------------------";
                 qDebug() << "MATCH FOUND (Spell #" << i << "):" << spellname;
-                if(m_class == 0)
+                if(s.category == 0)
 		{
-			qDebug() << "  ID:" << m_ID << " Class:" << m_class << "SORCERER" << " Actual Level:" << m_spellLevel;
+			qDebug() << "  ID:" << s.ID << " Class:" << s.category << "SORCERER" << " Actual Level:" << s.level;
 		}
 		else
 		{
-                	qDebug() << "  ID:" << m_ID << " Class:" << m_class << " Actual Level:" << m_spellLevel;
+                	qDebug() << "  ID:" << s.ID << " Class:" << s.category << " Actual Level:" << s.level;
 		}
                 
-                if (m_spellLevel == expectedLevel) {
+                if (uint16_t(s.level) == expectedLevel) {
                     qDebug() << "  -> SUCCESS: Level (" << expectedLevel << ") matches expected value.";
                 } else {
-                    qWarning() << "  -> WARNING: Level (" << m_spellLevel << ") DOES NOT match expected value (" << expectedLevel << ").";
+                    qWarning() << "  -> WARNING: Level (" << s.level << ") DOES NOT match expected value (" << expectedLevel << ").";
                 }
-                qDebug() << "  Resisted By:" << m_resistedBy << " Required (First 3):" << m_required[0] << m_required[1] << m_required[2];
-                
-                // If we found both, we can break early if desired, but we'll continue for a full parse.
-                // if (foundCount == spellsToFind.count()) break; 
+                qDebug() << "  Resisted By:" << s.resistedBy << " Required (First 3):" << s.required[0] << s.required[1] << s.required[2];
             }
-            // else, continue to next iteration
-
-            // --- F. Print Spell Details ---
-            //qDebug() << "--- Spell #" << i << " (ID:" << m_ID << ") ---";
-            //qDebug() << "Name:" << spellname;
-            //qDebug() << "Level:" << m_spellLevel << " Class:" << m_class;
-            //qDebug() << "Damage Range:" << m_damage1 << " to " << m_damage2;
-            //qDebug() << "Resisted By:" << m_resistedBy;
-            //qDebug() << "Required Items/Skills:" << m_required[0] << m_required[1] << m_required[2] << m_required[3] << m_required[4] << m_required[5] << m_required[6];
         }
         
-        qDebug() << "Successfully loaded" << numSpells << "spells.";
+        qDebug() << "Successfully loaded" << spells.size() << "spells.";
 
     } catch (const std::runtime_error& e) {
         qWarning() << "Error reading spell records:" << e.what();
-    } catch (const char* msg) {
-        qWarning() << "Generic error reading spell records:" << msg;
     }
     
     return spells;
@@ -162,13 +101,39 @@ int consumedBytes = 0;
 // ----------------------------------------------------------------------
 
 Items loadItems(const QString& filename) {
-    RecordReader<75> buff(filename);
+    RecordReader<mdr::MDATA3_SCHEMA.recordLength> buff(filename);
     Items items;
     try {
-        buff.read();
-        // ... loading logic ...
+        static const auto binding = mdr::Binding<Item>(mdr::ITEM_FIELDS)
+            .field("Name", &Item::name)
+            .field("ID", &Item::ID)
+            .field("Att", &Item::att)
+            .field("Def", &Item::def)
+            .field("Price", &Item::price)
+            .field("Floor", &Item::floor)
+            .field("Rarity", &Item::rarity)
+            .field("Abilities", &Item::abilities)
+            .field("Swings", &Item::swings)
+            .field("SpecialType", &Item::specialType)
+            .field("SpellIndex", &Item::spellIndex)
+            .field("SpellID", &Item::spellID)
+            .field("Charges", &Item::charges) // A Long on disk; the low word (the high one is 'deleted' here)
+            .field("Guilds", &Item::guilds)
+            .field("LevelScale", &Item::levelScale)
+            .field("DamageMod", &Item::damageMod)
+            .field("AlignmentFlags", &Item::alignmentFlags)
+            .field("Hands", &Item::nHands)
+            .field("Type", &Item::type)
+            .field("ResistanceFlags", &Item::resistanceFlags)
+            .field("StatsRequired", &Item::statsRequired)
+            .field("StatsMod", &Item::statsMod)
+            .field("Cursed", &Item::cursed)
+            .field("SpellLevel", &Item::spellLvl)
+            .field("ClassRestricted", &Item::classRestricted);
+        const std::vector<Item> decoded = mdr::decodeSection(mdr::MDATA3_SCHEMA, "Items", buff.bytes(), binding);
+        items = Items(decoded.begin(), decoded.end());
     } catch (const std::runtime_error& e) {
-        qWarning() << "Error in loadItems (Stub):" << e.what();
+        qWarning() << "Error in loadItems:" << e.what();
     }
     return items;
 }
@@ -191,16 +156,44 @@ Characters loadCharacters(const QString& filename) {
 // ----------------------------------------------------------------------
 
 Monsters loadMonsters(const QString& filename) {
-    RecordReader<75> buff(filename);
+    RecordReader<mdr::MDATA5_SCHEMA.recordLength> buff(filename);
     Monsters monsters;
     try {
-        buff.read();
-        uint16_t count = buff.getWord();
-        monsters.reserve(count); // Assuming Monsters IS a container type (QList/std::vector)
-        // ... loop to load records ...
-        qDebug() << "Stub: loadMonsters finished.";
+        static const auto binding = mdr::Binding<Monster>(mdr::MONSTER_FIELDS)
+            .field("Name", &Monster::name)
+            .field("Att", &Monster::att)
+            .field("Def", &Monster::def)
+            .field("ID", &Monster::id)
+            .field("Hits", &Monster::hits)
+            .field("NumGroups", &Monster::numGroups)
+            .field("PicID", &Monster::picID)
+            .field("LockedChance", &Monster::lockedChance)
+            .field("LevelFound", &Monster::levelFound)
+            .field("Resistances", &Monster::resistances)
+            .field("SpecialPropertyFlags", &Monster::specialPropertyFlags)
+            .field("SpecialAttackFlags", &Monster::specialAttackFlags)
+            .field("SpellFlags", &Monster::spellFlags)
+            .field("Chance", &Monster::chance)
+            .field("BoxChance", &Monster::boxChance)
+            .field("Alignment", &Monster::alignment)
+            .field("InGroup", &Monster::ingroup)
+            .field("GoldFactor", &Monster::goldFactor)
+            .field("TrapFlags", &Monster::trapFlags)
+            .field("GuildLevel", &Monster::guildlevel)
+            .field("Stats", &Monster::stats)
+            .field("Type", &Monster::type)
+            .field("DamageMod", &Monster::damageMod)
+            .field("CompanionType", &Monster::companionType)
+            .field("CompanionSpawnMode", &Monster::companionSpawnMode)
+            .field("CompanionID", &Monster::companionID)
+            .field("Items", &Monster::items)
+            .field("SubType", &Monster::subtype)
+            .field("CompanionSubType", &Monster::companionSubtype);
+        const std::vector<Monster> decoded = mdr::decodeSection(mdr::MDATA5_SCHEMA, "Monsters", buff.bytes(), binding);
+        monsters = Monsters(decoded.begin(), decoded.end());
+        qDebug() << "loadMonsters:" << monsters.size() << "monsters.";
     } catch (const std::runtime_error& e) {
-        qWarning() << "Error in loadMonsters (Stub):" << e.what();
+        qWarning() << "Error in loadMonsters:" << e.what();
     }
     return monsters;
 }
@@ -235,14 +228,29 @@ GuildLogs loadGuildLogs(const QString& filename) {
     return logs;
 }
 
+// Only the first floor is described in MDATA11_SCHEMA, so that is all this loads
 Dungeon loadDungeon(const QString& filename) {
-    RecordReader<75> buff(filename);
+    RecordReader<mdr::MDATA11_SCHEMA.recordLength> buff(filename);
     Dungeon dungeon;
     try {
-        buff.read();
-        qDebug() << "Stub: loadDungeon finished.";
+        static const auto headerBinding = mdr::Binding<Floor>(mdr::FLOOR_HEADER_FIELDS)
+            .field("Width", &Floor::width)
+            .field("Height", &Floor::height)
+            .field("LevelNumber", &Floor::levelNum);
+        static const auto cellBinding = mdr::Binding<Floor::Field>(mdr::DUNGEON_CELL_FIELDS)
+            .field("Area", &Floor::Field::areaID)
+            .field("Flags", &Floor::Field::flags);
+
+        const std::vector<Floor> headers = mdr::decodeSection(mdr::MDATA11_SCHEMA, "FloorHeader", buff.bytes(), headerBinding);
+        if (!headers.empty()) {
+            Floor floor = headers.front();
+            const std::vector<Floor::Field> cells = mdr::decodeSection(mdr::MDATA11_SCHEMA, "Cells", buff.bytes(), cellBinding);
+            floor.fields = QVector<Floor::Field>(cells.begin(), cells.end());
+            dungeon.append(floor);
+        }
+        qDebug() << "loadDungeon:" << dungeon.size() << "floor(s).";
     } catch (const std::runtime_error& e) {
-        qWarning() << "Error in loadDungeon (Stub):" << e.what();
+        qWarning() << "Error in loadDungeon:" << e.what();
     }
     return dungeon;
 }
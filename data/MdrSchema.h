@@ -0,0 +1,457 @@
+#pragma once
+
+#include "RecordReader.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// Record layouts of the MDR files, described as data.
+//
+// The C# models next to this file (DATA02Spells.cs, ...) describe each file as a
+// handful of header records followed by an array of fixed-length records; a
+// FileSchema is the same thing: a list of Sections, each a run of records that
+// share one field layout. decodeFile() walks a file by its schema and hands every
+// decoded field to a visitor (tools/mdrbench); Binding and decodeSection() put the
+// fields of one section straight into a struct (data/MLoader.cpp, tools/*converter).
+// The layouts below are the only description of these records in the tree.
+namespace mdr {
+
+enum class FieldType : uint8_t {
+    Byte,        // 1 byte
+    Integer,     // VB Integer, 16-bit signed
+    Long,        // VB Long, 32-bit signed
+    Single,      // VB Single, 32-bit float
+    Currency,    // VB Currency, 64-bit integer scaled by 10000
+    VBString,    // Integer length + that many Latin-1 bytes
+    FixedString  // 'length' Latin-1 bytes
+};
+
+struct Field {
+    const char* name;
+    FieldType type;
+    uint16_t count = 1;   // > 1 for arrays (Required[7], Resistances[12], ...)
+    uint16_t length = 0;  // FixedString only
+};
+
+// Size of a field on disk; VB strings count only their length prefix
+constexpr size_t fixedSize(const Field& field) {
+    switch (field.type) {
+    case FieldType::Byte:        return 1u * field.count;
+    case FieldType::Integer:     return 2u * field.count;
+    case FieldType::Long:        return 4u * field.count;
+    case FieldType::Single:      return 4u * field.count;
+    case FieldType::Currency:    return 8u * field.count;
+    case FieldType::VBString:    return 2u * field.count;
+    case FieldType::FixedString: return size_t(field.length) * field.count;
+    }
+    return 0;
+}
+
+constexpr size_t fixedSize(std::span<const Field> layout) {
+    size_t size = 0;
+    for (const Field& field : layout) size += fixedSize(field);
+    return size;
+}
+
+// A run of consecutive records with the same layout
+struct Section {
+    static constexpr size_t TO_END = 0;   // count: every remaining record in the file
+    static constexpr int NO_COUNT = -1;
+
+    const char* name;
+    size_t firstRecord;
+    std::span<const Field> layout;
+    size_t count = 1;
+    int countFrom = NO_COUNT;             // Section whose first Integer holds the record count
+};
+
+struct FileSchema {
+    const char* fileName;
+    size_t recordLength;
+    std::span<const Section> sections;
+};
+
+// --- Shared header records ---
+
+inline constexpr Field VERSION_FIELDS[] = { { "Version", FieldType::VBString } };
+inline constexpr Field COUNT_FIELDS[]   = { { "Count", FieldType::Integer } };
+
+// --- MDATA2: spells (75-byte records) ---
+
+inline constexpr Field SPELL_FIELDS[] = {
+    { "Name",          FieldType::VBString },
+    { "ID",            FieldType::Integer },
+    { "Class",         FieldType::Integer },
+    { "Level",         FieldType::Integer },
+    { "U4",            FieldType::Integer },
+    { "AlwaysZero",    FieldType::Integer },
+    { "KillEffect",    FieldType::Integer },
+    { "AffectMonster", FieldType::Integer },
+    { "AffectGroup",   FieldType::Integer },
+    { "Damage1",       FieldType::Integer },
+    { "Damage2",       FieldType::Integer },
+    { "SpecialEffect", FieldType::Integer },
+    { "Required",      FieldType::Integer, 7 },
+    { "ResistedBy",    FieldType::Integer },
+};
+static_assert(fixedSize(SPELL_FIELDS) <= 75, "Spell layout doesn't fit a 75-byte record");
+
+inline constexpr Section SPELL_SECTIONS[] = {
+    { "Version", 0, VERSION_FIELDS },
+    { "Count",   1, COUNT_FIELDS },
+    { "Spells",  2, SPELL_FIELDS, 0, 1 },
+};
+inline constexpr FileSchema MDATA2_SCHEMA = { "MDATA2.MDR", 75, SPELL_SECTIONS };
+
+// --- MDATA3: items (125-byte records) ---
+
+inline constexpr Field ITEM_FIELDS[] = {
+    { "Name",            FieldType::VBString },
+    { "ID",              FieldType::Integer },
+    { "Att",             FieldType::Integer },
+    { "Def",             FieldType::Integer },
+    { "Price",           FieldType::Long },
+    { "Floor",           FieldType::Integer },
+    { "Rarity",          FieldType::Integer },
+    { "Abilities",       FieldType::Long },
+    { "Swings",          FieldType::Integer },
+    { "SpecialType",     FieldType::Integer },
+    { "SpellIndex",      FieldType::Integer },
+    { "SpellID",         FieldType::Integer },
+    { "Charges",         FieldType::Long },
+    { "Guilds",          FieldType::Long },
+    { "LevelScale",      FieldType::Integer },
+    { "DamageMod",       FieldType::Single },
+    { "AlignmentFlags",  FieldType::Long },
+    { "Hands",           FieldType::Integer },
+    { "Type",            FieldType::Integer },
+    { "ResistanceFlags", FieldType::Long },
+    { "StatsRequired",   FieldType::Integer, 7 },
+    { "StatsMod",        FieldType::Integer, 7 },
+    { "Cursed",          FieldType::Integer },
+    { "SpellLevel",      FieldType::Integer },
+    { "ClassRestricted", FieldType::Integer },
+};
+static_assert(fixedSize(ITEM_FIELDS) <= 125, "Item layout doesn't fit a 125-byte record");
+
+inline constexpr Field STORE_CODE_FIELDS[] = { { "GeneralStoreCode", FieldType::Integer } };
+
+inline constexpr Section ITEM_SECTIONS[] = {
+    { "Version",          0, VERSION_FIELDS },
+    { "GeneralStoreCode", 1, STORE_CODE_FIELDS },
+    { "Count",            2, COUNT_FIELDS },
+    { "Items",            3, ITEM_FIELDS, 0, 2 },
+};
+inline constexpr FileSchema MDATA3_SCHEMA = { "MDATA3.MDR", 125, ITEM_SECTIONS };
+
+// --- MDATA5: monsters (160-byte records) ---
+
+inline constexpr Field MONSTER_FIELDS[] = {
+    { "Name",                 FieldType::VBString },
+    { "Att",                  FieldType::Integer },
+    { "Def",                  FieldType::Integer },
+    { "ID",                   FieldType::Integer },
+    { "Hits",                 FieldType::Integer },
+    { "NumGroups",            FieldType::Integer },
+    { "PicID",                FieldType::Integer },
+    { "LockedChance",         FieldType::Integer },
+    { "LevelFound",           FieldType::Integer },
+    { "Resistances",          FieldType::Integer, 12 },
+    { "SpecialPropertyFlags", FieldType::Long },
+    { "SpecialAttackFlags",   FieldType::Long },
+    { "SpellFlags",           FieldType::Long },
+    { "Chance",               FieldType::Integer },
+    { "BoxChance",            FieldType::Integer, 4 },
+    { "Alignment",            FieldType::Integer },
+    { "InGroup",              FieldType::Integer },
+    { "GoldFactor",           FieldType::Long },
+    { "TrapFlags",            FieldType::Long },
+    { "GuildLevel",           FieldType::Integer },
+    { "Stats",                FieldType::Integer, 7 },
+    { "Type",                 FieldType::Integer },
+    { "DamageMod",            FieldType::Single },
+    { "CompanionType",        FieldType::Integer },
+    { "CompanionSpawnMode",   FieldType::Integer },
+    { "CompanionID",          FieldType::Integer },
+    { "Items",                FieldType::Integer, 11 },
+    { "SubType",              FieldType::Integer },
+    { "CompanionSubType",     FieldType::Integer },
+    { "Deleted",              FieldType::Integer },
+};
+static_assert(fixedSize(MONSTER_FIELDS) <= 160, "Monster layout doesn't fit a 160-byte record");
+
+inline constexpr Field UNUSED_FIELDS[] = { { "Unused", FieldType::Integer } };
+
+inline constexpr Section MONSTER_SECTIONS[] = {
+    { "Version",  0, VERSION_FIELDS },
+    { "Unused",   1, UNUSED_FIELDS },
+    { "Count",    2, COUNT_FIELDS },
+    { "Monsters", 3, MONSTER_FIELDS, 0, 2 },
+};
+inline constexpr FileSchema MDATA5_SCHEMA = { "MDATA5.MDR", 160, MONSTER_SECTIONS };
+
+// --- MDATA11: dungeon map (20-byte records) ---
+// Only the first floor is described: its header sits in record 4 and is
+// followed by one record per cell (30 x 30).
+
+inline constexpr Field FLOOR_COUNT_FIELDS[] = { { "FloorCount", FieldType::Integer } };
+
+inline constexpr Field FLOOR_HEADER_FIELDS[] = {
+    { "Width",           FieldType::Integer },
+    { "Height",          FieldType::Integer },
+    { "LevelNumber",     FieldType::Integer },
+    { "AreaCount",       FieldType::Integer },
+    { "ChuteCount",      FieldType::Integer },
+    { "TeleporterCount", FieldType::Integer },
+};
+
+inline constexpr Field DUNGEON_CELL_FIELDS[] = {
+    { "Area",  FieldType::Integer },
+    { "Flags", FieldType::Currency },
+};
+static_assert(fixedSize(DUNGEON_CELL_FIELDS) <= 20, "Cell layout doesn't fit a 20-byte record");
+
+inline constexpr Section DUNGEON_SECTIONS[] = {
+    { "FloorCount",  0, FLOOR_COUNT_FIELDS },
+    { "FloorHeader", 4, FLOOR_HEADER_FIELDS },
+    { "Cells",       5, DUNGEON_CELL_FIELDS, 30 * 30 },
+};
+inline constexpr FileSchema MDATA11_SCHEMA = { "MDATA11.MDR", 20, DUNGEON_SECTIONS };
+
+/**
+ * @brief Decodes one record by 'layout' and calls visitor(field, index, value) for every value.
+ *
+ * 'index' is the position within an array field (0 for scalars). 'value' has the
+ * field's natural type: uint8_t, int16_t, int32_t, float, int64_t (Currency, still
+ * scaled) or std::string_view (a view into 'record').
+ *
+ * @return false if a field ran past the end of the record; the rest of it is skipped
+ */
+template<typename Visitor>
+bool decodeRecord(std::span<const std::byte> record, std::span<const Field> layout, Visitor&& visitor) {
+    size_t pos = 0;
+    for (const Field& field : layout) {
+        for (uint16_t i = 0; i < field.count; ++i) {
+            // Each type decodes through its own mdr::decode<T> instantiation
+            auto emit = [&](auto typed, size_t size) -> bool {
+                using T = decltype(typed);
+                if (pos + size > record.size()) return false;
+                visitor(field, i, decode<T>(record.data() + pos));
+                pos += size;
+                return true;
+            };
+            auto emitChars = [&](size_t length) -> bool {
+                if (pos + length > record.size()) return false;
+                visitor(field, i, std::string_view(reinterpret_cast<const char*>(record.data() + pos), length));
+                pos += length;
+                return true;
+            };
+
+            bool ok = false;
+            switch (field.type) {
+            case FieldType::Byte:     ok = emit(uint8_t{}, 1); break;
+            case FieldType::Integer:  ok = emit(int16_t{}, 2); break;
+            case FieldType::Long:     ok = emit(int32_t{}, 4); break;
+            case FieldType::Single:   ok = emit(float{}, 4); break;
+            case FieldType::Currency: ok = emit(int64_t{}, 8); break;
+            case FieldType::FixedString: ok = emitChars(field.length); break;
+            case FieldType::VBString:
+                if (pos + 2 <= record.size()) {
+                    const uint16_t length = static_cast<uint16_t>(decode<int16_t>(record.data() + pos));
+                    pos += 2;
+                    ok = emitChars(length);
+                }
+                break;
+            }
+            if (!ok) return false;
+        }
+    }
+    return true;
+}
+
+// The section called 'name'; throws std::runtime_error if the schema has none
+inline const Section& section(const FileSchema& schema, std::string_view name) {
+    for (const Section& s : schema.sections) {
+        if (name == s.name) return s;
+    }
+    throw std::runtime_error(std::string(schema.fileName) + " has no section " + std::string(name));
+}
+
+/**
+ * @brief Calls fn(record) for every record of 'section' in 'file'.
+ *
+ * A short final record is handed over zero-padded, like RecordReader::read().
+ *
+ * @return the number of records visited
+ */
+template<typename Fn>
+size_t forEachRecord(const FileSchema& schema, const Section& section, std::span<const std::byte> file, Fn&& fn) {
+    const size_t recordLength = schema.recordLength;
+    std::vector<std::byte> padded; // Only filled for a short final record
+
+    auto recordAt = [&](size_t index) -> std::span<const std::byte> {
+        const size_t offset = index * recordLength;
+        if (offset >= file.size()) return {};
+        if (offset + recordLength <= file.size()) return file.subspan(offset, recordLength);
+        padded.assign(recordLength, std::byte{0});
+        std::memcpy(padded.data(), file.data() + offset, file.size() - offset);
+        return padded;
+    };
+
+    size_t count = section.count;
+    if (section.countFrom != Section::NO_COUNT) {
+        const std::span<const std::byte> countRecord = recordAt(schema.sections[section.countFrom].firstRecord);
+        count = countRecord.size() >= 2 ? static_cast<uint16_t>(decode<int16_t>(countRecord.data())) : 0;
+    } else if (count == Section::TO_END) {
+        const size_t records = (file.size() + recordLength - 1) / recordLength;
+        count = records > section.firstRecord ? records - section.firstRecord : 0;
+    }
+
+    size_t visited = 0;
+    for (size_t r = 0; r < count; ++r) {
+        const std::span<const std::byte> record = recordAt(section.firstRecord + r);
+        if (record.empty()) break;
+        fn(record);
+        ++visited;
+    }
+    return visited;
+}
+
+/**
+ * @brief Walks 'file' by 'schema' and calls visitor(field, index, value) for every value.
+ *
+ * See decodeRecord() for the arguments. 'value' strings are views into 'file', valid
+ * while the file is mapped; a record with a corrupt field is skipped from there on.
+ *
+ * @return the number of records decoded
+ */
+template<typename Visitor>
+size_t decodeFile(const FileSchema& schema, std::span<const std::byte> file, Visitor&& visitor) {
+    size_t decoded = 0;
+    for (const Section& section : schema.sections) {
+        decoded += forEachRecord(schema, section, file, [&](std::span<const std::byte> record) {
+            decodeRecord(record, section.layout, visitor);
+        });
+    }
+    return decoded;
+}
+
+// One decoded value, for code that stores it without knowing the field type up front
+using Value = std::variant<uint8_t, int16_t, int32_t, float, int64_t, std::string_view>;
+
+template<typename V>
+inline constexpr bool isStringMember = std::is_same_v<V, std::string> || std::is_same_v<V, QString>;
+
+// Stores 'value' in 'out', converting numbers to the member's type and Latin-1 text to strings
+template<typename V>
+void assign(V& out, const Value& value) {
+    std::visit([&out](auto v) {
+        if constexpr (std::is_same_v<decltype(v), std::string_view>) {
+            if constexpr (std::is_same_v<V, std::string>) out = std::string(v);
+            else if constexpr (std::is_same_v<V, QString>) out = QString::fromLatin1(v.data(), static_cast<qsizetype>(v.size()));
+        } else if constexpr (std::is_arithmetic_v<V>) {
+            out = static_cast<V>(v);
+        }
+    }, value);
+}
+
+/**
+ * @brief Maps the fields of a record layout onto the members of a C++ struct.
+ *
+ * Built once, usually in a function-local static:
+ *
+ *     static const auto binding = mdr::Binding<Spell>(mdr::SPELL_FIELDS)
+ *         .field("Name", &Spell::name)
+ *         .field("Required", &Spell::required);
+ *
+ * Where each field sits and how it is decoded comes from the layout alone; the
+ * binding only says which member receives it. Fields left unbound are decoded
+ * and dropped, array fields fill as many elements as the member has. Naming a
+ * field the layout doesn't have, or binding text to a number (or the other way
+ * round), throws std::runtime_error when the binding is built.
+ */
+template<typename T>
+class Binding {
+public:
+    explicit Binding(std::span<const Field> layout) : m_layout(layout), m_setters(layout.size()) {}
+
+    template<typename V>
+    Binding& field(const char* name, V T::*member) {
+        m_setters[indexOf(name, isStringMember<V>)] = [member](T& out, uint16_t index, const Value& value) {
+            if (index == 0) assign(out.*member, value);
+        };
+        return *this;
+    }
+
+    template<typename V, size_t N>
+    Binding& field(const char* name, V (T::*member)[N]) {
+        m_setters[indexOf(name, isStringMember<V>)] = [member](T& out, uint16_t index, const Value& value) {
+            if (index < N) assign((out.*member)[index], value);
+        };
+        return *this;
+    }
+
+    // Decodes 'record' into 'out'. False if the record was cut short by a corrupt field.
+    bool decode(std::span<const std::byte> record, T& out) const {
+        return decodeRecord(record, m_layout, [&](const Field& field, uint16_t index, auto value) {
+            const Setter& set = m_setters[static_cast<size_t>(&field - m_layout.data())];
+            if (set) set(out, index, Value(std::in_place_type<decltype(value)>, value));
+        });
+    }
+
+private:
+    using Setter = std::function<void(T&, uint16_t, const Value&)>;
+
+    size_t indexOf(std::string_view name, bool stringMember) const {
+        for (size_t i = 0; i < m_layout.size(); ++i) {
+            if (name != m_layout[i].name) continue;
+            const bool stringField = m_layout[i].type == FieldType::VBString || m_layout[i].type == FieldType::FixedString;
+            if (stringField != stringMember) {
+                throw std::runtime_error("Field " + std::string(name) + " bound to a member of the wrong kind");
+            }
+            return i;
+        }
+        throw std::runtime_error("No field " + std::string(name) + " in this layout");
+    }
+
+    std::span<const Field> m_layout;
+    std::vector<Setter> m_setters; // One per layout field, empty if unbound
+};
+
+// Every record of the section called 'name', one struct each, starting from 'prototype'
+template<typename T>
+std::vector<T> decodeSection(const FileSchema& schema, std::string_view name, std::span<const std::byte> file,
+                             const Binding<T>& binding, const T& prototype = T()) {
+    std::vector<T> rows;
+    forEachRecord(schema, section(schema, name), file, [&](std::span<const std::byte> record) {
+        T row = prototype;
+        binding.decode(record, row);
+        rows.push_back(std::move(row));
+    });
+    return rows;
+}
+
+// The first value of the header section 'name' ("Version", "Count", ...), or 'fallback' if the file lacks it
+template<typename V>
+V headerValue(const FileSchema& schema, std::string_view name, std::span<const std::byte> file, V fallback = V()) {
+    const Section& header = section(schema, name);
+    V out = fallback;
+    bool done = false;
+    forEachRecord(schema, header, file, [&](std::span<const std::byte> record) {
+        decodeRecord(record, header.layout, [&](const Field&, uint16_t, auto value) {
+            if (!done) assign(out, Value(std::in_place_type<decltype(value)>, value));
+            done = true;
+        });
+    });
+    return out;
+}
+
+} // namespace mdr
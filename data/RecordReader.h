@@ -1,12 +1,19 @@
 #pragma once
 
 #include <QFile>
-#include <QDataStream>
+#include <QByteArray>
 #include <QString>
-#include <QBuffer> 
 #include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <stdint.h>
-#include <QDebug> 
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 // Define standard types for clarity
 typedef int32_t int32_t;
@@ -15,162 +22,244 @@ typedef int64_t int64_t;
 typedef uint64_t uint64_t;
 typedef uint8_t uint8_t; // Added for single-byte reads
 
+// Shared MDR decoding, used by data/MLoader.cpp and every tools/*converter.
+// MDR files are Visual Basic random-access files: fixed-length records of
+// little-endian Integer (16 bit), Long (32 bit), Single, Currency (64 bit)
+// and strings, either fixed-length or prefixed with an Integer length.
+namespace mdr {
+
+/**
+ * @brief Decodes one little-endian value of type T from raw record bytes.
+ */
+template<typename T>
+inline T decode(const std::byte* src) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "MDR fields are arithmetic types or strings");
+    std::array<std::byte, sizeof(T)> raw;
+    std::memcpy(raw.data(), src, sizeof(T));
+    if constexpr (sizeof(T) > 1 && std::endian::native == std::endian::big) {
+        std::reverse(raw.begin(), raw.end());
+    }
+    return std::bit_cast<T>(raw);
+}
+
+} // namespace mdr
+
 /**
- * @brief Template class for reading fixed-length records from a file using QDataStream.
+ * @brief Template class for reading fixed-length records from a memory-mapped MDR file.
+ *
+ * The whole file is mapped once when the reader is constructed. read() just moves
+ * a view to the next RECORD_LENGTH bytes, and the getters decode straight out of
+ * the mapping - nothing is copied or allocated per record.
+ *
+ * Sequential getters (getWord(), getDword(), ...) walk the current record and throw
+ * if a field would run past its end. When the field offset is known up front use
+ * field<OFFSET, T>() instead: the range check is a static_assert against the
+ * compile-time RECORD_LENGTH, so there is no check left at run time.
+ *
+ * Every error, including reading before the first read(), is reported as a
+ * std::runtime_error.
+ *
  * @tparam RECORD_LENGTH The size of the record in bytes.
  */
 template<size_t RECORD_LENGTH>
 class RecordReader {
+    static_assert(RECORD_LENGTH > 0, "RecordReader needs a fixed record length");
+
 public:
-    RecordReader(const QString& filename) : 
-        file(filename), 
-        s(&file), 
-        readRecord(false) 
+    using Record = std::span<const std::byte, RECORD_LENGTH>;
+
+    RecordReader(const QString& filename) :
+        file(filename)
     {
         if (!file.open(QIODevice::ReadOnly)) {
             throw std::runtime_error("Could not open file for reading: " + filename.toStdString());
         }
-        // Set to LittleEndian as per file analysis
-        s.setByteOrder(QDataStream::LittleEndian);
-        s.setVersion(QDataStream::Qt_6_0); 
+
+        qint64 size = file.size();
+        const uchar* mapped = (size > 0) ? file.map(0, size) : nullptr;
+        if (!mapped) {
+            // Not mappable (empty file, special device): keep one copy of the whole file instead
+            fallback = file.readAll();
+            mapped = reinterpret_cast<const uchar*>(fallback.constData());
+            size = fallback.size();
+        }
+        begin = reinterpret_cast<const std::byte*>(mapped);
+        end = begin + size;
+        next = begin;
     }
+    RecordReader(const std::string& filename) : RecordReader(QString::fromStdString(filename)) {}
+    RecordReader(const char* filename) : RecordReader(QString::fromUtf8(filename)) {}
+
+    // The mapping is owned by 'file' and released when it closes
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
 
     // --- Core Read and Seek Methods ---
 
     /**
-     * @brief Reads the next fixed-size record from the file into the internal buffer.
+     * @brief Moves to the next fixed-size record in the file.
+     *
+     * VB doesn't pad the last record of a file, so a short final record is
+     * copied into a zero-filled buffer and read from there.
      */
     void read() {
-        QByteArray data = file.read(RECORD_LENGTH);
-        if (data.size() != (int)RECORD_LENGTH) {
-            if (file.atEnd() && data.isEmpty()) {
-                throw std::runtime_error("Unexpected end of file or incomplete record read.");
-            }
-            throw std::runtime_error("Incomplete record read: Expected " + std::to_string(RECORD_LENGTH) + " bytes, got " + std::to_string(data.size()));
+        if (next >= end) {
+            throw std::runtime_error("Unexpected end of file or incomplete record read.");
         }
-        
-        // Reset the buffer for the new data
-        buffer.close();
-        buffer.setData(data); // Use setData instead of setBuffer for a clean copy
-        
-        if (!buffer.open(QIODevice::ReadOnly)) {
-            throw std::runtime_error("Failed to open QBuffer for read.");
+        const size_t available = static_cast<size_t>(end - next);
+        if (available < RECORD_LENGTH) {
+            tail.fill(std::byte{0});
+            std::memcpy(tail.data(), next, available);
+            current = tail.data();
+        } else {
+            current = next;
         }
-        
-        // CRITICAL: Point QDataStream to the new buffer BEFORE reading values
-        s.setDevice(&buffer); 
-        
-        readRecord = true;
+        next += std::min(available, RECORD_LENGTH);
+        pos = 0;
     }
 
     void seek(qint64 offset) {
-        if (!file.seek(offset)) {
+        if (offset < 0 || offset > end - begin) {
             throw std::runtime_error("Failed to seek file.");
         }
-        readRecord = false;
+        next = begin + offset;
+        current = nullptr;
     }
 
-    // --- Public Getter Template (Delegates to private overloads) ---
+    // --- Record Views ---
+
     /**
-     * @brief Reads a value of type T from the current record buffer.
+     * @brief The record loaded by the last read(), as a view into the mapped file.
      */
-    template<typename T>
-    T& get(T& var) {
-        if (!readRecord) throw "Tried to get before reading next record";
-        return readValue(var); // Calls the private readValue helper
+    Record record() const {
+        if (!current) throw std::runtime_error("Tried to get before reading next record");
+        return Record(current, RECORD_LENGTH);
     }
 
-    // --- Helper Getters for Primitive Types (Convenience) ---
+    // Random access by record number, independent of read()/seek().
+    // Only complete records are counted.
+    size_t recordCount() const { return static_cast<size_t>(end - begin) / RECORD_LENGTH; }
 
-    uint8_t getByte() {
-        uint8_t var;
-        get(var);
-        return var;
+    Record recordAt(size_t index) const {
+        if (index >= recordCount()) {
+            throw std::runtime_error("Record index out of range: " + std::to_string(index));
+        }
+        return Record(begin + index * RECORD_LENGTH, RECORD_LENGTH);
     }
 
-    uint16_t getWord() { 
-        uint16_t var; 
-        get(var); 
-        return var; 
-    }
-    
-    uint32_t getDword() { 
-        uint32_t var; 
-        get(var); 
-        return var; 
+    // The whole file, for decoders that walk it themselves (see MdrSchema.h)
+    std::span<const std::byte> bytes() const { return { begin, static_cast<size_t>(end - begin) }; }
+
+    /**
+     * @brief Decodes a value at a fixed offset of the current record.
+     */
+    template<size_t OFFSET, typename T>
+    T field() const {
+        static_assert(OFFSET + sizeof(T) <= RECORD_LENGTH, "Field lies outside the record");
+        if (!current) throw std::runtime_error("Tried to get before reading next record");
+        return mdr::decode<T>(current + OFFSET);
     }
 
-    float getFloat() {
-        float var;
-        get(var);
+    // --- Public Getter Templates ---
+    /**
+     * @brief Reads a value of type T from the current record and advances past it.
+     */
+    template<typename T>
+    T& get(T& var) {
+        var = mdr::decode<T>(take(sizeof(T)));
         return var;
     }
-    
-    int64_t getCurrency() {
-        int64_t var = 0; 
-        get(var); 
-        return var;
+
+    // VB string with an Integer length prefix
+    std::string& get(std::string& str) {
+        str = getString();
+        return str;
+    }
+
+    // Fixed-length string field
+    std::string& get(std::string& str, size_t length) {
+        str = getString(length);
+        return str;
     }
-    
-    int64_t getIntCurrency() {
-        int64_t var = 0; 
-        get(var);
-        return var / 10000; 
+
+    template<typename T>
+    void getArray(T* var, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            get(var[i]);
+        }
     }
-    
-    // --- String Getters (FIXED LENGTH) ---
+
+    // --- Helper Getters for Primitive Types (Convenience) ---
+
+    uint8_t getByte() { uint8_t var; return get(var); }
+
+    // VB Integer / Long are signed
+    int16_t getWord() { int16_t var; return get(var); }
+    int32_t getDword() { int32_t var; return get(var); }
+
+    // VB Single: 4-byte IEEE float
+    float getFloat() { float var; return get(var); }
+
+    int64_t getInt64() { int64_t var; return get(var); }
+    uint64_t getUint64() { uint64_t var; return get(var); }
+
+    // VB Currency: 8-byte integer scaled by 10000
+    int64_t getCurrency() { return getInt64(); }
+    int64_t getIntCurrency() { return getCurrency() / 10000; }
+
+    // Skips padding or fields nobody reads
+    void skip(size_t len) { take(len); }
+
+    // --- String Getters ---
     /**
-     * @brief Reads a fixed-length string from the current record buffer.
-     * @param len The exact byte length of the string field.
-     * * NOTE: This uses the QBuffer's read() which advances the QBuffer's pointer.
+     * @brief Reads a VB string: an Integer length followed by that many bytes.
      */
-    QString getString(size_t len = 0) {
-        if (!readRecord) throw "Tried to get before reading next record";
-        
-        QByteArray arr;
-        if (len == 0) {
-            // Fall back to standard length-prefixed Qt read
-            this->s >> arr;
-        } else {
-            // Reads fixed-length from the internal QBuffer device
-            // This is the source of conflict, but necessary for fixed-length strings.
-            arr = buffer.read(len); 
-        }
-        
-        return QString::fromLatin1(arr);
+    std::string getString() {
+        const uint16_t len = static_cast<uint16_t>(getWord());
+        return std::string(getChars(len));
     }
 
-private:
-    // ----------------------------------------------------------------------
-    // Private Overloaded Helper Functions (ALL using QDataStream 's')
-    // ----------------------------------------------------------------------
-    
-    // 1. Generic readValue (Used for all types QDataStream supports directly)
-    template<typename T>
-    T& readValue(T& var) {
-        this->s >> var;
-        return var;
+    /**
+     * @brief Reads a fixed-length string field.
+     */
+    std::string getString(size_t len) {
+        return std::string(getChars(len));
     }
 
-    // 2. Overload for int64_t
-    int64_t& readValue(int64_t& var) {
-        qint64 temp; 
-        this->s >> temp; 
-        var = temp;      
-        return var;
+    // Latin-1 QString versions for Qt callers
+    QString getQString() {
+        const uint16_t len = static_cast<uint16_t>(getWord());
+        return getQString(len);
     }
 
-    // 3. Overload for uint64_t
-    uint64_t& readValue(uint64_t& var) {
-        quint64 temp; 
-        this->s >> temp; 
-        var = temp;
-        return var;
+    QString getQString(size_t len) {
+        const std::string_view chars = getChars(len);
+        return QString::fromLatin1(chars.data(), static_cast<qsizetype>(chars.size()));
     }
-    
+
+private:
+    // Returns the current field and advances past it
+    const std::byte* take(size_t size) {
+        if (!current) throw std::runtime_error("Tried to get before reading next record");
+        if (size > RECORD_LENGTH - pos) {
+            throw std::runtime_error("Field read past the end of a " + std::to_string(RECORD_LENGTH) + "-byte record");
+        }
+        const std::byte* field = current + pos;
+        pos += size;
+        return field;
+    }
+
+    std::string_view getChars(size_t len) {
+        return std::string_view(reinterpret_cast<const char*>(take(len)), len);
+    }
+
 private:
     QFile file;
-    QDataStream s;
-    QBuffer buffer; 
-    bool readRecord;
+    QByteArray fallback;                  // Only used when the file can't be mapped
+    std::array<std::byte, RECORD_LENGTH> tail {}; // Zero-padded copy of a short final record
+    const std::byte* begin = nullptr;
+    const std::byte* end = nullptr;
+    const std::byte* next = nullptr;      // Start of the record read() will return
+    const std::byte* current = nullptr;   // Start of the current record, null before read()
+    size_t pos = 0;                       // Cursor within the current record
 };
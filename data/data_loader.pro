@@ -1,6 +1,6 @@
 # Define the application type
 QT -= gui
-CONFIG += console
+CONFIG += console c++20
 CONFIG -= app_bundle
 
 # Set the target application name
@@ -14,7 +14,8 @@ QT += core
 HEADERS += \
     MTypes.h \
     MLoader.h \
-    RecordReader.h
+    RecordReader.h \
+    MdrSchema.h
 
 # Specify all source files
 SOURCES += \
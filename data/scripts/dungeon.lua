@@ -0,0 +1,19 @@
+-- Tile handlers for the dungeon, loaded each time a dungeon opens.
+-- OnTile[Feature.X](x, y) runs instead of the built-in C++ handler for that feature.
+-- Handlers run as coroutines, so they may wait(n) ticks (100 ms each),
+-- wait_input() for a key press or wait_combat() for the current fight to end.
+
+OnTile = OnTile or {}
+
+OnTile[Feature.ANTIMAGIC] = function(x, y)
+    dungeon.log("You enter an Antimagic Field! Your spells feel suppressed.")
+end
+
+OnTile[Feature.EXTINGUISHER] = function(x, y)
+    if party.on_fire() then
+        party.set_on_fire(false)
+        dungeon.log("Magic waters spray from the ceiling! The flames are extinguished.")
+    else
+        dungeon.log("A refreshing mist falls upon you.")
+    end
+end
@@ -1,6 +1,10 @@
 #include "gameStateManager.h"
 #include "src/partymanager/PartyManager.h"
 #include "src/core/savegameUtils.h"
+#include "src/core/GameDataCache.h"
+#include "src/core/SaveContainer.h"
+#include "src/core/LuaRecords.h"
+#include "src/dungeon_dialog/DungeonScripts.h"
 
 #include "version.h"
 //#include "fontManager.h"
@@ -15,6 +19,7 @@
 #include <QVariantMap>
 #include <QMapIterator>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QTextStream>
 #include <QIODevice>
@@ -22,8 +27,11 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDir>
+#include <QDataStream>
+#include <QFileInfo>
 #include <QMetaType>
 #include <QPainter>
+#include <QtConcurrent>
 
 void gameStateManager::initializeResources() {
     checkSettingsFile();
@@ -102,7 +110,7 @@ void gameStateManager::refreshUI() {
     // If you have specific UI elements bound to "CurrentCharacterHP", 
     // update only those two or three global keys here.
     if (!m_PC.isEmpty()) {
-        m_gameStateData["CurrentCharacterHP"] = m_PC[0].hp;
+        m_state.set(GameState::Key::CurrentCharacterHP, m_PC[0].hp);
         m_gameStateData["isAlive"] = m_PC[0].isAlive;
     }
 
@@ -158,12 +166,16 @@ GameConstants::RaceStats gameStateManager::createRaceFromVariant(const QVariant&
 void gameStateManager::incrementStock(const QString& name)
 {
     m_confinementStock[name] = m_confinementStock.value(name, 0) + 1;
+    markDirty();
 }
 
 void gameStateManager::decrementStock(const QString& name)
 {
     int current = m_confinementStock.value(name, 0);
-    if (current > 0) m_confinementStock[name] = current - 1;
+    if (current > 0) {
+        m_confinementStock[name] = current - 1;
+        markDirty();
+    }
 }
 
 QMap<QString, int> gameStateManager::getConfinementStock() const
@@ -174,7 +186,8 @@ QMap<QString, int> gameStateManager::getConfinementStock() const
 gameStateManager::gameStateManager(QObject *parent)
     : QObject(parent)
 {
-    initializeResources();
+    // Images and static data are loaded in the background by LoadingScreen,
+    // which calls initializeResources() and applyStaticData() when they are ready
     m_fontSpriteSheet.load("resources/images/font_spritesheet_transparent.png");
 
     //loadAllGameResources();
@@ -184,6 +197,10 @@ gameStateManager::gameStateManager(QObject *parent)
     // 1. Setup Lua (if not already done)
     m_L = luaL_newstate();
     luaL_openlibs(m_L);
+    m_scripts = new LuaScriptCache(m_L);
+    m_scheduler = new ScriptScheduler(m_L);
+    m_scheduler->registerApi();
+    DungeonScripts::install(m_L);
 
     // Fetch the version from version.h and push it to Lua
     // This will be something like "528-9629655" based on your uploaded file
@@ -238,8 +255,8 @@ gameStateManager::gameStateManager(QObject *parent)
     m_luaTimer = new QTimer(this);
     connect(m_luaTimer, &QTimer::timeout, this, &gameStateManager::onLuaTimerTick);
     
-    // Start the timer (10000 ms = 10 seconds)
-    m_luaTimer->start(10000); 
+    // Start the timer: script ticks every 100 ms, the heartbeat every LUA_HEARTBEAT_TICKS of them (10 seconds)
+    m_luaTimer->start(LUA_TICK_MS);
 
     // Inside gameStateManager constructor
     m_clientSocket = new QTcpSocket(this);
@@ -270,20 +287,26 @@ gameStateManager::gameStateManager(QObject *parent)
 
     m_autosaveTimer = new QTimer(this);
     connect(m_autosaveTimer, &QTimer::timeout, this, &gameStateManager::handleAutosave);
+    // The roster journal; the first run imports the existing per-character .txt files into it
+    m_roster = new CharacterJournal();
+    if (m_roster->open() && m_roster->count() == 0) {
+        const int imported = m_roster->importTextFiles("data/characters");
+        if (imported > 0) qDebug() << "Imported" << imported << "character files into the roster journal.";
+    }
+    m_autosaveWatcher = new QFutureWatcher<AutosaveResult>(this);
+    connect(m_autosaveWatcher, &QFutureWatcherBase::finished, this, &gameStateManager::onAutosaveFinished);
+    // Every state change goes out through gameValueChanged; autosave skips the write when none happened
+    connect(this, &gameStateManager::gameValueChanged, this, [this]() { markDirty(); });
     // Initialize party members
     initializeParty();
     initializeGameState();
     // You can also initialize a list for the whole party if needed
     initializeConfinementStock();
 
-    // Load monster data from LUA
-    loadGameResources();
-    // Load monster data from CSV at start
-    loadGameData("tools/gamedataconverter/data/MDATA1.js");
-    loadSpellData("tools/spellconverter/data/MDATA2.csv");
-    loadMonsterData("tools/monsterconverter/data/MDATA5.csv");
-    performSanityCheck();
-    loadItemData("tools/itemconverter/data/MDATA3.csv");
+    if (qEnvironmentVariableIsSet("BLACKLANDS_BENCH")) {
+        benchmarkStateAccess();
+        benchmarkSaveFormats();
+    }
     // Max ages for each race
     initializeRaceAges();
     // Initialize Guild Leaders (Hall of Records)
@@ -292,19 +315,119 @@ gameStateManager::gameStateManager(QObject *parent)
     m_raceDefinitions = loadRaceData();
     qDebug() << "Loaded" << m_raceDefinitions.size() << "race definitions.";
     qDebug() << "gameStateManager initialized.";
-    listGameData();
     m_autosaveTimer->start(30000);
 }
 
-void gameStateManager::loadGameData(const QString& filePath) {
-    QVariantMap root = loadRawJsonWithWrapper(filePath);
-    if (root.isEmpty()) return;
+void gameStateManager::loadStaticData() {
+    applyStaticData(readStaticData());
+}
+
+gameStateManager::StaticData gameStateManager::readStaticData() {
+    static const QString CACHE_PATH = "data/gamedata.cache";
+    static const QString MONSTER_LUA = "data/MonsterData.lua";
+    static const QString GAME_DATA = "tools/gamedataconverter/data/MDATA1.js";
+    static const QString SPELL_DATA = "tools/spellconverter/data/MDATA2.csv";
+    static const QString MONSTER_DATA = "tools/monsterconverter/data/MDATA5.csv";
+    static const QString ITEM_DATA = "tools/itemconverter/data/MDATA3.csv";
+    const QStringList sources = { MONSTER_LUA, GAME_DATA, SPELL_DATA, MONSTER_DATA, ITEM_DATA };
+
+    QElapsedTimer timer;
+    timer.start();
+    StaticData data;
+
+    // 1. Precompiled cache: valid only if no source file changed since it was written
+    GameDataCache cache;
+    if (cache.open(CACHE_PATH, sources)) {
+        data.gameData = cache.table("GameData").toVariantMaps();
+        data.spells = cache.table("Spells").toVariantMaps();
+        data.monsters = cache.table("Monsters").toVariantMaps();
+        data.items = cache.table("Items").toVariantMaps();
+        data.fromCache = true;
+        qInfo() << "Static data loaded from" << CACHE_PATH << "in" << timer.nsecsElapsed() / 1e6 << "ms";
+        return data;
+    }
+    qDebug() << "Game data cache not used:" << cache.errorString();
+
+    // 2. Text sources, one pool thread per file. The parsers only write to the list they return.
+    auto readCsv = [this](const QString& path) {
+        QList<QVariantMap> rows;
+        loadCSVData(path, rows);
+        return rows;
+    };
+    QFuture<QList<QVariantMap>> luaMonsters = QtConcurrent::run([this] {
+        return loadLuaList(MONSTER_LUA, "Monsters", "MonsterType");
+    });
+    QFuture<QList<QVariantMap>> gameData = QtConcurrent::run([this] {
+        return buildGameData(loadRawJsonWithWrapper(GAME_DATA));
+    });
+    QFuture<QList<QVariantMap>> spells = QtConcurrent::run(readCsv, SPELL_DATA);
+    QFuture<QList<QVariantMap>> monsters = QtConcurrent::run(readCsv, MONSTER_DATA);
+    QFuture<QList<QVariantMap>> items = QtConcurrent::run(readCsv, ITEM_DATA);
+
+    data.gameData = gameData.result();
+    data.spells = spells.result();
+    data.items = items.result();
+    // The CSV monsters replace the Lua ones, as they always have; Lua is the fallback
+    data.monsters = monsters.result();
+    if (data.monsters.isEmpty()) data.monsters = luaMonsters.result();
+    luaMonsters.waitForFinished();
+    qInfo() << "Static data parsed from text files in" << timer.nsecsElapsed() / 1e6 << "ms";
+
+    // 3. Rebuild the cache for the next start
+    QString error;
+    const QList<GameDataCache::TableSource> tables = {
+        { "GameData", &data.gameData },
+        { "Spells", &data.spells },
+        { "Monsters", &data.monsters },
+        { "Items", &data.items }
+    };
+    if (!GameDataCache::write(CACHE_PATH, sources, tables, &error)) {
+        qWarning() << "Could not write" << CACHE_PATH << ":" << error;
+    }
+    return data;
+}
+
+// Monster rows come from the MDATA5 CSV or the Lua fallback, which spell the
+// name column differently; everything else reads the lower-case "name"
+static void normaliseMonsterKeys(QList<QVariantMap>& monsters) {
+    for (QVariantMap& row : monsters) {
+        if (row.contains("name")) continue;
+        for (auto it = row.begin(); it != row.end(); ++it) {
+            if (it.key().compare("name", Qt::CaseInsensitive) == 0) {
+                const QVariant value = it.value();
+                row.erase(it);
+                row.insert("name", value);
+                break;
+            }
+        }
+    }
+}
+
+QVariantMap gameStateManager::findMonster(const QString& name) const {
+    for (const QVariantMap& row : m_monsterData) {
+        if (row.value("name").toString().compare(name, Qt::CaseInsensitive) == 0) return row;
+    }
+    return QVariantMap();
+}
 
-    m_gameData.clear();
+void gameStateManager::applyStaticData(StaticData data) {
+    m_gameData = std::move(data.gameData);
+    m_spellData = std::move(data.spells);
+    m_monsterData = std::move(data.monsters);
+    normaliseMonsterKeys(m_monsterData);
+    m_itemData = std::move(data.items);
+    setGameValue("ResourcesLoaded", true);
+    performSanityCheck();
+    listGameData();
+}
+
+QList<QVariantMap> gameStateManager::buildGameData(const QVariantMap& root) const {
+    QList<QVariantMap> gameData;
+    if (root.isEmpty()) return gameData;
 
     // 1. Handle Version info
     if (root.contains("GameVersion")) {
-        m_gameData.append({
+        gameData.append({
             {"DataType", "VersionInfo"},
             {"VersionValue", root["GameVersion"]}
         });
@@ -324,9 +447,17 @@ void gameStateManager::loadGameData(const QString& filePath) {
         for (const QVariant& item : list) {
             QVariantMap map = item.toMap();
             map["DataType"] = it.value(); // Apply the tag
-            m_gameData.append(map);
+            gameData.append(map);
         }
     }
+    return gameData;
+}
+
+void gameStateManager::loadGameData(const QString& filePath) {
+    QVariantMap root = loadRawJsonWithWrapper(filePath);
+    if (root.isEmpty()) return;
+
+    m_gameData = buildGameData(root);
 
     setGameValue("ResourcesLoaded", true);
     qDebug() << "Total Game Data Entries loaded:" << m_gameData.size();
@@ -334,6 +465,7 @@ void gameStateManager::loadGameData(const QString& filePath) {
 
 void gameStateManager::loadMonsterData(const QString& filePath) {
     loadCSVData(filePath, m_monsterData);
+    normaliseMonsterKeys(m_monsterData);
     // Optional: Keep your specific debug report for monsters here
     if (!m_monsterData.isEmpty()) {
         qDebug() << "First Monster:" << m_monsterData[0]["name"].toString();
@@ -361,6 +493,7 @@ void gameStateManager::logGuildAction(const QString& actionDescription)
     QString entry = QDateTime::currentDateTime().toString("HH:mm:ss") + " - " + actionDescription;
     logList.append(entry);
     m_gameStateData["GuildActionLog"] = logList;
+    markDirty();
 }
 
 void gameStateManager::printAllGameState() const
@@ -371,44 +504,79 @@ void gameStateManager::printAllGameState() const
         i.next();
         qDebug() << "Key:" << i.key() << " | Value:" << i.value();
     }
+    for (int k = 0; k < GameState::KEY_COUNT; ++k) {
+        auto key = static_cast<GameState::Key>(k);
+        qDebug() << "Key:" << GameStateStore::keyName(key) << " | Value:" << m_state.toVariant(key);
+    }
     qDebug() << "--- END OF GAME STATE DUMP ---";
 }
 
 void gameStateManager::setGameValue(const QString& key, const QVariant& value)
 {
+    // Hot keys are routed into the typed store; everything else stays in the map
+    GameState::Key typedKey;
+    if (GameStateStore::lookup(key, typedKey)) {
+        m_state.set(typedKey, value.toLongLong());
+        syncLegacyPartySlot(key, value);
+        emit gameValueChanged(key, value);
+        return;
+    }
+
     m_gameStateData[key] = value;
+    syncLegacyPartySlot(key, value);
+    emit gameValueChanged(key, value);
+}
+
+void gameStateManager::setStateValue(GameState::Key key, qint64 value)
+{
+    if (!m_state.set(key, value)) return; // Unchanged: no copy, no signal
 
+    const QString& name = GameStateStore::keyName(key);
+    if (key == GameState::Key::CurrentCharacterHP ||
+        key == GameState::Key::MaxCharacterHP ||
+        key == GameState::Key::CurrentCharacterLevel) {
+        syncLegacyPartySlot(name, value);
+    }
+    emit gameValueChanged(name, value);
+}
+
+void gameStateManager::syncLegacyPartySlot(const QString& key, const QVariant& value)
+{
     // If we update a specific "CurrentCharacter" key, we must update the Party[0] slot
-    if (key.startsWith("CurrentCharacter") || key == "isAlive" || key == "MaxCharacterHP") {
-        QVariantList partyList = m_gameStateData["Party"].toList();
-        if (!partyList.isEmpty()) {
-            QVariantMap character = partyList[0].toMap();
-            
-            if (key == "CurrentCharacterName") character["Name"] = value;
-            else if (key == "CurrentCharacterLevel") character["Level"] = value;
-            else if (key == "CurrentCharacterHP") character["HP"] = value;
-            else if (key == "MaxCharacterHP") character["MaxHP"] = value;
-            else if (key == "isAlive") character["isAlive"] = value.toInt();
-            
-            // Check for stats (CurrentCharacterStrength, etc)
-            QString statName = key;
-            statName.remove("CurrentCharacter");
-            if (GameConstants::STAT_NAMES.contains(statName)) {
-                character[statName] = value;
-            }
-            //if (statNames().contains(statName)) {
-            //    character[statName] = value;
-            //}
-            partyList[0] = character;
-            m_gameStateData["Party"] = partyList;
-        }
+    if (!key.startsWith("CurrentCharacter") && key != "isAlive" && key != "MaxCharacterHP") return;
+
+    // "Party" is normally the PartyManager map; only the old list layout needs patching.
+    // Checking the type first avoids copying the whole party on every HP change.
+    auto partyIt = m_gameStateData.find("Party");
+    if (partyIt == m_gameStateData.end() || partyIt->typeId() != QMetaType::QVariantList) return;
+
+    QVariantList partyList = partyIt->toList();
+    if (partyList.isEmpty()) return;
+
+    QVariantMap character = partyList[0].toMap();
+
+    if (key == "CurrentCharacterName") character["Name"] = value;
+    else if (key == "CurrentCharacterLevel") character["Level"] = value;
+    else if (key == "CurrentCharacterHP") character["HP"] = value;
+    else if (key == "MaxCharacterHP") character["MaxHP"] = value;
+    else if (key == "isAlive") character["isAlive"] = value.toInt();
+
+    // Check for stats (CurrentCharacterStrength, etc)
+    QString statName = key;
+    statName.remove("CurrentCharacter");
+    if (GameConstants::STAT_NAMES.contains(statName)) {
+        character[statName] = value;
     }
-    
-    emit gameValueChanged(key, value);
+    partyList[0] = character;
+    *partyIt = partyList;
 }
 
 QVariant gameStateManager::getGameValue(const QString& key) const
 {
+    GameState::Key typedKey;
+    if (GameStateStore::lookup(key, typedKey)) {
+        return m_state.toVariant(typedKey);
+    }
     return m_gameStateData.value(key);
 }
 
@@ -469,6 +637,13 @@ void gameStateManager::performSanityCheck()
     } else {
         qWarning() << "FAIL: 'hits' column is not a valid integer.";
     }
+    // Test Case: A monster looked up by name (as combat does) gets its CSV stats
+    QVariantMap orc = findMonster("orc");
+    if (orc.value("name").toString() == "Orc" && orc.value("hits").toInt() > 0 && orc.value("att").toInt() > 0) {
+        qDebug() << "PASS: 'orc' resolves to Orc (hits" << orc.value("hits").toInt() << ", att" << orc.value("att").toInt() << ")";
+    } else {
+        qWarning() << "FAIL: 'orc' did not resolve to the Orc row, got" << orc;
+    }
 }
 /*
 void gameStateManager::setBankInventory(const QStringList& items) 
@@ -582,22 +757,10 @@ void gameStateManager::updateCharacterGold(int characterIndex, qulonglong amount
 */
 bool gameStateManager::loadCharacterFromFile(const QString& filePath) {
     if (filePath.endsWith(".lua")) {
-        if (!m_L) return false;
-
-        // Execute the script to load 'SaveData' into the global Lua environment
-        if (luaL_dofile(m_L, filePath.toUtf8().constData()) != LUA_OK) {
-            qWarning() << "Lua Load Error:" << lua_tostring(m_L, -1);
-            lua_pop(m_L, 1);
-            return false;
-        }
-
         // IMPORTANT: Your adam.lua uses "SaveData", not "Character"
-        lua_getglobal(m_L, "SaveData"); 
-        
-        QVariantMap characterMap = luaToVariant(m_L, -1).toMap();
-        lua_pop(m_L, 1);
-
-        if (characterMap.isEmpty()) {
+        // The save runs in its own sandboxed environment and is read straight into the struct
+        Character newChar;
+        if (!LuaDataLoader::forThisThread().loadRecord(filePath, "SaveData", characterSaveSchema(), newChar)) {
             qWarning() << "Could not find 'SaveData' table in" << filePath;
             return false;
         }
@@ -606,14 +769,13 @@ bool gameStateManager::loadCharacterFromFile(const QString& filePath) {
         auto& members = m_partyManager->currentParty().members;
         members.clear();
         
-        Character newChar;
-        // This will now map "HP" -> hp, "Name" -> name, etc.
-        newChar.loadFromMap(characterMap);
         if (newChar.inventory.isEmpty()) {
                 newChar.inventory.append("Rations");
         }
         // Force status to normal if loading from a fresh save
         newChar.status = GameConstants::Normal;
+        // Back into the same dungeon; saves from before WorldSeed existed get the legacy one (0)
+        setStateValue(GameState::Key::WorldSeed, newChar.worldSeed);
         
         //m_currentParty.members.append(newChar);
         members.append(newChar);
@@ -783,6 +945,19 @@ bool gameStateManager::loadCharacterFromFile(const QString& characterName)
 
 
 bool gameStateManager::saveCharacterToFile(int partyIndex) 
+{
+    QString filename;
+    QByteArray text;
+    if (!characterFileText(partyIndex, filename, text)) return false;
+    // The journal is the crash-safe copy; the .txt stays as the per-character export
+    m_roster->put(QFileInfo(filename).completeBaseName(), CharacterJournal::parseText(text));
+    if (!SavegameUtils::writeFileAtomic(filename, text)) return false;
+    qDebug() << "Successfully saved character:" << QFileInfo(filename).completeBaseName();
+    return true;
+}
+
+// The .txt character file for a party slot, built in memory so it can be written anywhere (or on another thread)
+bool gameStateManager::characterFileText(int partyIndex, QString& filename, QByteArray& text)
 {
     QVariantList party = m_gameStateData["Party"].toList();
     if (partyIndex < 0 || partyIndex >= party.size()) return false;
@@ -796,16 +971,9 @@ bool gameStateManager::saveCharacterToFile(int partyIndex)
         return false;
     }
 
-    QDir dir;
-    if (!dir.exists("data/characters/")) {
-        dir.mkpath("data/characters/");
-    }
-
-    QString filename = QString("data/characters/%1.txt").arg(characterName);
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
-
-    QTextStream out(&file);
+    filename = QString("data/characters/%1.txt").arg(characterName);
+    text.clear();
+    QTextStream out(&text, QIODevice::WriteOnly);
     out << "CHARACTER_FILE_VERSION: 1.0\n";
     out << "Name: " << characterName << "\n";
     out << "Race: " << character["Race"].toString() << "\n"; // Updated
@@ -813,6 +981,7 @@ bool gameStateManager::saveCharacterToFile(int partyIndex)
     out << "DungeonX: " << getGameValue("DungeonX").toInt() << "\n";
     out << "DungeonY: " << getGameValue("DungeonY").toInt() << "\n";
     out << "DungeonLevel: " << getGameValue("DungeonLevel").toInt() << "\n";
+    out << "WorldSeed: " << worldSeed() << "\n";
     out << "Guild: " << character["Guild"].toString() << "\n";
     out << "Level: " << character["Level"].toInt() << "\n";
     out << "HP: " << character["HP"].toInt() << "\n";
@@ -832,8 +1001,7 @@ bool gameStateManager::saveCharacterToFile(int partyIndex)
     // Save Inventory as a comma-separated list
     QStringList inv = character["Inventory"].toStringList();
     out << "Inventory: " << inv.join(",") << "\n";
-    file.close();
-    qDebug() << "Successfully saved character:" << characterName;
+    out.flush();
     return true;
 }
 // Example of how to correctly update HP in the Game State
@@ -945,27 +1113,68 @@ void gameStateManager::stopAutosave() {
 }
 
 void gameStateManager::handleAutosave() {
-    qDebug() << "Triggering periodic autosave...";
-    saveFullGameState("autosave");
+    // 1. Nothing to do if no state changed since the last save, or that save is still being written
+    if (m_stateRevision == m_savedRevision) {
+        qDebug() << "Autosave skipped: no changes since the last save.";
+        return;
+    }
+    if (m_autosaveWatcher->isRunning()) {
+        qDebug() << "Autosave skipped: the previous autosave is still writing.";
+        return;
+    }
 
-    // Check if a character is actually loaded before saving
+    // 2. Snapshot on the GUI thread: sync the live objects into the map and copy it
+    QElapsedTimer timer;
+    timer.start();
+    AutosaveJob job;
+    job.revision = m_stateRevision;
+    job.save = snapshotForSaving();
+
+    // Check if a character is actually loaded before saving Party Slot 0 (the active player) to its .txt file
     QString currentHero = getGameValue("CurrentCharacterName").toString();
-    if (currentHero.isEmpty() || currentHero == "Empty Slot") {
-        return; 
+    if (!currentHero.isEmpty() && currentHero != "Empty Slot") {
+        if (!characterFileText(0, job.characterPath, job.characterText)) {
+            qWarning() << "Autosave: could not snapshot character" << currentHero;
+        } else {
+            // One appended record; the roster is GUI-thread only, so it isn't left to the worker
+            m_roster->put(QFileInfo(job.characterPath).completeBaseName(), CharacterJournal::parseText(job.characterText));
+        }
     }
+    qDebug() << "Autosave snapshot took" << timer.nsecsElapsed() / 1000 << "us";
 
-    qDebug() << "Autosaving character:" << currentHero;
-    
-    // 1. Sync the live UI/Game values to the Party structure first
-    refreshUI();
-    //syncActiveCharacterToParty();
-    
-    // 2. Save Party Slot 0 (the active player) to the .txt file
-    if (saveCharacterToFile(0)) {
-        qDebug() << "Autosave successful.";
-    } else {
+    // 3. Serialize and write on a worker thread; onAutosaveFinished() logs the result
+    m_autosaveWatcher->setFuture(QtConcurrent::run(&gameStateManager::writeAutosave, job));
+}
+
+// Runs on a QtConcurrent worker: touches only the job, never the manager
+gameStateManager::AutosaveResult gameStateManager::writeAutosave(const AutosaveJob& job) {
+    AutosaveResult result;
+    result.revision = job.revision;
+
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray save = encodeBinarySave(job.save);
+    result.serializeNs = timer.nsecsElapsed();
+
+    timer.restart();
+    result.ok = SavegameUtils::writeFileAtomic("data/saves/autosave.sav", save);
+    if (result.ok && !job.characterPath.isEmpty()) {
+        result.ok = SavegameUtils::writeFileAtomic(job.characterPath, job.characterText);
+    }
+    result.writeNs = timer.nsecsElapsed();
+    result.bytes = save.size() + job.characterText.size();
+    return result;
+}
+
+void gameStateManager::onAutosaveFinished() {
+    const AutosaveResult result = m_autosaveWatcher->result();
+    if (!result.ok) {
         qWarning() << "Autosave failed!";
+        return; // Still dirty, so the next tick tries again
     }
+    m_savedRevision = result.revision;
+    qDebug() << "Autosave successful:" << result.bytes << "bytes, serialize"
+             << result.serializeNs / 1000 << "us, write" << result.writeNs / 1000 << "us (worker thread)";
 }
 
 // 1. Static helper for the raw data
@@ -1448,74 +1657,10 @@ QVariantMap gameStateManager::loadRawJsonWithWrapper(const QString& filePath) {
     return doc.object().toVariantMap();
 }
 
-QVariant gameStateManager::luaToVariant(lua_State* L, int index) {
-    int type = lua_type(L, index);
-    
-    switch (type) {
-        case LUA_TNUMBER:
-            return lua_tonumber(L, index);
-        case LUA_TSTRING:
-            return QString::fromUtf8(lua_tostring(L, index));
-        case LUA_TBOOLEAN:
-            return (bool)lua_toboolean(L, index);
-        case LUA_TTABLE: {
-            QVariantMap map;
-            QVariantList list;
-            bool isArray = true;
-            int n = 0;
-
-            lua_pushnil(L); // Start iteration
-            while (lua_next(L, index < 0 ? index - 1 : index) != 0) {
-                // Determine if this looks like an array (numeric keys 1, 2, 3...)
-                if (isArray) {
-                    if (lua_type(L, -2) == LUA_TNUMBER) {
-                        n++;
-                        if (lua_tonumber(L, -2) != n) isArray = false;
-                    } else {
-                        isArray = false;
-                    }
-                }
-                
-                QVariant val = luaToVariant(L, -1);
-                if (!isArray) {
-                    QString key = QString::fromUtf8(lua_tostring(L, -2));
-                    map[key] = val;
-                } else {
-                    list.append(val);
-                }
-                lua_pop(L, 1); // Remove value, keep key for next iteration
-            }
-            return isArray ? QVariant(list) : QVariant(map);
-        }
-        default:
-            return QVariant();
-    }
-}
-
 QVariantMap gameStateManager::loadLuaTable(const QString& filePath, const QString& tableName) {
-    qDebug() << "Attempting to load Lua from:" << QDir::current().absoluteFilePath(filePath);
-
-    lua_State* L = luaL_newstate();
-    luaL_openlibs(L);
-
-    if (luaL_dofile(L, filePath.toUtf8().constData()) != LUA_OK) {
-        qWarning() << "LUA ERROR (File):" << lua_tostring(L, -1);
-        lua_close(L);
-        return QVariantMap();
-    }
-
-    lua_getglobal(L, tableName.toUtf8().constData());
-    
-    // Safety check: Is it actually a table?
-    if (!lua_istable(L, -1)) {
-        qWarning() << "LUA ERROR: Table" << tableName << "not found in" << filePath;
-        lua_close(L);
-        return QVariantMap();
-    }
-
-    // Convert the Lua table to a QVariant (This will be a QVariantList for your Monsters)
-    QVariant result = luaToVariant(L, -1);
-    lua_close(L);
+    // One VM per thread, each file in its own environment (see LuaDataLoader)
+    QVariant result = LuaDataLoader::forThisThread().loadVariant(filePath, tableName.toUtf8().constData());
+    if (!result.isValid()) return QVariantMap();
 
     // This ensures that back in loadGameResources, monsterData["Monsters"] exists.
     QVariantMap finalMap;
@@ -1523,6 +1668,36 @@ QVariantMap gameStateManager::loadLuaTable(const QString& filePath, const QStrin
     return finalMap;
 }
 
+QList<QVariantMap> gameStateManager::loadLuaList(const QString& filePath, const QString& tableName, const QString& tag) {
+    QList<QVariantMap> rows;
+    LuaDataLoader& loader = LuaDataLoader::forThisThread();
+
+    // Monsters are read straight into MonsterRecord; other tables still go through QVariant
+    if (tag == "MonsterType") {
+        const QList<MonsterRecord> monsters = loader.loadList(filePath, tableName.toUtf8().constData(), MonsterRecord::schema());
+        rows.reserve(monsters.size());
+        for (const MonsterRecord& monster : monsters) {
+            QVariantMap m = monster.toVariantMap();
+            m["DataType"] = tag; // Tag it so the engine knows what it is
+            rows.append(m);
+        }
+    } else {
+        const QVariantList rawList = loader.loadVariant(filePath, tableName.toUtf8().constData()).toList();
+        for (const QVariant& item : rawList) {
+            QVariantMap m = item.toMap();
+            m["DataType"] = tag; // Tag it so the engine knows what it is
+            rows.append(m);
+        }
+    }
+
+    if (!rows.isEmpty()) {
+        qDebug() << "Loaded" << rows.size() << tag << "entries.";
+    } else {
+        qWarning() << "Failed to load" << tag << "from" << filePath;
+    }
+    return rows;
+}
+
 void gameStateManager::loadGameResources() {
     qDebug() << "--- Global Resource Load Started ---";
     // Define what we want to load: { "Lua_File_Path", "Table_Name", "DataType_Tag", "Target_List_Pointer" }
@@ -1540,21 +1715,8 @@ void gameStateManager::loadGameResources() {
     };
 
     for (const auto& job : jobs) {
-        QVariantMap data = loadLuaTable(job.path, job.table);
-        
-        if (data.contains(job.table)) {
-            job.target->clear();
-            QVariantList rawList = data[job.table].toList();
-
-            for (const QVariant& item : rawList) {
-                QVariantMap m = item.toMap();
-                m["DataType"] = job.tag; // Tag it so the engine knows what it is
-                job.target->append(m);
-            }
-            qDebug() << "Loaded" << job.target->size() << job.tag << "entries.";
-        } else {
-            qWarning() << "Failed to load" << job.tag << "from" << job.path;
-        }
+        QList<QVariantMap> rows = loadLuaList(job.path, job.table, job.tag);
+        if (!rows.isEmpty()) *job.target = rows;
     }
 
     setGameValue("ResourcesLoaded", true);
@@ -1564,6 +1726,7 @@ void gameStateManager::loadGameResources() {
 void gameStateManager::saveCharacterToLua(const Character& c, const QString& filePath) {
     // Use the existing toMap() helper from your character.h
     QVariantMap data = c.toMap();
+    data["WorldSeed"] = worldSeed(); // The party's current dungeon, not whatever the struct was loaded with
     
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
@@ -1640,17 +1803,18 @@ Character gameStateManager::loadCharacterFromLua(const QString& filePath) {
 }
 
 void gameStateManager::onLuaTimerTick() {
+    // 1. Wake the scripts whose wait(n) has run out
+    m_scheduler->tick();
+    if (++m_luaTicks % LUA_HEARTBEAT_TICKS != 0) return;
 
     if (!hasLivingCharacters()) {
         qDebug() << "Timer Tick: No living characters found. Skipping logic.";
         return; 
     }
-    // 1. Run your existing local heartbeat script
-    if (luaL_dofile(m_L, "data/scripts/heartbeat.lua") != LUA_OK) {
-        qWarning() << "LUA ERROR:" << lua_tostring(m_L, -1);
-    }
+    // 2. Run your existing local heartbeat script (compiled once, reloaded when the file changes)
+    m_scripts->run("data/scripts/heartbeat.lua");
 
-    // 2. Send a "Tick" message to the Lua Server
+    // 3. Send a "Tick" message to the Lua Server
     if (m_clientSocket->state() == QAbstractSocket::ConnectedState) {
         m_tickCounter++;
         
@@ -1674,7 +1838,8 @@ void gameStateManager::onServerDataReceived() {
 
         // Pass the server message into your Lua engine!
         // This allows the server to remotely run Lua code in your game.
-        if (luaL_dostring(m_L, data.constData()) != LUA_OK) {
+        // Repeated lines reuse the chunk compiled the first time
+        if (!m_scripts->runChunk(data, "=server", true)) {
              // If it wasn't valid Lua, just log it
              qDebug() << "Server said (non-Lua):" << message;
         }
@@ -1748,12 +1913,8 @@ QString gameStateManager::getLuaString(const QString& variableName) {
 bool gameStateManager::loadLuaScript(const QString& filePath) {
     if (!m_L) return false;
 
-    if (luaL_dofile(m_L, filePath.toUtf8().constData()) != LUA_OK) {
-        qWarning() << "Lua Error:" << lua_tostring(m_L, -1);
-        lua_pop(m_L, 1); // Remove error message
-        return false;
-    }
-    
+    if (!m_scripts->run(filePath)) return false;
+
     qDebug() << "Successfully loaded Lua script:" << filePath;
     return true;
 }
@@ -2019,30 +2180,44 @@ bool gameStateManager::saveFullGameState(const QString& saveName) {
     // 2. Prepare the data (Sync live objects to the map)
     packStateForSaving();
 
-    // 3. Create the file
+    // 3. Convert the QVariantMap to JSON and write it atomically (temp file + rename)
     QString filePath = QString("data/saves/%1.json").arg(saveName);
-    QFile file(filePath);
-    
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to create save file:" << filePath;
+    QJsonDocument doc = QJsonDocument::fromVariant(m_gameStateData);
+    if (!SavegameUtils::writeFileAtomic(filePath, doc.toJson())) {
         return false;
     }
 
-    // 4. Convert the QVariantMap to JSON and write
-    QJsonDocument doc = QJsonDocument::fromVariant(m_gameStateData);
-    file.write(doc.toJson());
-    file.close();
-
     qDebug() << "Full game state saved to:" << filePath;
     return true;
 }
 
 bool gameStateManager::loadFullGameState(const QString& saveName) {
+    // The binary save is what autosave writes; the JSON is the older format / debug export
+    if (QFile::exists("data/saves/" + saveName + ".sav") && loadBinaryGameState(saveName)) {
+        return true;
+    }
+
     QFile file("data/saves/" + saveName + ".json");
     if (!file.open(QIODevice::ReadOnly)) return false;
 
     QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
     m_gameStateData = doc.toVariant().toMap();
+    applyLoadedState();
+    return true;
+}
+
+// Shared tail of the JSON and binary loaders, once m_gameStateData holds the saved map
+void gameStateManager::applyLoadedState() {
+    // Move the hot keys out of the map into the typed store
+    m_state.clear();
+    for (int k = 0; k < GameState::KEY_COUNT; ++k) {
+        auto key = static_cast<GameState::Key>(k);
+        auto it = m_gameStateData.find(GameStateStore::keyName(key));
+        if (it != m_gameStateData.end()) {
+            m_state.set(key, it->toLongLong());
+            m_gameStateData.erase(it);
+        }
+    }
 
     // Reconstruct the C++ Party object from the saved map
     if (m_gameStateData.contains("Party")) {
@@ -2051,6 +2226,179 @@ bool gameStateManager::loadFullGameState(const QString& saveName) {
 
     unpackStateAfterLoading();
     refreshUI();
+}
+
+//----------------------------------------------------------------------
+// Binary saves
+//----------------------------------------------------------------------
+
+// Section ids and the schema version this build writes for each
+static const quint32 SECTION_PARTY = SaveContainer::tag("PRTY");       // QVariantMap: Party::toMap()
+static const quint32 SECTION_WORLD = SaveContainer::tag("WRLD");       // QVariantMap: the rest of m_gameStateData
+static const quint32 SECTION_CONFINEMENT = SaveContainer::tag("CONF"); // QMap<QString, int>
+static const quint32 SECTION_ITEMS = SaveContainer::tag("ITEM");       // count, then level, x, y, name
+static const quint32 SECTION_EXPLORED = SaveContainer::tag("EXPL");    // count, then level, QBitArray
+static const quint32 SECTION_VERSION = 1;
+
+template <typename Fn>
+static QByteArray streamSection(Fn fn) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out.setByteOrder(QDataStream::LittleEndian);
+    fn(out);
+    return data;
+}
+
+template <typename Fn>
+static bool readSection(SaveContainer& container, quint32 id, Fn fn) {
+    if (!container.contains(id)) return true; // Older save without it: keep the defaults
+    if (container.version(id) > SECTION_VERSION) {
+        qWarning() << "Save section" << SaveContainer::tagName(id) << "is from a newer version, skipping it.";
+        return true;
+    }
+    QByteArray data;
+    if (!container.read(id, data)) return false;
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+    in.setByteOrder(QDataStream::LittleEndian);
+    fn(in);
+    return in.status() == QDataStream::Ok;
+}
+
+void gameStateManager::setExploredTiles(int level, const QBitArray& tiles) {
+    m_exploredTiles[level] = tiles;
+    markDirty();
+}
+
+gameStateManager::SaveSnapshot gameStateManager::snapshotForSaving() {
+    packStateForSaving();
+    return { m_gameStateData, m_placedItems, m_exploredTiles };
+}
+
+QByteArray gameStateManager::encodeBinarySave(const SaveSnapshot& snapshot) {
+    QVariantMap world = snapshot.state;
+    const QVariantMap party = world.take("Party").toMap();
+    const QMap<QString, int> confinement = world.take("confinementStock").value<QMap<QString, int>>();
+
+    QList<SaveContainer::Section> sections;
+    sections.append({ SECTION_PARTY, SECTION_VERSION, streamSection([&](QDataStream& out) { out << party; }) });
+    sections.append({ SECTION_WORLD, SECTION_VERSION, streamSection([&](QDataStream& out) { out << world; }) });
+    sections.append({ SECTION_CONFINEMENT, SECTION_VERSION, streamSection([&](QDataStream& out) { out << confinement; }) });
+    sections.append({ SECTION_ITEMS, SECTION_VERSION, streamSection([&](QDataStream& out) {
+        out << quint32(snapshot.placedItems.size());
+        for (const PlacedItem& item : snapshot.placedItems) {
+            out << qint32(item.level) << qint32(item.x) << qint32(item.y) << item.itemName;
+        }
+    }) });
+    sections.append({ SECTION_EXPLORED, SECTION_VERSION, streamSection([&](QDataStream& out) {
+        out << quint32(snapshot.exploredTiles.size());
+        for (auto it = snapshot.exploredTiles.cbegin(); it != snapshot.exploredTiles.cend(); ++it) {
+            out << qint32(it.key()) << it.value();
+        }
+    }) });
+    return SaveContainer::serialize(sections);
+}
+
+bool gameStateManager::decodeBinarySave(const QString& path, SaveSnapshot& snapshot) {
+    SaveContainer container;
+    if (!container.open(path)) {
+        qWarning() << "Could not open binary save" << path << ":" << container.errorString();
+        return false;
+    }
+
+    // Sections are read by id; ids this build doesn't know are never touched
+    QVariantMap party;
+    QMap<QString, int> confinement;
+    const bool ok =
+        readSection(container, SECTION_WORLD, [&](QDataStream& in) { in >> snapshot.state; }) &&
+        readSection(container, SECTION_PARTY, [&](QDataStream& in) { in >> party; }) &&
+        readSection(container, SECTION_CONFINEMENT, [&](QDataStream& in) { in >> confinement; }) &&
+        readSection(container, SECTION_ITEMS, [&](QDataStream& in) {
+            quint32 count = 0;
+            in >> count;
+            for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                qint32 level = 0, x = 0, y = 0;
+                QString name;
+                in >> level >> x >> y >> name;
+                snapshot.placedItems.append({ level, x, y, name });
+            }
+        }) &&
+        readSection(container, SECTION_EXPLORED, [&](QDataStream& in) {
+            quint32 count = 0;
+            in >> count;
+            for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                qint32 level = 0;
+                QBitArray tiles;
+                in >> level >> tiles;
+                snapshot.exploredTiles.insert(level, tiles);
+            }
+        });
+    if (!ok) {
+        qWarning() << "Binary save" << path << "is damaged:" << container.errorString();
+        return false;
+    }
+    if (!party.isEmpty()) snapshot.state["Party"] = party;
+    snapshot.state["confinementStock"] = QVariant::fromValue(confinement);
+    return true;
+}
+
+bool gameStateManager::saveBinaryGameState(const QString& saveName) {
+    const QString filePath = QString("data/saves/%1.sav").arg(saveName);
+    if (!SavegameUtils::writeFileAtomic(filePath, encodeBinarySave(snapshotForSaving()))) {
+        return false;
+    }
+    qDebug() << "Full game state saved to:" << filePath;
+    return true;
+}
+
+bool gameStateManager::loadBinaryGameState(const QString& saveName) {
+    SaveSnapshot snapshot;
+    if (!decodeBinarySave(QString("data/saves/%1.sav").arg(saveName), snapshot)) return false;
+
+    m_confinementStock = snapshot.state.value("confinementStock").value<QMap<QString, int>>();
+    m_placedItems = snapshot.placedItems;
+    m_exploredTiles = snapshot.exploredTiles;
+    m_gameStateData = snapshot.state;
+    applyLoadedState();
+    return true;
+}
+
+// The save as one JSON-friendly map: the state plus the placed items and explored tiles
+QVariantMap gameStateManager::snapshotToVariant(const SaveSnapshot& snapshot) {
+    QVariantMap map = snapshot.state;
+
+    QVariantMap confinement;
+    const QMap<QString, int> stock = map.value("confinementStock").value<QMap<QString, int>>();
+    for (auto it = stock.cbegin(); it != stock.cend(); ++it) confinement[it.key()] = it.value();
+    map["confinementStock"] = confinement;
+
+    QVariantList items;
+    for (const PlacedItem& item : snapshot.placedItems) {
+        items.append(QVariantMap{ { "level", item.level }, { "x", item.x }, { "y", item.y }, { "itemName", item.itemName } });
+    }
+    map["placedItems"] = items;
+
+    QVariantMap explored;
+    for (auto it = snapshot.exploredTiles.cbegin(); it != snapshot.exploredTiles.cend(); ++it) {
+        QString bits(it.value().size(), '0');
+        for (qsizetype i = 0; i < it.value().size(); ++i) {
+            if (it.value().testBit(i)) bits[i] = '1';
+        }
+        explored[QString::number(it.key())] = bits;
+    }
+    map["exploredTiles"] = explored;
+    return map;
+}
+
+bool gameStateManager::exportBinarySaveToJson(const QString& saveName) {
+    SaveSnapshot snapshot;
+    if (!decodeBinarySave(QString("data/saves/%1.sav").arg(saveName), snapshot)) return false;
+
+    const QString filePath = QString("data/saves/%1.export.json").arg(saveName);
+    const QJsonDocument doc = QJsonDocument::fromVariant(snapshotToVariant(snapshot));
+    if (!SavegameUtils::writeFileAtomic(filePath, doc.toJson())) return false;
+    qDebug() << "Exported" << saveName << "to" << filePath;
     return true;
 }
 
@@ -2067,6 +2415,14 @@ void gameStateManager::packStateForSaving() {
     m_gameStateData["confinementStock"] = QVariant::fromValue(m_confinementStock);
     //m_gameStateData["bank"] = getBankInventory();
     m_gameStateData["lastSaved"] = QDateTime::currentDateTime().toString();
+
+    // 3. Flatten the typed store back into string keys so the save format is unchanged
+    for (int k = 0; k < GameState::KEY_COUNT; ++k) {
+        auto key = static_cast<GameState::Key>(k);
+        if (m_state.isAssigned(key)) {
+            m_gameStateData[GameStateStore::keyName(key)] = m_state.value(key);
+        }
+    }
 }
 
 // Distributes data from the master map back into live objects after a load
@@ -2153,5 +2509,148 @@ bool gameStateManager::spendPartyGold(int amount) {
 }
 
 gameStateManager::~gameStateManager() {
+    if (m_autosaveWatcher) m_autosaveWatcher->waitForFinished(); // Don't leave a half-finished autosave behind
+    delete m_roster;
+    delete m_scheduler;
+    delete m_scripts; // Releases its registry references, so before lua_close
     if (m_L) lua_close(m_L);
 }
+
+// Measures the per-move cost of the state traffic in DungeonDialog::movePlayer on this
+// manager: three position reads and two position writes, once through the string shim
+// (getGameValue/setGameValue, what movePlayer used to call) and once through the typed
+// accessors (dungeonX()/setDungeonPosition(), what it calls now). Both paths emit
+// gameValueChanged to everything connected, like a real step. An HP change is timed the
+// same way, as that is a key the shim also patches into the Party.
+// The state is put back afterwards. Run with BLACKLANDS_BENCH=1 to print the numbers at startup.
+void gameStateManager::benchmarkStateAccess(int iterations)
+{
+    if (iterations <= 0) return;
+    using GameState::Key;
+    const GameStateStore savedState = m_state;
+    const QVariant savedParty = m_gameStateData.value("Party");
+    const quint64 savedRevision = m_stateRevision;
+    setDungeonPosition(10, 10);
+    setStateValue(Key::DungeonLevel, 1);
+    setStateValue(Key::CurrentCharacterHP, 10);
+
+    // 1. A step through the string shim
+    qint64 checksum = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        int x = getGameValue("DungeonX").toInt();
+        int y = getGameValue("DungeonY").toInt();
+        int level = getGameValue("DungeonLevel").toInt();
+        setGameValue("DungeonX", (x + 1) % 30);
+        setGameValue("DungeonY", (y + 1) % 30);
+        checksum += level;
+    }
+    const qint64 shimMoveNs = timer.nsecsElapsed();
+
+    // 2. The same step through the typed accessors
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        int x = dungeonX();
+        int y = dungeonY();
+        int level = dungeonLevel();
+        setDungeonPosition((x + 1) % 30, (y + 1) % 30);
+        checksum += level;
+    }
+    const qint64 typedMoveNs = timer.nsecsElapsed();
+
+    // 3. An HP change (trap, fight), both ways
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        setGameValue("CurrentCharacterHP", getGameValue("CurrentCharacterHP").toInt() % 20 + 1);
+    }
+    const qint64 shimHpNs = timer.nsecsElapsed();
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        setStateValue(Key::CurrentCharacterHP, getStateValue(Key::CurrentCharacterHP) % 20 + 1);
+    }
+    const qint64 typedHpNs = timer.nsecsElapsed();
+    checksum += getStateValue(Key::CurrentCharacterHP);
+
+    // 4. Back to how it was, and tell the listeners about the real values again
+    m_state = savedState;
+    if (savedParty.isValid()) m_gameStateData["Party"] = savedParty;
+    for (Key key : { Key::DungeonX, Key::DungeonY, Key::DungeonLevel, Key::CurrentCharacterHP }) {
+        if (m_state.isAssigned(key)) emit gameValueChanged(GameStateStore::keyName(key), m_state.toVariant(key));
+    }
+    m_stateRevision = savedRevision;
+
+    qDebug() << "--- STATE ACCESS BENCHMARK ---" << iterations << "iterations, signals included";
+    qDebug() << "  Move, string shim:" << double(shimMoveNs) / iterations << "ns";
+    qDebug() << "  Move, typed:      " << double(typedMoveNs) / iterations << "ns"
+             << "(" << (typedMoveNs > 0 ? double(shimMoveNs) / typedMoveNs : 0.0) << "x )";
+    qDebug() << "  HP, string shim:  " << double(shimHpNs) / iterations << "ns";
+    qDebug() << "  HP, typed:        " << double(typedHpNs) / iterations << "ns"
+             << "(" << (typedHpNs > 0 ? double(shimHpNs) / typedHpNs : 0.0) << "x )"
+             << "(checksum" << checksum << ")";
+}
+
+// Saves and reloads the current state 'iterations' times as indented JSON
+// (what saveFullGameState writes) and as a binary container, then compares
+// time and size. Works on scratch files in data/saves/ and removes them.
+// Run with BLACKLANDS_BENCH=1 to print the numbers at startup.
+void gameStateManager::benchmarkSaveFormats(int iterations)
+{
+    if (iterations <= 0) return;
+    const QString jsonPath = "data/saves/bench_format.json";
+    const QString binaryPath = "data/saves/bench_format.sav";
+
+    // A few explored levels, so the binary save carries what a real one would
+    SaveSnapshot snapshot = snapshotForSaving();
+    for (int level = 1; level <= 5; ++level) {
+        QBitArray tiles(30 * 30);
+        for (int i = 0; i < tiles.size(); i += level + 1) tiles.setBit(i);
+        snapshot.exploredTiles.insert(level, tiles);
+    }
+
+    // 1. JSON: serialize + write, then read + parse
+    qint64 jsonSize = 0, checksum = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        const QByteArray json = QJsonDocument::fromVariant(snapshotToVariant(snapshot)).toJson();
+        SavegameUtils::writeFileAtomic(jsonPath, json);
+        jsonSize = json.size();
+    }
+    const qint64 jsonSaveNs = timer.nsecsElapsed();
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        QFile file(jsonPath);
+        if (!file.open(QIODevice::ReadOnly)) break;
+        checksum += QJsonDocument::fromJson(file.readAll()).toVariant().toMap().size();
+    }
+    const qint64 jsonLoadNs = timer.nsecsElapsed();
+
+    // 2. Binary container: encode + write, then open + read every section
+    qint64 binarySize = 0;
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        const QByteArray save = encodeBinarySave(snapshot);
+        SavegameUtils::writeFileAtomic(binaryPath, save);
+        binarySize = save.size();
+    }
+    const qint64 binarySaveNs = timer.nsecsElapsed();
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        SaveSnapshot loaded;
+        if (!decodeBinarySave(binaryPath, loaded)) break;
+        checksum += loaded.state.size();
+    }
+    const qint64 binaryLoadNs = timer.nsecsElapsed();
+
+    QFile::remove(jsonPath);
+    QFile::remove(binaryPath);
+
+    qDebug() << "--- SAVE FORMAT BENCHMARK ---" << iterations << "saves and loads";
+    qDebug() << "  JSON:  " << jsonSize << "bytes, save" << double(jsonSaveNs) / iterations / 1000
+             << "us, load" << double(jsonLoadNs) / iterations / 1000 << "us";
+    qDebug() << "  Binary:" << binarySize << "bytes, save" << double(binarySaveNs) / iterations / 1000
+             << "us, load" << double(binaryLoadNs) / iterations / 1000 << "us";
+    qDebug() << "  Size ratio:" << (binarySize > 0 ? double(jsonSize) / binarySize : 0.0) << "x"
+             << "(checksum" << checksum << ")";
+}
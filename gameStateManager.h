@@ -10,6 +10,10 @@ extern "C" {
 // Project Includes
 #include "src/core/GameConstants.h"
 #include "src/core/game_resources.h"
+#include "src/core/LuaScriptCache.h"
+#include "src/scripting/ScriptScheduler.h"
+#include "src/core/GameStateStore.h"
+#include "src/core/CharacterJournal.h"
 #include "dataRegistry.h"
 #include "audioManager.h"
 #include "fontManager.h"
@@ -28,6 +32,8 @@ extern "C" {
 #include <QVariantMap>
 #include <QPoint>
 #include <QTimer>
+#include <QFutureWatcher>
+#include <QBitArray>
 #include <QDebug>
 
 // Qt GUI & Widgets
@@ -69,10 +75,12 @@ private:
     int m_tickCounter = 0;
 
     lua_State* m_L;
+    LuaScriptCache* m_scripts = nullptr; // Compiled scripts, run with lua_pcall
+    ScriptScheduler* m_scheduler = nullptr; // Coroutine scripts, resumed from onLuaTimerTick
     QTimer* m_luaTimer;
-
-    // The recursive engine that converts Lua data types to Qt data types
-    QVariant luaToVariant(lua_State* L, int index);
+    int m_luaTicks = 0;
+    static constexpr int LUA_TICK_MS = 100;          // One ScriptScheduler tick, i.e. wait(1)
+    static constexpr int LUA_HEARTBEAT_TICKS = 100;  // heartbeat.lua every 10 seconds, as before
 
     // The main public/internal call to get data from a Lua file
     QVariantMap loadLuaTable(const QString& filePath, const QString& tableName);
@@ -80,6 +88,8 @@ private:
 
     QVariantMap loadRawJsonWithWrapper(const QString& filePath);
     void loadCSVData(const QString& filePath, QList<QVariantMap>& targetList);
+    QList<QVariantMap> loadLuaList(const QString& filePath, const QString& tableName, const QString& tag);
+    QList<QVariantMap> buildGameData(const QVariantMap& root) const;
     //Helper functions
     void initializeGuildLeaders();
     void initializeRaceAges();
@@ -97,6 +107,8 @@ private:
     QVariantMap findRaceMap(const QString& raceName) const;
     GameConstants::RaceStats createRaceFromVariant(const QVariant& data) const;
     QString statusKey(GameConstants::EntityStatus effect) const;
+    // Patches Party slot 0 for legacy "CurrentCharacter*" keys (only when Party is still a list)
+    void syncLegacyPartySlot(const QString& key, const QVariant& value);
 
 public:
 
@@ -118,8 +130,29 @@ public:
 
     bool saveFullGameState(const QString& saveName);
     bool loadFullGameState(const QString& saveName);
+    // Binary container (data/saves/<name>.sav); loadFullGameState() prefers it over the JSON
+    bool saveBinaryGameState(const QString& saveName);
+    bool loadBinaryGameState(const QString& saveName);
+    // Debugging aid: writes data/saves/<name>.sav out as readable JSON next to it
+    bool exportBinarySaveToJson(const QString& saveName);
     void checkSettingsFile();
     void initializeResources();
+
+    // Game data, spells, items and monsters, as read by readStaticData()
+    struct StaticData {
+        QList<QVariantMap> gameData;
+        QList<QVariantMap> spells;
+        QList<QVariantMap> monsters;
+        QList<QVariantMap> items;
+        bool fromCache = false;
+    };
+    // From data/gamedata.cache when it is current, otherwise from the text files
+    // (parsed in parallel, and the cache is rebuilt). Touches no members, so
+    // LoadingScreen runs it on a worker thread.
+    StaticData readStaticData();
+    // Installs what readStaticData() returned. GUI thread only.
+    void applyStaticData(StaticData data);
+    void loadStaticData();
     QPixmap getFontSpriteSheet() const { return m_fontSpriteSheet; }
 
     void addItemToInventory(const QString& itemName);
@@ -154,6 +187,10 @@ public:
     bool loadPartyFromFile(const QString& filePath);
     void addCharacterToParty(const Character& character);
     bool loadLuaScript(const QString& filePath);
+    lua_State* luaState() const { return m_L; }
+    // Every saved character (data/characters/roster.journal), indexed in memory
+    CharacterJournal* roster() const { return m_roster; }
+    ScriptScheduler* scheduler() const { return m_scheduler; }
     QString getLuaString(const QString& variableName);
     void saveCharacterToLua(const Character& character, const QString& filePath);
     Character loadCharacterFromLua(const QString& filePath);
@@ -204,8 +241,12 @@ public:
     };
     void addPlacedItem(int level, int x, int y, const QString& name) {
         m_placedItems.append({level, x, y, name});
+        markDirty();
     }
     QList<PlacedItem> getPlacedItems() const { return m_placedItems; }
+    // Explored tiles of a dungeon level (WIDTH x HEIGHT bits, row-major), kept between visits and saved
+    void setExploredTiles(int level, const QBitArray& tiles);
+    QBitArray exploredTiles(int level) const { return m_exploredTiles.value(level); }
     QVector<GameConstants::RaceStats> m_raceDefinitions;
     // --- Character Management ---
     void setCharacterGold(int index, qulonglong newGold);
@@ -244,6 +285,8 @@ public:
     QVariantMap getMonster(int index) const {
         return (index >= 0 && index < m_monsterData.size()) ? m_monsterData[index] : QVariantMap();
     }
+    // Case-insensitive lookup by monster name; empty if there is no such monster
+    QVariantMap findMonster(const QString& name) const;
     // --- Inventory and Stock ---
     void incrementStock(const QString& name);
     void decrementStock(const QString& name);
@@ -262,6 +305,20 @@ public:
     // --- Global Values System ---
     void setGameValue(const QString& key, const QVariant& value);
     QVariant getGameValue(const QString& key) const;
+    // --- Typed State Store (hot path) ---
+    // Typed accessors skip the QString hash and QVariant boxing of the legacy API.
+    // setStateValue() only emits gameValueChanged when the value actually changes.
+    qint64 getStateValue(GameState::Key key) const { return m_state.value(key); }
+    void setStateValue(GameState::Key key, qint64 value);
+    int dungeonX() const { return static_cast<int>(m_state.value(GameState::Key::DungeonX)); }
+    int dungeonY() const { return static_cast<int>(m_state.value(GameState::Key::DungeonY)); }
+    int dungeonLevel() const { return static_cast<int>(m_state.value(GameState::Key::DungeonLevel)); }
+    // Seeds every generated dungeon level; 0 (saves from before it existed) is the original dungeon
+    quint32 worldSeed() const { return static_cast<quint32>(m_state.value(GameState::Key::WorldSeed)); }
+    void setDungeonPosition(int x, int y) {
+        setStateValue(GameState::Key::DungeonX, x);
+        setStateValue(GameState::Key::DungeonY, y);
+    }
     void logGuildAction(const QString& actionDescription);
     // --- Status Flags ---
     // For World Events: setGlobalStatus("WorldOnFire", true);
@@ -299,6 +356,8 @@ public:
     // --- Diagnostics ---
     void performSanityCheck();
     void printAllGameState() const;
+    void benchmarkStateAccess(int iterations = 100000);
+    void benchmarkSaveFormats(int iterations = 200);
     bool areResourcesLoaded() const;
     QString getCraftingRecipeResult(const QString& item1, const QString& item2);
 
@@ -315,6 +374,7 @@ private:
     int m_currentCharacterIndex = 0;
     QList<PlacedItem> m_placedItems;
     QVariantMap m_gameStateData;
+    GameStateStore m_state;
     QMap<QString, int> m_confinementStock;
     QList<QVariantMap> m_gameData;
     QList<QVariantMap> m_spellData;
@@ -333,6 +393,45 @@ private:
     QList<QVariantMap> m_confinementcreaturesData;
     
     QTimer *m_autosaveTimer = nullptr;
+    QMap<int, QBitArray> m_exploredTiles;
+    CharacterJournal* m_roster = nullptr;
+
+    // --- Binary saves ---
+    // Everything a save holds, copied out of the live state (cheap: all implicitly shared)
+    struct SaveSnapshot {
+        QVariantMap state;                  // m_gameStateData after packStateForSaving()
+        QList<PlacedItem> placedItems;
+        QMap<int, QBitArray> exploredTiles;
+    };
+    SaveSnapshot snapshotForSaving();
+    static QByteArray encodeBinarySave(const SaveSnapshot& snapshot);
+    static bool decodeBinarySave(const QString& path, SaveSnapshot& snapshot);
+    static QVariantMap snapshotToVariant(const SaveSnapshot& snapshot);
+    void applyLoadedState();
+
+    // --- Autosave ---
+    // What the background writer gets: copies made on the GUI thread (the maps are implicitly shared, so this is cheap)
+    struct AutosaveJob {
+        quint64 revision = 0;
+        SaveSnapshot save;
+        QString characterPath;      // Empty when no character file is written
+        QByteArray characterText;
+    };
+    struct AutosaveResult {
+        quint64 revision = 0;
+        bool ok = false;
+        qint64 bytes = 0;
+        qint64 serializeNs = 0;
+        qint64 writeNs = 0;
+    };
+    static AutosaveResult writeAutosave(const AutosaveJob& job);
+    void onAutosaveFinished();
+    bool characterFileText(int partyIndex, QString& filePath, QByteArray& text);
+    void markDirty() { ++m_stateRevision; }
+
+    QFutureWatcher<AutosaveResult>* m_autosaveWatcher = nullptr;
+    quint64 m_stateRevision = 1;   // Bumped by every state change (gameValueChanged)
+    quint64 m_savedRevision = 0;   // Revision the last finished autosave wrote
 };
 
 #endif // gameStateManager_H
@@ -1,18 +1,13 @@
 #include "MapLoader.h"
 
+#include <QtEndian>
+
 //----------------------------------------------------------------------
 // CONSTRUCTOR
 //----------------------------------------------------------------------
 
 MapLoader::MapLoader() {
-    // Initialize the map structure to the correct dimensions (15 levels * 30 * 30 cells)
-    m_mapData.resize(MAP_LEVELS);
-    for (int i = 0; i < MAP_LEVELS; ++i) {
-        m_mapData[i].resize(MAP_HEIGHT);
-        for (int j = 0; j < MAP_HEIGHT; ++j) {
-            m_mapData[i][j].resize(MAP_WIDTH);
-        }
-    }
+    // m_mapData is a fixed 15 * 30 * 30 block that starts zeroed, nothing to allocate
 }
 
 //----------------------------------------------------------------------
@@ -20,105 +15,102 @@ MapLoader::MapLoader() {
 //----------------------------------------------------------------------
 
 // Helper function to read a VBString (Length-prefixed string)
-bool MapLoader::readVBString(QDataStream& stream, QString& outString) {
-    quint8 length; // Assuming a 1-byte length prefix
-    stream >> length;
-
-    if (stream.status() != QDataStream::Ok) {
+bool MapLoader::readVBString(const uchar*& cursor, const uchar* end, QString& outString) {
+    if (end - cursor < 1) { // Assuming a 1-byte length prefix
         qWarning() << "Error reading VBString length.";
         return false;
     }
+    quint8 length = *cursor++;
 
-    if (length == 0) {
-        outString = QString();
-        return true;
-    }
-
-    QByteArray data;
-    data.resize(length);
-    qint64 bytesRead = stream.readRawData(data.data(), length);
-
-    if (bytesRead != length) {
-        qWarning() << "Error reading VBString data. Expected" << length << "bytes, read" << bytesRead;
+    if (end - cursor < length) {
+        qWarning() << "Error reading VBString data. Expected" << length << "bytes, have" << (end - cursor);
         return false;
     }
 
     // Assuming the string content is Latin-1 or ASCII, typical for older formats
-    outString = QString::fromLatin1(data);
+    outString = QString::fromLatin1(reinterpret_cast<const char*>(cursor), length);
+    cursor += length;
     return true;
 }
 
-// Helper function to read all the fixed-size Level Data
-bool MapLoader::readLevelData(QDataStream& stream) {
-    quint32 bitmask;
-    int cellCount = 0;
+// Helper function to read all the fixed-size Level Data.
+// The cell block is 15 * 30 * 30 little-endian quint32s in the same order as
+// MapData, so it is converted in one pass (a plain copy on little-endian hosts).
+bool MapLoader::readLevelData(const uchar*& cursor, const uchar* end) {
+    const qint64 blockSize = qint64(MapData::CELL_COUNT) * sizeof(quint32);
 
-    for (int l = 0; l < MAP_LEVELS; ++l) {
-        for (int y = 0; y < MAP_HEIGHT; ++y) {
-            for (int x = 0; x < MAP_WIDTH; ++x) {
-                // Read the 4-byte FieldBitmask
-                stream >> bitmask;
+    if (end - cursor < blockSize) {
+        qWarning() << "Error reading level data. Expected" << blockSize << "bytes, have" << (end - cursor);
+        return false;
+    }
 
-                if (stream.status() != QDataStream::Ok) {
-                    qWarning() << "Error reading cell data at Level:" << l << "Y:" << y << "X:" << x;
-                    return false;
-                }
+    qFromLittleEndian<quint32>(cursor, MapData::CELL_COUNT, m_mapData.data());
+    cursor += blockSize;
 
-                m_mapData[l][y][x].fieldBitmask = bitmask;
-                cellCount++;
-            }
-        }
-    }
-    qDebug() << "Successfully read" << cellCount << "cells of level data.";
+    if (m_verbose) qDebug() << "Successfully read" << MapData::CELL_COUNT << "cells of level data.";
     return true;
 }
 
-//----------------------------------------------------------------------
-// PUBLIC LOAD FUNCTION
-//----------------------------------------------------------------------
-
-// Main map loading function
-bool MapLoader::loadMap(const QString& filePath) {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open file:" << filePath;
-        return false;
-    }
-
-    QDataStream stream(&file);
-    stream.setVersion(QDataStream::Qt_5_15);
-    // stream.setByteOrder(QDataStream::LittleEndian); // Uncomment if needed
+// Parses a whole map file image
+bool MapLoader::parseMap(const uchar* data, qint64 size) {
+    const uchar* cursor = data;
+    const uchar* end = data + size;
 
     // 1. HEADER RECORD (Version)
-    if (!readVBString(stream, m_version)) {
+    if (!readVBString(cursor, end, m_version)) {
         qWarning() << "Failed to read Version string.";
         return false;
     }
-    qDebug() << "Version:" << m_version;
+    if (m_verbose) qDebug() << "Version:" << m_version;
 
     // 2. DEEPEST LEVEL (2 bytes)
-    stream >> m_deepestLevelExplored;
-
-    if (stream.status() != QDataStream::Ok) {
+    if (end - cursor < qint64(sizeof(quint16))) {
         qWarning() << "Failed to read DeepestLevelExplored (2 bytes).";
         return false;
     }
-    qDebug() << "Deepest Level Explored:" << m_deepestLevelExplored;
-
+    m_deepestLevelExplored = qFromLittleEndian<quint16>(cursor);
+    cursor += sizeof(quint16);
+    if (m_verbose) qDebug() << "Deepest Level Explored:" << m_deepestLevelExplored;
 
     // 3. LEVEL DATA
-    if (!readLevelData(stream)) {
+    if (!readLevelData(cursor, end)) {
         qWarning() << "Failed to read Level Data.";
         return false;
     }
 
-    if (!file.atEnd()) {
+    if (cursor != end) {
         qWarning() << "Warning: Data remains in the file after reading all expected records.";
     }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// PUBLIC LOAD FUNCTION
+//----------------------------------------------------------------------
+
+// Main map loading function.
+// The file is memory-mapped and parsed in place; if the device can't be
+// mapped it is read in a single call and parsed the same way.
+bool MapLoader::loadMap(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open file:" << filePath;
+        return false;
+    }
+
+    bool ok = false;
+    const qint64 size = file.size();
+    if (uchar* mapped = (size > 0) ? file.map(0, size) : nullptr) {
+        ok = parseMap(mapped, size);
+        file.unmap(mapped);
+    } else {
+        const QByteArray bytes = file.readAll();
+        ok = parseMap(reinterpret_cast<const uchar*>(bytes.constData()), bytes.size());
+    }
 
     file.close();
-    qDebug() << "Map file loaded successfully!";
-    return true;
+    if (ok && m_verbose) qDebug() << "Map file loaded successfully!";
+    return ok;
 }
 
 //----------------------------------------------------------------------
@@ -158,11 +150,11 @@ void MapLoader::populateRandomData() {
         for (int y = 0; y < MAP_HEIGHT; ++y) {
             for (int x = 0; x < MAP_WIDTH; ++x) {
                 // Generate a random 4-byte value, masked to the relevant bits.
-                m_mapData[l][y][x].fieldBitmask = randGen->generate() & maxBitmaskValue;
+                m_mapData.at(l, y, x).fieldBitmask = randGen->generate() & maxBitmaskValue;
 
                 // Ensure a base level of "Explored" for most cells, typical for save games
                 if (randGen->bounded(100) > 10) { // 90% chance of being explored
-                    m_mapData[l][y][x].fieldBitmask |= static_cast<quint32>(MapFeature::EXPLORED);
+                    m_mapData.at(l, y, x).fieldBitmask |= static_cast<quint32>(MapFeature::EXPLORED);
                 }
             }
         }
@@ -170,25 +162,19 @@ void MapLoader::populateRandomData() {
     qDebug() << "Map data randomly populated.";
 }
 
-// Helper function to write all the Level Data
+// Helper function to write all the Level Data.
+// Mirror of readLevelData(): the whole cell block goes out as one little-endian write.
 bool MapLoader::writeLevelData(QDataStream& stream) {
-    int cellCount = 0;
+    const int blockSize = MapData::CELL_COUNT * int(sizeof(quint32));
 
-    for (int l = 0; l < MAP_LEVELS; ++l) {
-        for (int y = 0; y < MAP_HEIGHT; ++y) {
-            for (int x = 0; x < MAP_WIDTH; ++x) {
-                // Write the 4-byte FieldBitmask
-                stream << m_mapData[l][y][x].fieldBitmask;
+    QByteArray block(blockSize, Qt::Uninitialized);
+    qToLittleEndian<quint32>(m_mapData.data(), MapData::CELL_COUNT, block.data());
 
-                if (stream.status() != QDataStream::Ok) {
-                    qWarning() << "Error writing cell data at Level:" << l << "Y:" << y << "X:" << x;
-                    return false;
-                }
-                cellCount++;
-            }
-        }
+    if (stream.writeRawData(block.constData(), blockSize) != blockSize) {
+        qWarning() << "Error writing level data block of" << blockSize << "bytes.";
+        return false;
     }
-    qDebug() << "Successfully wrote" << cellCount << "cells of level data.";
+    qDebug() << "Successfully wrote" << MapData::CELL_COUNT << "cells of level data.";
     return true;
 }
 
@@ -212,7 +198,7 @@ bool MapLoader::generateRandomMap(const QString& filePath, const QString& versio
 
     QDataStream stream(&file);
     stream.setVersion(QDataStream::Qt_5_15);
-    // stream.setByteOrder(QDataStream::LittleEndian); // Uncomment if needed
+    stream.setByteOrder(QDataStream::LittleEndian); // The map format is little-endian throughout
 
     // 3. Write HEADER RECORD (Version)
     if (!writeVBString(stream, m_version)) {
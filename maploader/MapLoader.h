@@ -9,6 +9,7 @@
 #include <QDebug>
 #include <QRandomGenerator> // For map generation
 #include <QtGlobal>        // For quint types
+#include <array>
 
 // --- Data Structures ---
 
@@ -52,11 +53,36 @@ enum class MapFeature : quint32 {
     FOG              = 1048576,  
     CHUTE            = 2097152,  
     STUD             = 4194304,  
-    EXPLORED         = 8388608   
+    EXPLORED         = 8388608,
+    // Runtime-only bits used by the live dungeon (never written to map files)
+    TRAP             = 16777216,
+    MONSTER          = 33554432,
+    TREASURE         = 67108864,
+    HIDDEN_DOOR      = 134217728,
+    BODY             = 268435456,
+    ROOM_FLOOR       = 536870912
 };
 
-// Typedef for the main map structure: Level, Y (Height), X (Width)
-using MapData = QVector<QVector<QVector<CellData>>>;
+// CellData is read and written as a raw block of little-endian quint32s
+static_assert(sizeof(CellData) == sizeof(quint32), "CellData must stay a bare 4-byte bitmask");
+
+// The main map structure: every cell of every level in one contiguous block,
+// laid out Level, Y (Height), X (Width) exactly as in the map file.
+struct MapData {
+    static constexpr int CELL_COUNT = MAP_LEVELS * MAP_HEIGHT * MAP_WIDTH;
+
+    std::array<CellData, CELL_COUNT> cells{};
+
+    CellData& at(int level, int y, int x) { return cells[index(level, y, x)]; }
+    const CellData& at(int level, int y, int x) const { return cells[index(level, y, x)]; }
+
+    CellData* data() { return cells.data(); }
+    const CellData* data() const { return cells.data(); }
+
+    static constexpr int index(int level, int y, int x) {
+        return (level * MAP_HEIGHT + y) * MAP_WIDTH + x;
+    }
+};
 
 
 // --- Class Definition ---
@@ -74,14 +100,21 @@ public:
     quint16 getDeepestLevelExplored() const { return m_deepestLevelExplored; }
     const MapData& getMapData() const { return m_mapData; }
 
+    // Turns off the per-load qDebug chatter (used by the load benchmark)
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+
 private:
     QString m_version;
     quint16 m_deepestLevelExplored = 0; // 2 bytes
     MapData m_mapData;
+    bool m_verbose = true;
 
     // --- Private Read Helpers ---
-    bool readVBString(QDataStream& stream, QString& outString);
-    bool readLevelData(QDataStream& stream);
+    // These parse straight out of the file bytes (memory-mapped, or read in one go as a fallback).
+    // 'cursor' is advanced past whatever was consumed.
+    bool parseMap(const uchar* data, qint64 size);
+    bool readVBString(const uchar*& cursor, const uchar* end, QString& outString);
+    bool readLevelData(const uchar*& cursor, const uchar* end);
     
     // --- Private Write/Generate Helpers (The ones that caused the previous errors) ---
     bool writeVBString(QDataStream& stream, const QString& inString);
@@ -2,6 +2,66 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+
+// The old way of loading the cell block: one QDataStream read per cell.
+// Only kept here as the baseline for the load benchmark.
+static bool streamLoadCells(const QString& filePath, MapData& out) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint8 length;
+    stream >> length;
+    stream.skipRawData(length);
+    quint16 deepest;
+    stream >> deepest;
+
+    for (int l = 0; l < MAP_LEVELS; ++l) {
+        for (int y = 0; y < MAP_HEIGHT; ++y) {
+            for (int x = 0; x < MAP_WIDTH; ++x) {
+                stream >> out.at(l, y, x).fieldBitmask;
+            }
+        }
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+// Times full 15-level loads of the same file: the mapped bulk loader vs. per-cell streaming
+static void runLoadBenchmark(const QString& filePath, int iterations) {
+    MapLoader loader;
+    loader.setVerbose(false);
+    MapData streamed;
+
+    // 1. Warm up the page cache so both paths read from memory
+    loader.loadMap(filePath);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        loader.loadMap(filePath);
+    }
+    const qint64 mappedNs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        streamLoadCells(filePath, streamed);
+    }
+    const qint64 streamNs = timer.nsecsElapsed();
+
+    // 2. Both paths must agree cell for cell
+    const bool identical = std::equal(streamed.cells.begin(), streamed.cells.end(), loader.getMapData().cells.begin(),
+                                      [](const CellData& a, const CellData& b) { return a.fieldBitmask == b.fieldBitmask; });
+
+    qDebug() << "Map load benchmark," << iterations << "loads of" << MapData::CELL_COUNT << "cells:";
+    qDebug() << "  mapped bulk load:" << (mappedNs / iterations) / 1000.0 << "us per map";
+    qDebug() << "  per-cell stream: " << (streamNs / iterations) / 1000.0 << "us per map";
+    qDebug() << "  results identical:" << identical;
+}
 
 int main(int argc, char *argv[]) {
     QCoreApplication a(argc, argv);
@@ -25,7 +85,7 @@ int main(int argc, char *argv[]) {
             qDebug() << "Verification successful:";
             
             // 3. SAMPLE DATA CHECK
-            const CellData& cell = loader.getMapData()[5][15][15];
+            const CellData& cell = loader.getMapData().at(5, 15, 15);
             
             qDebug() << "Sample Cell (5, 15, 15) Bitmask:" 
                      << QString::number(cell.fieldBitmask, 16).toUpper().rightJustified(8, '0');
@@ -42,6 +102,12 @@ int main(int argc, char *argv[]) {
                 qDebug() << "-> Cell is marked as EXPLORED.";
             }
             
+
+            // 4. LOAD TIMING (opt-in, the loop is long)
+            if (qEnvironmentVariableIsSet("BLACKLANDS_BENCH")) {
+                runLoadBenchmark(mapFilePath, 1000);
+            }
+
         } else {
             qWarning() << "Verification failed: Could not load the generated map.";
         }
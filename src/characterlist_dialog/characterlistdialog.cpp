@@ -1,4 +1,5 @@
 #include "characterlistdialog.h"
+#include "gameStateManager.h"
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QDir>
@@ -40,25 +41,16 @@ CharacterListDialog::CharacterListDialog(QWidget *parent)
     loadCharactersFromFiles();
 }
 /**
- * @brief Dynamically loads character names from .txt files in the "characters" folder.
+ * @brief Lists every character on the roster (see CharacterJournal).
  */
 void CharacterListDialog::loadCharactersFromFiles()
 {
-    QString charactersDir = "./data/characters";
-    QDir dir(charactersDir);
-    if (!dir.exists()) {
-        QMessageBox::warning(this, "Load Error", "Character directory not found: " + charactersDir);
-        return;
+    const auto characters = gameStateManager::instance()->roster()->list();
+    if (characters.isEmpty()) {
+        QMessageBox::information(this, "No Characters", "No saved characters found.");
     }
-    QStringList filters;
-    filters << "*.txt";
-    QFileInfoList fileList = dir.entryInfoList(filters, QDir::Files | QDir::NoDotAndDotDot);
-    if (fileList.isEmpty()) {
-        QMessageBox::information(this, "No Characters", "No character save files (.txt) found in the 'characters' folder.");
-    }
-    foreach (const QFileInfo &fileInfo, fileList) {
-        QString characterName = fileInfo.baseName(); 
-        characterListWidget->addItem(characterName);
+    for (const CharacterJournal::Summary &character : characters) {
+        characterListWidget->addItem(character.name);
     }
 }
 
@@ -86,15 +78,16 @@ void CharacterListDialog::onDeleteClicked()
                                       "Are you sure you want to delete the character: " + characterName + "?",
                                       QMessageBox::Yes|QMessageBox::No);
         if (reply == QMessageBox::Yes) {
-            // Try removing the actual file
-            QString filePath = "characters/" + characterName + ".txt";
-            if (QFile::remove(filePath)) {
+            // Drop it from the roster, then remove the .txt export
+            QString filePath = "data/characters/" + characterName + ".txt";
+            if (gameStateManager::instance()->roster()->remove(characterName)) {
+                QFile::remove(filePath);
                 // Remove from UI if file removed
                 delete characterListWidget->takeItem(characterListWidget->currentRow());
                 QMessageBox::information(this, "Deleted", characterName + " and its save file have been deleted.");
             } else {
-                QMessageBox::critical(this, "Error", "Could not delete the file: " + filePath + 
-                                       "\n(File may not exist or permissions are wrong.)");
+                QMessageBox::critical(this, "Error", "Could not delete the character: " + characterName +
+                                       "\n(" + gameStateManager::instance()->roster()->errorString() + ")");
             }
         }
     } else {
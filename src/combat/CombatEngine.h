@@ -0,0 +1,111 @@
+#ifndef COMBATENGINE_H
+#define COMBATENGINE_H
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QString>
+#include <QVariantMap>
+#include <array>
+
+#include "../../character.h"
+
+/**
+ * @brief One fight between the party and a group of monsters, simulated in
+ * fixed 100 ms steps with no widgets, timers or global state involved.
+ *
+ * Every combatant has a swing interval; each step() adds TICK_MS to its
+ * cooldown and it attacks once the interval is reached (party first, then
+ * monsters, in the order they were added). All rolls come from one
+ * generator seeded per encounter, so the same seed and line-up always play
+ * out the same fight.
+ *
+ * Whoever drives the engine reads what happened from takeEvents(): the
+ * dungeon turns them into log lines and HP updates, the balance tools only
+ * count them. Outside effects (spells, defending) go in through damage()
+ * and setDefending().
+ */
+class CombatEngine {
+public:
+    static constexpr int TICK_MS = 100;
+
+    // MDATA5 resistance columns, in file order
+    enum Resistance { Fire, Cold, Electric, Mind, Poison, Disease, Magic, Physical, Weapon, Spell, Special, RESISTANCE_COUNT };
+    static const char* const RESISTANCE_KEYS[RESISTANCE_COUNT];
+
+    enum class Side { Party, Monsters };
+    enum class Outcome { Ongoing, PartyWon, PartyLost, TimedOut };
+
+    struct Combatant {
+        QString name;
+        Side side = Side::Party;
+        int hp = 1;
+        int maxHp = 1;
+        int attack = 0;                 // MDATA5 "att"; party: from stats and level
+        int defense = 0;                // MDATA5 "def"
+        int minDamage = 1;
+        int maxDamage = 1;
+        int damageMod = 0;              // MDATA5 "damageMod", added to every hit
+        std::array<int, RESISTANCE_COUNT> resistances {}; // Percent
+        qint32 specialAttackFlags = 0;  // Carried for the caller; the engine doesn't interpret them yet
+        int swingMs = 1000;
+        int cooldownMs = 0;
+        bool defending = false;         // Halves incoming damage (minimum 1)
+
+        bool alive() const { return hp > 0; }
+
+        // One MDATA5 row as loaded by gameStateManager (keys are the CSV header names)
+        static Combatant fromMonster(const QVariantMap& row);
+        static Combatant fromCharacter(const Character& character);
+    };
+
+    struct Event {
+        enum class Type { Hit, Miss, Death };
+        Type type = Type::Hit;
+        int tick = 0;
+        int attacker = -1;   // Combatant index, -1 for damage() from outside
+        int target = -1;
+        int damage = 0;      // Hit only, after resistance and defending
+    };
+
+    explicit CombatEngine(quint32 seed);
+
+    int add(const Combatant& combatant);   // Returns its index
+    const Combatant& combatant(int index) const { return m_combatants.at(index); }
+    int combatantCount() const { return int(m_combatants.size()); }
+
+    // One fixed step of TICK_MS
+    Outcome step();
+    // Steps until the fight is decided or 'maxTicks' have passed
+    Outcome run(int maxTicks = 10 * 60 * 1000 / TICK_MS);
+
+    Outcome outcome() const;
+    int ticks() const { return m_tick; }
+    quint32 seed() const { return m_seed; }
+
+    // Outside damage, e.g. a spell; resistances are the caller's business
+    void damage(int target, int amount);
+    void setDefending(int index, bool defending);
+
+    // Events since the last call
+    QList<Event> takeEvents();
+    // Simulations that only want the outcome can skip building the event list
+    void setRecordEvents(bool record) { m_recordEvents = record; }
+
+    // Fights 'fights' seeded encounters of a level-1 fighter against 'monsters' (MDATA5 rows) and logs fights/second
+    static void benchmark(const QList<QVariantMap>& monsters, int fights);
+
+private:
+    void attack(int attacker);
+    void applyDamage(int attacker, int target, int amount);
+    int pickTarget(Side side);
+    bool sideAlive(Side side) const;
+
+    QList<Combatant> m_combatants;
+    QList<Event> m_events;
+    QRandomGenerator m_rng;
+    quint32 m_seed;
+    int m_tick = 0;
+    bool m_recordEvents = true;
+};
+
+#endif // COMBATENGINE_H
@@ -0,0 +1,352 @@
+#include "CharacterJournal.h"
+#include "Crc32.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+// --- File layout (all little-endian) ---
+//
+// Header, 8 bytes:
+//   0  char[4]  "BLCJ"
+//   4  quint32  format version
+// Records, back to back:
+//      quint32 payload size, quint32 CRC-32 of the payload,
+//      payload: QDataStream of quint8 op, QString name, and for Put the QMap<QString, QString> fields
+namespace {
+    const char MAGIC[4] = { 'B', 'L', 'C', 'J' };
+    const int HEADER_SIZE = 8;
+    const int RECORD_HEADER_SIZE = 8;
+    const quint32 MAX_RECORD_SIZE = 16 * 1024 * 1024; // Anything larger is garbage, not a character
+
+    template<typename T>
+    void put(QByteArray& out, T value) {
+        const T le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+    }
+
+    QByteArray fileHeader() {
+        QByteArray header(MAGIC, sizeof(MAGIC));
+        put<quint32>(header, CharacterJournal::FORMAT_VERSION);
+        return header;
+    }
+}
+
+const char* const CharacterJournal::DEFAULT_PATH = "data/characters/roster.journal";
+
+CharacterJournal::CharacterJournal(const QString& path)
+    : m_path(path)
+{
+}
+
+CharacterJournal::~CharacterJournal() {
+    close();
+}
+
+bool CharacterJournal::fail(const QString& reason) {
+    m_error = reason;
+    qWarning() << "Character journal" << m_path << ":" << reason;
+    return false;
+}
+
+void CharacterJournal::close() {
+    m_file.close();
+    m_index.clear();
+    for (QSet<QString>& names : m_byStatus) names.clear();
+    m_liveBytes = m_deadBytes = 0;
+}
+
+bool CharacterJournal::open() {
+    close();
+    m_error.clear();
+    m_recoveredBytes = 0;
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::ReadWrite)) return fail(m_file.errorString());
+
+    // 1. A new (or empty) file gets a header
+    if (m_file.size() == 0) {
+        if (m_file.write(fileHeader()) != HEADER_SIZE || !m_file.flush()) return fail(m_file.errorString());
+        return true;
+    }
+
+    // 2. Otherwise check it and rebuild the index from the records
+    const QByteArray header = m_file.read(HEADER_SIZE);
+    if (header.size() != HEADER_SIZE || std::memcmp(header.constData(), MAGIC, sizeof(MAGIC)) != 0) {
+        m_file.close();
+        return fail("not a character journal");
+    }
+    if (qFromLittleEndian<quint32>(header.constData() + 4) > FORMAT_VERSION) {
+        m_file.close();
+        return fail("journal is from a newer format version");
+    }
+    return replay();
+}
+
+bool CharacterJournal::replay() {
+    const qint64 fileSize = m_file.size();
+    qint64 pos = HEADER_SIZE;
+
+    while (pos + RECORD_HEADER_SIZE <= fileSize) {
+        // 1. Length and checksum; a record that runs past the end or fails its CRC is a torn write
+        if (!m_file.seek(pos)) break;
+        const QByteArray head = m_file.read(RECORD_HEADER_SIZE);
+        if (head.size() != RECORD_HEADER_SIZE) break;
+        const quint32 payloadSize = qFromLittleEndian<quint32>(head.constData());
+        const quint32 crc = qFromLittleEndian<quint32>(head.constData() + 4);
+        if (payloadSize > MAX_RECORD_SIZE || pos + RECORD_HEADER_SIZE + payloadSize > fileSize) break;
+        const QByteArray payload = m_file.read(payloadSize);
+        if (payload.size() != qsizetype(payloadSize) || Crc32::compute(payload.constData(), payload.size()) != crc) break;
+
+        // 2. Apply it
+        QDataStream in(payload);
+        in.setVersion(QDataStream::Qt_6_0);
+        quint8 op = 0;
+        QString name;
+        Fields fields;
+        in >> op >> name;
+        if (Op(op) == Op::Put) in >> fields;
+        if (in.status() != QDataStream::Ok || (Op(op) != Op::Put && Op(op) != Op::Remove)) break;
+
+        const qint64 size = RECORD_HEADER_SIZE + payloadSize;
+        apply(Op(op), name, fields, pos, size);
+        pos += size;
+    }
+
+    // 3. Recovery: drop whatever follows the last good record
+    if (pos < fileSize) {
+        m_recoveredBytes = fileSize - pos;
+        qWarning() << "Character journal: dropping" << m_recoveredBytes << "bytes of an interrupted write at offset" << pos;
+        if (!m_file.resize(pos)) return fail(m_file.errorString());
+    }
+    return true;
+}
+
+void CharacterJournal::apply(Op op, const QString& name, const Fields& fields, qint64 offset, qint64 size) {
+    // The record this one supersedes becomes dead weight
+    auto it = m_index.find(name);
+    if (it != m_index.end()) {
+        m_deadBytes += it->size;
+        m_liveBytes -= it->size;
+        m_byStatus[int(it->summary.status)].remove(name);
+        m_index.erase(it);
+    }
+
+    if (op == Op::Remove) {
+        m_deadBytes += size; // The tombstone itself is only needed until the next compaction
+        return;
+    }
+
+    Entry entry;
+    entry.summary = summarize(name, fields);
+    entry.offset = offset;
+    entry.size = size;
+    m_byStatus[int(entry.summary.status)].insert(name);
+    m_index.insert(name, entry);
+    m_liveBytes += size;
+}
+
+QByteArray CharacterJournal::encodeRecord(Op op, const QString& name, const Fields& fields) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint8(op) << name;
+    if (op == Op::Put) out << fields;
+
+    QByteArray record;
+    record.reserve(RECORD_HEADER_SIZE + payload.size());
+    put<quint32>(record, quint32(payload.size()));
+    put<quint32>(record, Crc32::compute(payload.constData(), payload.size()));
+    record.append(payload);
+    return record;
+}
+
+bool CharacterJournal::append(Op op, const QString& name, const Fields& fields) {
+    if (!isOpen()) return fail("journal is not open");
+    if (name.isEmpty()) return fail("character without a name");
+
+    const QByteArray record = encodeRecord(op, name, fields);
+    const qint64 offset = m_file.size();
+    if (!m_file.seek(offset) || m_file.write(record) != record.size() || !m_file.flush()) {
+        // Leave the file as it was; a partial record would be cut off by the next open() anyway
+        m_file.resize(offset);
+        return fail(m_file.errorString());
+    }
+    apply(op, name, fields, offset, record.size());
+    maybeCompact();
+    return true;
+}
+
+bool CharacterJournal::put(const QString& name, const Fields& fields) {
+    return append(Op::Put, name, fields);
+}
+
+bool CharacterJournal::update(const QString& name, const Fields& changes) {
+    Fields fields;
+    if (!get(name, fields)) return false;
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) fields.insert(it.key(), it.value());
+    return put(name, fields);
+}
+
+bool CharacterJournal::remove(const QString& name) {
+    if (!contains(name)) {
+        m_error = name + " is not on the roster";
+        return false;
+    }
+    return append(Op::Remove, name, Fields());
+}
+
+void CharacterJournal::maybeCompact() {
+    if (m_deadBytes >= COMPACT_MIN_DEAD_BYTES && m_deadBytes > m_liveBytes) compact();
+}
+
+bool CharacterJournal::compact() {
+    if (!isOpen()) return fail("journal is not open");
+
+    // 1. Copy the live records, in file order, into a fresh journal
+    QList<QString> names = m_index.keys();
+    std::sort(names.begin(), names.end(), [this](const QString& a, const QString& b) {
+        return m_index[a].offset < m_index[b].offset;
+    });
+
+    QSaveFile out(m_path);
+    if (!out.open(QIODevice::WriteOnly) || out.write(fileHeader()) != HEADER_SIZE) return fail(out.errorString());
+    QHash<QString, qint64> newOffsets;
+    qint64 pos = HEADER_SIZE;
+    for (const QString& name : std::as_const(names)) {
+        const Entry& entry = m_index[name];
+        if (!m_file.seek(entry.offset)) return fail(m_file.errorString());
+        const QByteArray record = m_file.read(entry.size);
+        if (record.size() != entry.size || out.write(record) != record.size()) {
+            out.cancelWriting();
+            return fail("compaction failed to copy " + name);
+        }
+        newOffsets.insert(name, pos);
+        pos += record.size();
+    }
+
+    // 2. Swap it in (atomic rename), then point the index at the new offsets
+    m_file.close();
+    if (!out.commit()) {
+        m_file.open(QIODevice::ReadWrite);
+        return fail(out.errorString());
+    }
+    if (!m_file.open(QIODevice::ReadWrite)) return fail(m_file.errorString());
+    for (auto it = newOffsets.cbegin(); it != newOffsets.cend(); ++it) m_index[it.key()].offset = it.value();
+    qDebug() << "Character journal compacted:" << m_deadBytes << "bytes reclaimed," << m_index.size() << "characters kept";
+    m_deadBytes = 0;
+    return true;
+}
+
+const CharacterJournal::Summary* CharacterJournal::summary(const QString& name) const {
+    auto it = m_index.constFind(name);
+    return it == m_index.constEnd() ? nullptr : &it->summary;
+}
+
+QList<CharacterJournal::Summary> CharacterJournal::list() const {
+    QList<Summary> result;
+    result.reserve(m_index.size());
+    for (const Entry& entry : m_index) result.append(entry.summary);
+    std::sort(result.begin(), result.end(), [](const Summary& a, const Summary& b) { return a.name < b.name; });
+    return result;
+}
+
+QList<CharacterJournal::Summary> CharacterJournal::list(Status status) const {
+    QList<Summary> result;
+    for (const QString& name : m_byStatus[int(status)]) result.append(m_index.value(name).summary);
+    std::sort(result.begin(), result.end(), [](const Summary& a, const Summary& b) { return a.name < b.name; });
+    return result;
+}
+
+QList<CharacterJournal::Summary> CharacterJournal::search(const QString& text) const {
+    QList<Summary> result;
+    for (const Entry& entry : m_index) {
+        if (entry.summary.name.contains(text, Qt::CaseInsensitive)) result.append(entry.summary);
+    }
+    std::sort(result.begin(), result.end(), [](const Summary& a, const Summary& b) { return a.name < b.name; });
+    return result;
+}
+
+bool CharacterJournal::get(const QString& name, Fields& fields) {
+    auto it = m_index.constFind(name);
+    if (it == m_index.constEnd()) return false;
+    if (!m_file.seek(it->offset + RECORD_HEADER_SIZE)) return fail(m_file.errorString());
+
+    const QByteArray payload = m_file.read(it->size - RECORD_HEADER_SIZE);
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint8 op = 0;
+    QString storedName;
+    in >> op >> storedName >> fields;
+    return in.status() == QDataStream::Ok;
+}
+
+//----------------------------------------------------------------------
+// .txt interop
+//----------------------------------------------------------------------
+
+CharacterJournal::Fields CharacterJournal::parseText(const QByteArray& text) {
+    Fields fields;
+    for (const QByteArray& rawLine : text.split('\n')) {
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        const qsizetype colon = line.indexOf(':');
+        if (colon <= 0) continue; // Blank lines and "--- STATS ---" headings
+        fields.insert(line.left(colon).trimmed(), line.mid(colon + 1).trimmed());
+    }
+    return fields;
+}
+
+QByteArray CharacterJournal::toText(const Fields& fields) {
+    // Version and name first, like the files the game writes itself
+    QByteArray text;
+    const QStringList first = { "CHARACTER_FILE_VERSION", "Name" };
+    for (const QString& key : first) {
+        if (fields.contains(key)) text += (key + ": " + fields.value(key) + "\n").toUtf8();
+    }
+    for (auto it = fields.cbegin(); it != fields.cend(); ++it) {
+        if (first.contains(it.key())) continue;
+        text += (it.key() + ": " + it.value() + "\n").toUtf8();
+    }
+    return text;
+}
+
+CharacterJournal::Summary CharacterJournal::summarize(const QString& name, const Fields& fields) {
+    Summary s;
+    s.name = name;
+    s.level = fields.value("Level").toInt();
+    s.guild = fields.value("Guild");
+    s.dungeonLevel = fields.value("DungeonLevel").toInt();
+    s.dungeonX = fields.value("DungeonX").toInt();
+    s.dungeonY = fields.value("DungeonY").toInt();
+    s.inCity = fields.contains("inCity") ? fields.value("inCity") == "1" : s.dungeonLevel == 0;
+
+    const QString alive = fields.value("isAlive", "1").toLower();
+    if (alive == "0" || alive == "false") s.status = Status::Dead;
+    else if (!s.inCity && s.dungeonLevel > 0) s.status = Status::InDungeon;
+    else s.status = Status::Alive;
+    return s;
+}
+
+bool CharacterJournal::importTextFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    Fields fields = parseText(file.readAll());
+    QString name = fields.value("Name");
+    if (name.isEmpty()) name = QFileInfo(path).completeBaseName();
+    return put(name, fields);
+}
+
+int CharacterJournal::importTextFiles(const QString& directory) {
+    QDir dir(directory);
+    int imported = 0;
+    for (const QFileInfo& info : dir.entryInfoList({ "*.txt" }, QDir::Files)) {
+        if (contains(info.completeBaseName())) continue;
+        if (importTextFile(info.absoluteFilePath())) ++imported;
+    }
+    return imported;
+}
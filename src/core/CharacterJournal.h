@@ -0,0 +1,113 @@
+#ifndef CHARACTERJOURNAL_H
+#define CHARACTERJOURNAL_H
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+
+/**
+ * @brief Every character on the roster in one append-only journal file,
+ * with an in-memory index so listing and searching never touch the disk.
+ *
+ * A character is stored as the same "Key: value" fields its .txt save
+ * has. Each change appends one record (length, CRC-32, then the name and
+ * fields) and flushes; nothing already written is ever modified, so a crash
+ * can at worst leave a torn record at the very end. open() replays the
+ * journal, rebuilds the index from the last record of each name and cuts
+ * such a tail off.
+ *
+ * Superseded records stay in the file until compact() rewrites only the
+ * live ones through QSaveFile. put() and remove() compact on their own once
+ * the dead records outweigh the live ones.
+ *
+ * Not thread-safe: the game uses it from the GUI thread only.
+ */
+class CharacterJournal {
+public:
+    static const quint32 FORMAT_VERSION = 1;
+    static const char* const DEFAULT_PATH;
+
+    enum class Status { Alive, Dead, InDungeon };
+
+    // The "Key: value" lines of a character save, e.g. fields["HP"] == "12"
+    using Fields = QMap<QString, QString>;
+
+    // What the index keeps per character: enough for the roster screens without reading the record
+    struct Summary {
+        QString name;
+        Status status = Status::Alive;
+        int level = 0;
+        QString guild;
+        bool inCity = true;
+        int dungeonLevel = 0;
+        int dungeonX = 0;
+        int dungeonY = 0;
+    };
+
+    explicit CharacterJournal(const QString& path = QString::fromLatin1(DEFAULT_PATH));
+    ~CharacterJournal();
+    CharacterJournal(const CharacterJournal&) = delete;
+    CharacterJournal& operator=(const CharacterJournal&) = delete;
+
+    // Opens (or creates) the journal and replays it
+    bool open();
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_error; }
+    qint64 recoveredBytes() const { return m_recoveredBytes; } // Torn tail dropped by the last open()
+
+    // --- Writing: one appended record each ---
+    bool put(const QString& name, const Fields& fields);
+    bool update(const QString& name, const Fields& changes); // Merges into the current fields
+    bool remove(const QString& name);
+    bool compact();
+
+    // --- Reading ---
+    bool contains(const QString& name) const { return m_index.contains(name); }
+    int count() const { return int(m_index.size()); }
+    int count(Status status) const { return int(m_byStatus[int(status)].size()); }
+    const Summary* summary(const QString& name) const;
+    QList<Summary> list() const;
+    QList<Summary> list(Status status) const;
+    QList<Summary> search(const QString& text) const; // Case-insensitive name match
+    bool get(const QString& name, Fields& fields);    // One seek + one read
+
+    // --- .txt interop ---
+    bool importTextFile(const QString& path);
+    int importTextFiles(const QString& directory);   // Every *.txt not already on the roster
+    static Fields parseText(const QByteArray& text);
+    static QByteArray toText(const Fields& fields);
+    static Summary summarize(const QString& name, const Fields& fields);
+
+private:
+    enum class Op : quint8 { Put = 1, Remove = 2 };
+
+    struct Entry {
+        Summary summary;
+        qint64 offset = 0;   // Record start (length field)
+        qint64 size = 0;     // Whole record, header included
+    };
+
+    static QByteArray encodeRecord(Op op, const QString& name, const Fields& fields);
+    bool append(Op op, const QString& name, const Fields& fields);
+    bool replay();
+    void apply(Op op, const QString& name, const Fields& fields, qint64 offset, qint64 size);
+    void maybeCompact();
+    bool fail(const QString& reason);
+
+    QString m_path;
+    QFile m_file;
+    QHash<QString, Entry> m_index;
+    QSet<QString> m_byStatus[3];
+    qint64 m_liveBytes = 0;
+    qint64 m_deadBytes = 0;
+    qint64 m_recoveredBytes = 0;
+    QString m_error;
+
+    static constexpr qint64 COMPACT_MIN_DEAD_BYTES = 64 * 1024;
+};
+
+#endif // CHARACTERJOURNAL_H
@@ -0,0 +1,39 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <QtGlobal>
+#include <array>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, the zlib/PNG polynomial) for integrity checks on
+ * the binary files the game writes itself. qChecksum() is only CRC-16.
+ */
+namespace Crc32 {
+
+    constexpr std::array<quint32, 256> makeTable() {
+        std::array<quint32, 256> table {};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<quint32, 256> TABLE = makeTable();
+
+    // Pass the previous result as 'crc' to checksum data in pieces
+    inline quint32 compute(const void* data, qsizetype size, quint32 crc = 0) {
+        const uchar* p = static_cast<const uchar*>(data);
+        crc = ~crc;
+        for (qsizetype i = 0; i < size; ++i) {
+            crc = TABLE[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+} // namespace Crc32
+
+#endif // CRC32_H
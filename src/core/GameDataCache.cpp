@@ -0,0 +1,425 @@
+#include "GameDataCache.h"
+#include "Crc32.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QSaveFile>
+#include <QtEndian>
+#include <bit>
+#include <cstring>
+
+// --- File layout (all little-endian) ---
+//
+// Header, 32 bytes:
+//   0  char[4]  "BLGD"
+//   4  quint32  format version
+//   8  quint32  payload size (everything after the header)
+//  12  quint32  CRC-32 of the payload
+//  16  quint32  source count
+//  20  quint32  table count
+//  24  quint32  string pool offset (payload-relative)
+//  28  quint32  string pool size
+// Payload:
+//   sources  16 bytes each: path (offset, size), qint64 mtime in ms
+//   tables   24 bytes each: name (offset, size), rows, columns, columns offset, cells offset
+//   per table: column names (offset, size), then rows * columns cells of 16 bytes:
+//            quint32 CellType, quint32 size, quint64 value (string offset, integer or double bits)
+//   string pool
+namespace {
+    const char MAGIC[4] = { 'B', 'L', 'G', 'D' };
+    const int HEADER_SIZE = 32;
+    const int SOURCE_SIZE = 16;
+    const int TABLE_SIZE = 24;
+    const int COLUMN_SIZE = 8;
+    const int CELL_SIZE = 16;
+
+    template<typename T>
+    T get(const uchar* p) { return qFromLittleEndian<T>(p); }
+
+    template<typename T>
+    void put(QByteArray& out, T value) {
+        const T le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+    }
+
+    // Builds the de-duplicated string pool while the tables are written
+    class StringPool {
+    public:
+        quint32 intern(const QByteArray& utf8) {
+            auto it = m_offsets.constFind(utf8);
+            if (it != m_offsets.constEnd()) return it.value();
+            const quint32 offset = quint32(m_pool.size());
+            m_pool.append(utf8);
+            m_offsets.insert(utf8, offset);
+            return offset;
+        }
+
+        // StringRef: offset, size
+        void put(QByteArray& out, const QByteArray& utf8) {
+            ::put<quint32>(out, intern(utf8));
+            ::put<quint32>(out, quint32(utf8.size()));
+        }
+
+        // Cell: type, size, offset
+        void putCell(QByteArray& out, GameDataCache::CellType type, const QByteArray& utf8) {
+            ::put<quint32>(out, quint32(type));
+            ::put<quint32>(out, quint32(utf8.size()));
+            ::put<quint64>(out, intern(utf8));
+        }
+        const QByteArray& bytes() const { return m_pool; }
+
+    private:
+        QByteArray m_pool;
+        QHash<QByteArray, quint32> m_offsets;
+    };
+
+    bool sameText(QUtf8StringView a, QUtf8StringView b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), size_t(a.size())) == 0;
+    }
+
+    qint64 sourceTime(const QString& path) {
+        QFileInfo info(path);
+        return info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// Table views
+//----------------------------------------------------------------------
+
+QString GameDataCache::Table::name() const {
+    return isValid() ? m_cache->string(m_nameOffset, m_nameSize).toString() : QString();
+}
+
+QString GameDataCache::Table::columnName(int column) const {
+    if (!isValid() || column < 0 || column >= m_columns) return QString();
+    const uchar* ref = m_columnRefs + column * COLUMN_SIZE;
+    return m_cache->string(get<quint32>(ref), get<quint32>(ref + 4)).toString();
+}
+
+int GameDataCache::Table::columnIndex(QUtf8StringView name) const {
+    for (int c = 0; c < m_columns; ++c) {
+        const uchar* ref = m_columnRefs + c * COLUMN_SIZE;
+        if (sameText(m_cache->string(get<quint32>(ref), get<quint32>(ref + 4)), name)) return c;
+    }
+    return -1;
+}
+
+const uchar* GameDataCache::Table::cell(int row, int column) const {
+    if (!isValid() || row < 0 || row >= m_rows || column < 0 || column >= m_columns) return nullptr;
+    return m_cells + (qsizetype(row) * m_columns + column) * CELL_SIZE;
+}
+
+GameDataCache::CellType GameDataCache::Table::type(int row, int column) const {
+    const uchar* c = cell(row, column);
+    return c ? CellType(get<quint32>(c)) : CellType::Missing;
+}
+
+QUtf8StringView GameDataCache::Table::text(int row, int column) const {
+    const uchar* c = cell(row, column);
+    if (!c) return {};
+    const CellType t = CellType(get<quint32>(c));
+    if (t != CellType::String && t != CellType::Json) return {};
+    return m_cache->string(quint32(get<quint64>(c + 8)), get<quint32>(c + 4));
+}
+
+qint64 GameDataCache::Table::integer(int row, int column) const {
+    const uchar* c = cell(row, column);
+    if (!c) return 0;
+    switch (CellType(get<quint32>(c))) {
+    case CellType::Int:    return qint64(get<quint64>(c + 8));
+    case CellType::Double: return qint64(std::bit_cast<double>(get<quint64>(c + 8)));
+    case CellType::Bool:   return get<quint64>(c + 8) ? 1 : 0;
+    default:               return 0;
+    }
+}
+
+double GameDataCache::Table::number(int row, int column) const {
+    const uchar* c = cell(row, column);
+    if (c && CellType(get<quint32>(c)) == CellType::Double) {
+        return std::bit_cast<double>(get<quint64>(c + 8));
+    }
+    return double(integer(row, column));
+}
+
+bool GameDataCache::Table::boolean(int row, int column) const {
+    return integer(row, column) != 0;
+}
+
+QVariant GameDataCache::Table::value(int row, int column) const {
+    const CellType t = type(row, column);
+    switch (t) {
+    case CellType::String: return text(row, column).toString();
+    case CellType::Int:
+    case CellType::Double: {
+        // Numbers come back as the same QMetaType the loader produced (int from CSV, double from JSON)
+        QVariant v = (t == CellType::Int) ? QVariant(integer(row, column)) : QVariant(number(row, column));
+        const int typeId = int(get<quint32>(cell(row, column) + 4));
+        if (typeId != v.typeId()) v.convert(QMetaType(typeId));
+        return v;
+    }
+    case CellType::Bool:   return boolean(row, column);
+    case CellType::Json: {
+        const QUtf8StringView json = text(row, column);
+        return QJsonDocument::fromJson(QByteArray(json.data(), json.size())).toVariant();
+    }
+    case CellType::Null:
+    case CellType::Missing:
+        break;
+    }
+    return QVariant();
+}
+
+QList<QVariantMap> GameDataCache::Table::toVariantMaps() const {
+    QList<QVariantMap> rows;
+    if (!isValid()) return rows;
+
+    // 1. Column names once, not per row
+    QStringList names;
+    names.reserve(m_columns);
+    for (int c = 0; c < m_columns; ++c) names << columnName(c);
+
+    rows.reserve(m_rows);
+    for (int r = 0; r < m_rows; ++r) {
+        QVariantMap map;
+        for (int c = 0; c < m_columns; ++c) {
+            if (type(r, c) != CellType::Missing) map.insert(names[c], value(r, c));
+        }
+        rows.append(map);
+    }
+    return rows;
+}
+
+//----------------------------------------------------------------------
+// Reading
+//----------------------------------------------------------------------
+
+GameDataCache::~GameDataCache() {
+    close();
+}
+
+void GameDataCache::close() {
+    if (m_data && m_fallback.isEmpty()) m_file.unmap(const_cast<uchar*>(m_data));
+    m_file.close();
+    m_fallback.clear();
+    m_data = m_payload = m_strings = m_tables = nullptr;
+    m_size = 0;
+    m_stringsSize = 0;
+    m_tableCount = 0;
+}
+
+bool GameDataCache::fail(const QString& reason) {
+    close();
+    m_error = reason;
+    return false;
+}
+
+QUtf8StringView GameDataCache::string(quint32 offset, quint32 size) const {
+    if (qint64(offset) + size > m_stringsSize) return {};
+    return QUtf8StringView(reinterpret_cast<const char*>(m_strings + offset), size);
+}
+
+bool GameDataCache::open(const QString& cachePath, const QStringList& sources) {
+    close();
+    m_error.clear();
+
+    m_file.setFileName(cachePath);
+    if (!m_file.open(QIODevice::ReadOnly)) return fail("no cache file");
+
+    // 1. Map the whole file
+    m_size = m_file.size();
+    if (m_size < HEADER_SIZE) return fail("truncated header");
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_fallback = m_file.readAll();
+        m_data = reinterpret_cast<const uchar*>(m_fallback.constData());
+    }
+
+    // 2. Header and checksum
+    if (std::memcmp(m_data, MAGIC, sizeof(MAGIC)) != 0) return fail("bad magic");
+    if (get<quint32>(m_data + 4) != FORMAT_VERSION) return fail("format version changed");
+    const quint32 payloadSize = get<quint32>(m_data + 8);
+    if (qint64(payloadSize) != m_size - HEADER_SIZE) return fail("size mismatch");
+    m_payload = m_data + HEADER_SIZE;
+    if (Crc32::compute(m_payload, payloadSize) != get<quint32>(m_data + 12)) return fail("checksum mismatch");
+
+    const quint32 sourceCount = get<quint32>(m_data + 16);
+    const quint32 tableCount = get<quint32>(m_data + 20);
+    const quint32 stringsOffset = get<quint32>(m_data + 24);
+    m_stringsSize = get<quint32>(m_data + 28);
+    if (qint64(stringsOffset) + m_stringsSize > payloadSize
+        || qint64(sourceCount) * SOURCE_SIZE + qint64(tableCount) * TABLE_SIZE > stringsOffset) {
+        return fail("corrupt directory");
+    }
+    m_strings = m_payload + stringsOffset;
+
+    // 3. Same sources, none modified since the cache was written
+    if (sourceCount != quint32(sources.size())) return fail("source list changed");
+    for (quint32 i = 0; i < sourceCount; ++i) {
+        const uchar* s = m_payload + i * SOURCE_SIZE;
+        if (!sameText(string(get<quint32>(s), get<quint32>(s + 4)), sources[i].toUtf8())) {
+            return fail("source list changed");
+        }
+        if (sourceTime(sources[i]) > get<qint64>(s + 8)) {
+            return fail(sources[i] + " is newer than the cache");
+        }
+    }
+
+    // 4. Every table's columns and cells must lie before the string pool
+    m_tables = m_payload + sourceCount * SOURCE_SIZE;
+    m_tableCount = int(tableCount);
+    for (int t = 0; t < m_tableCount; ++t) {
+        const uchar* e = m_tables + t * TABLE_SIZE;
+        const qint64 rows = get<quint32>(e + 8), columns = get<quint32>(e + 12);
+        if (get<quint32>(e + 16) + columns * COLUMN_SIZE > stringsOffset
+            || get<quint32>(e + 20) + rows * columns * CELL_SIZE > stringsOffset) {
+            return fail("corrupt table directory");
+        }
+    }
+    return true;
+}
+
+GameDataCache::Table GameDataCache::table(int index) const {
+    Table view;
+    if (!isOpen() || index < 0 || index >= m_tableCount) return view;
+    const uchar* e = m_tables + index * TABLE_SIZE;
+    view.m_cache = this;
+    view.m_nameOffset = get<quint32>(e);
+    view.m_nameSize = get<quint32>(e + 4);
+    view.m_rows = int(get<quint32>(e + 8));
+    view.m_columns = int(get<quint32>(e + 12));
+    view.m_columnRefs = m_payload + get<quint32>(e + 16);
+    view.m_cells = m_payload + get<quint32>(e + 20);
+    return view;
+}
+
+GameDataCache::Table GameDataCache::table(const QString& name) const {
+    const QByteArray utf8 = name.toUtf8();
+    for (int t = 0; t < m_tableCount; ++t) {
+        const uchar* e = m_tables + t * TABLE_SIZE;
+        if (sameText(string(get<quint32>(e), get<quint32>(e + 4)), utf8)) return table(t);
+    }
+    return Table();
+}
+
+//----------------------------------------------------------------------
+// Writing
+//----------------------------------------------------------------------
+
+bool GameDataCache::write(const QString& cachePath, const QStringList& sources,
+                          const QList<TableSource>& tables, QString* error) {
+    StringPool pool;
+    QByteArray sourceBlock, tableBlock, body;
+    const qint64 bodyStart = qint64(sources.size()) * SOURCE_SIZE + qint64(tables.size()) * TABLE_SIZE;
+
+    // 1. Sources with their current modification times
+    for (const QString& source : sources) {
+        pool.put(sourceBlock, source.toUtf8());
+        put<qint64>(sourceBlock, sourceTime(source));
+    }
+
+    for (const TableSource& source : tables) {
+        const QList<QVariantMap>& rows = *source.rows;
+
+        // 2. Columns are the union of every row's keys, in first-seen order
+        QStringList columns;
+        QHash<QString, int> columnIndex;
+        for (const QVariantMap& row : rows) {
+            for (auto it = row.constBegin(); it != row.constEnd(); ++it) {
+                if (!columnIndex.contains(it.key())) {
+                    columnIndex.insert(it.key(), columns.size());
+                    columns << it.key();
+                }
+            }
+        }
+
+        pool.put(tableBlock, source.name.toUtf8());
+        put<quint32>(tableBlock, quint32(rows.size()));
+        put<quint32>(tableBlock, quint32(columns.size()));
+        put<quint32>(tableBlock, quint32(bodyStart + body.size()));
+        for (const QString& column : columns) pool.put(body, column.toUtf8());
+        put<quint32>(tableBlock, quint32(bodyStart + body.size()));
+
+        // 3. Cells, row-major
+        for (const QVariantMap& row : rows) {
+            for (const QString& column : columns) {
+                auto it = row.constFind(column);
+                if (it == row.constEnd()) {
+                    put<quint32>(body, quint32(CellType::Missing));
+                    put<quint32>(body, 0);
+                    put<quint64>(body, 0);
+                    continue;
+                }
+                const QVariant& v = it.value();
+                switch (v.typeId()) {
+                case QMetaType::QString:
+                    pool.putCell(body, CellType::String, v.toString().toUtf8());
+                    break;
+                case QMetaType::Bool:
+                    put<quint32>(body, quint32(CellType::Bool));
+                    put<quint32>(body, 0);
+                    put<quint64>(body, v.toBool() ? 1 : 0);
+                    break;
+                case QMetaType::Int:
+                case QMetaType::UInt:
+                case QMetaType::LongLong:
+                case QMetaType::ULongLong:
+                    put<quint32>(body, quint32(CellType::Int));
+                    put<quint32>(body, quint32(v.typeId())); // Restored by value()
+                    put<quint64>(body, quint64(v.toLongLong()));
+                    break;
+                case QMetaType::Double:
+                case QMetaType::Float:
+                    put<quint32>(body, quint32(CellType::Double));
+                    put<quint32>(body, quint32(v.typeId()));
+                    put<quint64>(body, std::bit_cast<quint64>(v.toDouble()));
+                    break;
+                default: {
+                    const QJsonValue json = QJsonValue::fromVariant(v);
+                    if (json.isArray()) {
+                        pool.putCell(body, CellType::Json, QJsonDocument(json.toArray()).toJson(QJsonDocument::Compact));
+                    } else if (json.isObject()) {
+                        pool.putCell(body, CellType::Json, QJsonDocument(json.toObject()).toJson(QJsonDocument::Compact));
+                    } else if (v.isNull() || json.isNull() || json.isUndefined()) {
+                        put<quint32>(body, quint32(CellType::Null));
+                        put<quint32>(body, 0);
+                        put<quint64>(body, 0);
+                    } else {
+                        pool.putCell(body, CellType::String, v.toString().toUtf8());
+                    }
+                    break;
+                }
+                }
+            }
+        }
+    }
+
+    // 4. Assemble: header, payload, checksum
+    QByteArray payload = sourceBlock + tableBlock + body;
+    const quint32 stringsOffset = quint32(payload.size());
+    payload.append(pool.bytes());
+
+    QByteArray header;
+    header.append(MAGIC, sizeof(MAGIC));
+    put<quint32>(header, FORMAT_VERSION);
+    put<quint32>(header, quint32(payload.size()));
+    put<quint32>(header, Crc32::compute(payload.constData(), payload.size()));
+    put<quint32>(header, quint32(sources.size()));
+    put<quint32>(header, quint32(tables.size()));
+    put<quint32>(header, stringsOffset);
+    put<quint32>(header, quint32(pool.bytes().size()));
+
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(header) != header.size()
+        || file.write(payload) != payload.size()
+        || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef GAMEDATACACHE_H
+#define GAMEDATACACHE_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QUtf8StringView>
+#include <QVariant>
+#include <QVariantMap>
+
+/**
+ * @brief Precompiled binary copy of the static game data (game info, spells,
+ * items, monsters) so startup doesn't re-parse JSON, Lua and CSV every launch.
+ *
+ * The cache is one little-endian file: a header (magic, format version,
+ * payload size, CRC-32 of the payload), the list of text sources it was built
+ * from with their modification times, a table directory, the cells and a
+ * de-duplicated UTF-8 string pool. open() memory-maps it and checks all of
+ * that; any mismatch, or a source that is newer than the cache, makes open()
+ * fail and the caller goes back to the text files and writes a fresh cache.
+ *
+ * Tables are read through Table views. Strings come back as views into the
+ * mapping; toVariantMaps() builds the QList<QVariantMap> the rest of the game
+ * uses, identical to what the text loaders produce.
+ */
+class GameDataCache {
+public:
+    static const quint32 FORMAT_VERSION = 1;
+
+    enum class CellType : quint32 {
+        Missing = 0, // Row has no such key
+        Null,
+        String,
+        Int,
+        Double,
+        Bool,
+        Json         // Nested list/map, stored as compact JSON text
+    };
+
+    class Table {
+    public:
+        bool isValid() const { return m_cache != nullptr; }
+        QString name() const;
+        int rowCount() const { return m_rows; }
+        int columnCount() const { return m_columns; }
+        QString columnName(int column) const;
+        int columnIndex(QUtf8StringView name) const;
+
+        CellType type(int row, int column) const;
+        QUtf8StringView text(int row, int column) const; // String and Json cells
+        qint64 integer(int row, int column) const;
+        double number(int row, int column) const;        // Int or Double cells
+        bool boolean(int row, int column) const;
+        QVariant value(int row, int column) const;
+
+        QList<QVariantMap> toVariantMaps() const;
+
+    private:
+        friend class GameDataCache;
+        const GameDataCache* m_cache = nullptr;
+        quint32 m_nameOffset = 0, m_nameSize = 0;
+        int m_rows = 0;
+        int m_columns = 0;
+        const uchar* m_columnRefs = nullptr;
+        const uchar* m_cells = nullptr;
+
+        const uchar* cell(int row, int column) const;
+    };
+
+    // What write() stores: a name and the rows to keep under it
+    struct TableSource {
+        QString name;
+        const QList<QVariantMap>* rows;
+    };
+
+    GameDataCache() = default;
+    ~GameDataCache();
+    GameDataCache(const GameDataCache&) = delete;
+    GameDataCache& operator=(const GameDataCache&) = delete;
+
+    // Maps and validates 'cachePath'. 'sources' must be the same list the cache was written with.
+    bool open(const QString& cachePath, const QStringList& sources);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_error; }
+
+    int tableCount() const { return m_tableCount; }
+    Table table(int index) const;
+    Table table(const QString& name) const;
+
+    static bool write(const QString& cachePath, const QStringList& sources,
+                      const QList<TableSource>& tables, QString* error = nullptr);
+
+private:
+    bool fail(const QString& reason);
+    QUtf8StringView string(quint32 offset, quint32 size) const;
+
+    QFile m_file;
+    QByteArray m_fallback;           // Used when the file can't be mapped
+    const uchar* m_data = nullptr;   // Whole file
+    qint64 m_size = 0;
+    const uchar* m_payload = nullptr;
+    const uchar* m_strings = nullptr;
+    quint32 m_stringsSize = 0;
+    const uchar* m_tables = nullptr;
+    int m_tableCount = 0;
+    QString m_error;
+};
+
+#endif // GAMEDATACACHE_H
@@ -0,0 +1,128 @@
+#ifndef GAMESTATESTORE_H
+#define GAMESTATESTORE_H
+
+#include <QString>
+#include <QVariant>
+#include <QHash>
+#include <QtGlobal>
+#include <array>
+
+/**
+ * @brief Compile-time handles for the game values that are read and written
+ * on every dungeon step.
+ *
+ * Everything listed here lives in flat POD storage inside GameStateStore
+ * instead of the string-keyed QVariantMap. The enum order must match
+ * KEY_NAMES below, which is also the string used by the legacy
+ * getGameValue()/setGameValue() API.
+ */
+namespace GameState {
+
+    enum class Key : int {
+        DungeonX,
+        DungeonY,
+        DungeonLevel,
+        CurrentCharacterHP,
+        MaxCharacterHP,
+        CurrentCharacterLevel,
+        CurrentCharacterGold,
+        CurrentCharacterExperience,
+        PlayerGold,
+        PlayerExperience,
+        ActiveCharacterIndex,
+        WorldSeed,
+        Count
+    };
+
+    constexpr int KEY_COUNT = static_cast<int>(Key::Count);
+
+    constexpr const char* KEY_NAMES[KEY_COUNT] = {
+        "DungeonX",
+        "DungeonY",
+        "DungeonLevel",
+        "CurrentCharacterHP",
+        "MaxCharacterHP",
+        "CurrentCharacterLevel",
+        "CurrentCharacterGold",
+        "CurrentCharacterExperience",
+        "PlayerGold",
+        "PlayerExperience",
+        "ActiveCharacterIndex",
+        "WorldSeed"
+    };
+
+    constexpr int index(Key key) { return static_cast<int>(key); }
+
+} // namespace GameState
+
+/**
+ * @brief Flat, typed storage for the hot game values.
+ *
+ * Values are plain qint64 slots indexed by GameState::Key, so a typed read is
+ * an array access with no hashing and no QVariant boxing. A bitmask remembers
+ * which slots were ever assigned so the string shim can still hand back an
+ * invalid QVariant for keys that were never set (matching the old map).
+ */
+class GameStateStore {
+public:
+    qint64 value(GameState::Key key) const {
+        return m_values[GameState::index(key)];
+    }
+
+    // Returns true if the stored value actually changed.
+    bool set(GameState::Key key, qint64 value) {
+        const int i = GameState::index(key);
+        const quint32 bit = 1u << i;
+        if ((m_assigned & bit) && m_values[i] == value) return false;
+        m_values[i] = value;
+        m_assigned |= bit;
+        return true;
+    }
+
+    bool isAssigned(GameState::Key key) const {
+        return (m_assigned & (1u << GameState::index(key))) != 0;
+    }
+
+    QVariant toVariant(GameState::Key key) const {
+        return isAssigned(key) ? QVariant(value(key)) : QVariant();
+    }
+
+    void clear() {
+        m_values.fill(0);
+        m_assigned = 0;
+    }
+
+    // Shared QString for each key, built once so signals never allocate.
+    static const QString& keyName(GameState::Key key) {
+        static const std::array<QString, GameState::KEY_COUNT> names = [] {
+            std::array<QString, GameState::KEY_COUNT> n;
+            for (int i = 0; i < GameState::KEY_COUNT; ++i) {
+                n[i] = QString::fromLatin1(GameState::KEY_NAMES[i]);
+            }
+            return n;
+        }();
+        return names[GameState::index(key)];
+    }
+
+    // Maps a legacy string key to its typed handle (used by the compatibility shim).
+    static bool lookup(const QString& name, GameState::Key& out) {
+        static const QHash<QString, GameState::Key> table = [] {
+            QHash<QString, GameState::Key> t;
+            for (int i = 0; i < GameState::KEY_COUNT; ++i) {
+                t.insert(QString::fromLatin1(GameState::KEY_NAMES[i]), static_cast<GameState::Key>(i));
+            }
+            return t;
+        }();
+        auto it = table.constFind(name);
+        if (it == table.constEnd()) return false;
+        out = it.value();
+        return true;
+    }
+
+private:
+    static_assert(GameState::KEY_COUNT <= 32, "m_assigned is a 32-bit mask");
+    std::array<qint64, GameState::KEY_COUNT> m_values{};
+    quint32 m_assigned = 0;
+};
+
+#endif // GAMESTATESTORE_H
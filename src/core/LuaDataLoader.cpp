@@ -0,0 +1,161 @@
+#include "LuaDataLoader.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QVariantMap>
+
+// Library functions a data file may call; everything else (io, os, require, load, ...) is absent
+static const char* const SAFE_GLOBALS[] = {
+    "assert", "error", "ipairs", "next", "pairs", "pcall", "rawequal", "rawget", "rawlen",
+    "select", "tonumber", "tostring", "type", "math", "string", "table", "utf8"
+};
+
+// __newindex of a library proxy
+static int refuseLibraryWrite(lua_State* L) {
+    return luaL_error(L, "attempt to modify a read-only library table");
+}
+
+// __pairs of a library proxy: iterates the real library table (upvalue 1)
+static int pairsOfLibrary(lua_State* L) {
+    lua_getglobal(L, "next");
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_pushnil(L);
+    return 3;
+}
+
+// Replaces the library table on top of the stack with an empty proxy that reads through to it and refuses writes
+static void wrapReadOnly(lua_State* L) {
+    lua_newtable(L);                   // lib, proxy
+    lua_createtable(L, 0, 4);          // lib, proxy, meta
+    lua_pushvalue(L, -3);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, refuseLibraryWrite);
+    lua_setfield(L, -2, "__newindex");
+    lua_pushvalue(L, -3);
+    lua_pushcclosure(L, pairsOfLibrary, 1);
+    lua_setfield(L, -2, "__pairs");
+    lua_pushboolean(L, 0);
+    lua_setfield(L, -2, "__metatable");
+    lua_setmetatable(L, -2);
+    lua_remove(L, -2);                 // proxy
+}
+
+LuaDataLoader::LuaDataLoader(lua_Alloc alloc, void* allocData)
+{
+    m_L = alloc ? lua_newstate(alloc, allocData, luaL_makeseed(nullptr)) : luaL_newstate();
+    // Only the libraries data files may use; io, os, debug and package are never opened
+    luaL_openselectedlibs(m_L, LUA_GLIBK | LUA_MATHLIBK | LUA_STRLIBK | LUA_TABLIBK | LUA_UTF8LIBK, 0);
+
+    // 1. Copy the safe subset of the globals into their own table. The library tables are shared by
+    //    every file this VM loads, so files only get read-only proxies of them (string.format = nil
+    //    in one file must not break the next)
+    lua_newtable(m_L);
+    for (const char* name : SAFE_GLOBALS) {
+        if (lua_getglobal(m_L, name) == LUA_TTABLE) wrapReadOnly(m_L);
+        lua_setfield(m_L, -2, name);
+    }
+
+    // 2. The metatable every file environment shares: unknown names fall back to that table
+    lua_newtable(m_L);
+    lua_insert(m_L, -2);
+    lua_setfield(m_L, -2, "__index");
+    m_envMetaRef = luaL_ref(m_L, LUA_REGISTRYINDEX);
+}
+
+LuaDataLoader::~LuaDataLoader() {
+    lua_close(m_L);
+}
+
+LuaDataLoader& LuaDataLoader::forThisThread() {
+    thread_local LuaDataLoader loader;
+    return loader;
+}
+
+bool LuaDataLoader::pushTable(const QString& path, const char* table) {
+    const int top = lua_gettop(m_L);
+
+    // 1. Compile; text only, a precompiled chunk could do anything
+    if (luaL_loadfilex(m_L, QFile::encodeName(path).constData(), "t") != LUA_OK) {
+        qWarning() << "LUA ERROR (File):" << lua_tostring(m_L, -1)
+                   << "in" << QDir::current().absoluteFilePath(path);
+        lua_settop(m_L, top);
+        return false;
+    }
+
+    // 2. Fresh environment for this file; its globals land in there, not in the VM
+    lua_newtable(m_L);
+    lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_envMetaRef);
+    lua_setmetatable(m_L, -2);
+    lua_pushvalue(m_L, -1);
+    lua_insert(m_L, -3);               // env, chunk, env
+    lua_setupvalue(m_L, -2, 1);        // The main chunk's only upvalue is _ENV
+
+    // 3. Run it and fetch the table it defined
+    if (lua_pcall(m_L, 0, 0, 0) != LUA_OK) {
+        qWarning() << "LUA ERROR (File):" << lua_tostring(m_L, -1);
+        lua_settop(m_L, top);
+        return false;
+    }
+    lua_getfield(m_L, -1, table);
+    if (!lua_istable(m_L, -1)) {
+        qWarning() << "LUA ERROR: Table" << table << "not found in" << path;
+        lua_settop(m_L, top);
+        return false;
+    }
+    lua_remove(m_L, -2);               // Drop the environment, keep the table
+    return true;
+}
+
+QVariant LuaDataLoader::loadVariant(const QString& path, const char* table) {
+    if (!pushTable(path, table)) return QVariant();
+    QVariant result = toVariant(m_L, -1);
+    lua_pop(m_L, 1);
+    return result;
+}
+
+QVariant LuaDataLoader::toVariant(lua_State* L, int index) {
+    switch (lua_type(L, index)) {
+    case LUA_TNUMBER:
+        return lua_tonumber(L, index);
+    case LUA_TSTRING:
+        return QString::fromUtf8(lua_tostring(L, index));
+    case LUA_TBOOLEAN:
+        return bool(lua_toboolean(L, index));
+    case LUA_TTABLE: {
+        index = lua_absindex(L, index);
+
+        // 1. Keys 1..n and nothing else is a list
+        const lua_Unsigned length = lua_rawlen(L, index);
+        lua_Unsigned keys = 0;
+        lua_pushnil(L);
+        while (lua_next(L, index) != 0) {
+            ++keys;
+            lua_pop(L, 1);
+        }
+        if (keys == length) {
+            QVariantList list;
+            list.reserve(qsizetype(length));
+            for (lua_Unsigned i = 1; i <= length; ++i) {
+                lua_rawgeti(L, index, lua_Integer(i));
+                list.append(toVariant(L, -1));
+                lua_pop(L, 1);
+            }
+            return list;
+        }
+
+        // 2. Anything else is a map keyed by the string form of each key
+        QVariantMap map;
+        lua_pushnil(L);
+        while (lua_next(L, index) != 0) {
+            // Convert a copy; lua_tostring on the key itself would confuse lua_next
+            lua_pushvalue(L, -2);
+            const char* key = lua_tostring(L, -1);
+            if (key) map.insert(QString::fromUtf8(key), toVariant(L, -2));
+            lua_pop(L, 2);
+        }
+        return map;
+    }
+    default:
+        return QVariant();
+    }
+}
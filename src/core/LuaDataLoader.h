@@ -0,0 +1,197 @@
+#ifndef LUADATALOADER_H
+#define LUADATALOADER_H
+
+extern "C" {
+    #include "lua.h"
+    #include "lualib.h"
+    #include "lauxlib.h"
+}
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QtConcurrent>
+
+#include <functional>
+#include <type_traits>
+
+/**
+ * @brief Maps the fields of a Lua table onto the members of a C++ struct.
+ *
+ * A schema is a list of (Lua key, member) pairs built once, usually in a
+ * function-local static:
+ *
+ *     static const auto schema = LuaSchema<MonsterRecord>()
+ *         .field("Name", &MonsterRecord::name)
+ *         .field("HP", &MonsterRecord::hp, 0)
+ *         .nested("Stats", LuaSchema<MonsterRecord>().field("Str", &MonsterRecord::strength));
+ *
+ * read() looks each key up in the table and writes the converted value
+ * straight into the struct; nothing goes through a QVariant tree. A key that
+ * is missing (nil) leaves the member alone, or sets the fallback if the field
+ * was declared with one. Keys the schema doesn't list are ignored.
+ */
+template<typename T>
+class LuaSchema {
+public:
+    template<typename V>
+    LuaSchema& field(const char* key, V T::*member) {
+        m_fields.append({ key, [member](lua_State* L, T& out) {
+            if (!lua_isnil(L, -1)) readValue(L, -1, out.*member);
+        } });
+        return *this;
+    }
+
+    template<typename V>
+    LuaSchema& field(const char* key, V T::*member, std::type_identity_t<V> fallback) {
+        m_fields.append({ key, [member, fallback](lua_State* L, T& out) {
+            if (lua_isnil(L, -1)) out.*member = fallback;
+            else readValue(L, -1, out.*member);
+        } });
+        return *this;
+    }
+
+    // A sub-table whose keys map onto members of the same struct (e.g. Stats = { Str = 12 })
+    LuaSchema& nested(const char* key, const LuaSchema<T>& inner) {
+        m_fields.append({ key, [inner](lua_State* L, T& out) {
+            if (lua_istable(L, -1)) inner.read(L, -1, out);
+        } });
+        return *this;
+    }
+
+    // Reads the table at 'index' into 'out'. False if the value isn't a table.
+    bool read(lua_State* L, int index, T& out) const {
+        if (!lua_istable(L, index)) return false;
+        index = lua_absindex(L, index);
+        for (const Field& f : m_fields) {
+            lua_getfield(L, index, f.key);
+            f.read(L, out);
+            lua_pop(L, 1);
+        }
+        return true;
+    }
+
+    // Reads every element of the array at 'index', each starting from 'prototype'
+    QList<T> readList(lua_State* L, int index, const T& prototype = T()) const {
+        QList<T> rows;
+        if (!lua_istable(L, index)) return rows;
+        index = lua_absindex(L, index);
+        const lua_Unsigned count = lua_rawlen(L, index);
+        rows.reserve(qsizetype(count));
+        for (lua_Unsigned i = 1; i <= count; ++i) {
+            lua_rawgeti(L, index, lua_Integer(i));
+            T row = prototype;
+            if (read(L, -1, row)) rows.append(std::move(row));
+            lua_pop(L, 1);
+        }
+        return rows;
+    }
+
+private:
+    struct Field {
+        const char* key;
+        std::function<void(lua_State*, T&)> read; // Value to read is on top of the stack
+    };
+
+    static void readValue(lua_State* L, int index, int& out) {
+        out = lua_isinteger(L, index) ? int(lua_tointeger(L, index)) : qRound(lua_tonumber(L, index));
+    }
+    static void readValue(lua_State* L, int index, uint& out) {
+        out = lua_isinteger(L, index) ? uint(lua_tointeger(L, index)) : uint(qRound64(lua_tonumber(L, index)));
+    }
+    static void readValue(lua_State* L, int index, double& out) { out = lua_tonumber(L, index); }
+    static void readValue(lua_State* L, int index, bool& out) { out = lua_toboolean(L, index); }
+    static void readValue(lua_State* L, int index, QString& out) {
+        size_t length = 0;
+        const char* text = lua_tolstring(L, index, &length);
+        out = text ? QString::fromUtf8(text, qsizetype(length)) : QString();
+    }
+    static void readValue(lua_State* L, int index, QStringList& out) {
+        out.clear();
+        if (!lua_istable(L, index)) return;
+        index = lua_absindex(L, index);
+        const lua_Unsigned count = lua_rawlen(L, index);
+        out.reserve(qsizetype(count));
+        for (lua_Unsigned i = 1; i <= count; ++i) {
+            lua_rawgeti(L, index, lua_Integer(i));
+            QString item;
+            readValue(L, -1, item);
+            out.append(item);
+            lua_pop(L, 1);
+        }
+    }
+
+    QList<Field> m_fields;
+};
+
+/**
+ * @brief Loads data tables from Lua files (MonsterData.lua, character saves)
+ * on one long-lived Lua VM instead of a fresh lua_State per file.
+ *
+ * Each file runs in its own environment table, so a file's globals never
+ * leak into the next one. Environments can read a small set of safe library
+ * functions (string, table, math, pairs, ...) but not io, os, require or
+ * load; data files only build tables. The library tables are read-only
+ * proxies, since every environment shares them. Files are loaded as text only.
+ *
+ * A loader and its VM belong to one thread. forThisThread() keeps one per
+ * thread, and loadParallel() spreads several files over the global thread
+ * pool, one VM per worker.
+ */
+class LuaDataLoader {
+public:
+    // 'alloc' replaces Lua's allocator (used by luabench to measure the VM's memory)
+    explicit LuaDataLoader(lua_Alloc alloc = nullptr, void* allocData = nullptr);
+    ~LuaDataLoader();
+
+    LuaDataLoader(const LuaDataLoader&) = delete;
+    LuaDataLoader& operator=(const LuaDataLoader&) = delete;
+
+    // The calling thread's loader, created on first use
+    static LuaDataLoader& forThisThread();
+
+    // Runs 'path' in a fresh environment and pushes the global 'table' it defined.
+    // False, with nothing pushed, if the file fails or doesn't define that table.
+    bool pushTable(const QString& path, const char* table);
+
+    // The array 'table' in 'path', one struct per element
+    template<typename T>
+    QList<T> loadList(const QString& path, const char* table, const LuaSchema<T>& schema, const T& prototype = T()) {
+        if (!pushTable(path, table)) return {};
+        QList<T> rows = schema.readList(m_L, -1, prototype);
+        lua_pop(m_L, 1);
+        return rows;
+    }
+
+    // The single record 'table' in 'path'
+    template<typename T>
+    bool loadRecord(const QString& path, const char* table, const LuaSchema<T>& schema, T& out) {
+        if (!pushTable(path, table)) return false;
+        const bool ok = schema.read(m_L, -1, out);
+        lua_pop(m_L, 1);
+        return ok;
+    }
+
+    // The table as a QVariantMap/QVariantList tree, for data that has no schema
+    QVariant loadVariant(const QString& path, const char* table);
+
+    // Loads the same table from several files at once; results are in the order of 'paths'
+    template<typename T>
+    static QList<QList<T>> loadParallel(const QStringList& paths, const char* table, const LuaSchema<T>& schema) {
+        return QtConcurrent::blockingMapped<QList<QList<T>>>(paths, [table, &schema](const QString& path) {
+            return forThisThread().loadList(path, table, schema);
+        });
+    }
+
+    // Converts any Lua value to a QVariant; tables with keys 1..n become lists
+    static QVariant toVariant(lua_State* L, int index);
+
+    lua_State* state() const { return m_L; }
+
+private:
+    lua_State* m_L;
+    int m_envMetaRef = LUA_NOREF; // { __index = safe libraries }, shared by every environment
+};
+
+#endif // LUADATALOADER_H
@@ -0,0 +1,70 @@
+#ifndef LUARECORDS_H
+#define LUARECORDS_H
+
+#include "LuaDataLoader.h"
+#include "../../character.h"
+
+#include <QVariantMap>
+
+// Typed rows for the data the game loads from Lua, and the schemas that fill them.
+
+// One entry of Monsters = { ... } in data/MonsterData.lua
+struct MonsterRecord {
+    QString name;
+    int hp = 0;
+    int strength = 0;
+    int dexterity = 0;
+    QStringList loot;
+
+    static const LuaSchema<MonsterRecord>& schema() {
+        static const auto s = LuaSchema<MonsterRecord>()
+            .field("Name", &MonsterRecord::name)
+            .field("HP", &MonsterRecord::hp)
+            .nested("Stats", LuaSchema<MonsterRecord>()
+                .field("Str", &MonsterRecord::strength)
+                .field("Dex", &MonsterRecord::dexterity))
+            .field("Loot", &MonsterRecord::loot);
+        return s;
+    }
+
+    // Same shape the old QVariant loader produced, for code that still reads monster maps
+    QVariantMap toVariantMap() const {
+        return {
+            { "Name", name },
+            { "HP", hp },
+            { "Stats", QVariantMap{ { "Str", strength }, { "Dex", dexterity } } },
+            { "Loot", loot }
+        };
+    }
+};
+
+// SaveData = { ... } in data/characters/*.lua, with the same defaults as Character::loadFromMap()
+inline const LuaSchema<Character>& characterSaveSchema() {
+    static const auto s = LuaSchema<Character>()
+        .field("Name", &Character::name, QString())
+        .field("Race", &Character::race, QString())
+        .field("Age", &Character::age, 18)
+        .field("Level", &Character::level, 1)
+        .field("Experience", &Character::experience, 0)
+        .field("HP", &Character::hp, 0)
+        .field("MaxHP", &Character::maxHp, 0)
+        .field("Gold", &Character::gold, 0)
+        .field("Strength", &Character::strength, 0)
+        .field("Intelligence", &Character::intelligence, 0)
+        .field("Wisdom", &Character::wisdom, 0)
+        .field("Constitution", &Character::constitution, 0)
+        .field("Charisma", &Character::charisma, 0)
+        .field("Dexterity", &Character::dexterity, 0)
+        .field("Mana", &Character::mana, 0)
+        .field("MaxMana", &Character::maxMana, 0)
+        .field("StatusFlags", &Character::statusFlags, StatusFlag::None)
+        .field("DungeonLevel", &Character::dungeonLevel, 0)
+        .field("DungeonX", &Character::dungeonX, 0)
+        .field("DungeonY", &Character::dungeonY, 0)
+        .field("row", &Character::row, 0)
+        .field("WorldSeed", &Character::worldSeed, 0u)
+        .field("Inventory", &Character::inventory, QStringList());
+    return s;
+}
+
+#endif // LUARECORDS_H
@@ -0,0 +1,95 @@
+#include "LuaScriptCache.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+LuaScriptCache::LuaScriptCache(lua_State* L)
+    : m_L(L)
+{
+}
+
+LuaScriptCache::~LuaScriptCache() {
+    clear();
+}
+
+void LuaScriptCache::clear() {
+    for (const Script& script : std::as_const(m_scripts)) luaL_unref(m_L, LUA_REGISTRYINDEX, script.ref);
+    for (int ref : std::as_const(m_chunks)) luaL_unref(m_L, LUA_REGISTRYINDEX, ref);
+    m_scripts.clear();
+    m_chunks.clear();
+    m_chunkOrder.clear();
+}
+
+bool LuaScriptCache::push(const QString& path) {
+    Script& script = m_scripts[path];
+
+    // 1. Only look at the file again once the recheck interval has passed
+    if (script.ref == LUA_NOREF || !script.checked.isValid() || script.checked.hasExpired(m_recheckMs)) {
+        const QFileInfo info(path);
+        const QDateTime modified = info.lastModified();
+        const qint64 size = info.size();
+        script.checked.start();
+
+        // 2. New or changed on disk: compile and replace the registry entry
+        if (script.ref == LUA_NOREF || modified != script.modified || size != script.size) {
+            if (luaL_loadfile(m_L, QFile::encodeName(path).constData()) != LUA_OK) {
+                qWarning() << "Lua Load Error:" << lua_tostring(m_L, -1);
+                lua_pop(m_L, 1);
+                // Keep the last good version, if there is one
+                if (script.ref != LUA_NOREF) {
+                    lua_rawgeti(m_L, LUA_REGISTRYINDEX, script.ref);
+                    return true;
+                }
+                m_scripts.remove(path);
+                return false;
+            }
+            luaL_unref(m_L, LUA_REGISTRYINDEX, script.ref);
+            lua_pushvalue(m_L, -1);
+            script.ref = luaL_ref(m_L, LUA_REGISTRYINDEX);
+            script.modified = modified;
+            script.size = size;
+            ++m_compiles;
+            return true;
+        }
+    }
+
+    // 3. Cached
+    lua_rawgeti(m_L, LUA_REGISTRYINDEX, script.ref);
+    return true;
+}
+
+bool LuaScriptCache::run(const QString& path, int results) {
+    if (!push(path)) return false;
+    return call(results);
+}
+
+bool LuaScriptCache::runChunk(const QByteArray& source, const char* chunkName, bool quiet) {
+    auto it = m_chunks.constFind(source);
+    if (it != m_chunks.constEnd()) {
+        lua_rawgeti(m_L, LUA_REGISTRYINDEX, it.value());
+    } else {
+        // Text that doesn't compile is not cached; it is usually chat, not code
+        if (luaL_loadbufferx(m_L, source.constData(), size_t(source.size()), chunkName, "t") != LUA_OK) {
+            if (!quiet) qWarning() << "Lua Load Error:" << lua_tostring(m_L, -1);
+            lua_pop(m_L, 1);
+            return false;
+        }
+        if (m_chunkOrder.size() >= MAX_CHUNKS) {
+            luaL_unref(m_L, LUA_REGISTRYINDEX, m_chunks.take(m_chunkOrder.takeFirst()));
+        }
+        lua_pushvalue(m_L, -1);
+        m_chunks.insert(source, luaL_ref(m_L, LUA_REGISTRYINDEX));
+        m_chunkOrder.append(source);
+        ++m_compiles;
+    }
+    return call(0);
+}
+
+bool LuaScriptCache::call(int results) {
+    if (lua_pcall(m_L, 0, results, 0) != LUA_OK) {
+        qWarning() << "Lua Error:" << lua_tostring(m_L, -1);
+        lua_pop(m_L, 1); // Remove error message
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef LUASCRIPTCACHE_H
+#define LUASCRIPTCACHE_H
+
+extern "C" {
+    #include "lua.h"
+    #include "lauxlib.h"
+}
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Compiles each Lua script once and keeps the compiled chunk in the
+ * Lua registry, so running it again is a single lua_pcall instead of a
+ * luaL_dofile that re-reads and re-parses the file.
+ *
+ * A script is recompiled when its modification time or size changes, so
+ * editing a script while the game runs still takes effect. The file is
+ * stat'ed at most once per recheck interval (1 s by default) to keep that
+ * check out of hot loops.
+ *
+ * runChunk() does the same for source text that doesn't come from a file
+ * (lines from the Lua server). Those are keyed by their text and the cache
+ * keeps the most recent MAX_CHUNKS of them.
+ *
+ * Not thread-safe; use it from the thread that owns the lua_State, and
+ * destroy it before lua_close().
+ */
+class LuaScriptCache {
+public:
+    static const int MAX_CHUNKS = 64;
+
+    explicit LuaScriptCache(lua_State* L);
+    ~LuaScriptCache();
+
+    LuaScriptCache(const LuaScriptCache&) = delete;
+    LuaScriptCache& operator=(const LuaScriptCache&) = delete;
+
+    // Runs the script at 'path', leaving 'results' values on the stack.
+    // On a load or runtime error it logs, leaves the stack as it was and returns false.
+    bool run(const QString& path, int results = 0);
+
+    // Pushes the compiled script without running it; false (and nothing pushed) if it won't load
+    bool push(const QString& path);
+
+    // Runs a piece of Lua source. 'quiet' suppresses the warning for text that isn't Lua.
+    bool runChunk(const QByteArray& source, const char* chunkName = "=chunk", bool quiet = false);
+
+    // Drops every compiled chunk; the next run() reloads from disk
+    void clear();
+
+    void setRecheckInterval(int ms) { m_recheckMs = ms; }
+    int compileCount() const { return m_compiles; }
+
+private:
+    struct Script {
+        int ref = LUA_NOREF;
+        QDateTime modified;
+        qint64 size = -1;
+        QElapsedTimer checked;
+    };
+
+    bool call(int results);
+
+    lua_State* m_L;
+    QHash<QString, Script> m_scripts;
+    QHash<QByteArray, int> m_chunks;  // Source text -> registry ref
+    QList<QByteArray> m_chunkOrder;   // Oldest first, for eviction
+    int m_recheckMs = 1000;
+    int m_compiles = 0;
+};
+
+#endif // LUASCRIPTCACHE_H
@@ -0,0 +1,157 @@
+#include "SaveContainer.h"
+#include "Crc32.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+// --- File layout (all little-endian) ---
+//
+// Header, 16 bytes:
+//   0  char[4]  "BLSV"
+//   4  quint32  format version
+//   8  quint32  section count
+//  12  quint32  CRC-32 of the section table
+// Section table, 20 bytes per section:
+//      quint32 id, quint32 schema version, quint32 offset (from file start), quint32 size, quint32 CRC-32 of the data
+// Section data, back to back in table order
+namespace {
+    const char MAGIC[4] = { 'B', 'L', 'S', 'V' };
+    const int HEADER_SIZE = 16;
+    const int ENTRY_SIZE = 20;
+    const quint32 MAX_SECTIONS = 1024; // Anything larger is a corrupt header, not a save
+
+    template<typename T>
+    T get(const uchar* p) { return qFromLittleEndian<T>(p); }
+
+    template<typename T>
+    void put(QByteArray& out, T value) {
+        const T le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+    }
+}
+
+QByteArray SaveContainer::serialize(const QList<Section>& sections) {
+    // 1. Table, with offsets past the header and the table itself
+    QByteArray table;
+    quint32 offset = quint32(HEADER_SIZE + sections.size() * ENTRY_SIZE);
+    qsizetype total = offset;
+    for (const Section& section : sections) {
+        put<quint32>(table, section.id);
+        put<quint32>(table, section.version);
+        put<quint32>(table, offset);
+        put<quint32>(table, quint32(section.data.size()));
+        put<quint32>(table, Crc32::compute(section.data.constData(), section.data.size()));
+        offset += quint32(section.data.size());
+        total += section.data.size();
+    }
+
+    // 2. Header, table, data
+    QByteArray out;
+    out.reserve(total);
+    out.append(MAGIC, sizeof(MAGIC));
+    put<quint32>(out, FORMAT_VERSION);
+    put<quint32>(out, quint32(sections.size()));
+    put<quint32>(out, Crc32::compute(table.constData(), table.size()));
+    out.append(table);
+    for (const Section& section : sections) out.append(section.data);
+    return out;
+}
+
+bool SaveContainer::write(const QString& path, const QList<Section>& sections, QString* error) {
+    const QByteArray bytes = serialize(sections);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(bytes) != bytes.size()
+        || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SaveContainer::fail(const QString& reason) {
+    close();
+    m_error = reason;
+    return false;
+}
+
+void SaveContainer::close() {
+    m_file.close();
+    m_entries.clear();
+}
+
+bool SaveContainer::open(const QString& path) {
+    close();
+    m_error.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return fail("no save file");
+
+    // 1. Header
+    const QByteArray header = m_file.read(HEADER_SIZE);
+    if (header.size() != HEADER_SIZE) return fail("truncated header");
+    const uchar* h = reinterpret_cast<const uchar*>(header.constData());
+    if (std::memcmp(h, MAGIC, sizeof(MAGIC)) != 0) return fail("bad magic");
+    if (get<quint32>(h + 4) > FORMAT_VERSION) return fail("save is from a newer format version");
+    const quint32 count = get<quint32>(h + 8);
+    if (count > MAX_SECTIONS) return fail("corrupt header");
+
+    // 2. Section table, checksummed as a whole
+    const QByteArray table = m_file.read(qint64(count) * ENTRY_SIZE);
+    if (table.size() != qsizetype(count) * ENTRY_SIZE) return fail("truncated section table");
+    if (Crc32::compute(table.constData(), table.size()) != get<quint32>(h + 12)) return fail("section table checksum mismatch");
+
+    const qint64 fileSize = m_file.size();
+    const uchar* t = reinterpret_cast<const uchar*>(table.constData());
+    for (quint32 i = 0; i < count; ++i, t += ENTRY_SIZE) {
+        Entry entry { get<quint32>(t), get<quint32>(t + 4), get<quint32>(t + 8), get<quint32>(t + 12), get<quint32>(t + 16) };
+        if (qint64(entry.offset) + entry.size > fileSize) return fail("section " + tagName(entry.id) + " runs past the end of the file");
+        m_entries.append(entry);
+    }
+    return true;
+}
+
+const SaveContainer::Entry* SaveContainer::find(quint32 id) const {
+    for (const Entry& entry : m_entries) {
+        if (entry.id == id) return &entry;
+    }
+    return nullptr;
+}
+
+quint32 SaveContainer::version(quint32 id) const {
+    const Entry* entry = find(id);
+    return entry ? entry->version : 0;
+}
+
+QList<quint32> SaveContainer::sectionIds() const {
+    QList<quint32> ids;
+    for (const Entry& entry : m_entries) ids.append(entry.id);
+    return ids;
+}
+
+bool SaveContainer::read(quint32 id, QByteArray& data) {
+    const Entry* entry = find(id);
+    if (!entry) {
+        m_error = "no section " + tagName(id);
+        return false;
+    }
+    if (!m_file.seek(entry->offset)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    data = m_file.read(entry->size);
+    if (data.size() != qsizetype(entry->size)) {
+        m_error = "section " + tagName(id) + " is truncated";
+        return false;
+    }
+    if (Crc32::compute(data.constData(), data.size()) != entry->crc) {
+        m_error = "section " + tagName(id) + " checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+QString SaveContainer::tagName(quint32 id) {
+    const char name[4] = { char(id & 0xFF), char((id >> 8) & 0xFF), char((id >> 16) & 0xFF), char((id >> 24) & 0xFF) };
+    return QString::fromLatin1(name, 4);
+}
@@ -0,0 +1,72 @@
+#ifndef SAVECONTAINER_H
+#define SAVECONTAINER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Binary save file: a small header, a section table and the sections
+ * themselves, each section with its own id, schema version and CRC-32.
+ *
+ * Writing goes through QSaveFile, so a save is replaced atomically. Reading
+ * only loads the header and table on open(); read() then seeks to one
+ * section and checks its CRC, so a loader pulls exactly what it needs and
+ * skips ids it doesn't know (a save from a newer build still loads).
+ *
+ * What a section contains is up to the caller; the game stores QDataStream
+ * payloads (see gameStateManager::encodeBinarySave()).
+ */
+class SaveContainer {
+public:
+    static const quint32 FORMAT_VERSION = 1;
+
+    // Four-character section ids, e.g. tag("PRTY")
+    static constexpr quint32 tag(const char (&id)[5]) {
+        return quint32(uchar(id[0])) | quint32(uchar(id[1])) << 8 | quint32(uchar(id[2])) << 16 | quint32(uchar(id[3])) << 24;
+    }
+
+    struct Section {
+        quint32 id = 0;
+        quint32 version = 1;   // Schema version of this section's payload
+        QByteArray data;
+    };
+
+    // Header + table + sections as one buffer (what write() puts on disk)
+    static QByteArray serialize(const QList<Section>& sections);
+    static bool write(const QString& path, const QList<Section>& sections, QString* error = nullptr);
+
+    // Reads and checks the header and section table; sections are read on demand
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_error; }
+
+    bool contains(quint32 id) const { return find(id) != nullptr; }
+    quint32 version(quint32 id) const;   // 0 if missing
+    QList<quint32> sectionIds() const;
+
+    // Loads one section and verifies its checksum
+    bool read(quint32 id, QByteArray& data);
+
+    static QString tagName(quint32 id);
+
+private:
+    struct Entry {
+        quint32 id;
+        quint32 version;
+        quint32 offset;   // From the start of the file
+        quint32 size;
+        quint32 crc;
+    };
+
+    const Entry* find(quint32 id) const;
+    bool fail(const QString& reason);
+
+    QFile m_file;
+    QList<Entry> m_entries;
+    QString m_error;
+};
+
+#endif // SAVECONTAINER_H
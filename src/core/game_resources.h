@@ -2,6 +2,11 @@
 #define GAME_RESOURCES_H
 
 #include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
 #include <QPixmap>
 #include <QString>
 #include <QDebug>
@@ -11,6 +16,11 @@
  * @brief Manages all game-related assets (images/pixmaps).
  *
  * It uses a static pattern for single-point access and lazy loading.
+ *
+ * Both caches are guarded by one mutex, so lookups are safe while LoadingScreen
+ * is still filling them. The background loader decodes QImages on worker
+ * threads (decodeImage()) and hands them to adoptImages() on the GUI thread,
+ * which is the only place QPixmaps are created.
  */
 class GameResources {
 public:
@@ -20,6 +30,7 @@ public:
      * @return The requested QPixmap. Returns a null QPixmap if not found.
      */
     static QPixmap getPixmap(const QString& key) {
+        QMutexLocker locker(&s_mutex);
         // Lazy initialization: Load resources only on the first call
         if (s_resources.isEmpty()) {
             loadResources();
@@ -35,6 +46,7 @@ public:
      * This function should be called once during game startup.
      */
     static void loadAllResources() {
+        QMutexLocker locker(&s_mutex);
         if (s_resources.isEmpty()) {
             _loadResources();
         } else {
@@ -42,49 +54,119 @@ public:
         }
     }
 
-private:
-    // Declaration of the static storage container (must be defined in a .cpp file)
-    static QHash<QString, QPixmap> s_resources;
-
-/**
-     * @brief Internal function to handle the resource loading logic from the file system.
+    /**
+     * @brief Loads an image from disk once and returns it scaled to the given size.
+     *
+     * Results are cached per (path, size), so repeated calls (e.g. from the
+     * minimap on every step) never touch the disk or rescale again. A missing
+     * file is cached as a null QPixmap and only reported once.
      */
-    static void _loadResources() {
-        // --- 1. Define the base path for your resources ---
-        // IMPORTANT: This path is RELATIVE to where your executable is run from.
-        // A common setup places the assets folder next to the executable.
-        const QString RESOURCE_PATH = "resources/images/";
+    static QPixmap getScaledPixmap(const QString& path, int width, int height) {
+        const QString key = QString("%1@%2x%3").arg(path).arg(width).arg(height);
+        QMutexLocker locker(&s_mutex);
+        auto it = s_scaledResources.constFind(key);
+        if (it != s_scaledResources.constEnd()) {
+            return it.value();
+        }
 
-        QDir dir(RESOURCE_PATH);
+        QPixmap source(path);
+        QPixmap scaled;
+        if (source.isNull()) {
+            qWarning() << "Failed to load image:" << path;
+        } else {
+            scaled = source.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        s_scaledResources.insert(key, scaled);
+        return scaled;
+    }
+
+    // --- Background loading (see LoadingScreen) ---
+
+    // One image to load: its lookup key and file path
+    struct ImageJob {
+        QString key;
+        QString path;
+    };
 
-        // Check if the directory is valid before proceeding
+    /**
+     * @brief Lists every image loadAllResources() loads, in the same order.
+     *
+     * Keys are file names without the extension; when two files share a key
+     * the later one wins, as it does in loadAllResources().
+     */
+    static QList<ImageJob> imageJobs() {
+        QList<ImageJob> jobs;
+        QDir dir(RESOURCE_PATH);
         if (!dir.exists()) {
             qWarning() << "CRITICAL: Resource directory not found:" << QDir::currentPath() + "/" + RESOURCE_PATH;
-            return;
+            return jobs;
         }
 
-        // --- 2. Set up filters for common image files ---
         QStringList nameFilters;
         nameFilters << "*.png" << "*.jpg" << "*.jpeg" << "*.gif" << "*.bmp";
+        const QFileInfoList fileList = dir.entryInfoList(nameFilters, QDir::Files | QDir::Readable);
+        for (const QFileInfo& fileInfo : fileList) {
+            jobs.append({ fileInfo.baseName(), fileInfo.absoluteFilePath() });
+        }
+        return jobs;
+    }
 
-        QFileInfoList fileList = dir.entryInfoList(nameFilters, QDir::Files | QDir::Readable);
+    /**
+     * @brief Decodes one image file. Safe to call from any thread.
+     */
+    static QImage decodeImage(const QString& path) {
+        QImage image(path);
+        if (image.isNull()) {
+            qWarning() << "Failed to load image:" << path;
+        }
+        return image;
+    }
 
-        // --- 3. Iterate and load each file ---
-        foreach (const QFileInfo &fileInfo, fileList) {
-            QString filePath = fileInfo.absoluteFilePath();
-            // Use the filename WITHOUT the extension as the lookup key
-            QString key = fileInfo.baseName();
+    /**
+     * @brief Converts decoded images to QPixmaps and stores them under their keys.
+     *
+     * Must run on the GUI thread. Null images are skipped.
+     */
+    static void adoptImages(const QList<QPair<QString, QImage>>& images) {
+        QMutexLocker locker(&s_mutex);
+        for (const auto& image : images) {
+            if (!image.second.isNull()) {
+                s_resources.insert(image.first, QPixmap::fromImage(image.second));
+            }
+        }
+        qDebug() << "Group Successfully loaded" << s_resources.count() << "game resources from the file system.";
+    }
+
+private:
+    // IMPORTANT: This path is RELATIVE to where your executable is run from.
+    static inline const QString RESOURCE_PATH = "resources/images/";
+
+    // Guards s_resources and s_scaledResources
+    static QMutex s_mutex;
+    // Declaration of the static storage container (must be defined in a .cpp file)
+    static QHash<QString, QPixmap> s_resources;
+    // Pre-scaled images keyed by "path@WxH" (see getScaledPixmap)
+    static QHash<QString, QPixmap> s_scaledResources;
+
+/**
+     * @brief Internal function to handle the resource loading logic from the file system.
+     */
+    static void _loadResources() {
+        // --- 1. Every image file in the resource directory ---
+        const QList<ImageJob> jobs = imageJobs();
 
-            QPixmap pixmap(filePath);
+        // --- 2. Iterate and load each file ---
+        for (const ImageJob& job : jobs) {
+            QPixmap pixmap(job.path);
 
             if (!pixmap.isNull()) {
-                s_resources.insert(key, pixmap);
+                s_resources.insert(job.key, pixmap);
             } else {
-                qWarning() << "Failed to load image:" << filePath;
+                qWarning() << "Failed to load image:" << job.path;
             }
         }
 
-        // --- 4. Final check and reporting ---
+        // --- 3. Final check and reporting ---
         if (s_resources.isEmpty()) {
             qWarning() << "No game resources were loaded from:" << RESOURCE_PATH;
         } else {
@@ -1,5 +1,8 @@
 #include "savegameUtils.h"
 #include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
 #include <QTextStream>
 #include <QSet>
 #include <QList>
@@ -155,4 +158,25 @@ bool repairSaveGame(const QString& characterName) {
     return false;
 }
 
+bool writeFileAtomic(const QString& filePath, const QByteArray& data) {
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open save file:" << filePath << file.errorString();
+        return false;
+    }
+    if (file.write(data) != data.size()) {
+        qWarning() << "Failed to write save file:" << filePath << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    // Renames the temporary over the target; the old file stays until this succeeds
+    if (!file.commit()) {
+        qWarning() << "Failed to commit save file:" << filePath << file.errorString();
+        return false;
+    }
+    return true;
+}
+
 } // namespace SavegameUtils
@@ -2,6 +2,7 @@
 #define SAVEGAME_UTILS_H
 
 #include <QString>
+#include <QByteArray>
 
 namespace SavegameUtils {
 
@@ -19,6 +20,15 @@ namespace SavegameUtils {
      */
     bool repairSaveGame(const QString& characterName);
 
+    /**
+     * @brief Writes a whole file through a temporary and renames it over the target (QSaveFile),
+     * so a crash mid-write leaves the previous save intact. Safe to call from any thread.
+     * @param filePath Target file; its directory is created if missing.
+     * @param data The complete new contents.
+     * @return true once the new file is in place.
+     */
+    bool writeFileAtomic(const QString& filePath, const QByteArray& data);
+
 } // namespace SavegameUtils
 
 #endif // SAVEGAME_UTILS_H
@@ -377,6 +377,8 @@ void CreateCharacterDialog::onSaveCharacterClicked()
 
         out << "\n--- GUILD ---\nGuild: " << selectedGuild << "\n";
         file.close();
+        // The roster is what the city screens list from
+        gsm->roster()->importTextFile(filename);
         QMessageBox::information(this, "Save Character", QString("Character **%1** saved successfully.").arg(characterName));
         emit characterCreated(characterName);
         QDialog::accept();
@@ -2,8 +2,11 @@
 #include "src/character_dialog/CharacterDialog.h"
 #include "DungeonDialog.h"
 #include "DungeonHandlers.h"
+#include "DungeonScripts.h"
 #include "../../gameStateManager.h"
 #include "../event/EventManager.h"
+#include "../network_manager/NetworkManager.h"
+#include "../scripting/ScriptScheduler.h"
 #include "src/spell_casting/SpellCastingDialog.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -17,6 +20,7 @@
 #include <QTextEdit>
 #include <QGroupBox>
 #include <QKeyEvent>
+#include <QKeySequence>
 #include <QTimer>
 #include <QtDebug>
 #include <QRandomGenerator>
@@ -71,38 +75,6 @@ void DungeonDialog::setupControls() {
 }
 
 
-void DungeonDialog::populateRandomTreasures(int level)
-{
-    gameStateManager* gsm = gameStateManager::instance();
-    // MDATA3 is loaded into m_itemData in gameStateManager
-    const QList<QVariantMap>& allItems = gsm->itemData(); 
-    if (allItems.isEmpty()) {
-        qDebug() << "MDATA3 not loaded or empty.";
-        return;
-    }
-    QRandomGenerator* rng = QRandomGenerator::global();
-    int itemsPlaced = 0;
-    while (itemsPlaced < 100) {
-        // 1. Pick a random coordinate
-        int x = rng->bounded(MAP_SIZE);
-        int y = rng->bounded(MAP_SIZE);
-        QPair<int, int> pos = {x, y};
-        // 2. Ensure it is a floor tile (not a wall/obstacle) and not already a treasure
-        if (!m_obstaclePositions.contains(pos) && !m_treasurePositions.contains(pos)) {
-            // 3. Pick a random item from the MDATA3 list
-            int itemIdx = rng->bounded(allItems.size());
-            QString itemName = allItems.at(itemIdx).value("name").toString();
-            // 4. Add to local level map (for rendering/interaction)
-            m_treasurePositions.insert(pos, itemName);
-            // 5. Add to the Global Array in gameStateManager
-            gsm->addPlacedItem(level, x, y, itemName);
-            qDebug() << itemName;
-            itemsPlaced++;
-        }
-    }
-    qDebug() << "Successfully placed 10 random items from MDATA3 on level" << level;
-}
-
 void DungeonDialog::revealAroundPlayer(int x, int y, int z=0)
 {
     Q_UNUSED(z);
@@ -113,9 +85,7 @@ void DungeonDialog::revealAroundPlayer(int x, int y, int z=0)
             int ny = y + dy;
 
             // Ensure we stay within map boundaries defined in the header
-            if (nx >= 0 && nx < MAP_SIZE && ny >= 0 && ny < MAP_SIZE) {
-                m_visitedTiles.insert({nx, ny});
-            }
+            m_grid.set(nx, ny, MapFeature::EXPLORED);
         }
     }
 }
@@ -128,6 +98,10 @@ void DungeonDialog::resizeEvent(QResizeEvent *event)
     if (dungeonView && m_dungeonScene) {
         dungeonView->fitInView(m_dungeonScene->sceneRect(), Qt::KeepAspectRatio);
     }
+    // Re-bake the 3D view atlas at the new on-screen size (no-op if unchanged)
+    if (m_wireframeScene) {
+        renderWireframeView();
+    }
 }
 
 void DungeonDialog::logMessage(const QString& message)
@@ -176,21 +150,28 @@ void DungeonDialog::updatePartyMemberHealth(int row, int damage)
         gsm->setGameValue("CurrentCharacterHP", newHp);
 
         if (newHp <= 0) {
-            logMessage("You have been defeated!");
-            gsm->setGameValue("isAlive", 0);
-            this->close(); 
-            emit exitedDungeonToCity(); 
+            partyDefeated();
         }
     }
 }
+
+void DungeonDialog::partyDefeated()
+{
+    gameStateManager* gsm = gameStateManager::instance();
+    logMessage("You have been defeated!");
+    gsm->setGameValue("isAlive", 0);
+    gsm->scheduler()->notify(ScriptScheduler::Wait::CombatEnd, false);
+    this->close(); 
+    emit exitedDungeonToCity(); 
+}
 // --- Dungeon Management (Movement, Drawing, Encounters) ---
 void DungeonDialog::movePlayer(int dx, int dy, int dz=0)
 {
     Q_UNUSED(dz);
     gameStateManager* gsm = gameStateManager::instance();
-    int currentX = gsm->getGameValue("DungeonX").toInt();
-    int currentY = gsm->getGameValue("DungeonY").toInt();
-    int currentZ = gsm->getGameValue("DungeonLevel").toInt();
+    int currentX = gsm->dungeonX();
+    int currentY = gsm->dungeonY();
+    int currentZ = gsm->dungeonLevel();
     int newX = currentX + dx;
     int newY = currentY + dy;
     if (newX < MAP_MIN || newX > MAP_MAX || newY < MAP_MIN || newY > MAP_MAX) {
@@ -198,7 +179,7 @@ void DungeonDialog::movePlayer(int dx, int dy, int dz=0)
         return;
     }
     QPair<int, int> newPos = {newX, newY};
-    if (m_obstaclePositions.contains(newPos)) {
+    if (m_grid.has(newPos, MapFeature::ROCK)) {
         logMessage("A solid rock wall blocks your path.");
         return;
     }
@@ -207,20 +188,13 @@ void DungeonDialog::movePlayer(int dx, int dy, int dz=0)
     if (m_breadcrumbPath.size() > MAX_BREADCRUMBS) {
         m_breadcrumbPath.removeFirst(); // Keep the trail from getting too long
     }
-    gsm->setGameValue("DungeonX", newX);
-    gsm->setGameValue("DungeonY", newY);
+    gsm->setDungeonPosition(newX, newY);
     revealAroundPlayer(newX, newY);
     updateLocation(QString("Dungeon Level %1, (%2, %3)").arg(currentZ).arg(newX).arg(newY));
-    m_visitedTiles.insert({newX, newY});
+    m_grid.set(newX, newY, MapFeature::EXPLORED);
     updateMinimap(newX, newY, 0);
-    DungeonHandlers::handleTreasure(this, newX, newY); // Now only logs chest presence
-    DungeonHandlers::handleWater(this, newX, newY);
-    DungeonHandlers::handleAntimagic(this, newX, newY);
-    DungeonHandlers::handleTrap(this, newX, newY);
-    DungeonHandlers::handleChute(this, newX, newY);
-    DungeonHandlers::handleExtinguisher(this, newX, newY);
-    DungeonHandlers::handleEncounters(this, newX, newY);
-    DungeonHandlers::handlePit(this, newX, newY); // Added pit check
+    // One read of the cell, then only the handlers whose feature bit is set run
+    DungeonHandlers::dispatch(this, newX, newY, m_grid.bits(newX, newY));
     logMessage(QString("You move to (%1, %2).").arg(newX).arg(newY));
     drawMinimap();
     renderWireframeView();
@@ -229,6 +203,9 @@ void DungeonDialog::movePlayer(int dx, int dy, int dz=0)
 void DungeonDialog::updateCompass(const QString& direction)
 {
     m_compassLabel->setText(QString("Facing %1").arg(direction));
+    static const QStringList dirs = {"North", "East", "South", "West"};
+    const int facing = dirs.indexOf(direction);
+    if (facing >= 0) NetworkManager::instance()->setFacing(quint8(facing));
 }
 
 void DungeonDialog::updateLocation(const QString& location)
@@ -236,231 +213,6 @@ void DungeonDialog::updateLocation(const QString& location)
     m_locationLabel->setText(location);
 }
 
-void DungeonDialog::generateRandomObstacles(int roomCount, QRandomGenerator& rng)
-{
-    m_obstaclePositions.clear();
-    // 1. Fill entire map with rock
-    for (int x = 0; x < MAP_SIZE; ++x)
-        for (int y = 0; y < MAP_SIZE; ++y)
-            m_obstaclePositions.insert({x, y});
-    struct Room { int x, y, w, h; };
-    QList<Room> rooms;
-    QList<Room> processingQueue;
-    // 2. Start Room in a random corner
-    int startX = rng.bounded(2) == 0 ? 1 : MAP_SIZE - 6;
-    int startY = rng.bounded(2) == 0 ? 1 : MAP_SIZE - 6;
-    Room seed = {startX, startY, rng.bounded(3, 5), rng.bounded(3, 5)};
-    for (int rx = seed.x; rx < seed.x + seed.w; ++rx)
-        for (int ry = seed.y; ry < seed.y + seed.h; ++ry)
-            m_obstaclePositions.remove({rx, ry});
-    rooms.append(seed);
-    processingQueue.append(seed);
-    int roomsCreated = 1;
-    // 3. Sprout until we hit the target count or run out of space
-    while (!processingQueue.isEmpty() && roomsCreated < roomCount) {
-        // Pick a room from the queue (shuffling makes it more "web-like")
-        int idx = rng.bounded(processingQueue.size());
-        Room current = processingQueue.takeAt(idx);
-        // Try to sprout in all 4 directions
-        QList<int> directions = {0, 1, 2, 3};
-        for(int i=0; i<4; ++i) { // Randomize direction order
-            int swapIdx = rng.bounded(4);
-            directions.swapItemsAt(i, swapIdx);
-        }
-        for (int dir : directions) {
-            if (roomsCreated >= roomCount) break;
-            int corridorLen = rng.bounded(2, 5); // Shorter corridors allow more rooms
-            int newW = rng.bounded(3, 6);
-            int newH = rng.bounded(3, 6);
-            int cX = current.x + current.w / 2;
-            int cY = current.y + current.h / 2;
-            int endX = cX, endY = cY;
-            int roomX = 0, roomY = 0;
-            // Direction Logic
-            if (dir == 0) { // North
-                endY = current.y - corridorLen;
-                roomX = endX - newW / 2; roomY = endY - newH;
-            } else if (dir == 1) { // East
-                endX = current.x + current.w + corridorLen;
-                roomY = endY - newH / 2; roomX = endX;
-            } else if (dir == 2) { // South
-                endY = current.y + current.h + corridorLen;
-                roomX = endX - newW / 2; roomY = endY;
-            } else { // West
-                endX = current.x - corridorLen;
-                roomY = endY - newH / 2; roomX = endX - newW;
-            }
-            // Boundary and Overlap Check
-            if (roomX > 0 && roomY > 0 && roomX + newW < MAP_MAX && roomY + newH < MAP_MAX) {
-                bool overlaps = false;
-                for (const auto& r : rooms) {
-                    // Using 1-tile buffer to keep corridors distinct
-                    if (roomX < r.x + r.w + 1 && roomX + newW > r.x - 1 && 
-                        roomY < r.y + r.h + 1 && roomY + newH > r.y - 1) {
-                        overlaps = true; break;
-                    }
-                }
-                if (!overlaps) {
-                    // Carve Corridor
-                    int stepX = cX, stepY = cY;
-                    while (stepX != endX || stepY != endY) {
-                        if (stepX < endX) stepX++; else if (stepX > endX) stepX--;
-                        if (stepY < endY) stepY++; else if (stepY > endY) stepY--;
-                        m_obstaclePositions.remove({stepX, stepY});
-                    }
-                    // Carve Room
-                    Room nextRoom = {roomX, roomY, newW, newH};
-                    for (int rx = roomX; rx < roomX + newW; ++rx) {
-                        for (int ry = roomY; ry < roomY + newH; ++ry) {
-                            m_obstaclePositions.remove({rx, ry});
-                            m_roomFloorTiles.insert(qMakePair(rx, ry));
-                        }
-                    }
-                    rooms.append(nextRoom);
-                    processingQueue.append(nextRoom);
-                    roomsCreated++;
-                }
-            }
-        }
-    }
-    // Start player in the first room created
-    gameStateManager::instance()->setGameValue("DungeonX", rooms[0].x + 1);
-    gameStateManager::instance()->setGameValue("DungeonY", rooms[0].y + 1);
-}
-
-void DungeonDialog::generateStairs(QRandomGenerator& rng)
-{
-    gameStateManager* gsm = gameStateManager::instance();
-    int currentX = gsm->getGameValue("DungeonX").toInt();
-    int currentY = gsm->getGameValue("DungeonY").toInt();
-    QPair<int, int> currentPos = {currentX, currentY};
-    do {
-        m_stairsUpPosition = {rng.bounded(MAP_SIZE), rng.bounded(MAP_SIZE)};
-        //m_stairsUpPosition = {QRandomGenerator::global()->bounded(MAP_SIZE), QRandomGenerator::global()->bounded(MAP_SIZE)};
-    } while (m_stairsUpPosition == currentPos || m_obstaclePositions.contains(m_stairsUpPosition));
-    do {
-        m_stairsDownPosition = {rng.bounded(MAP_SIZE), rng.bounded(MAP_SIZE)};
-        //m_stairsDownPosition = {QRandomGenerator::global()->bounded(MAP_SIZE), QRandomGenerator::global()->bounded(MAP_SIZE)};
-    } while (m_stairsDownPosition == currentPos || m_stairsDownPosition == m_stairsUpPosition || m_obstaclePositions.contains(m_stairsDownPosition));
-    m_obstaclePositions.remove(m_stairsUpPosition);
-    m_obstaclePositions.remove(m_stairsDownPosition);
-}
-
-void DungeonDialog::generateSpecialTiles(int tileCount, QRandomGenerator& rng)
-{
-    m_bodyPositions.clear();
-    // 1. Reset all containers
-    m_antimagicPositions.clear();
-    m_extinguisherPositions.clear();
-    m_fogPositions.clear();
-    m_pitPositions.clear();
-    m_rotatorPositions.clear();
-    m_studPositions.clear();
-    m_chutePositions.clear();
-    m_monsterPositions.clear();
-    //m_treasurePositions.clear();
-    m_trapPositions.clear();
-    m_waterPositions.clear();
-    m_teleporterPositions.clear();
-    m_hiddenDoorPositions.clear();
-    gameStateManager* gsm = gameStateManager::instance();
-int currentLevel = gsm->getGameValue("DungeonLevel").toInt();
-    QPair<int, int> playerPos = {gsm->getGameValue("DungeonX").toInt(), gsm->getGameValue("DungeonY").toInt()};
-    // Helper A: Get a tile ONLY from a room (No corridors!)
-    auto getValidRoomTile = [&]() -> QPair<int, int> {
-        if (m_roomFloorTiles.isEmpty()) return {-1, -1};
-        QList<QPair<int, int>> roomList = m_roomFloorTiles.values();
-        for (int i = 0; i < 100; ++i) {
-            QPair<int, int> p = roomList.at(rng.bounded(roomList.size()));
-            if (p != m_stairsUpPosition && p != m_stairsDownPosition && p != playerPos) return p;
-        }
-        return {-1, -1};
-    };
-    // Helper: Get ANY floor tile (Rooms OR Corridors)
-    auto getAnyFloorTile = [&]() -> QPair<int, int> {
-        for (int i = 0; i < 500; ++i) {
-            int x = rng.bounded(MAP_SIZE);
-            int y = rng.bounded(MAP_SIZE);
-            QPair<int, int> p = {x, y};
-            if (!m_obstaclePositions.contains(p) && p != playerPos && 
-                p != m_stairsUpPosition && p != m_stairsDownPosition &&
-                !m_treasurePositions.contains(p)) { // Also check if treasure is already there
-                return p;
-            }
-        }
-        return {-1, -1};
-    };
-    // 2. Guaranteed Room-Only Spawns (Chutes & Teleporters)
-    // We do these first so they get priority in the rooms
-    for (int i = 0; i < 4; ++i) {
-        QPair<int, int> cp = getValidRoomTile();
-        if (cp.first != -1) m_chutePositions.insert(cp);
-        
-        QPair<int, int> tp = getValidRoomTile();
-        if (tp.first != -1) m_teleporterPositions.insert(tp);
-    }
-    // 3. General Population Loop
-    for (int i = 0; i < tileCount; ++i) {
-        int roll = rng.bounded(100); // Using 100 for better percentage control
-        QPair<int, int> pos;
-        if (roll < 15) { // 15% Monsters
-            pos = getAnyFloorTile();
-            if (pos.first != -1) m_monsterPositions.insert(pos, "Orc");
-        } 
-        else if (roll < 30) { // 15% Treasures
-            pos = getAnyFloorTile();
-            if (pos.first != -1) m_treasurePositions.insert(pos, "Gold Pouch");
-        } 
-        else if (roll < 55) { // 10% Water
-            pos = getAnyFloorTile();
-            if (pos.first != -1) m_waterPositions.insert(pos);
-        }
-        else if (roll < 65) { // 10% Anti-magic/Extinguisher
-            pos = getAnyFloorTile();
-            if (pos.first != -1) m_antimagicPositions.insert(pos);
-        }
-        // Extra Room-Only Chutes/Teleporters via random roll
-        else if (roll < 70) { 
-            pos = getValidRoomTile();
-            if (pos.first != -1) m_chutePositions.insert(pos);
-        }
-        else if (roll < 75) { // 5% Pits
-            pos = getAnyFloorTile();
-            if (pos.first != -1) m_pitPositions.insert(pos);
-        }
-    }
-    if (currentLevel == 1) {
-        QList<QPair<int, int>> wallList = m_obstaclePositions.values();
-        bool placed = false;
-        
-        // Shuffle wall list to get a random wall tile for the door
-        std::shuffle(wallList.begin(), wallList.end(), std::default_random_engine(rng.generate()));
-
-        for (const auto& wallPos : wallList) {
-            // Check 4 cardinal directions for a floor tile
-            QList<QPair<int, int>> neighbors = {
-                {wallPos.first, wallPos.second - 1}, // North
-                {wallPos.first, wallPos.second + 1}, // South
-                {wallPos.first - 1, wallPos.second}, // West
-                {wallPos.first + 1, wallPos.second}  // East
-            };
-
-            for (const auto& neighbor : neighbors) {
-                // Check boundaries and ensure neighbor is NOT a wall
-                if (neighbor.first >= 0 && neighbor.first < MAP_SIZE && 
-                    neighbor.second >= 0 && neighbor.second < MAP_SIZE &&
-                    !m_obstaclePositions.contains(neighbor)) {
-                    
-                    m_hiddenDoorPositions.insert(wallPos);
-                    qDebug() << "Accessible Hidden Door placed in wall at:" << wallPos << " next to floor at:" << neighbor;
-                    placed = true;
-                    break; 
-                }
-            }
-            if (placed) break;
-        }
-    }
-}
 // --- Constructor Implementation ---
 DungeonDialog::DungeonDialog(QWidget *parent)
     : QDialog(parent),
@@ -489,9 +241,9 @@ DungeonDialog::DungeonDialog(QWidget *parent)
     // int con = gsm->getGameValue("CurrentCharacterConstitution").toInt();
     //int maxHP = (con > 0) ? con * 5 : 50; 
     // --- Retrieve/Set persistent dungeon state (New GameState logic) ---
-    int initialLevel = gsm->getGameValue("DungeonLevel").toInt();
-    int initialX = gsm->getGameValue("DungeonX").toInt();
-    int initialY = gsm->getGameValue("DungeonY").toInt();
+    int initialLevel = gsm->dungeonLevel();
+    int initialX = gsm->dungeonX();
+    int initialY = gsm->dungeonY();
     //quint64 initialGold = gsm->getGameValue("PlayerGold").toULongLong();
     gsm->setGameValue("PlayerGold", gsm->getPC().at(0).gold);
     //initialGold = gsm->getPC().at(0).gold;
@@ -503,9 +255,8 @@ DungeonDialog::DungeonDialog(QWidget *parent)
         initialY = MAP_SIZE / 2;
         quint64 initialGold = 1500;
         // Save initial defaults to GameState
-        gsm->setGameValue("DungeonLevel", initialLevel);
-        gsm->setGameValue("DungeonX", initialX);
-        gsm->setGameValue("DungeonY", initialY);
+        gsm->setStateValue(GameState::Key::DungeonLevel, initialLevel);
+        gsm->setDungeonPosition(initialX, initialY);
         gsm->setGameValue("PlayerGold", initialGold);
     }
     // -----------------------------------------------------------------
@@ -564,11 +315,14 @@ DungeonDialog::DungeonDialog(QWidget *parent)
     updateGoldLabel(); // Call to update label with GameState value
     rightPanelLayout->addWidget(m_goldLabel);
     // Initialize map state and draw the initial view
-    QRandomGenerator initialRng(1 + 12345); 
-    // 2. Pass 'initialRng' to the functions as the second argument
-    generateRandomObstacles(40, initialRng);  
-    generateStairs(initialRng);               
-    generateSpecialTiles(20, initialRng);
+    // Level 1's layout (no treasure on this first pass), with the player in its first room
+    m_levelCache.setWorldSeed(gsm->worldSeed());
+    QSharedPointer<const GeneratedLevel> firstLevel = LevelGenerator::generate(gsm->worldSeed(), 1, {});
+    applyLevel(*firstLevel);
+    gsm->setDungeonPosition(firstLevel->start.first, firstLevel->start.second);
+    m_levelCache.prefetchAround(1, gsm->itemData());
+    // Each dungeon level is its own zone on the server, so chat and positions stay on this level
+    NetworkManager::instance()->enterZone("dungeon", 1);
     drawMinimap();
 
     // 4. Action Buttons
@@ -671,6 +425,8 @@ DungeonDialog::DungeonDialog(QWidget *parent)
     // Do this for ALL buttons (Fight, Spell, Map, etc.)
     this->setFocusPolicy(Qt::StrongFocus);
     this->setFocus();
+    // Lua tile handlers and bindings act on this dialog from now on
+    DungeonScripts::attach(this);
 }
 
 void DungeonDialog::updateExperienceLabel()
@@ -687,34 +443,64 @@ void DungeonDialog::updateExperienceLabel()
 void DungeonDialog::enterLevel(int level, bool movingUp)
 {
     m_breadcrumbPath.clear();
-    m_visitedTiles.clear();
-    // Clear treasures specifically at the start of level generation
-    m_treasurePositions.clear();
+    storeExploration();
     gameStateManager* gsm = gameStateManager::instance();
-    // 1. Generate the map using Room-and-Corridor logic
-    // Seed by level to ensure the layout is deterministic
-    QRandomGenerator levelRng(level + 12345);
-    populateRandomTreasures(level);
-    // We pass a 'Room Count' instead of 'Obstacle Count'. 
-    // 7 rooms at level 1, increasing slightly as you go deeper.
-    generateRandomObstacles(40, levelRng); 
-    // 2. Place Stairs and Special Tiles
-    // These must be called AFTER generateRandomObstacles so they know where the floor is.
-    generateStairs(levelRng);
-    // Scale the number of special tiles (monsters/traps) with the level
-    generateSpecialTiles(20, levelRng);
+    // 1. The level itself, normally built in the background while the last one was explored.
+    // Swapping it in replaces the whole level (visited tiles, treasures, everything).
+    m_levelCache.setWorldSeed(gsm->worldSeed());
+    QSharedPointer<const GeneratedLevel> generated = m_levelCache.take(level, gsm->itemData());
+    m_grid.setLevel(level);
+    applyLevel(*generated);
+    // 2. The layout is seeded by level, so what was explored last time still lines up
+    restoreExploration();
     // 3. Determine Landing Position
     // Arrive at the Down stairs if moving Up, or Up stairs if moving Down
     QPair<int, int> landingPos = movingUp ? m_stairsDownPosition : m_stairsUpPosition;
     // 4. Update Game State and UI
-    gsm->setGameValue("DungeonLevel", level);
-    gsm->setGameValue("DungeonX", landingPos.first);
-    gsm->setGameValue("DungeonY", landingPos.second);
+    gsm->setStateValue(GameState::Key::DungeonLevel, level);
+    gsm->setDungeonPosition(landingPos.first, landingPos.second);
     revealAroundPlayer(landingPos.first, landingPos.second);
-    m_visitedTiles.insert(landingPos);
+    m_grid.set(landingPos, MapFeature::EXPLORED);
     updateLocation(QString("Dungeon Level %1, (%2, %3)").arg(level).arg(landingPos.first).arg(landingPos.second));
     drawMinimap();
     logMessage(QString("You have entered **Dungeon Level %1**.").arg(level));
+    NetworkManager::instance()->enterZone("dungeon", level);
+    // 5. Have the next levels either way ready by the time the party gets to the stairs
+    m_levelCache.prefetchAround(level, gsm->itemData());
+}
+
+void DungeonDialog::applyLevel(const GeneratedLevel& level)
+{
+    m_grid.restoreLevel(level.tiles);
+    m_stairsUpPosition = level.stairsUp;
+    m_stairsDownPosition = level.stairsDown;
+    // The level's treasure goes into the global item list, as it always has
+    gameStateManager* gsm = gameStateManager::instance();
+    for (const GeneratedLevel::Treasure& treasure : level.treasures) {
+        gsm->addPlacedItem(level.level, treasure.x, treasure.y, treasure.itemName);
+    }
+}
+
+void DungeonDialog::storeExploration()
+{
+    QBitArray tiles(DungeonGrid::WIDTH * DungeonGrid::HEIGHT);
+    bool any = false;
+    m_grid.forEach(MapFeature::EXPLORED, [&](int x, int y) {
+        tiles.setBit(y * DungeonGrid::WIDTH + x);
+        any = true;
+    });
+    if (any) gameStateManager::instance()->setExploredTiles(m_grid.levelIndex() + 1, tiles);
+}
+
+void DungeonDialog::restoreExploration()
+{
+    const QBitArray tiles = gameStateManager::instance()->exploredTiles(m_grid.levelIndex() + 1);
+    if (tiles.size() != DungeonGrid::WIDTH * DungeonGrid::HEIGHT) return;
+    for (int y = 0; y < DungeonGrid::HEIGHT; ++y) {
+        for (int x = 0; x < DungeonGrid::WIDTH; ++x) {
+            if (tiles.testBit(y * DungeonGrid::WIDTH + x)) m_grid.set(x, y, MapFeature::EXPLORED);
+        }
+    }
 }
 
 void DungeonDialog::on_attackCompanionButton_clicked() 
@@ -749,23 +535,23 @@ void DungeonDialog::on_dropButton_clicked()
 {
     gameStateManager* gsm = gameStateManager::instance();
 
-    int x = gsm->getGameValue("DungeonX").toInt();
-    int y = gsm->getGameValue("DungeonY").toInt();
+    int x = gsm->dungeonX();
+    int y = gsm->dungeonY();
     QPair<int, int> pos = {x, y};
-    m_bodyPositions.insert(pos);
+    m_grid.set(pos, MapFeature::BODY);
     
     // Check if the player is actually carrying a body
     // Assuming "IsCarryingBody" is a flag in your gameStateManager
     if (gsm->getGameValue("IsCarryingBody").toBool()) {
         
         // Get current position
-        int curX = gsm->getGameValue("DungeonX").toInt();
-        int curY = gsm->getGameValue("DungeonY").toInt();
+        int curX = gsm->dungeonX();
+        int curY = gsm->dungeonY();
         QPair<int, int> pos = {curX, curY};
 
         // Logic to check if the player is actually carrying a body would go here
         // For now, we add the tile at the current location
-        m_bodyPositions.insert(pos);
+        m_grid.set(pos, MapFeature::BODY);
         // Update GameState: No longer carrying, and place body on map
         gsm->setGameValue("IsCarryingBody", false);
         
@@ -792,16 +578,15 @@ void DungeonDialog::on_teleportButton_clicked()
         newX = QRandomGenerator::global()->bounded(MAP_SIZE);
         newY = QRandomGenerator::global()->bounded(MAP_SIZE);
         newPos = {newX, newY};
-    } while (m_obstaclePositions.contains(newPos));
+    } while (m_grid.has(newPos, MapFeature::ROCK));
     // 2. Update the Game State
-    gsm->setGameValue("DungeonX", newX);
-    gsm->setGameValue("DungeonY", newY);
+    gsm->setDungeonPosition(newX, newY);
     // 3. Log the event to the user
     logMessage(QString("A mystical force teleports you to (%1, %2)!")
                .arg(newX).arg(newY));
     // 4. Update the UI
     updateLocation(QString("Dungeon Level %1, (%2, %3)")
-                   .arg(gsm->getGameValue("DungeonLevel").toInt()).arg(newX).arg(newY));
+                   .arg(gsm->dungeonLevel()).arg(newX).arg(newY));
     // Refresh the map and trigger encounter checks at the new location
     drawMinimap();
     DungeonHandlers::handleTreasure(this, newX, newY);
@@ -823,67 +608,116 @@ void DungeonDialog::on_fightButton_clicked()
     
     // Use the Lambda to bypass all slot logic
     connect(m_combatTimer, &QTimer::timeout, [this]() {
-        qDebug() << "--- ACTUAL HARDWARE TICK ---"; 
         this->processCombatTick();
     });
 
+    startCombat();
+    m_combatTimer->start(CombatEngine::TICK_MS);
+}
+
+void DungeonDialog::startCombat()
+{
+    gameStateManager* gsm = gameStateManager::instance();
+
+    // 1. Who is fighting: the current hero against the monster on this tile
+    Character hero;
+    hero.name = gsm->getGameValue("CurrentCharacterName").toString();
+    hero.level = qMax(1, gsm->getGameValue("CurrentCharacterLevel").toInt());
+    hero.hp = gsm->getGameValue("CurrentCharacterHP").toInt();
+    hero.maxHp = qMax(hero.hp, int(gsm->getStateValue(GameState::Key::MaxCharacterHP)));
+    hero.strength = gsm->getGameValue("CurrentCharacterStrength").toInt();
+    hero.dexterity = gsm->getGameValue("CurrentCharacterDexterity").toInt();
+    hero.constitution = gsm->getGameValue("CurrentCharacterConstitution").toInt();
+
+    const QPair<int, int> pos = getCurrentPosition();
+    m_activeMonsterName = m_grid.has(pos, MapFeature::MONSTER) ? m_grid.name(pos, MapFeature::MONSTER) : QString("monster");
+    QVariantMap monsterRow = gsm->findMonster(m_activeMonsterName);
+    if (monsterRow.isEmpty()) {
+        qWarning() << "No MDATA5 entry for" << m_activeMonsterName << "- using placeholder stats";
+        monsterRow = { { "name", m_activeMonsterName }, { "hits", 20 }, { "att", 20 }, { "def", 5 } };
+    }
+
+    // 2. A fresh engine with its own seed; logged so a fight can be replayed headless
+    delete m_combat;
+    const quint32 seed = QRandomGenerator::global()->generate();
+    m_combat = new CombatEngine(seed);
+    m_combatHero = m_combat->add(CombatEngine::Combatant::fromCharacter(hero));
+    m_combatMonster = m_combat->add(CombatEngine::Combatant::fromMonster(monsterRow));
+    m_combat->setDefending(m_combatHero, m_isDefending);
+    qDebug() << "Combat against" << m_activeMonsterName << "with seed" << seed;
+
     m_isFighting = true;
-    m_combatTimer->start(100); 
-    logMessage("FORCING TIMER START...");
+    logMessage(QString("You attack the %1!").arg(m_activeMonsterName));
 }
 
 void DungeonDialog::processCombatTick() 
 {
-    if (!m_isFighting) return;
+    if (!m_isFighting || !m_combat) return;
+    m_combat->step();
+    showCombatEvents();
+}
+
+void DungeonDialog::showCombatEvents()
+{
+    if (!m_combat) return;
+    gameStateManager* gsm = gameStateManager::instance();
 
-    // --- PLAYER LOGIC ---
-    m_playerAttackCooldown += 100; 
-    if (m_playerAttackCooldown >= 1000) { // Player swings every 1.0s
-        performPlayerAttack();
-        m_playerAttackCooldown = 0;
+    // 1. What happened since the last call, as log lines
+    for (const CombatEngine::Event& event : m_combat->takeEvents()) {
+        const bool heroActs = event.attacker == m_combatHero;
+        switch (event.type) {
+        case CombatEngine::Event::Type::Miss:
+            logMessage(heroActs ? QString("You miss the %1.").arg(m_activeMonsterName)
+                                : QString("The %1 misses you.").arg(m_activeMonsterName));
+            break;
+        case CombatEngine::Event::Type::Hit:
+            if (event.attacker < 0) break; // Spell damage is logged by the spell handler
+            logMessage(heroActs ? QString("You hit the %1 for %2 damage!").arg(m_activeMonsterName).arg(event.damage)
+                                : QString("<font color='red'>The %1 hits you for %2 damage!</font>").arg(m_activeMonsterName).arg(event.damage));
+            break;
+        case CombatEngine::Event::Type::Death:
+            break; // Handled by the outcome below
+        }
     }
 
-    // --- MONSTER LOGIC ---
-    // Increment monster cooldown by 100ms per tick
-    m_monsterAttackCooldown += 100;
+    // 2. The engine owns the hero's HP during the fight
+    gsm->setGameValue("CurrentCharacterHP", m_combat->combatant(m_combatHero).hp);
 
-    // Let's say the monster is slightly slower, attacking every 1.4 seconds
-    if (m_monsterAttackCooldown >= 1400) {
-        performMonsterAttack();
-        m_monsterAttackCooldown = 0;
+    // 3. Decided?
+    switch (m_combat->outcome()) {
+    case CombatEngine::Outcome::PartyWon:  endCombat(true); break;
+    case CombatEngine::Outcome::PartyLost: endCombat(false); break;
+    default: break;
     }
 }
 
-void DungeonDialog::performPlayerAttack() {
-    int damage = QRandomGenerator::global()->bounded(5, 15);
-    m_activeMonsterHP -= damage;
-    logMessage(QString("You hit the monster for %1 damage!").arg(damage));
-
-    if (m_activeMonsterHP <= 0) {
-        logMessage("The monster falls!");
-        m_isFighting = false;
-        m_isDefending = false; // Reset defense state
-        m_combatTimer->stop();
-        
-        QPair<int, int> pos = getCurrentPosition();
-        m_monsterPositions.remove(pos);
-        renderWireframeView();
-        awardBattleLoot();
+void DungeonDialog::endCombat(bool won)
+{
+    m_isFighting = false;
+    m_isDefending = false; // Reset defense state
+    if (m_combatTimer) m_combatTimer->stop();
+    delete m_combat;
+    m_combat = nullptr;
+
+    if (!won) {
+        partyDefeated();
+        return;
     }
-}
+    logMessage(QString("<font color='green'>The %1 falls!</font>").arg(m_activeMonsterName));
+    gameStateManager::instance()->scheduler()->notify(ScriptScheduler::Wait::CombatEnd, true);
 
-void DungeonDialog::performMonsterAttack() {
-    int damage = QRandomGenerator::global()->bounded(1, 10);
-    updatePartyMemberHealth(0, damage);
-    logMessage(QString("<font color='red'>The monster hits you for %1 damage!</font>").arg(damage));
+    QPair<int, int> pos = getCurrentPosition();
+    m_grid.clear(pos, MapFeature::MONSTER);
+    renderWireframeView();
+    awardBattleLoot();
 }
 
 // DungeonDialog.cpp
 QPair<int, int> DungeonDialog::getCurrentPosition()
 {
     gameStateManager* gsm = gameStateManager::instance();
-    return qMakePair(gsm->getGameValue("DungeonX").toInt(), 
-                     gsm->getGameValue("DungeonY").toInt());
+    return qMakePair(gsm->dungeonX(), 
+                     gsm->dungeonY());
 }
 
 void DungeonDialog::on_takeButton_clicked() 
@@ -901,12 +735,12 @@ void DungeonDialog::on_searchButton_clicked()
         for (int dy = -1; dy <= 1; ++dy) {
             QPair<int, int> checkPos = {currentPos.first + dx, currentPos.second + dy};
             
-            if (m_hiddenDoorPositions.contains(checkPos)) {
+            if (m_grid.has(checkPos, MapFeature::HIDDEN_DOOR)) {
                 logMessage(QString("Your search reveals a hidden door at %1, %2!")
                            .arg(checkPos.first).arg(checkPos.second));
                 
                 // Add to visited tiles so it stays on the map
-                m_visitedTiles.insert(checkPos);
+                m_grid.set(checkPos, MapFeature::EXPLORED);
                 found = true;
             }
         }
@@ -940,6 +774,14 @@ void DungeonDialog::keyPressEvent(QKeyEvent *event)
 {
     // Add this to see if the event is even reaching the function
     qDebug() << "Key Pressed:" << event->key();
+    // A tile script waiting in wait_input() gets this key instead of the dialog
+    ScriptScheduler* scripts = gameStateManager::instance()->scheduler();
+    if (scripts->hasWaiting(ScriptScheduler::Wait::Input)) {
+        const QString key = event->text().isEmpty() ? QKeySequence(event->key()).toString() : event->text();
+        scripts->notify(ScriptScheduler::Wait::Input, key);
+        event->accept();
+        return;
+    }
     switch (event->key()) {
         // --- Movement (WASD) ---
         case Qt::Key_Up:
@@ -973,8 +815,8 @@ void DungeonDialog::keyPressEvent(QKeyEvent *event)
         case Qt::Key_T: {
             gameStateManager* gsm = gameStateManager::instance();
             QPair<int, int> currentPos = { 
-                gsm->getGameValue("DungeonX").toInt(), 
-                gsm->getGameValue("DungeonY").toInt() 
+                gsm->dungeonX(), 
+                gsm->dungeonY() 
             };
 
             if (currentPos == m_stairsUpPosition) {
@@ -1035,6 +877,7 @@ void DungeonDialog::keyPressEvent(QKeyEvent *event)
             if (m_isFighting) {
                 // Toggle defending state
                 m_isDefending = !m_isDefending; 
+                if (m_combat) m_combat->setDefending(m_combatHero, m_isDefending);
                 if (m_isDefending) {
                     logMessage("<font color='blue'>You raise your guard! (Half damage taken)</font>");
                 } else {
@@ -1078,8 +921,8 @@ void DungeonDialog::on_stairsUpButton_clicked()
 {
     gameStateManager* gsm = gameStateManager::instance();
     QPair<int, int> currentPos = { 
-        gsm->getGameValue("DungeonX").toInt(), 
-        gsm->getGameValue("DungeonY").toInt() 
+        gsm->dungeonX(), 
+        gsm->dungeonY() 
     };
 
     if (currentPos == m_stairsUpPosition) {
@@ -1097,6 +940,7 @@ void DungeonDialog::on_openButton_clicked()
 
 void DungeonDialog::updateDungeonView(const QImage& dungeonImage)
 {
+    m_wireframeScene = nullptr; // clear() deletes the pooled 3D items
     m_dungeonScene->clear();
     QPixmap pixmap = QPixmap::fromImage(dungeonImage);
     m_dungeonScene->addPixmap(pixmap);
@@ -1186,10 +1030,10 @@ void DungeonDialog::transitionLevel(StairDirection direction)
 {
     gameStateManager* gsm = gameStateManager::instance();
     // Retrieve current position once
-    int currentZ = gsm->getGameValue("DungeonLevel").toInt();
+    int currentZ = gsm->dungeonLevel();
     QPair<int, int> currentPos = { 
-        gsm->getGameValue("DungeonX").toInt(), 
-        gsm->getGameValue("DungeonY").toInt() 
+        gsm->dungeonX(), 
+        gsm->dungeonY() 
     };
     // Use the Enum to pick the correct target
     bool isGoingUp = (direction == StairDirection::Up);
@@ -1227,11 +1071,11 @@ void DungeonDialog::processTreasureOpening()
 {
     gameStateManager* gsm = gameStateManager::instance();
     QPair<int, int> pos = {
-        gsm->getGameValue("DungeonX").toInt(),
-        gsm->getGameValue("DungeonY").toInt()
+        gsm->dungeonX(),
+        gsm->dungeonY()
     };
-    if (m_treasurePositions.contains(pos)) {
-        QString treasure = m_treasurePositions.value(pos);
+    if (m_grid.has(pos, MapFeature::TREASURE)) {
+        QString treasure = m_grid.name(pos, MapFeature::TREASURE);
         int activeIdx = gsm->getGameValue("ActiveCharacterIndex").toInt(); //
 
         if (treasure.contains("Gold")) {
@@ -1245,7 +1089,7 @@ void DungeonDialog::processTreasureOpening()
             gsm->addItemToCharacter(activeIdx, treasure);
             logMessage(QString("You found a %1 and added it to your inventory!").arg(treasure));
         }
-        m_treasurePositions.remove(pos);
+        m_grid.clear(pos, MapFeature::TREASURE);
         drawMinimap();
     }
 }
@@ -1255,8 +1099,8 @@ void DungeonDialog::update3DView() {
     QPen wirePen(Qt::green, 2); // Classic green phosphor look
 
     gameStateManager* gsm = gameStateManager::instance();
-    int px = gsm->getGameValue("DungeonX").toInt();
-    int py = gsm->getGameValue("DungeonY").toInt();
+    int px = gsm->dungeonX();
+    int py = gsm->dungeonY();
     QString facing = m_compassLabel->text(); // e.g., "Facing North"
 
     // Scan up to 3 tiles ahead
@@ -1310,7 +1154,7 @@ bool DungeonDialog::isWallAt(int x, int y) {
         return true; 
     }
     // Check if the position is in our obstacle set
-    return m_obstaclePositions.contains({x, y});
+    return m_grid.has(x, y, MapFeature::ROCK);
 }
 
 bool DungeonDialog::isWallAtSide(int x, int y, const QString& side) {
@@ -1334,361 +1178,6 @@ bool DungeonDialog::isWallAtSide(int x, int y, const QString& side) {
     return isWallAt(targetX, targetY);
 }
 
-void DungeonDialog::renderWireframeView() {
-    m_dungeonScene->clear();
-    m_dungeonScene->setBackgroundBrush(Qt::black);
-
-    gameStateManager *gsm = gameStateManager::instance();
-    int px = gsm->getGameValue("DungeonX").toInt();
-    int py = gsm->getGameValue("DungeonY").toInt();
-    QString facing = m_compassLabel->text();
-
-    const int w = 300; 
-    const int h = 300;
-    
-    // Perspective points
-    int xs[] = {0, 75, 120, 150}; 
-    int ys[] = {0, 75, 120, 150};
-
-    for (int d = 2; d >= 0; --d) {
-        // 1. Calculate tile coordinates for the CENTER path
-        int tx = px, ty = py;
-        int dx = 0, dy = 0; 
-        if (facing.contains("North")) dy = -1;
-        else if (facing.contains("South")) dy = 1;
-        else if (facing.contains("East"))  dx = 1;
-        else if (facing.contains("West"))  dx = -1;
-
-        tx += (dx * d);
-        ty += (dy * d);
-
-        // 2. Calculate coordinates for adjacent tiles (Left/Right) at this depth
-        // This is necessary to see if the side-corridor is blocked by a wall
-        int lx = tx + dy, ly = ty - dx; // Left tile relative to facing
-        int rx = tx - dy, ry = ty + dx; // Right tile relative to facing
-
-        // Wall Checks
-        bool wallFront      = isWallAt(tx, ty);
-        bool wallLeftSide   = isWallAtSide(tx, ty, "left");  // The plane parallel to you
-        bool wallRightSide  = isWallAtSide(tx, ty, "right"); // The plane parallel to you
-        bool wallInLeftTile = isWallAt(lx, ly);              // The wall inside the side corridor
-        bool wallInRightTile = isWallAt(rx, ry);             // The wall inside the side corridor
-
-        // Screen coordinates for this depth
-        int xL = xs[d];     int xR = w - xs[d];
-        int yT = ys[d];     int yB = h - ys[d];
-        int nxL = xs[d+1];  int nxR = w - xs[d+1];
-        int nyT = ys[d+1];  int nyB = h - ys[d+1];
-
-        // --- 1. FLOOR & CEILING (Full Span) ---
-        QPolygon floor, ceil;
-        floor << QPoint(0, yB) << QPoint(w, yB) << QPoint(w, nyB) << QPoint(0, nyB);
-        ceil << QPoint(0, yT) << QPoint(w, yT) << QPoint(w, nyT) << QPoint(0, nyT);
-        
-        int floorCol = qMax(0, 40 - (d * 10));
-        int ceilR = qMax(0, 80 - (d * 20)); // Brown base
-        m_dungeonScene->addPolygon(floor, QPen(Qt::NoPen), QBrush(QColor(floorCol, floorCol, floorCol)));
-        m_dungeonScene->addPolygon(ceil, QPen(Qt::NoPen), QBrush(QColor(ceilR, qMax(0, 50-(d*15)), qMax(0, 30-(d*10)))));
-
-        // --- 2. SIDE-FACING WALLS (Corridor Walls) ---
-        int sideWallCol = qMax(0, 80 - (d * 15));
-        if (wallLeftSide) {
-            QPolygon p; p << QPoint(xL, yT) << QPoint(nxL, nyT) << QPoint(nxL, nyB) << QPoint(xL, yB);
-            m_dungeonScene->addPolygon(p, QPen(Qt::black), QBrush(QColor(sideWallCol, sideWallCol, sideWallCol)));
-            drawBrickPattern(p, d);
-        }
-        if (wallRightSide) {
-            QPolygon p; p << QPoint(xR, yT) << QPoint(nxR, nyT) << QPoint(nxR, nyB) << QPoint(xR, yB);
-            m_dungeonScene->addPolygon(p, QPen(Qt::black), QBrush(QColor(sideWallCol, sideWallCol, sideWallCol)));
-            drawBrickPattern(p, d);
-        }
-
-        // --- 3. FRONT-FACING WALLS IN SIDE CORRIDORS ---
-        // If there is NO side wall blocking the view, check if the adjacent tile has a wall
-        int sideRoomWallCol = qMax(0, 65 - (d * 15));
-        if (!wallLeftSide && wallInLeftTile) {
-            // Draw a wall on the left wing of the screen
-            m_dungeonScene->addRect(0, yT, xL, yB - yT, QPen(Qt::black), QBrush(QColor(sideRoomWallCol, sideRoomWallCol, sideRoomWallCol)));
-        }
-        if (!wallRightSide && wallInRightTile) {
-            // Draw a wall on the right wing of the screen
-            m_dungeonScene->addRect(xR, yT, w - xR, yB - yT, QPen(Qt::black), QBrush(QColor(sideRoomWallCol, sideRoomWallCol, sideRoomWallCol)));
-        }
-        
-        bool hasAntimagic = m_antimagicPositions.contains({tx, ty});
-
-        // 1. Draw floor/ceiling
-        // ... 
-
-        // 2. Draw Antimagic effect on the floor
-        if (hasAntimagic) {
-            drawAntimagic(d, xL, xR, yB, nxL, nxR, nyB);
-        }
-        // Identify if tile is water (Adjust based on your tile type logic)
-        // Assuming you have a set or map for water tiles
-        bool hasWater = m_waterPositions.contains({tx, ty});
-
-        // 1. Draw floor and ceiling first
-        // ... (existing floor drawing) ...
-
-        // 2. Draw Water on top of the floor
-        if (hasWater) {
-            drawWater(d, xL, xR, yB, nxL, nxR, nyB);
-        }
-
-        // 1. Check if this tile is a Spinner (Rotator)
-        bool hasSpinner = m_rotatorPositions.contains({tx, ty});
-
-        // ... (Existing Floor, Ceiling, and Side Wall rendering)
-
-        // 2. Draw the Spinner effect
-        if (hasSpinner) {
-            drawSpinner(d, xL, xR, yB, nxL, nxR, nyB);
-        }
-
-        // 1. Check for teleporter at this map coordinate
-        bool hasTeleporter = m_teleporterPositions.contains({tx, ty});
-
-        // ... existing Floor/Ceiling/Side Wall rendering ...
-
-        // 2. Draw the Teleporter effect on the floor
-        if (hasTeleporter) {
-            drawTeleporter(d, xL, xR, yB, nxL, nxR, nyB);
-        }
-
-        // Check if there is a monster at this coordinate
-        bool hasMonster = m_monsterPositions.contains({tx, ty});
-
-        // ... (draw floor and side walls)
-
-        // Draw the monster if present
-        if (hasMonster) {
-            drawMonster(d, xL, xR, yB);
-        }   
-
-        // --- 4. FRONT WALL (Main Path) ---
-        if (wallFront) {
-            int frontCol = qMax(0, 110 - (d * 20));
-            m_dungeonScene->addRect(xL, yT, xR - xL, yB - yT, QPen(Qt::black), QBrush(QColor(frontCol, frontCol, frontCol)));
-        }
-        
-        // 1. Check if there is a chute at this specific map tile
-        bool hasChute = m_chutePositions.contains({tx, ty});
-        // 2. Draw the chute on top of the floor
-        if (hasChute) {
-            drawChute(d, xL, xR, yB, nxL, nxR, nyB);
-        }
-    }
-}
-
-void DungeonDialog::drawBrickPattern(const QPolygon& wallPoly, int depth) 
-{
-    Q_UNUSED(depth);
-    QRect bounds = wallPoly.boundingRect();
-    QPen mortarPen(QColor(40, 40, 40, 150)); // Semi-transparent dark gray
-    mortarPen.setWidth(1);
-
-    int rows = 6;    // Number of brick layers
-    int columns = 4; // Number of bricks per row
-    
-    // Calculate row height
-    double rowHeight = static_cast<double>(bounds.height()) / rows;
-
-    for (int i = 1; i < rows; ++i) {
-        int y = bounds.top() + (i * rowHeight);
-        
-        // Find left and right edges of the polygon at this specific Y height
-        // to ensure bricks don't float outside the perspective wall
-        int xMin = bounds.right();
-        int xMax = bounds.left();
-        
-        // Basic scan-line logic to keep lines inside the trapezoid
-        for (int x = bounds.left(); x <= bounds.right(); ++x) {
-            if (wallPoly.containsPoint(QPoint(x, y), Qt::OddEvenFill)) {
-                xMin = qMin(xMin, x);
-                xMax = qMax(xMax, x);
-            }
-        }
-
-        // Draw horizontal mortar line
-        if (xMin < xMax) {
-            m_dungeonScene->addLine(xMin, y, xMax, y, mortarPen);
-            
-            // Draw vertical "staggered" mortar lines
-            double colWidth = static_cast<double>(xMax - xMin) / columns;
-            double offset = (i % 2 == 0) ? 0 : colWidth / 2; // Stagger bricks
-            
-            for (int j = 0; j <= columns; ++j) {
-                int vx = xMin + (j * colWidth) + offset;
-                if (vx > xMin && vx < xMax) {
-                    m_dungeonScene->addLine(vx, y, vx, y - rowHeight, mortarPen);
-                }
-            }
-        }
-    }
-}
-
-void DungeonDialog::drawChute(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB) {
-    // We want the chute to be in the center of the tile floor
-    // Calculate a 40% width/depth hole
-    double margin = 0.3;     
-    // Interpolate points for the "hole" on the floor
-    int cxL = xL + (xR - xL) * margin;
-    int cxR = xR - (xR - xL) * margin;
-    int cnxL = nxL + (nxR - nxL) * margin;
-    int cnxR = nxR - (nxR - nxL) * margin;
-    // Perspective depth for the floor (yB to nyB)
-    int cyNear = yB;
-    int cyFar = yB + (nyB - yB) * 0.6; // The hole doesn't take the whole tile
-
-    QPolygon chuteHole;
-    chuteHole << QPoint(cxL, cyNear) << QPoint(cxR, cyNear) 
-              << QPoint(cnxR, cyFar) << QPoint(cnxL, cyFar);
-    // Draw the "void" (black hole)
-    m_dungeonScene->addPolygon(chuteHole, QPen(Qt::black), QBrush(Qt::black));
-    // Draw inner "walls" of the chute for a 3D effect
-    QPolygon leftInner;
-    leftInner << QPoint(cxL, cyNear) << QPoint(cnxL, cyFar) 
-              << QPoint(cnxL, cyFar + 10) << QPoint(cxL, cyNear + 10);
-    
-    int depthShade = qMax(0, 30 - (d * 10));
-    m_dungeonScene->addPolygon(leftInner, QPen(Qt::NoPen), QBrush(QColor(depthShade, depthShade, depthShade)));
-}
-
-void DungeonDialog::drawMonster(int d, int xL, int xR, int yB) {
-    // Calculate size based on depth
-    // d=0 (Near): Large, d=2 (Far): Small
-    int monsterWidth = (xR - xL) * 0.6; 
-    int monsterHeight = monsterWidth * 1.2;
-    
-    // Center horizontally, sit on the floor (yB)
-    int centerX = xL + (xR - xL) / 2;
-    int xPos = centerX - (monsterWidth / 2);
-    int yPos = yB - monsterHeight;
-
-    // Depth shading: make monsters darker in the distance
-    int shade = qMax(0, 200 - (d * 60));
-    QColor monsterColor(shade, 0, 0); // Dark red silhouette
-
-    // Draw a simple head and body (billboard style)
-    QRect body(xPos, yPos + (monsterHeight * 0.3), monsterWidth, monsterHeight * 0.7);
-    QRect head(centerX - (monsterWidth / 4), yPos, monsterWidth / 2, monsterHeight * 0.4);
-
-    m_dungeonScene->addEllipse(head, QPen(Qt::black), QBrush(monsterColor));
-    m_dungeonScene->addRect(body, QPen(Qt::black), QBrush(monsterColor));
-}
-
-void DungeonDialog::drawTeleporter(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB) 
-{
-    Q_UNUSED(nxR);
-    Q_UNUSED(nxL);
-    // Calculate the center and size of the tile floor
-    int centerX = xL + (xR - xL) / 2;
-    int centerY = yB + (nyB - yB) / 2;    
-    // Scale radius based on depth
-    int baseRadius = (xR - xL) / 3;
-    // Create a shimmering effect with multiple ellipses
-    for (int i = 0; i < 3; ++i) {
-        int r = baseRadius - (i * (baseRadius / 4));
-        QRectF glowRect(centerX - r, centerY - (r / 2), r * 2, r); // Flattened for perspective
-        // Alternating cyan/blue glow
-        QColor glowColor = (i % 2 == 0) ? QColor(0, 255, 255, 150) : QColor(0, 100, 255, 100);
-        // Depth shading: make it dimmer in the distance
-        int alpha = glowColor.alpha() - (d * 30);
-        glowColor.setAlpha(qMax(0, alpha));
-        m_dungeonScene->addEllipse(glowRect, QPen(Qt::white, 1), QBrush(glowColor));
-    }
-    // Optional: Add some "sparkles" (small white dots)
-    for (int j = 0; j < 5; ++j) {
-        int sx = centerX + (QRandomGenerator::global()->bounded(baseRadius * 2) - baseRadius);
-        int sy = centerY + (QRandomGenerator::global()->bounded(baseRadius) - (baseRadius / 2));
-        m_dungeonScene->addRect(sx, sy, 1, 1, QPen(Qt::white), QBrush(Qt::white));
-    }
-}
-
-void DungeonDialog::drawSpinner(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB) {
-    // Calculate the center of the tile floor using both near and far bounds
-    int centerX = (xL + xR + nxL + nxR) / 4;
-    int centerY = (yB + nyB) / 2;    
-    // Scale the size of the spinner based on the available floor width at this depth
-    int radius = (xR - xL) / 3;
-    QPen spinnerPen(QColor(200, 200, 0), 2); 
-    // Depth shading to make it darker in the distance
-    int alpha = qMax(0, 200 - (d * 50));
-    spinnerPen.setColor(QColor(200, 200, 0, alpha));
-    // Define the bounding rect for the ellipse/arcs, flattened for perspective
-    QRectF arcRect(centerX - radius, centerY - (radius / 2), radius * 2, radius);
-    // QGraphicsScene doesn't have addArc; we use QPainterPath instead
-    for (int i = 0; i < 4; ++i) {
-        QPainterPath path;
-        int startAngle = i * 90; // Angles in QPainterPath are in degrees
-        int spanAngle = 60;
-        
-        path.arcMoveTo(arcRect, startAngle);
-        path.arcTo(arcRect, startAngle, spanAngle);
-        
-        m_dungeonScene->addPath(path, spinnerPen);
-    }
-    // Add a center point (uses near/far center)
-    m_dungeonScene->addEllipse(centerX - 2, centerY - 1, 4, 2, spinnerPen, QBrush(spinnerPen.color()));
-}
-
-void DungeonDialog::drawWater(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB) {
-    // 1. Create the water surface polygon (the floor area)
-    QPolygon waterPoly;
-    waterPoly << QPoint(xL, yB) << QPoint(xR, yB) << QPoint(nxR, nyB) << QPoint(nxL, nyB);
-    // Deep blue color, semi-transparent so you can still see the floor/chutes
-    int alpha = qMax(0, 180 - (d * 40));
-    QColor waterColor(0, 105, 148, alpha); // Sea Blue
-    m_dungeonScene->addPolygon(waterPoly, QPen(Qt::NoPen), QBrush(waterColor));
-    // 2. Add "Ripples" (shimmering lines)
-    QPen ripplePen(QColor(255, 255, 255, qMax(0, 100 - (d * 30))));
-    ripplePen.setWidth(1);
-    // Draw 3 horizontal lines at different depths within the tile
-    for (int i = 1; i <= 3; ++i) {
-        double ratio = i / 4.0;
-        // Interpolate Y position between near (yB) and far (nyB)
-        int ry = yB + (nyB - yB) * ratio;
-        // Interpolate X width based on perspective
-        int rxL = xL + (nxL - xL) * ratio;
-        int rxR = xR + (nxR - xR) * ratio;
-        // Draw a partial shimmering line (not the whole width for a natural look)
-        int rippleWidth = (rxR - rxL) * 0.6;
-        int rippleStart = rxL + (rxR - rxL) * 0.2;
-        
-        m_dungeonScene->addLine(rippleStart, ry, rippleStart + rippleWidth, ry, ripplePen);
-    }
-}
-void DungeonDialog::drawAntimagic(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB) {
-    // Define the floor polygon for clipping or reference
-    QPolygon floorPoly;
-    floorPoly << QPoint(xL, yB) << QPoint(xR, yB) << QPoint(nxR, nyB) << QPoint(nxL, nyB);
-    // Color: A muted, "dulling" purple or gray
-    int alpha = qMax(0, 120 - (d * 30));
-    QColor fieldColor(100, 100, 150, alpha); 
-    // Draw a subtle tint first
-    m_dungeonScene->addPolygon(floorPoly, QPen(Qt::NoPen), QBrush(fieldColor));
-    // Draw "Static" lines (cross-hatch pattern)
-    QPen staticPen(QColor(200, 200, 255, qMax(0, 150 - (d * 40))));
-    staticPen.setWidth(1);
-
-    int lines = 5;
-    for (int i = 0; i <= lines; ++i) {
-        double ratio = (double)i / lines;
-
-        // Vertical-ish lines (converging towards vanishing point)
-        int xNear = xL + (xR - xL) * ratio;
-        int xFar = nxL + (nxR - nxL) * ratio;
-        m_dungeonScene->addLine(xNear, yB, xFar, nyB, staticPen);
-
-        // Horizontal lines (interpolated by depth)
-        int yHoriz = yB + (nyB - yB) * ratio;
-        int xHLeft = xL + (nxL - xL) * ratio;
-        int xHRight = xR + (nxR - xR) * ratio;
-        m_dungeonScene->addLine(xHLeft, yHoriz, xHRight, yHoriz, staticPen);
-    }
-}
-
 void DungeonDialog::togglePartyInfo() {
     if (m_charSheet) {
         m_charSheet->close();
@@ -1729,11 +1218,11 @@ void DungeonDialog::on_spellButton_clicked()
     logMessage("You try to cast some sort of spell but fail."); 
     // Check if in antimagic zone
     gameStateManager* gsm = gameStateManager::instance();
-    int x = gsm->getGameValue("DungeonX").toInt();
-    int y = gsm->getGameValue("DungeonY").toInt();
+    int x = gsm->dungeonX();
+    int y = gsm->dungeonY();
     QPair<int, int> pos = {x, y};
     
-    if (m_antimagicPositions.contains(pos)) {
+    if (m_grid.has(pos, MapFeature::ANTIMAGIC)) {
         logMessage("<font color='purple'>An antimagic field prevents you from casting spells here!</font>");
         return;
     }
@@ -1749,22 +1238,15 @@ void DungeonDialog::on_spellButton_clicked()
     logMessage(QString("<font color='cyan'>%1</font>").arg(result.message));
         
         // Handle damage to current monster if in combat
-        if (result.damageDealt > 0 && m_isFighting && m_activeMonsterHP > 0) {
-            m_activeMonsterHP -= result.damageDealt;
+        if (result.damageDealt > 0 && m_isFighting && m_combat) {
+            m_combat->damage(m_combatMonster, result.damageDealt);
             logMessage(QString("<font color='yellow'>The %1 takes %2 spell damage!</font>")
                       .arg(m_activeMonsterName).arg(result.damageDealt));
-            
-            if (m_activeMonsterHP <= 0) {
+            if (!m_combat->combatant(m_combatMonster).alive()) {
                 logMessage(QString("<font color='green'>The %1 is destroyed by your magic!</font>")
                           .arg(m_activeMonsterName));
-                m_isFighting = false;
-                m_isDefending = false;
-                if (m_combatTimer) m_combatTimer->stop();
-                
-                QPair<int, int> pos = getCurrentPosition();
-                m_monsterPositions.remove(pos);
-                renderWireframeView();
             }
+            showCombatEvents();
         }
         
         // Handle teleport spell
@@ -1794,4 +1276,11 @@ void DungeonDialog::awardBattleLoot() {
     logMessage(QString("<font color='gold'>The monster dropped a %1!</font>").arg(itemName));
 }
 
-DungeonDialog::~DungeonDialog(){}
+DungeonDialog::~DungeonDialog()
+{
+    storeExploration();
+    DungeonScripts::detach(this);
+    delete m_combat;
+    // However the dungeon was left, the party is back in the city zone
+    NetworkManager::instance()->enterZone("theCity");
+}
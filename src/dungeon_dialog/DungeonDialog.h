@@ -18,6 +18,10 @@
 #include "../event/EventManager.h"
 #include "../../gameStateManager.h"
 #include "MiniMapDialog.h"
+#include "DungeonViewAtlas.h"
+#include "DungeonGrid.h"
+#include "LevelGenerator.h"
+#include "../combat/CombatEngine.h"
 
 // Forward declarations
 class QGraphicsScene;
@@ -26,6 +30,9 @@ class QLabel;
 class QPushButton;
 class QListWidget;
 class QTimer;
+class QGraphicsPixmapItem;
+class QGraphicsEllipseItem;
+class QGraphicsPolygonItem;
 
 // Define MAP_SIZE here to resolve initialization errors in the class definition
 const int MAP_SIZE = 30; 
@@ -49,6 +56,7 @@ class DungeonDialog : public QDialog
 {
     Q_OBJECT
     friend class DungeonHandlers; // allow the handler to see private members
+    friend class DungeonScripts;  // and the Lua bindings
 public:
     explicit DungeonDialog(QWidget *parent = nullptr);
     //void enterLevel(int level);
@@ -99,22 +107,23 @@ private:
     void awardBattleLoot();
     void setupControls();
     void handleFalling(); // New method to handle falling through a pit
-    QSet<QPair<int, int>> m_bodyPositions;
     PartyInfoDialog *m_charSheet = nullptr; // Track the window here
     QPair<int, int> getCurrentPosition(); // The helper function
     QTimer *m_combatTimer = nullptr; // MUST be here
-    int m_playerAttackCooldown = 0;
-    int m_monsterAttackCooldown = 0;
     bool m_isFighting = false;
     bool m_isDefending = false;
 
-    void performPlayerAttack();
-    void performMonsterAttack();
+    // The fight itself runs in CombatEngine; the dialog only drives its clock and shows the results
+    CombatEngine *m_combat = nullptr;
+    int m_combatHero = -1;
+    int m_combatMonster = -1;
+    void startCombat();
+    void showCombatEvents();
+    void endCombat(bool won);
+    void partyDefeated();
 
     QString m_activeMonsterName;
-    int m_activeMonsterHP;
     bool m_isInCombat = false;
-    QSet<QPair<int, int>> m_roomFloorTiles; // Tracks tiles that are part of rooms
     MinimapDialog *m_standaloneMinimap = nullptr;
     QList<QPair<int, int>> m_breadcrumbPath; // Stores the history of player positions
     const int MAX_BREADCRUMBS = 50;           // Limits the length of the trail
@@ -163,36 +172,30 @@ private:
     QSet<TilePos> m_chutePositions3D;
     QMap<TilePos, QString> m_monsterPositions3D;
     QMap<TilePos, QString> m_treasurePositions3D;
-    QSet<QPair<int, int>> m_obstaclePositions;
-    void generateRandomObstacles(int obstacleCount, QRandomGenerator& rng);
-    void generateStairs(QRandomGenerator& rng); 
-    void generateSpecialTiles(int tileCount, QRandomGenerator& rng);
+    // Levels come from LevelGenerator; the neighbours of the current one are built in the background
+    LevelCache m_levelCache;
+    void applyLevel(const GeneratedLevel& level);
     QPair<int, int> m_stairsUpPosition; 
     QPair<int, int> m_stairsDownPosition; 
-    // Special Tile Position Sets (Combined list)
-    QSet<QPair<int, int>> m_antimagicPositions; // implemented
-    QSet<QPair<int, int>> m_extinguisherPositions; // implemented 
-    QSet<QPair<int, int>> m_fogPositions; // implemented
-    QSet<QPair<int, int>> m_pitPositions; // implemented
-    QSet<QPair<int, int>> m_rotatorPositions; // implemented
-    QSet<QPair<int, int>> m_studPositions; // implemented
-    QSet<QPair<int, int>> m_chutePositions; // implemeted
-    QSet<QPair<int, int>> m_teleportPositions; // implemented
-    QSet<QPair<int, int>> m_waterPositions; // implemented
-    QSet<QPair<int, int>> m_teleporterPositions; // implemented
-    QSet<QPair<int, int>> m_hiddenDoorPositions;
-    // Map data
-    // In the private section of DungeonDialog class
-    QSet<QPair<int, int>> m_visitedTiles; // Tracks which (x, y) coordinates have been seen
-    QMap<QPair<int, int>, QString> m_monsterPositions;
-    QMap<QPair<int, int>, QString> m_treasurePositions;
-    QMap<QPair<int, int>, QString> m_trapPositions;
+    // Live level state: walls, hazards, visited tiles, monsters, treasure,
+    // traps, hidden doors and bodies are all bits in one CellData grid.
+    DungeonGrid m_grid;
     QMap<QString, QString> m_MonsterAttitude;
     enum class StairDirection {
         Up,
         Down
     };
     void drawMinimap(); 
+    // --- Minimap (DungeonMinimap.cpp) ---
+    // One scene for the whole session; drawMinimap() only re-skins tiles whose contents changed.
+    QGraphicsScene *m_minimapScene = nullptr;
+    QGraphicsPixmapItem *m_minimapTiles[MAP_SIZE][MAP_SIZE] = {};
+    quint32 m_minimapTileMask[MAP_SIZE][MAP_SIZE] = {};
+    QHash<quint32, QPixmap> m_minimapTileCache; // Composed tile image per feature combination
+    QList<QGraphicsEllipseItem*> m_minimapBreadcrumbs;
+    QGraphicsPolygonItem *m_minimapPlayer = nullptr;
+    void buildMinimapScene();
+    QPixmap minimapTileFor(quint32 mask);
     void handleMovement(int actionIndex);
     void handleSurfaceExit();
     void transitionLevel(StairDirection direction);
@@ -203,7 +206,9 @@ private:
     void logMessage(const QString& message); 
     void spawnMonsters(const QString& monsterType, int count);
     void revealAroundPlayer(int x, int y, int z);
-    void populateRandomTreasures(int level);
+    // Explored tiles of the active level to/from gameStateManager, so they outlive the level and get saved
+    void storeExploration();
+    void restoreExploration();
     void processTreasureOpening();
     void keyPressEvent(QKeyEvent *event) override;
     QGraphicsScene* m_threeDScene;
@@ -213,14 +218,20 @@ private:
     void drawWireframeWall(int depth, bool left, bool right, bool front);
     bool isWallAt(int x, int y);
     bool isWallAtSide(int x, int y, const QString& side);
+    // --- 3D View (DungeonWireframe.cpp) ---
+    // Layers are pre-rendered once per (depth, layer) in m_viewAtlas;
+    // renderWireframeView() only picks which ones m_viewItem blits.
+    DungeonViewAtlas m_viewAtlas;
+    DungeonViewItem *m_viewItem = nullptr;
+    QGraphicsScene *m_wireframeScene = nullptr; // Scene m_viewItem lives in (nullptr = rebuild)
+    // Frame-time counter for renderWireframeView()
+    qint64 m_frameTimeLastNs = 0;
+    qint64 m_frameTimeMaxNs = 0;
+    qint64 m_frameTimeTotalNs = 0;
+    int m_frameCount = 0;
     void renderWireframeView();
-    void drawBrickPattern(const QPolygon& wallPoly, int depth);
-    void  drawChute(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB);
-    void drawMonster(int d, int xL, int xR, int yB);
-    void drawTeleporter(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB);
-    void drawSpinner(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB);
-    void drawWater(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB);
-    void drawAntimagic(int d, int xL, int xR, int yB, int nxL, int nxR, int nyB);
+    void buildWireframeItems();
+    qreal wireframePixelScale() const;
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
@@ -0,0 +1,164 @@
+#ifndef DUNGEONGRID_H
+#define DUNGEONGRID_H
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <algorithm>
+#include <array>
+#include "../../maploader/MapLoader.h" // CellData, MapFeature, MAP_LEVELS/WIDTH/HEIGHT
+
+/**
+ * @brief Live dungeon state as a flat MAP_LEVELS x 30 x 30 array of CellData.
+ *
+ * Every tile property (rock, water, pits, visited, monsters, ...) is a bit in
+ * the cell's fieldBitmask, so tile queries are a single bit test instead of a
+ * hash lookup per feature set. Features that carry a name (monster type,
+ * treasure item, trap kind) keep that name in a side table; the bit is still
+ * the source of truth for "is there one here".
+ *
+ * Layout matches MapLoader: [level][y][x], 16 cells per 64-byte cache line.
+ */
+class DungeonGrid {
+public:
+    static constexpr int LEVELS = MAP_LEVELS;
+    static constexpr int WIDTH = MAP_WIDTH;
+    static constexpr int HEIGHT = MAP_HEIGHT;
+
+    static constexpr quint32 bit(MapFeature feature) { return static_cast<quint32>(feature); }
+
+    static bool inBounds(int x, int y) {
+        return x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT;
+    }
+
+    // Selects the active level (dungeon levels are 1-based)
+    void setLevel(int level) { m_level = qBound(0, level - 1, LEVELS - 1); }
+    int levelIndex() const { return m_level; }
+
+    CellData& at(int levelIndex, int x, int y) { return m_cells[index(levelIndex, x, y)]; }
+    const CellData& at(int levelIndex, int x, int y) const { return m_cells[index(levelIndex, x, y)]; }
+
+    // --- Queries on the active level (out of bounds = empty cell) ---
+    quint32 bits(int x, int y) const {
+        return inBounds(x, y) ? at(m_level, x, y).fieldBitmask : 0;
+    }
+    bool has(int x, int y, MapFeature feature) const {
+        return (bits(x, y) & bit(feature)) != 0;
+    }
+    bool has(const QPair<int, int>& pos, MapFeature feature) const {
+        return has(pos.first, pos.second, feature);
+    }
+
+    // --- Mutation on the active level ---
+    void set(int x, int y, MapFeature feature) {
+        if (inBounds(x, y)) at(m_level, x, y).fieldBitmask |= bit(feature);
+    }
+    void set(const QPair<int, int>& pos, MapFeature feature) { set(pos.first, pos.second, feature); }
+
+    void clear(int x, int y, MapFeature feature) {
+        if (!inBounds(x, y)) return;
+        at(m_level, x, y).fieldBitmask &= ~bit(feature);
+        m_names.remove(nameKey(x, y, feature));
+    }
+    void clear(const QPair<int, int>& pos, MapFeature feature) { clear(pos.first, pos.second, feature); }
+
+    // Sets the bit and remembers what it is (e.g. "Orc" for MONSTER)
+    void place(const QPair<int, int>& pos, MapFeature feature, const QString& name) {
+        if (!inBounds(pos.first, pos.second)) return;
+        set(pos, feature);
+        m_names.insert(nameKey(pos.first, pos.second, feature), name);
+    }
+    QString name(const QPair<int, int>& pos, MapFeature feature) const {
+        if (!has(pos, feature)) return QString();
+        return m_names.value(nameKey(pos.first, pos.second, feature));
+    }
+
+    // Removes one feature from every cell of the active level
+    void clearFeature(MapFeature feature) {
+        const quint32 mask = ~bit(feature);
+        CellData* level = &m_cells[index(m_level, 0, 0)];
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            level[i].fieldBitmask &= mask;
+        }
+        for (auto it = m_names.begin(); it != m_names.end(); ) {
+            if (featureOfKey(it.key()) == bit(feature) && levelOfKey(it.key()) == m_level) it = m_names.erase(it);
+            else ++it;
+        }
+    }
+
+    // Wipes the active level (used when a level is (re)generated)
+    void clearLevel() {
+        CellData* level = &m_cells[index(m_level, 0, 0)];
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            level[i].fieldBitmask = 0;
+        }
+        for (auto it = m_names.begin(); it != m_names.end(); ) {
+            if (levelOfKey(it.key()) == m_level) it = m_names.erase(it);
+            else ++it;
+        }
+    }
+
+    // Calls fn(x, y) for every cell on the active level that has the feature,
+    // in row-major order (deterministic, unlike iterating a QSet).
+    template <typename Fn>
+    void forEach(MapFeature feature, Fn fn) const {
+        const quint32 mask = bit(feature);
+        const CellData* level = &m_cells[index(m_level, 0, 0)];
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int x = 0; x < WIDTH; ++x) {
+                if (level[y * WIDTH + x].fieldBitmask & mask) fn(x, y);
+            }
+        }
+    }
+
+    int count(MapFeature feature) const {
+        int n = 0;
+        forEach(feature, [&n](int, int) { ++n; });
+        return n;
+    }
+
+    // The active level's cells and names, detached from the grid, so a level
+    // can be built elsewhere (see LevelGenerator) and swapped in whole
+    struct LevelSnapshot {
+        std::array<CellData, WIDTH * HEIGHT> cells{};
+        QHash<quint64, QString> names;   // Keys as in the grid, without the level part
+    };
+
+    LevelSnapshot snapshotLevel() const {
+        LevelSnapshot snapshot;
+        const CellData* level = &m_cells[index(m_level, 0, 0)];
+        std::copy(level, level + WIDTH * HEIGHT, snapshot.cells.begin());
+        const quint32 base = quint32(index(m_level, 0, 0));
+        for (auto it = m_names.cbegin(); it != m_names.cend(); ++it) {
+            if (levelOfKey(it.key()) == m_level) snapshot.names.insert(it.key() - base, it.value());
+        }
+        return snapshot;
+    }
+
+    // Replaces the active level with 'snapshot'
+    void restoreLevel(const LevelSnapshot& snapshot) {
+        clearLevel();
+        std::copy(snapshot.cells.begin(), snapshot.cells.end(), &m_cells[index(m_level, 0, 0)]);
+        const quint32 base = quint32(index(m_level, 0, 0));
+        for (auto it = snapshot.names.cbegin(); it != snapshot.names.cend(); ++it) {
+            m_names.insert(it.key() + base, it.value());
+        }
+    }
+
+private:
+    static int index(int levelIndex, int x, int y) {
+        return (levelIndex * HEIGHT + y) * WIDTH + x;
+    }
+    // Name keys pack (feature bit, level, cell) into one integer
+    quint64 nameKey(int x, int y, MapFeature feature) const {
+        return (quint64(bit(feature)) << 32) | quint32(index(m_level, x, y));
+    }
+    static quint32 featureOfKey(quint64 key) { return quint32(key >> 32); }
+    static int levelOfKey(quint64 key) { return int(quint32(key) / (WIDTH * HEIGHT)); }
+
+    std::array<CellData, LEVELS * WIDTH * HEIGHT> m_cells{};
+    QHash<quint64, QString> m_names;
+    int m_level = 0;
+};
+
+#endif // DUNGEONGRID_H
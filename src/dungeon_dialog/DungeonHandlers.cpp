@@ -1,11 +1,43 @@
 #include "DungeonHandlers.h"
 #include "DungeonDialog.h"
+#include "DungeonScripts.h"
 #include "../../gameStateManager.h"
 
+// Handlers in the order movePlayer() has always run them.
+// Each entry fires only if its feature bit is set on the cell.
+struct FeatureHandler {
+    MapFeature feature;
+    void (*handler)(DungeonDialog*, int, int);
+};
+
+static const FeatureHandler FEATURE_HANDLERS[] = {
+    { MapFeature::TREASURE,     &DungeonHandlers::handleTreasure },
+    { MapFeature::WATER,        &DungeonHandlers::handleWater },
+    { MapFeature::ANTIMAGIC,    &DungeonHandlers::handleAntimagic },
+    { MapFeature::TRAP,         &DungeonHandlers::handleTrap },
+    { MapFeature::CHUTE,        &DungeonHandlers::handleChute },
+    { MapFeature::EXTINGUISHER, &DungeonHandlers::handleExtinguisher },
+    { MapFeature::MONSTER,      &DungeonHandlers::handleEncounters },
+    { MapFeature::PIT,          &DungeonHandlers::handlePit }
+};
+
+void DungeonHandlers::dispatch(DungeonDialog* dialog, int x, int y, quint32 cellBits)
+{
+    const quint32 scripted = DungeonScripts::scriptedFeatures();
+    for (const FeatureHandler& entry : FEATURE_HANDLERS) {
+        if (cellBits & DungeonGrid::bit(entry.feature)) {
+            // An OnTile handler in dungeon.lua replaces the built-in one
+            if ((scripted & DungeonGrid::bit(entry.feature))
+                && DungeonScripts::runTileHandler(dialog, entry.feature, x, y)) continue;
+            entry.handler(dialog, x, y);
+        }
+    }
+}
+
 void DungeonHandlers::handlePit(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_pitPositions.contains(pos)) {
+    if (dialog->m_grid.has(pos, MapFeature::PIT)) {
         int damage = QRandomGenerator::global()->bounded(2, 13);
         dialog->updatePartyMemberHealth(0, damage);
         dialog->logMessage(QString("<font color='red'>You fall into a pit and take %1 damage!</font>").arg(damage));
@@ -13,7 +45,7 @@ void DungeonHandlers::handlePit(DungeonDialog* dialog, int x, int y)
         // 25% chance to fall to the next level
         if (QRandomGenerator::global()->bounded(100) < 25) {
             dialog->logMessage("<font color='orange'>The floor crumbles away! You tumble to the level below...</font>");
-            int nextLevel = gameStateManager::instance()->getGameValue("DungeonLevel").toInt() + 1;
+            int nextLevel = gameStateManager::instance()->dungeonLevel() + 1;
             dialog->enterLevel(nextLevel);
         }
     }
@@ -23,7 +55,7 @@ void DungeonHandlers::handleWater(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};    
     // Check if the current position contains water using the dialog's member
-    if (dialog->m_waterPositions.contains(pos)) {
+    if (dialog->m_grid.has(pos, MapFeature::WATER)) {
         gameStateManager* gsm = gameStateManager::instance();
         if (gsm->isCharacterOnFire()) {
             gsm->setCharacterOnFire(false);
@@ -37,7 +69,7 @@ void DungeonHandlers::handleWater(DungeonDialog* dialog, int x, int y)
 void DungeonHandlers::handleAntimagic(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_antimagicPositions.contains(pos)) {
+    if (dialog->m_grid.has(pos, MapFeature::ANTIMAGIC)) {
         dialog->logMessage("You enter an Antimagic Field! Your spells feel suppressed.");
     }
 }
@@ -45,12 +77,12 @@ void DungeonHandlers::handleAntimagic(DungeonDialog* dialog, int x, int y)
 void DungeonHandlers::handleTrap(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_trapPositions.contains(pos)) {
-        QString trapType = dialog->m_trapPositions.value(pos);
+    if (dialog->m_grid.has(pos, MapFeature::TRAP)) {
+        QString trapType = dialog->m_grid.name(pos, MapFeature::TRAP);
         int damage = QRandomGenerator::global()->bounded(1, 10);
         dialog->updatePartyMemberHealth(0, damage);
         dialog->logMessage(QString("You step on a **%1** trap and take %2 damage!").arg(trapType).arg(damage));
-        dialog->m_trapPositions.remove(pos);
+        dialog->m_grid.clear(pos, MapFeature::TRAP);
         dialog->drawMinimap();
     }
 };
@@ -58,14 +90,14 @@ void DungeonHandlers::handleTrap(DungeonDialog* dialog, int x, int y)
 void DungeonHandlers::handleChute(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_chutePositions.contains(pos)) {
+    if (dialog->m_grid.has(pos, MapFeature::CHUTE)) {
         dialog->logMessage("AAAHHH! You fall through a hidden chute!");
         // 1. Deal Fall Damage
         int fallDamage = QRandomGenerator::global()->bounded(5, 15);
         dialog->updatePartyMemberHealth(0, fallDamage); // Damage main character
         // 2. Determine New Level
         gameStateManager* gsm = gameStateManager::instance();
-        int nextLevel = gsm->getGameValue("DungeonLevel").toInt() + 1;
+        int nextLevel = gsm->dungeonLevel() + 1;
         // 3. Trigger Level Transition
         dialog->enterLevel(nextLevel);
     }
@@ -74,7 +106,7 @@ void DungeonHandlers::handleChute(DungeonDialog* dialog, int x, int y)
 void DungeonHandlers::handleExtinguisher(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_extinguisherPositions.contains(pos)) {
+    if (dialog->m_grid.has(pos, MapFeature::EXTINGUISHER)) {
         gameStateManager* gsm = gameStateManager::instance();        
         if (gsm->isCharacterOnFire()) {
             gsm->setCharacterOnFire(false);
@@ -88,8 +120,8 @@ void DungeonHandlers::handleExtinguisher(DungeonDialog* dialog, int x, int y)
 void DungeonHandlers::handleEncounters(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_monsterPositions.contains(pos)) {
-        QString monster = dialog->m_monsterPositions.value(pos);
+    if (dialog->m_grid.has(pos, MapFeature::MONSTER)) {
+        QString monster = dialog->m_grid.name(pos, MapFeature::MONSTER);
         QString attitude = dialog->m_MonsterAttitude.value(monster, "Hostile");
         dialog->logMessage(QString("You encounter a **%1**! It looks **%2**.").arg(monster).arg(attitude));
     }
@@ -98,7 +130,7 @@ void DungeonHandlers::handleEncounters(DungeonDialog* dialog, int x, int y)
 void DungeonHandlers::handleTreasure(DungeonDialog* dialog, int x, int y)
 {
     QPair<int, int> pos = {x, y};
-    if (dialog->m_treasurePositions.contains(pos)) {
+    if (dialog->m_grid.has(pos, MapFeature::TREASURE)) {
         dialog->logMessage("There is a treasure chest here! Use the Open button to see what's inside.");
     }
 }
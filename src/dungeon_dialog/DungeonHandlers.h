@@ -3,11 +3,14 @@
 
 #include <QPair>
 #include <QString>
+#include <QtGlobal>
 // Forward declaration to avoid circular includes
 class DungeonDialog;
 
 class DungeonHandlers {
 public:
+    // Runs every handler whose feature bit is set in cellBits (see DungeonGrid)
+    static void dispatch(DungeonDialog* dialog, int x, int y, quint32 cellBits);
     static void handlePit(DungeonDialog* dialog, int x, int y);
     static void handleWater(DungeonDialog* dialog, int x, int y);
     static void handleAntimagic(DungeonDialog* dialog, int x, int y);
@@ -1,7 +1,11 @@
 #include "DungeonDialog.h"
 #include "../../gameStateManager.h"
+#include "src/core/game_resources.h"
 #include <QGraphicsPixmapItem>
 #include <QGraphicsPolygonItem>
+#include <QGraphicsEllipseItem>
+#include <QPainter>
+#include <functional>
 #include <QPen>
 #include <QBrush>
 #include <QDebug>
@@ -10,362 +14,287 @@ static const int TILE_SIZE = 10;
 static const int MAP_WIDTH_PIXELS = MAP_SIZE * TILE_SIZE; 
 static const int MAP_HEIGHT_PIXELS = MAP_SIZE * TILE_SIZE; 
 
-void DungeonDialog::drawMinimap()
+// Everything that can be shown on one minimap tile, in paint order
+enum MinimapFeature : quint32 {
+    MinimapRock         = 1u << 0,
+    MinimapChute        = 1u << 1,
+    MinimapMonster      = 1u << 2,
+    MinimapTreasure     = 1u << 3,
+    MinimapTrap         = 1u << 4,
+    MinimapAntimagic    = 1u << 5,
+    MinimapRotator      = 1u << 6,
+    MinimapWater        = 1u << 7,
+    MinimapTeleport     = 1u << 8,
+    MinimapStud         = 1u << 9,
+    MinimapExtinguisher = 1u << 10,
+    MinimapPit          = 1u << 11,
+    // Drawn above the floor features (were Z=1 items)
+    MinimapStairsUp     = 1u << 12,
+    MinimapStairsDown   = 1u << 13,
+    MinimapHiddenDoor   = 1u << 14,
+    MinimapBody         = 1u << 15,
+    // Fog of war replaces everything else on the tile
+    MinimapFog          = 1u << 16
+};
+
+static QPixmap minimapPixmap(const char* name)
+{
+    return GameResources::getScaledPixmap(QString("resources/images/minimap/%1.png").arg(name), TILE_SIZE, TILE_SIZE);
+}
+
+// Paints one image tile, or the fallback shape if the image is missing
+static void paintMinimapImage(QPainter& p, const char* name, const std::function<void(QPainter&)>& fallback)
 {
-    QString fogPath = "resources/images/minimap/fog.png";
-    QString antimagicPath = "resources/images/minimap/antimagic.png";
-    QString chutePath = "resources/images/minimap/chute.png";
-    QString extinguisherPath = "resources/images/minimap/extinguisher.png";
-    QString rotatorPath = "resources/images/minimap/rotator.png";
-    QString rockPath = "resources/images/minimap/rock.png";
-    QString studPath = "resources/images/minimap/stud.png";
-    QString teleporterPath = "resources/images/minimap/teleporter.png";
-    QString stairsdownPath = "resources/images/minimap/stairsdown.png";
-    QString stairsupPath = "resources/images/minimap/stairsup.png";
-    QString waterPath = "resources/images/minimap/water.png";
-    QPixmap antimagicPixmap(antimagicPath);
-    QPixmap chutePixmap(chutePath);
-    QPixmap extinguisherPixmap(extinguisherPath);
-    QPixmap rotatorPixmap(rotatorPath);
-    QPixmap studPixmap(studPath);
-    QPixmap teleporterPixmap(teleporterPath);
-    QPixmap stairsdownPixmap(stairsdownPath);
-    QPixmap waterPixmap(waterPath);
-    QPixmap stairsupPixmap(stairsupPath);
-    QPixmap scaledAntimagic = antimagicPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledChute = chutePixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledExtinguisher = extinguisherPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledRotator = rotatorPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledStud = studPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledTeleporter = teleporterPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledStairsDown = stairsdownPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledWater = waterPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap scaledStairsUp = stairsupPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    QPixmap fogPixmap(fogPath);
-    // Check if the image loaded correctly for debugging
-    if (fogPixmap.isNull()) {
-        qDebug() << "Error: Fog image not found at" << fogPath;
+    QPixmap pixmap = minimapPixmap(name);
+    if (!pixmap.isNull()) {
+        p.drawPixmap(0, 0, pixmap);
+    } else {
+        fallback(p);
     }
-    // Scale the image once to 10x10 pixels (TILE_SIZE)
-    QPixmap scaledFog = fogPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                         Qt::IgnoreAspectRatio, 
-                                         Qt::SmoothTransformation);
-    // Load and scale the rock pixmap
-    QPixmap rockPixmap(rockPath);
-     // Check if the image loaded correctly for debugging
-    if (rockPixmap.isNull()) {
-         qDebug() << "Error: rock image not found at" << rockPath;
+}
+
+// Composes the 10x10 image for one feature combination. Each combination is
+// only painted once and then reused from m_minimapTileCache.
+QPixmap DungeonDialog::minimapTileFor(quint32 mask)
+{
+    auto cached = m_minimapTileCache.constFind(mask);
+    if (cached != m_minimapTileCache.constEnd()) {
+        return cached.value();
     }
-    QPixmap scaledRock = rockPixmap.scaled(TILE_SIZE, TILE_SIZE, 
-                                           Qt::IgnoreAspectRatio, 
-                                           Qt::SmoothTransformation);
-    gameStateManager* gsm = gameStateManager::instance();
-    // Retrieve player position from GameState
-    int currentX = gsm->getGameValue("DungeonX").toInt();
-    int currentY = gsm->getGameValue("DungeonY").toInt();
-    QPair<int, int> currentPos = {currentX, currentY};
-    // Mark the current position as visited for the Fog of War
-    m_visitedTiles.insert(currentPos);
-    QGraphicsScene *scene = new QGraphicsScene(this);
-    scene->setSceneRect(0, 0, MAP_WIDTH_PIXELS, MAP_HEIGHT_PIXELS);
-    // Check the toggle state from our new dialog
-    bool revealAll = m_standaloneMinimap && m_standaloneMinimap->isRevealAllEnabled();
-    // 2. Draw Obstacles (Walls)
-    for (const auto& pos : m_obstaclePositions) {
-        // Walls are visible only if the tile has been visited
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!rockPixmap.isNull()) {
-                // Use the rock image tile
-                QGraphicsPixmapItem* rockTile = scene->addPixmap(scaledRock);
-                rockTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback to dark gray rectangle if image is missing
-                scene->addRect(pos.first * TILE_SIZE, pos.second * TILE_SIZE, 
-                               TILE_SIZE, TILE_SIZE, QPen(Qt::black), QBrush(Qt::darkGray));
-            }
-        }
+
+    QPixmap tile(TILE_SIZE, TILE_SIZE);
+    tile.fill(Qt::transparent);
+    QPainter p(&tile);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    if (mask & MinimapFog) {
+        paintMinimapImage(p, "fog", [](QPainter& q) {
+            q.fillRect(0, 0, TILE_SIZE, TILE_SIZE, QColor(0, 0, 0, 220));
+        });
     }
-    // 3. Draw Stairs (Cyan)
-    if (revealAll || m_visitedTiles.contains(m_stairsUpPosition)) {
-        if (!stairsupPixmap.isNull()) {
-            QGraphicsPixmapItem* upTile = scene->addPixmap(scaledStairsUp);
-            upTile->setPos(m_stairsUpPosition.first * TILE_SIZE, 
-                           m_stairsUpPosition.second * TILE_SIZE);
-            upTile->setZValue(1); // Ensure it stays above the floor/grid
-        } else {
-            // Fallback to Cyan if image fails to load
-            QGraphicsRectItem* stairsRect = scene->addRect(m_stairsUpPosition.first * TILE_SIZE, 
-                           m_stairsUpPosition.second * TILE_SIZE, 
-                           TILE_SIZE, TILE_SIZE, QPen(Qt::black), QBrush(Qt::cyan));
-            stairsRect->setZValue(1);
-        }
+    if (mask & MinimapRock) {
+        paintMinimapImage(p, "rock", [](QPainter& q) {
+            q.setPen(QPen(Qt::black)); q.setBrush(Qt::darkGray);
+            q.drawRect(0, 0, TILE_SIZE, TILE_SIZE);
+        });
     }
-    if (revealAll || m_visitedTiles.contains(m_stairsDownPosition)) {
-        if (!stairsdownPixmap.isNull()) {
-            QGraphicsPixmapItem* downTile = scene->addPixmap(scaledStairsDown);
-            downTile->setPos(m_stairsDownPosition.first * TILE_SIZE, 
-                           m_stairsDownPosition.second * TILE_SIZE);
-            downTile->setZValue(1); // Ensure it stays above the floor/grid
-        } else {
-            // Fallback to Cyan if image fails to load
-            QGraphicsRectItem* stairsRect = scene->addRect(m_stairsDownPosition.first * TILE_SIZE, 
-                           m_stairsDownPosition.second * TILE_SIZE, 
-                           TILE_SIZE, TILE_SIZE, QPen(Qt::black), QBrush(Qt::cyan));
-            stairsRect->setZValue(1);
-        }
+    if (mask & MinimapChute) {
+        paintMinimapImage(p, "chute", [](QPainter& q) {
+            q.setPen(QPen(Qt::gray)); q.setBrush(Qt::black);
+            q.drawEllipse(1, 1, TILE_SIZE - 2, TILE_SIZE - 2);
+        });
     }
-    // 4. Draw Chutes (Only if visited)
-    for (const auto& pos : m_chutePositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledChute.isNull()) {
-                // Use the chute image tile
-                QGraphicsPixmapItem* chuteTile = scene->addPixmap(scaledChute);
-                chuteTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback to the ellipse if image fails to load
-                scene->addEllipse(pos.first * TILE_SIZE + 1, pos.second * TILE_SIZE + 1, 
-                                  TILE_SIZE - 2, TILE_SIZE - 2, QPen(Qt::gray), QBrush(Qt::black));
-            }
-        }
+    if (mask & MinimapMonster) {
+        p.setPen(QPen(Qt::black)); p.setBrush(Qt::red);
+        p.drawEllipse(TILE_SIZE/4, TILE_SIZE/4, TILE_SIZE/2, TILE_SIZE/2);
     }
-    // 5. Draw Monsters (Red Ellipses)
-    for (auto it = m_monsterPositions.begin(); it != m_monsterPositions.end(); ++it) {
-        QPair<int, int> pos = it.key();
-        // Only show if the tile is visited or "Reveal All" is on
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            scene->addEllipse(pos.first * TILE_SIZE + TILE_SIZE/4, 
-                              pos.second * TILE_SIZE + TILE_SIZE/4, 
-                              TILE_SIZE/2, TILE_SIZE/2, 
-                              QPen(Qt::black), QBrush(Qt::red));
-        }
+    if (mask & MinimapTreasure) {
+        p.setPen(QPen(Qt::black)); p.setBrush(Qt::yellow);
+        p.drawRect(TILE_SIZE/4, TILE_SIZE/4, TILE_SIZE/2, TILE_SIZE/2);
     }
-    // 6. Draw Treasure/Chests (Yellow Rectangles)
-    for (auto it = m_treasurePositions.begin(); it != m_treasurePositions.end(); ++it) {
-        QPair<int, int> pos = it.key();
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            scene->addRect(pos.first * TILE_SIZE + TILE_SIZE/4, 
-                           pos.second * TILE_SIZE + TILE_SIZE/4, 
-                           TILE_SIZE/2, TILE_SIZE/2, 
-                           QPen(Qt::black), QBrush(Qt::yellow));
-        }
+    if (mask & MinimapTrap) {
+        p.setPen(QPen(Qt::black)); p.setBrush(Qt::darkGreen);
+        p.drawRect(TILE_SIZE/4, TILE_SIZE/4, TILE_SIZE/2, TILE_SIZE/2);
     }
-    // 7. Draw Traps (Dark Green Rectangles)
-    for (auto it = m_trapPositions.begin(); it != m_trapPositions.end(); ++it) {
-        QPair<int, int> pos = it.key();
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            scene->addRect(pos.first * TILE_SIZE + TILE_SIZE/4, 
-                           pos.second * TILE_SIZE + TILE_SIZE/4, 
-                           TILE_SIZE/2, TILE_SIZE/2, 
-                           QPen(Qt::black), QBrush(Qt::darkGreen));
-        }
+    if (mask & MinimapAntimagic) {
+        paintMinimapImage(p, "antimagic", [](QPainter& q) {
+            q.setPen(QPen(Qt::magenta)); q.setBrush(Qt::NoBrush);
+            q.drawRect(1, 1, TILE_SIZE - 2, TILE_SIZE - 2);
+        });
     }
-    // 7.5. Draw Antimagic Fields (Only if visited)
-    for (const auto& pos : m_antimagicPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledAntimagic.isNull()) {
-                QGraphicsPixmapItem* antiTile = scene->addPixmap(scaledAntimagic);
-                antiTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback to Purple if image fails to load
-                scene->addRect(pos.first * TILE_SIZE + 1, pos.second * TILE_SIZE + 1, 
-                               TILE_SIZE - 2, TILE_SIZE - 2, QPen(Qt::magenta), QBrush(Qt::NoBrush));
-            }
-        }
+    if (mask & MinimapRotator) {
+        paintMinimapImage(p, "rotator", [](QPainter& q) {
+            q.setPen(QPen(Qt::darkYellow)); q.setBrush(Qt::NoBrush);
+            q.drawEllipse(1, 1, TILE_SIZE - 2, TILE_SIZE - 2);
+        });
     }
-    // 7.6. Draw Rotator Tiles (Only if visited)
-    for (const auto& pos : m_rotatorPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledRotator.isNull()) {
-                QGraphicsPixmapItem* rotTile = scene->addPixmap(scaledRotator);
-                rotTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback: A dark green/yellow circle if image fails to load
-                scene->addEllipse(pos.first * TILE_SIZE + 1, pos.second * TILE_SIZE + 1, 
-                                 TILE_SIZE - 2, TILE_SIZE - 2, QPen(Qt::darkYellow), QBrush(Qt::NoBrush));
-            }
-        }
+    if (mask & MinimapWater) {
+        paintMinimapImage(p, "water", [](QPainter& q) {
+            q.setPen(QPen(Qt::blue)); q.setBrush(Qt::blue);
+            q.drawRect(0, 0, TILE_SIZE, TILE_SIZE);
+        });
     }
-    // 7.7. Draw Water Tiles (Only if visited)
-    for (const auto& pos : m_waterPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledWater.isNull()) {
-                QGraphicsPixmapItem* waterTile = scene->addPixmap(scaledWater);
-                waterTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback: Blue square if image fails to load
-                scene->addRect(pos.first * TILE_SIZE, pos.second * TILE_SIZE, 
-                               TILE_SIZE, TILE_SIZE, QPen(Qt::blue), QBrush(Qt::blue));
-            }
-        }
+    if (mask & MinimapTeleport) {
+        paintMinimapImage(p, "teleporter", [](QPainter& q) {
+            q.setPen(QPen(Qt::magenta)); q.setBrush(Qt::NoBrush);
+            q.drawEllipse(1, 1, TILE_SIZE - 2, TILE_SIZE - 2);
+        });
     }
-    // 7.8. Draw Teleporter Tiles (Only if visited)
-    for (const auto& pos : m_teleportPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledTeleporter.isNull()) {
-                // Use the teleporter image tile
-                QGraphicsPixmapItem* teleTile = scene->addPixmap(scaledTeleporter);
-                teleTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback: Magenta circle if image fails to load
-                scene->addEllipse(pos.first * TILE_SIZE + 1, pos.second * TILE_SIZE + 1, 
-                                  TILE_SIZE - 2, TILE_SIZE - 2, QPen(Qt::magenta), QBrush(Qt::NoBrush));
-            }
-        }
+    if (mask & MinimapStud) {
+        paintMinimapImage(p, "stud", [](QPainter& q) {
+            q.setPen(QPen(Qt::gray)); q.setBrush(Qt::lightGray);
+            q.drawRect(2, 2, TILE_SIZE - 4, TILE_SIZE - 4);
+        });
     }
-    // Draw Stud Tiles (Only if visited)
-    for (const auto& pos : m_studPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledStud.isNull()) {
-                // Use the stud image tile
-                QGraphicsPixmapItem* studTile = scene->addPixmap(scaledStud);
-                studTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback: A simple gray rectangle if image fails to load
-                scene->addRect(pos.first * TILE_SIZE + 2, pos.second * TILE_SIZE + 2, 
-                               TILE_SIZE - 4, TILE_SIZE - 4, QPen(Qt::gray), QBrush(Qt::lightGray));
-            }
-        }
+    if (mask & MinimapExtinguisher) {
+        paintMinimapImage(p, "extinguisher", [](QPainter& q) {
+            q.setPen(QPen(Qt::blue)); q.setBrush(Qt::darkBlue);
+            q.drawRect(1, 1, TILE_SIZE - 2, TILE_SIZE - 2);
+        });
     }
-    //Draw extinguisher tiles
-    for (const auto& pos : m_extinguisherPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!scaledExtinguisher.isNull()) {
-                QGraphicsPixmapItem* extTile = scene->addPixmap(scaledExtinguisher);
-                extTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-            } else {
-                // Fallback: Dark Blue/Gray square to represent "extinguishing" light
-                scene->addRect(pos.first * TILE_SIZE + 1, pos.second * TILE_SIZE + 1, 
-                               TILE_SIZE - 2, TILE_SIZE - 2, QPen(Qt::blue), QBrush(Qt::darkBlue));
-            }
-        }
+    if (mask & MinimapPit) {
+        p.setPen(QPen(Qt::darkRed)); p.setBrush(Qt::black);
+        p.drawRect(1, 1, TILE_SIZE - 2, TILE_SIZE - 2);
     }
-    // Draw pits
-    for (const auto& pos : m_pitPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            scene->addRect(pos.first * TILE_SIZE + 1, pos.second * TILE_SIZE + 1, 
-                           TILE_SIZE - 2, TILE_SIZE - 2, 
-                           QPen(Qt::darkRed), QBrush(Qt::black));
-        }
+    if (mask & MinimapStairsUp) {
+        paintMinimapImage(p, "stairsup", [](QPainter& q) {
+            q.setPen(QPen(Qt::black)); q.setBrush(Qt::cyan);
+            q.drawRect(0, 0, TILE_SIZE, TILE_SIZE);
+        });
+    }
+    if (mask & MinimapStairsDown) {
+        paintMinimapImage(p, "stairsdown", [](QPainter& q) {
+            q.setPen(QPen(Qt::black)); q.setBrush(Qt::cyan);
+            q.drawRect(0, 0, TILE_SIZE, TILE_SIZE);
+        });
     }
+    if (mask & MinimapHiddenDoor) {
+        paintMinimapImage(p, "hiddendoor", [](QPainter& q) {
+            q.setPen(QPen(Qt::yellow)); q.setBrush(Qt::yellow);
+            q.drawRect(2, 2, TILE_SIZE - 4, TILE_SIZE - 4);
+        });
+    }
+    if (mask & MinimapBody) {
+        paintMinimapImage(p, "body", [](QPainter& q) {
+            q.setPen(QPen(Qt::red)); q.setBrush(Qt::red);
+            q.drawRect(2, 2, TILE_SIZE - 4, TILE_SIZE - 4);
+        });
+    }
+    p.end();
 
-    // Define a path and pixmap for the door icon
-    QString doorPath = "resources/images/minimap/hiddendoor.png";
-    QPixmap doorPixmap(doorPath);
-    QPixmap scaledDoor = doorPixmap.scaled(TILE_SIZE, TILE_SIZE, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    m_minimapTileCache.insert(mask, tile);
+    return tile;
+}
 
-    // Draw Hidden Doors
-    for (const auto& pos : m_hiddenDoorPositions) {
-        // Logic: Show if debug 'revealAll' is on, OR if the tile is visited
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!doorPixmap.isNull()) {
-                QGraphicsPixmapItem* doorTile = scene->addPixmap(scaledDoor);
-                doorTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-                doorTile->setZValue(1); 
-            } else {
-                // Fallback: Draw a yellow rectangle for testing if image is missing
-                scene->addRect(pos.first * TILE_SIZE + 2, pos.second * TILE_SIZE + 2, 
-                               TILE_SIZE - 4, TILE_SIZE - 4, 
-                               QPen(Qt::yellow), QBrush(Qt::yellow));
-            }
-        }
-    }
+// Creates the one scene the minimap keeps for the lifetime of the dialog:
+// a pixmap item per tile, a pool of breadcrumb dots and the player arrow.
+void DungeonDialog::buildMinimapScene()
+{
+    m_minimapScene = new QGraphicsScene(this);
+    m_minimapScene->setSceneRect(0, 0, MAP_WIDTH_PIXELS, MAP_HEIGHT_PIXELS);
 
-    // 8. Draw Fog of War Overlay
-    if (!revealAll) {
-        for (int x = 0; x < MAP_SIZE; ++x) { 
-            for (int y = 0; y < MAP_SIZE; ++y) {
-                if (!m_visitedTiles.contains({x, y})) {
-                    if (!fogPixmap.isNull()) {
-                        // Use the image tile
-                        QGraphicsPixmapItem* fogTile = scene->addPixmap(scaledFog);
-                        fogTile->setPos(x * TILE_SIZE, y * TILE_SIZE);
-                    } else {
-                        // Fallback to semi-transparent black if image is missing
-                        scene->addRect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE, 
-                                       Qt::NoPen, QBrush(QColor(0, 0, 0, 220))); 
-                    }
-                }
-            }
+    for (int x = 0; x < MAP_SIZE; ++x) {
+        for (int y = 0; y < MAP_SIZE; ++y) {
+            QGraphicsPixmapItem* tile = m_minimapScene->addPixmap(QPixmap());
+            tile->setPos(x * TILE_SIZE, y * TILE_SIZE);
+            tile->setVisible(false);
+            m_minimapTiles[x][y] = tile;
+            m_minimapTileMask[x][y] = 0;
         }
     }
-    // Draw Breadcrumb Trail
-    for (int i = 0; i < m_breadcrumbPath.size(); ++i) {
-        QPair<int, int> pos = m_breadcrumbPath.at(i);   
-        // Calculate opacity so older dots fade out
-        int opacity = static_cast<int>((static_cast<float>(i) / m_breadcrumbPath.size()) * 150);
-        // Draw a small subtle dot in the center of the tile
-        scene->addEllipse(pos.first * TILE_SIZE + (TILE_SIZE / 3), 
-                            pos.second * TILE_SIZE + (TILE_SIZE / 3), 
-                            TILE_SIZE / 4, TILE_SIZE / 4, 
-                            Qt::NoPen, 
-                            //QBrush(QColor(0, 200, 255, opacity))); // Fading cyan trail
-                            QBrush(QColor(255, 255, 0, opacity + 100))); // Brighter yellow trail
+
+    for (int i = 0; i < MAX_BREADCRUMBS; ++i) {
+        QGraphicsEllipseItem* dot = m_minimapScene->addEllipse(0, 0, TILE_SIZE / 4, TILE_SIZE / 4, Qt::NoPen);
+        dot->setZValue(2);
+        dot->setVisible(false);
+        m_minimapBreadcrumbs.append(dot);
     }
-    // 9. Draw Player Arrow (Blue)
-    QGraphicsPolygonItem* playerArrow = new QGraphicsPolygonItem();
+
+    // Player Arrow (Blue)
+    m_minimapPlayer = new QGraphicsPolygonItem();
     QPolygonF arrowHead;
     // Defining an arrow shape relative to its origin
     arrowHead << QPointF(TILE_SIZE / 2, 0)               // Tip
               << QPointF(0, TILE_SIZE)                   // Bottom Left
               << QPointF(TILE_SIZE / 2, TILE_SIZE * 0.7) // Inner Notch
               << QPointF(TILE_SIZE, TILE_SIZE);          // Bottom Right
-    playerArrow->setPolygon(arrowHead);
-    playerArrow->setBrush(QBrush(Qt::blue));
-    playerArrow->setPen(QPen(Qt::blue));
-    // Calculate rotation based on facing direction string
+    m_minimapPlayer->setPolygon(arrowHead);
+    m_minimapPlayer->setBrush(QBrush(Qt::blue));
+    m_minimapPlayer->setPen(QPen(Qt::blue));
+    m_minimapPlayer->setTransformOriginPoint(TILE_SIZE / 2, TILE_SIZE / 2);
+    m_minimapPlayer->setZValue(3);
+    m_minimapScene->addItem(m_minimapPlayer);
+}
+
+void DungeonDialog::drawMinimap()
+{
+    if (!m_minimapScene) {
+        buildMinimapScene();
+    }
+
+    gameStateManager* gsm = gameStateManager::instance();
+    // Retrieve player position from GameState
+    int currentX = gsm->dungeonX();
+    int currentY = gsm->dungeonY();
+    QPair<int, int> currentPos = {currentX, currentY};
+    // Mark the current position as visited for the Fog of War
+    m_grid.set(currentPos, MapFeature::EXPLORED);
+    // Check the toggle state from our new dialog
+    bool revealAll = m_standaloneMinimap && m_standaloneMinimap->isRevealAllEnabled();
+
+    // Grid feature -> minimap layer
+    static const QPair<MapFeature, quint32> FEATURE_TO_MINIMAP[] = {
+        { MapFeature::ROCK,         MinimapRock },
+        { MapFeature::CHUTE,        MinimapChute },
+        { MapFeature::MONSTER,      MinimapMonster },
+        { MapFeature::TREASURE,     MinimapTreasure },
+        { MapFeature::TRAP,         MinimapTrap },
+        { MapFeature::ANTIMAGIC,    MinimapAntimagic },
+        { MapFeature::ROTATOR,      MinimapRotator },
+        { MapFeature::WATER,        MinimapWater },
+        { MapFeature::TELEPORTER,   MinimapTeleport },
+        { MapFeature::STUD,         MinimapStud },
+        { MapFeature::EXTINGUISHER, MinimapExtinguisher },
+        { MapFeature::PIT,          MinimapPit },
+        { MapFeature::STAIRS_UP,    MinimapStairsUp },
+        { MapFeature::STAIRS_DOWN,  MinimapStairsDown },
+        { MapFeature::HIDDEN_DOOR,  MinimapHiddenDoor },
+        { MapFeature::BODY,         MinimapBody }
+    };
+
+    // 1. Single pass over the grid; only touch the tiles whose contents changed
+    for (int x = 0; x < MAP_SIZE; ++x) {
+        for (int y = 0; y < MAP_SIZE; ++y) {
+            const quint32 cell = m_grid.bits(x, y);
+            quint32 mask = 0;
+            // Features are visible only if the tile has been visited (Fog of War otherwise)
+            if (!revealAll && !(cell & DungeonGrid::bit(MapFeature::EXPLORED))) {
+                mask = MinimapFog;
+            } else {
+                for (const auto& entry : FEATURE_TO_MINIMAP) {
+                    if (cell & DungeonGrid::bit(entry.first)) mask |= entry.second;
+                }
+            }
+            if (mask == m_minimapTileMask[x][y]) continue;
+
+            m_minimapTileMask[x][y] = mask;
+            QGraphicsPixmapItem* tile = m_minimapTiles[x][y];
+            if (mask == 0) {
+                tile->setVisible(false);
+            } else {
+                tile->setPixmap(minimapTileFor(mask));
+                tile->setVisible(true);
+            }
+        }
+    }
+
+    // 2. Breadcrumb Trail (pooled dots, older ones fade out)
+    for (int i = 0; i < m_minimapBreadcrumbs.size(); ++i) {
+        QGraphicsEllipseItem* dot = m_minimapBreadcrumbs.at(i);
+        if (i >= m_breadcrumbPath.size()) {
+            dot->setVisible(false);
+            continue;
+        }
+        QPair<int, int> pos = m_breadcrumbPath.at(i);
+        int opacity = static_cast<int>((static_cast<float>(i) / m_breadcrumbPath.size()) * 150);
+        dot->setPos(pos.first * TILE_SIZE + (TILE_SIZE / 3), pos.second * TILE_SIZE + (TILE_SIZE / 3));
+        dot->setBrush(QBrush(QColor(255, 255, 0, opacity + 100))); // Brighter yellow trail
+        dot->setVisible(true);
+    }
+
+    // 3. Player Arrow: rotation based on facing direction string
     int rotation = 0;
     QString currentFacing = m_compassLabel->text();
     if (currentFacing == "Facing North") rotation = 0;
     else if (currentFacing == "Facing East") rotation = 90;
     else if (currentFacing == "Facing South") rotation = 180;
     else if (currentFacing == "Facing West") rotation = 270;
-    // Center the arrow in the tile and rotate
-    playerArrow->setTransformOriginPoint(TILE_SIZE / 2, TILE_SIZE / 2);
-    playerArrow->setRotation(rotation);
-    playerArrow->setPos(currentPos.first * TILE_SIZE, currentPos.second * TILE_SIZE);
-    scene->addItem(playerArrow);
-    if (m_standaloneMinimap) {
-        m_standaloneMinimap->updateScene(scene);
-    } else {
-        delete scene; // Cleanup if window doesn't exist
-    }
-    QString bodyPath = "resources/images/minimap/body.png";
-    QPixmap bodyPixmap(bodyPath);
-    QPixmap scaledBody = bodyPixmap.scaled(TILE_SIZE, TILE_SIZE, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    // ... (Inside the drawing loop after other special tiles) ...
-    for (const auto& pos : m_bodyPositions) {
-        if (revealAll || m_visitedTiles.contains(pos)) {
-            if (!bodyPixmap.isNull()) {
-                QGraphicsPixmapItem* bodyTile = scene->addPixmap(scaledBody);
-                bodyTile->setPos(pos.first * TILE_SIZE, pos.second * TILE_SIZE);
-                bodyTile->setZValue(1); 
-            } else {
-                // Fallback: Draw a red cross if the image is missing
-                scene->addRect(pos.first * TILE_SIZE + 2, pos.second * TILE_SIZE + 2, 
-                               TILE_SIZE - 4, TILE_SIZE - 4, 
-                               QPen(Qt::red), QBrush(Qt::red));
-            }
-        }
-    }
+    m_minimapPlayer->setRotation(rotation);
+    m_minimapPlayer->setPos(currentPos.first * TILE_SIZE, currentPos.second * TILE_SIZE);
 
+    if (m_standaloneMinimap && m_standaloneMinimap->scene() != m_minimapScene) {
+        m_standaloneMinimap->updateScene(m_minimapScene);
+    }
 }
 
 void DungeonDialog::updateMinimap(int x, int y, int z=0)
@@ -378,9 +307,7 @@ void DungeonDialog::updateMinimap(int x, int y, int z=0)
             int targetX = x + dx;
             int targetY = y + dy;
             // Ensure we stay within the map boundaries
-            if (targetX >= 0 && targetX < MAP_SIZE && targetY >= 0 && targetY < MAP_SIZE) {
-                m_visitedTiles.insert({targetX, targetY});
-            }
+            m_grid.set(targetX, targetY, MapFeature::EXPLORED);
         }
     }
     drawMinimap(); 
@@ -0,0 +1,217 @@
+#include "DungeonScripts.h"
+#include "DungeonDialog.h"
+#include "../../gameStateManager.h"
+#include "../scripting/ScriptScheduler.h"
+#include <QLabel>
+#include <bit>
+
+extern "C" {
+    #include "lua.h"
+    #include "lauxlib.h"
+}
+
+DungeonDialog* DungeonScripts::s_dialog = nullptr;
+quint32 DungeonScripts::s_scriptedMask = 0;
+
+static const char* const DUNGEON_SCRIPT = "data/scripts/dungeon.lua";
+
+// Feature.<name> in Lua
+struct FeatureName {
+    const char* name;
+    MapFeature feature;
+};
+
+static const FeatureName FEATURE_NAMES[] = {
+    { "EXTINGUISHER", MapFeature::EXTINGUISHER }, { "PIT", MapFeature::PIT },
+    { "STAIRS_UP", MapFeature::STAIRS_UP },       { "STAIRS_DOWN", MapFeature::STAIRS_DOWN },
+    { "TELEPORTER", MapFeature::TELEPORTER },     { "WATER", MapFeature::WATER },
+    { "QUICKSAND", MapFeature::QUICKSAND },       { "ROTATOR", MapFeature::ROTATOR },
+    { "ANTIMAGIC", MapFeature::ANTIMAGIC },       { "ROCK", MapFeature::ROCK },
+    { "FOG", MapFeature::FOG },                   { "CHUTE", MapFeature::CHUTE },
+    { "STUD", MapFeature::STUD },                 { "EXPLORED", MapFeature::EXPLORED },
+    { "TRAP", MapFeature::TRAP },                 { "MONSTER", MapFeature::MONSTER },
+    { "TREASURE", MapFeature::TREASURE },         { "HIDDEN_DOOR", MapFeature::HIDDEN_DOOR },
+    { "BODY", MapFeature::BODY }
+};
+
+// The open dungeon, or a Lua error if there is none
+static DungeonDialog* dialogOrError(lua_State* L, DungeonDialog* dialog) {
+    if (!dialog) luaL_error(L, "no dungeon is open");
+    return dialog;
+}
+
+// Argument 'arg' as a single MapFeature bit
+static MapFeature checkFeature(lua_State* L, int arg) {
+    const lua_Integer value = luaL_checkinteger(L, arg);
+    luaL_argcheck(L, value > 0 && value <= lua_Integer(MapFeature::BODY) && std::has_single_bit(quint64(value)),
+                  arg, "not a Feature");
+    return MapFeature(quint32(value));
+}
+
+static void registerTable(lua_State* L, const char* name, const luaL_Reg* functions) {
+    lua_newtable(L);
+    luaL_setfuncs(L, functions, 0);
+    lua_setglobal(L, name);
+}
+
+void DungeonScripts::install(lua_State* L) {
+    // 1. Feature constants
+    lua_createtable(L, 0, int(std::size(FEATURE_NAMES)));
+    for (const FeatureName& entry : FEATURE_NAMES) {
+        lua_pushinteger(L, lua_Integer(entry.feature));
+        lua_setfield(L, -2, entry.name);
+    }
+    lua_setglobal(L, "Feature");
+
+    // 2. party: the leader's HP and gold, and the fire status
+    static const luaL_Reg PARTY[] = {
+        { "size", [](lua_State* L) -> int {
+            lua_pushinteger(L, gameStateManager::instance()->getPartyMembers().size());
+            return 1;
+        } },
+        { "hp", [](lua_State* L) -> int {
+            lua_pushinteger(L, gameStateManager::instance()->getGameValue("CurrentCharacterHP").toInt());
+            return 1;
+        } },
+        { "damage", [](lua_State* L) -> int {
+            const int amount = int(luaL_checkinteger(L, 1));
+            dialogOrError(L, s_dialog)->updatePartyMemberHealth(0, amount);
+            return 0;
+        } },
+        { "gold", [](lua_State* L) -> int {
+            lua_pushinteger(L, gameStateManager::instance()->getGold());
+            return 1;
+        } },
+        { "add_gold", [](lua_State* L) -> int {
+            gameStateManager::instance()->addGold(int(luaL_checkinteger(L, 1)));
+            return 0;
+        } },
+        { "on_fire", [](lua_State* L) -> int {
+            lua_pushboolean(L, gameStateManager::instance()->isCharacterOnFire());
+            return 1;
+        } },
+        { "set_on_fire", [](lua_State* L) -> int {
+            gameStateManager::instance()->setCharacterOnFire(lua_toboolean(L, 1));
+            return 0;
+        } },
+        { nullptr, nullptr }
+    };
+    registerTable(L, "party", PARTY);
+
+    // 3. position: where the party stands and which way it faces
+    static const luaL_Reg POSITION[] = {
+        { "get", [](lua_State* L) -> int {
+            gameStateManager* gsm = gameStateManager::instance();
+            lua_pushinteger(L, gsm->dungeonX());
+            lua_pushinteger(L, gsm->dungeonY());
+            lua_pushinteger(L, gsm->dungeonLevel());
+            return 3;
+        } },
+        { "facing", [](lua_State* L) -> int {
+            static const QStringList dirs = {"North", "East", "South", "West"};
+            DungeonDialog* dialog = dialogOrError(L, s_dialog);
+            lua_pushinteger(L, qMax(0, dirs.indexOf(dialog->m_compassLabel->text().mid(7))));
+            return 1;
+        } },
+        { nullptr, nullptr }
+    };
+    registerTable(L, "position", POSITION);
+
+    // 4. dungeon: the active level's grid and the dialog
+    static const luaL_Reg DUNGEON[] = {
+        { "has", [](lua_State* L) -> int {
+            DungeonDialog* dialog = dialogOrError(L, s_dialog);
+            const int x = int(luaL_checkinteger(L, 1)), y = int(luaL_checkinteger(L, 2));
+            lua_pushboolean(L, dialog->m_grid.has(x, y, checkFeature(L, 3)));
+            return 1;
+        } },
+        { "set", [](lua_State* L) -> int {
+            DungeonDialog* dialog = dialogOrError(L, s_dialog);
+            const int x = int(luaL_checkinteger(L, 1)), y = int(luaL_checkinteger(L, 2));
+            dialog->m_grid.set(x, y, checkFeature(L, 3));
+            return 0;
+        } },
+        { "clear", [](lua_State* L) -> int {
+            DungeonDialog* dialog = dialogOrError(L, s_dialog);
+            const int x = int(luaL_checkinteger(L, 1)), y = int(luaL_checkinteger(L, 2));
+            dialog->m_grid.clear(x, y, checkFeature(L, 3));
+            return 0;
+        } },
+        { "name", [](lua_State* L) -> int {
+            DungeonDialog* dialog = dialogOrError(L, s_dialog);
+            const QPair<int, int> pos = { int(luaL_checkinteger(L, 1)), int(luaL_checkinteger(L, 2)) };
+            lua_pushstring(L, dialog->m_grid.name(pos, checkFeature(L, 3)).toUtf8().constData());
+            return 1;
+        } },
+        { "log", [](lua_State* L) -> int {
+            dialogOrError(L, s_dialog)->logMessage(QString::fromUtf8(luaL_checkstring(L, 1)));
+            return 0;
+        } },
+        { "redraw", [](lua_State* L) -> int {
+            DungeonDialog* dialog = dialogOrError(L, s_dialog);
+            dialog->drawMinimap();
+            dialog->renderWireframeView();
+            return 0;
+        } },
+        { "enter_level", [](lua_State* L) -> int {
+            dialogOrError(L, s_dialog)->enterLevel(int(luaL_checkinteger(L, 1)));
+            return 0;
+        } },
+        { "in_combat", [](lua_State* L) -> int {
+            lua_pushboolean(L, dialogOrError(L, s_dialog)->m_isFighting);
+            return 1;
+        } },
+        { nullptr, nullptr }
+    };
+    registerTable(L, "dungeon", DUNGEON);
+}
+
+void DungeonScripts::attach(DungeonDialog* dialog) {
+    s_dialog = dialog;
+    s_scriptedMask = 0;
+
+    // 1. Re-run the script (a no-op compile unless it changed on disk)
+    gameStateManager* gsm = gameStateManager::instance();
+    if (!gsm->loadLuaScript(DUNGEON_SCRIPT)) return;
+
+    // 2. Remember which features have a Lua handler, so dispatch() doesn't ask Lua for the others
+    lua_State* L = gsm->luaState();
+    lua_getglobal(L, "OnTile");
+    if (lua_istable(L, -1)) {
+        for (const FeatureName& entry : FEATURE_NAMES) {
+            lua_rawgeti(L, -1, lua_Integer(entry.feature));
+            if (lua_isfunction(L, -1)) s_scriptedMask |= DungeonGrid::bit(entry.feature);
+            lua_pop(L, 1);
+        }
+    }
+    lua_pop(L, 1);
+}
+
+void DungeonScripts::detach(DungeonDialog* dialog) {
+    gameStateManager::instance()->scheduler()->cancelOwner(dialog);
+    if (s_dialog == dialog) {
+        s_dialog = nullptr;
+        s_scriptedMask = 0;
+    }
+}
+
+bool DungeonScripts::runTileHandler(DungeonDialog* dialog, MapFeature feature, int x, int y) {
+    if (dialog != s_dialog || !(s_scriptedMask & DungeonGrid::bit(feature))) return false;
+
+    lua_State* L = gameStateManager::instance()->luaState();
+    lua_getglobal(L, "OnTile");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        return false;
+    }
+    lua_rawgeti(L, -1, lua_Integer(feature));
+    lua_remove(L, -2);
+    if (!lua_isfunction(L, -1)) {
+        lua_pop(L, 1);
+        return false;
+    }
+    lua_pushinteger(L, x);
+    lua_pushinteger(L, y);
+    gameStateManager::instance()->scheduler()->spawn(2, dialog);
+    return true;
+}
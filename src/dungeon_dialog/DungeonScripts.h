@@ -0,0 +1,50 @@
+#ifndef DUNGEONSCRIPTS_H
+#define DUNGEONSCRIPTS_H
+
+#include <QtGlobal>
+#include "../../maploader/MapLoader.h" // MapFeature
+
+struct lua_State;
+class DungeonDialog;
+
+/**
+ * @brief Lua bindings for the open dungeon, and tile handlers written in Lua.
+ *
+ * install() registers typed tables once at startup:
+ *
+ *     party.size()  party.hp()  party.damage(n)  party.gold()  party.add_gold(n)
+ *     party.on_fire()  party.set_on_fire(b)
+ *     position.get() -> x, y, level      position.facing() -> 0..3 (N, E, S, W)
+ *     dungeon.has(x, y, f)  dungeon.set(x, y, f)  dungeon.clear(x, y, f)  dungeon.name(x, y, f)
+ *     dungeon.log(text)  dungeon.redraw()  dungeon.enter_level(n)  dungeon.in_combat()
+ *     Feature.TRAP, Feature.WATER, ...    (MapFeature bits)
+ *
+ * data/scripts/dungeon.lua fills OnTile[Feature.X] with handler functions.
+ * DungeonHandlers::dispatch() starts those as coroutines on the game's
+ * ScriptScheduler instead of the built-in C++ handler, so a tile script can
+ * wait(n), wait_input() or wait_combat() without blocking the dialog.
+ *
+ * The bindings act on the dialog given to attach(); calling them while no
+ * dungeon is open raises a Lua error. detach() cancels every tile script
+ * that dungeon started.
+ */
+class DungeonScripts {
+public:
+    static void install(lua_State* L);
+
+    // (Re)loads dungeon.lua and points the bindings at 'dialog'
+    static void attach(DungeonDialog* dialog);
+    static void detach(DungeonDialog* dialog);
+
+    // MapFeature bits that have an OnTile handler
+    static quint32 scriptedFeatures() { return s_scriptedMask; }
+
+    // Starts OnTile[feature](x, y); false if there is no such handler
+    static bool runTileHandler(DungeonDialog* dialog, MapFeature feature, int x, int y);
+
+private:
+    static DungeonDialog* s_dialog;
+    static quint32 s_scriptedMask;
+};
+
+#endif // DUNGEONSCRIPTS_H
@@ -0,0 +1,407 @@
+#include "DungeonViewAtlas.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QPicture>
+#include <QPolygon>
+#include <QtMath>
+
+// Perspective points for the three depth slices
+static const int VIEW_XS[] = {0, 75, 120, 150};
+static const int VIEW_YS[] = {0, 75, 120, 150};
+
+namespace {
+
+// Screen coordinates of one depth slice
+struct DepthGeometry {
+    int xL, xR, yT, yB;
+    int nxL, nxR, nyT, nyB;
+};
+
+DepthGeometry depthGeometry(int d)
+{
+    const int w = DungeonViewAtlas::VIEW_SIZE;
+    const int h = DungeonViewAtlas::VIEW_SIZE;
+    return { VIEW_XS[d], w - VIEW_XS[d], VIEW_YS[d], h - VIEW_YS[d],
+             VIEW_XS[d+1], w - VIEW_XS[d+1], VIEW_YS[d+1], h - VIEW_YS[d+1] };
+}
+
+void paintBrickPattern(QPainter& p, const QPolygon& wallPoly)
+{
+    QRect bounds = wallPoly.boundingRect();
+    QPen mortarPen(QColor(40, 40, 40, 150)); // Semi-transparent dark gray
+    mortarPen.setWidth(1);
+    p.setPen(mortarPen);
+
+    int rows = 6;    // Number of brick layers
+    int columns = 4; // Number of bricks per row
+
+    // Calculate row height
+    double rowHeight = static_cast<double>(bounds.height()) / rows;
+
+    for (int i = 1; i < rows; ++i) {
+        int y = bounds.top() + (i * rowHeight);
+
+        // Find left and right edges of the polygon at this specific Y height
+        // to ensure bricks don't float outside the perspective wall
+        int xMin = bounds.right();
+        int xMax = bounds.left();
+
+        // Basic scan-line logic to keep lines inside the trapezoid
+        for (int x = bounds.left(); x <= bounds.right(); ++x) {
+            if (wallPoly.containsPoint(QPoint(x, y), Qt::OddEvenFill)) {
+                xMin = qMin(xMin, x);
+                xMax = qMax(xMax, x);
+            }
+        }
+
+        // Draw horizontal mortar line
+        if (xMin < xMax) {
+            p.drawLine(xMin, y, xMax, y);
+
+            // Draw vertical "staggered" mortar lines
+            double colWidth = static_cast<double>(xMax - xMin) / columns;
+            double offset = (i % 2 == 0) ? 0 : colWidth / 2; // Stagger bricks
+
+            for (int j = 0; j <= columns; ++j) {
+                int vx = xMin + (j * colWidth) + offset;
+                if (vx > xMin && vx < xMax) {
+                    p.drawLine(QLineF(vx, y, vx, y - rowHeight));
+                }
+            }
+        }
+    }
+}
+
+void paintChute(QPainter& p, int d, const DepthGeometry& g)
+{
+    // We want the chute to be in the center of the tile floor
+    // Calculate a 40% width/depth hole
+    double margin = 0.3;
+    // Interpolate points for the "hole" on the floor
+    int cxL = g.xL + (g.xR - g.xL) * margin;
+    int cxR = g.xR - (g.xR - g.xL) * margin;
+    int cnxL = g.nxL + (g.nxR - g.nxL) * margin;
+    int cnxR = g.nxR - (g.nxR - g.nxL) * margin;
+    // Perspective depth for the floor (yB to nyB)
+    int cyNear = g.yB;
+    int cyFar = g.yB + (g.nyB - g.yB) * 0.6; // The hole doesn't take the whole tile
+
+    QPolygon chuteHole;
+    chuteHole << QPoint(cxL, cyNear) << QPoint(cxR, cyNear)
+              << QPoint(cnxR, cyFar) << QPoint(cnxL, cyFar);
+    // Draw the "void" (black hole)
+    p.setPen(QPen(Qt::black));
+    p.setBrush(QBrush(Qt::black));
+    p.drawPolygon(chuteHole);
+    // Draw inner "walls" of the chute for a 3D effect
+    QPolygon leftInner;
+    leftInner << QPoint(cxL, cyNear) << QPoint(cnxL, cyFar)
+              << QPoint(cnxL, cyFar + 10) << QPoint(cxL, cyNear + 10);
+
+    int depthShade = qMax(0, 30 - (d * 10));
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(depthShade, depthShade, depthShade));
+    p.drawPolygon(leftInner);
+}
+
+void paintMonster(QPainter& p, int d, const DepthGeometry& g)
+{
+    // Calculate size based on depth
+    // d=0 (Near): Large, d=2 (Far): Small
+    int monsterWidth = (g.xR - g.xL) * 0.6;
+    int monsterHeight = monsterWidth * 1.2;
+
+    // Center horizontally, sit on the floor (yB)
+    int centerX = g.xL + (g.xR - g.xL) / 2;
+    int xPos = centerX - (monsterWidth / 2);
+    int yPos = g.yB - monsterHeight;
+
+    // Depth shading: make monsters darker in the distance
+    int shade = qMax(0, 200 - (d * 60));
+    QColor monsterColor(shade, 0, 0); // Dark red silhouette
+
+    // Draw a simple head and body (billboard style)
+    QRect body(xPos, yPos + (monsterHeight * 0.3), monsterWidth, monsterHeight * 0.7);
+    QRect head(centerX - (monsterWidth / 4), yPos, monsterWidth / 2, monsterHeight * 0.4);
+
+    p.setPen(QPen(Qt::black));
+    p.setBrush(monsterColor);
+    p.drawEllipse(head);
+    p.drawRect(body);
+}
+
+void paintTeleporter(QPainter& p, int d, const DepthGeometry& g)
+{
+    // Calculate the center and size of the tile floor
+    int centerX = g.xL + (g.xR - g.xL) / 2;
+    int centerY = g.yB + (g.nyB - g.yB) / 2;
+    // Scale radius based on depth
+    int baseRadius = (g.xR - g.xL) / 3;
+    // Create a shimmering effect with multiple ellipses
+    p.setPen(QPen(Qt::white, 1));
+    for (int i = 0; i < 3; ++i) {
+        int r = baseRadius - (i * (baseRadius / 4));
+        QRectF glowRect(centerX - r, centerY - (r / 2), r * 2, r); // Flattened for perspective
+        // Alternating cyan/blue glow
+        QColor glowColor = (i % 2 == 0) ? QColor(0, 255, 255, 150) : QColor(0, 100, 255, 100);
+        // Depth shading: make it dimmer in the distance
+        int alpha = glowColor.alpha() - (d * 30);
+        glowColor.setAlpha(qMax(0, alpha));
+        p.setBrush(glowColor);
+        p.drawEllipse(glowRect);
+    }
+    // The "sparkles" move every frame, so DungeonViewItem draws them on top
+}
+
+void paintSpinner(QPainter& p, int d, const DepthGeometry& g)
+{
+    // Calculate the center of the tile floor using both near and far bounds
+    int centerX = (g.xL + g.xR + g.nxL + g.nxR) / 4;
+    int centerY = (g.yB + g.nyB) / 2;
+    // Scale the size of the spinner based on the available floor width at this depth
+    int radius = (g.xR - g.xL) / 3;
+    QPen spinnerPen(QColor(200, 200, 0), 2);
+    // Depth shading to make it darker in the distance
+    int alpha = qMax(0, 200 - (d * 50));
+    spinnerPen.setColor(QColor(200, 200, 0, alpha));
+    // Define the bounding rect for the ellipse/arcs, flattened for perspective
+    QRectF arcRect(centerX - radius, centerY - (radius / 2), radius * 2, radius);
+    p.setPen(spinnerPen);
+    p.setBrush(Qt::NoBrush);
+    for (int i = 0; i < 4; ++i) {
+        QPainterPath path;
+        int startAngle = i * 90; // Angles in QPainterPath are in degrees
+        int spanAngle = 60;
+
+        path.arcMoveTo(arcRect, startAngle);
+        path.arcTo(arcRect, startAngle, spanAngle);
+
+        p.drawPath(path);
+    }
+    // Add a center point (uses near/far center)
+    p.setBrush(spinnerPen.color());
+    p.drawEllipse(QRectF(centerX - 2, centerY - 1, 4, 2));
+}
+
+void paintWater(QPainter& p, int d, const DepthGeometry& g)
+{
+    // 1. Create the water surface polygon (the floor area)
+    QPolygon waterPoly;
+    waterPoly << QPoint(g.xL, g.yB) << QPoint(g.xR, g.yB) << QPoint(g.nxR, g.nyB) << QPoint(g.nxL, g.nyB);
+    // Deep blue color, semi-transparent so you can still see the floor/chutes
+    int alpha = qMax(0, 180 - (d * 40));
+    QColor waterColor(0, 105, 148, alpha); // Sea Blue
+    p.setPen(Qt::NoPen);
+    p.setBrush(waterColor);
+    p.drawPolygon(waterPoly);
+    // 2. Add "Ripples" (shimmering lines)
+    QPen ripplePen(QColor(255, 255, 255, qMax(0, 100 - (d * 30))));
+    ripplePen.setWidth(1);
+    p.setPen(ripplePen);
+    // Draw 3 horizontal lines at different depths within the tile
+    for (int i = 1; i <= 3; ++i) {
+        double ratio = i / 4.0;
+        // Interpolate Y position between near (yB) and far (nyB)
+        int ry = g.yB + (g.nyB - g.yB) * ratio;
+        // Interpolate X width based on perspective
+        int rxL = g.xL + (g.nxL - g.xL) * ratio;
+        int rxR = g.xR + (g.nxR - g.xR) * ratio;
+        // Draw a partial shimmering line (not the whole width for a natural look)
+        int rippleWidth = (rxR - rxL) * 0.6;
+        int rippleStart = rxL + (rxR - rxL) * 0.2;
+
+        p.drawLine(rippleStart, ry, rippleStart + rippleWidth, ry);
+    }
+}
+
+void paintAntimagic(QPainter& p, int d, const DepthGeometry& g)
+{
+    // Define the floor polygon for clipping or reference
+    QPolygon floorPoly;
+    floorPoly << QPoint(g.xL, g.yB) << QPoint(g.xR, g.yB) << QPoint(g.nxR, g.nyB) << QPoint(g.nxL, g.nyB);
+    // Color: A muted, "dulling" purple or gray
+    int alpha = qMax(0, 120 - (d * 30));
+    QColor fieldColor(100, 100, 150, alpha);
+    // Draw a subtle tint first
+    p.setPen(Qt::NoPen);
+    p.setBrush(fieldColor);
+    p.drawPolygon(floorPoly);
+    // Draw "Static" lines (cross-hatch pattern)
+    QPen staticPen(QColor(200, 200, 255, qMax(0, 150 - (d * 40))));
+    staticPen.setWidth(1);
+    p.setPen(staticPen);
+
+    int lines = 5;
+    for (int i = 0; i <= lines; ++i) {
+        double ratio = (double)i / lines;
+
+        // Vertical-ish lines (converging towards vanishing point)
+        int xNear = g.xL + (g.xR - g.xL) * ratio;
+        int xFar = g.nxL + (g.nxR - g.nxL) * ratio;
+        p.drawLine(xNear, g.yB, xFar, g.nyB);
+
+        // Horizontal lines (interpolated by depth)
+        int yHoriz = g.yB + (g.nyB - g.yB) * ratio;
+        int xHLeft = g.xL + (g.nxL - g.xL) * ratio;
+        int xHRight = g.xR + (g.nxR - g.xR) * ratio;
+        p.drawLine(xHLeft, yHoriz, xHRight, yHoriz);
+    }
+}
+
+// Paints one layer of one depth slice in 300x300 view coordinates
+void paintLayer(QPainter& p, int d, DungeonViewAtlas::Layer layer)
+{
+    const DepthGeometry g = depthGeometry(d);
+    const int w = DungeonViewAtlas::VIEW_SIZE;
+
+    switch (layer) {
+    case DungeonViewAtlas::Floor: {
+        QPolygon floor;
+        floor << QPoint(0, g.yB) << QPoint(w, g.yB) << QPoint(w, g.nyB) << QPoint(0, g.nyB);
+        int floorCol = qMax(0, 40 - (d * 10));
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(floorCol, floorCol, floorCol));
+        p.drawPolygon(floor);
+        break;
+    }
+    case DungeonViewAtlas::Ceiling: {
+        QPolygon ceil;
+        ceil << QPoint(0, g.yT) << QPoint(w, g.yT) << QPoint(w, g.nyT) << QPoint(0, g.nyT);
+        int ceilR = qMax(0, 80 - (d * 20)); // Brown base
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(ceilR, qMax(0, 50-(d*15)), qMax(0, 30-(d*10))));
+        p.drawPolygon(ceil);
+        break;
+    }
+    case DungeonViewAtlas::LeftWall:
+    case DungeonViewAtlas::RightWall: {
+        int sideWallCol = qMax(0, 80 - (d * 15));
+        QPolygon poly;
+        if (layer == DungeonViewAtlas::LeftWall) {
+            poly << QPoint(g.xL, g.yT) << QPoint(g.nxL, g.nyT) << QPoint(g.nxL, g.nyB) << QPoint(g.xL, g.yB);
+        } else {
+            poly << QPoint(g.xR, g.yT) << QPoint(g.nxR, g.nyT) << QPoint(g.nxR, g.nyB) << QPoint(g.xR, g.yB);
+        }
+        p.setPen(QPen(Qt::black));
+        p.setBrush(QColor(sideWallCol, sideWallCol, sideWallCol));
+        p.drawPolygon(poly);
+        paintBrickPattern(p, poly);
+        break;
+    }
+    case DungeonViewAtlas::LeftWing:
+    case DungeonViewAtlas::RightWing: {
+        int sideRoomWallCol = qMax(0, 65 - (d * 15));
+        p.setPen(QPen(Qt::black));
+        p.setBrush(QColor(sideRoomWallCol, sideRoomWallCol, sideRoomWallCol));
+        if (layer == DungeonViewAtlas::LeftWing) {
+            p.drawRect(0, g.yT, g.xL, g.yB - g.yT);
+        } else {
+            p.drawRect(g.xR, g.yT, w - g.xR, g.yB - g.yT);
+        }
+        break;
+    }
+    case DungeonViewAtlas::Antimagic:  paintAntimagic(p, d, g); break;
+    case DungeonViewAtlas::Water:      paintWater(p, d, g); break;
+    case DungeonViewAtlas::Spinner:    paintSpinner(p, d, g); break;
+    case DungeonViewAtlas::Teleporter: paintTeleporter(p, d, g); break;
+    case DungeonViewAtlas::Monster:    paintMonster(p, d, g); break;
+    case DungeonViewAtlas::FrontWall: {
+        int frontCol = qMax(0, 110 - (d * 20));
+        p.setPen(QPen(Qt::black));
+        p.setBrush(QColor(frontCol, frontCol, frontCol));
+        p.drawRect(g.xL, g.yT, g.xR - g.xL, g.yB - g.yT);
+        break;
+    }
+    case DungeonViewAtlas::Chute:      paintChute(p, d, g); break;
+    case DungeonViewAtlas::LayerCount: break;
+    }
+}
+
+} // namespace
+
+void DungeonViewAtlas::bake(qreal scale)
+{
+    if (scale <= 0.0) scale = 1.0;
+
+    for (int d = 0; d < DEPTHS; ++d) {
+        for (int l = 0; l < LayerCount; ++l) {
+            const Layer layer = static_cast<Layer>(l);
+
+            // 1. Record the layer once to find the area it covers
+            QPicture picture;
+            {
+                QPainter recorder(&picture);
+                paintLayer(recorder, d, layer);
+            }
+            // Pad for pen width and clamp to the view
+            QRectF target = QRectF(picture.boundingRect()).adjusted(-1, -1, 1, 1)
+                                .intersected(QRectF(0, 0, VIEW_SIZE, VIEW_SIZE));
+            Sprite& sprite = m_sprites[d][l];
+            sprite.target = target;
+            if (target.isEmpty()) {
+                sprite.pixmap = QPixmap();
+                continue;
+            }
+
+            // 2. Paint it again at device resolution into a transparent pixmap
+            QSize pixelSize(qCeil(target.width() * scale), qCeil(target.height() * scale));
+            sprite.pixmap = QPixmap(pixelSize);
+            sprite.pixmap.fill(Qt::transparent);
+            QPainter painter(&sprite.pixmap);
+            painter.scale(scale, scale);
+            painter.translate(-target.topLeft());
+            paintLayer(painter, d, layer);
+        }
+    }
+    m_scale = scale;
+}
+
+QPoint DungeonViewAtlas::sparkleCenter(int depth) const
+{
+    const DepthGeometry g = depthGeometry(depth);
+    return QPoint(g.xL + (g.xR - g.xL) / 2, g.yB + (g.nyB - g.yB) / 2);
+}
+
+int DungeonViewAtlas::sparkleRadius(int depth) const
+{
+    const DepthGeometry g = depthGeometry(depth);
+    return qMax(1, (g.xR - g.xL) / 3);
+}
+
+// --- DungeonViewItem ---
+
+DungeonViewItem::DungeonViewItem(const DungeonViewAtlas *atlas, QGraphicsItem *parent)
+    : QGraphicsItem(parent),
+      m_atlas(atlas)
+{
+}
+
+QRectF DungeonViewItem::boundingRect() const
+{
+    return QRectF(0, 0, DungeonViewAtlas::VIEW_SIZE, DungeonViewAtlas::VIEW_SIZE);
+}
+
+void DungeonViewItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    painter->fillRect(boundingRect(), Qt::black);
+
+    // Far slice first so nearer walls cover it
+    for (int d = DungeonViewAtlas::DEPTHS - 1; d >= 0; --d) {
+        const quint32 mask = m_layers[d];
+        for (int l = 0; l < DungeonViewAtlas::LayerCount; ++l) {
+            if (!(mask & (1u << l))) continue;
+            const DungeonViewAtlas::Sprite& sprite = m_atlas->sprite(d, static_cast<DungeonViewAtlas::Layer>(l));
+            if (sprite.pixmap.isNull()) continue;
+            painter->drawPixmap(sprite.target, sprite.pixmap, QRectF(sprite.pixmap.rect()));
+
+            if (l == DungeonViewAtlas::Teleporter) {
+                for (const QPoint& sparkle : m_sparkles[d]) {
+                    painter->fillRect(QRectF(sparkle.x(), sparkle.y(), 1, 1), Qt::white);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef DUNGEONVIEWATLAS_H
+#define DUNGEONVIEWATLAS_H
+
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QPoint>
+#include <QRectF>
+
+/**
+ * @brief Pre-rendered layers for the first-person dungeon view.
+ *
+ * The perspective geometry is fixed (a 300x300 view with three depth slices),
+ * so every floor, wall, brick pattern and hazard overlay is painted once per
+ * (depth, layer) into a pixmap at the current on-screen resolution. Drawing a
+ * step is then a handful of drawPixmap() blits. When the view is resized the
+ * atlas is re-baked at the new scale instead of scaling the vectors.
+ */
+class DungeonViewAtlas {
+public:
+    static const int VIEW_SIZE = 300;
+    static const int DEPTHS = 3;
+    static const int SPARKLES = 5;
+
+    // Layers in back-to-front paint order within one depth slice
+    enum Layer {
+        Floor,
+        Ceiling,
+        LeftWall,      // side-facing corridor wall + mortar lines
+        RightWall,
+        LeftWing,      // front-facing wall inside the side corridor
+        RightWing,
+        Antimagic,
+        Water,
+        Spinner,
+        Teleporter,
+        Monster,
+        FrontWall,
+        Chute,
+        LayerCount
+    };
+
+    struct Sprite {
+        QPixmap pixmap;
+        QRectF target; // Where the pixmap goes, in 300x300 view coordinates
+    };
+
+    // Bakes every (depth, layer) at 'scale' device pixels per view unit.
+    void bake(qreal scale);
+    bool isBakedFor(qreal scale) const { return m_scale > 0.0 && qFuzzyCompare(m_scale, scale); }
+    qreal scale() const { return m_scale; }
+
+    const Sprite& sprite(int depth, Layer layer) const { return m_sprites[depth][layer]; }
+
+    // Teleporter sparkles are scattered per frame around this point
+    QPoint sparkleCenter(int depth) const;
+    int sparkleRadius(int depth) const;
+
+private:
+    Sprite m_sprites[DEPTHS][LayerCount];
+    qreal m_scale = 0.0;
+};
+
+/**
+ * @brief Scene item that composites the atlas for the current step.
+ *
+ * DungeonDialog::renderWireframeView() only sets a layer bitmask per depth;
+ * paint() blits the matching sprites far-to-near.
+ */
+class DungeonViewItem : public QGraphicsItem {
+public:
+    explicit DungeonViewItem(const DungeonViewAtlas *atlas, QGraphicsItem *parent = nullptr);
+
+    void setDepthLayers(int depth, quint32 layerMask) { m_layers[depth] = layerMask; }
+    void setSparkle(int depth, int index, const QPoint& pos) { m_sparkles[depth][index] = pos; }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    const DungeonViewAtlas *m_atlas;
+    quint32 m_layers[DungeonViewAtlas::DEPTHS] = {};
+    QPoint m_sparkles[DungeonViewAtlas::DEPTHS][DungeonViewAtlas::SPARKLES];
+};
+
+#endif // DUNGEONVIEWATLAS_H
@@ -0,0 +1,124 @@
+#include "DungeonDialog.h"
+#include "DungeonViewAtlas.h"
+#include "../../gameStateManager.h"
+#include <QGraphicsView>
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QDebug>
+
+static const int FRAME_REPORT_INTERVAL = 100; // frames between frame-time reports
+
+// Device pixels per scene unit in the view showing the dungeon scene,
+// so the atlas is baked at the size it is actually displayed at.
+qreal DungeonDialog::wireframePixelScale() const
+{
+    const QList<QGraphicsView*> views = m_dungeonScene->views();
+    if (views.isEmpty()) return 1.0;
+    const QGraphicsView *view = views.first();
+    qreal scale = view->transform().m11() * view->devicePixelRatioF();
+    return scale > 0.0 ? scale : 1.0;
+}
+
+// Puts the single compositing item into the (new or cleared) scene
+void DungeonDialog::buildWireframeItems()
+{
+    m_dungeonScene->clear();
+    m_dungeonScene->setBackgroundBrush(Qt::black);
+    m_viewItem = new DungeonViewItem(&m_viewAtlas);
+    m_dungeonScene->addItem(m_viewItem);
+    m_wireframeScene = m_dungeonScene;
+}
+
+void DungeonDialog::renderWireframeView() {
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    // 1. (Re)build the item if the scene is new or was cleared,
+    //    and re-bake the atlas if the on-screen resolution changed
+    if (m_wireframeScene != m_dungeonScene) {
+        buildWireframeItems();
+    }
+    const qreal scale = wireframePixelScale();
+    if (!m_viewAtlas.isBakedFor(scale)) {
+        QElapsedTimer bakeTimer;
+        bakeTimer.start();
+        m_viewAtlas.bake(scale);
+        if (qEnvironmentVariableIsSet("BLACKLANDS_BENCH")) {
+            qDebug() << "Baked dungeon view atlas at scale" << scale << "in" << bakeTimer.elapsed() << "ms";
+        }
+    }
+
+    gameStateManager *gsm = gameStateManager::instance();
+    int px = gsm->dungeonX();
+    int py = gsm->dungeonY();
+
+    // 2. Resolve the facing once per frame instead of per depth
+    const QString facing = m_compassLabel->text();
+    int dx = 0, dy = 0;
+    if (facing.contains(QLatin1String("North"))) dy = -1;
+    else if (facing.contains(QLatin1String("South"))) dy = 1;
+    else if (facing.contains(QLatin1String("East")))  dx = 1;
+    else if (facing.contains(QLatin1String("West")))  dx = -1;
+
+    for (int d = DungeonViewAtlas::DEPTHS - 1; d >= 0; --d) {
+        // Tile coordinates for the CENTER path
+        int tx = px + (dx * d);
+        int ty = py + (dy * d);
+
+        // Adjacent tiles (Left/Right) relative to facing. These are the same
+        // tiles isWallAtSide() resolves, without re-reading the compass label.
+        int lx = tx + dy, ly = ty - dx;
+        int rx = tx - dy, ry = ty + dx;
+
+        // Wall Checks
+        bool wallFront       = isWallAt(tx, ty);
+        bool wallLeftSide    = isWallAt(lx, ly);
+        bool wallRightSide   = isWallAt(rx, ry);
+        bool wallInLeftTile  = isWallAt(lx, ly);
+        bool wallInRightTile = isWallAt(rx, ry);
+
+        const quint32 cell = m_grid.bits(tx, ty);
+        auto bit = [](DungeonViewAtlas::Layer layer) { return 1u << layer; };
+        auto cellHas = [cell](MapFeature feature) { return (cell & DungeonGrid::bit(feature)) != 0; };
+        quint32 mask = bit(DungeonViewAtlas::Floor) | bit(DungeonViewAtlas::Ceiling);
+        if (wallLeftSide)                        mask |= bit(DungeonViewAtlas::LeftWall);
+        if (wallRightSide)                       mask |= bit(DungeonViewAtlas::RightWall);
+        if (!wallLeftSide && wallInLeftTile)     mask |= bit(DungeonViewAtlas::LeftWing);
+        if (!wallRightSide && wallInRightTile)   mask |= bit(DungeonViewAtlas::RightWing);
+        if (cellHas(MapFeature::ANTIMAGIC))      mask |= bit(DungeonViewAtlas::Antimagic);
+        if (cellHas(MapFeature::WATER))          mask |= bit(DungeonViewAtlas::Water);
+        if (cellHas(MapFeature::ROTATOR))        mask |= bit(DungeonViewAtlas::Spinner);
+        if (cellHas(MapFeature::MONSTER))        mask |= bit(DungeonViewAtlas::Monster);
+        if (wallFront)                           mask |= bit(DungeonViewAtlas::FrontWall);
+        if (cellHas(MapFeature::CHUTE))          mask |= bit(DungeonViewAtlas::Chute);
+
+        if (cellHas(MapFeature::TELEPORTER)) {
+            mask |= bit(DungeonViewAtlas::Teleporter);
+            // Re-scatter the "sparkles" so the teleporter still shimmers
+            const QPoint center = m_viewAtlas.sparkleCenter(d);
+            const int baseRadius = m_viewAtlas.sparkleRadius(d);
+            for (int j = 0; j < DungeonViewAtlas::SPARKLES; ++j) {
+                int sx = center.x() + (QRandomGenerator::global()->bounded(baseRadius * 2) - baseRadius);
+                int sy = center.y() + (QRandomGenerator::global()->bounded(baseRadius) - (baseRadius / 2));
+                m_viewItem->setSparkle(d, j, QPoint(sx, sy));
+            }
+        }
+        m_viewItem->setDepthLayers(d, mask);
+    }
+    m_viewItem->update();
+
+    // 3. Frame-time counter
+    m_frameTimeLastNs = frameTimer.nsecsElapsed();
+    m_frameTimeMaxNs = qMax(m_frameTimeMaxNs, m_frameTimeLastNs);
+    m_frameTimeTotalNs += m_frameTimeLastNs;
+    if (++m_frameCount >= FRAME_REPORT_INTERVAL) {
+        if (qEnvironmentVariableIsSet("BLACKLANDS_BENCH")) {
+            qDebug() << "3D view frame time over" << m_frameCount << "frames: avg"
+                     << (m_frameTimeTotalNs / m_frameCount) / 1000.0 << "us, max"
+                     << m_frameTimeMaxNs / 1000.0 << "us";
+        }
+        m_frameCount = 0;
+        m_frameTimeTotalNs = 0;
+        m_frameTimeMaxNs = 0;
+    }
+}
@@ -0,0 +1,475 @@
+#include "LevelGenerator.h"
+#include <QtConcurrent>
+#include <array>
+
+namespace {
+    const int SIZE = DungeonGrid::WIDTH;   // Square map
+    const int MAX = SIZE - 1;
+
+    const int CAVE_FILL_PERCENT = 45;      // Starting rock density
+    const int CAVE_SMOOTHING_PASSES = 4;
+    const int CAVE_MIN_TILES = 120;        // Smaller biggest-caves are rerolled
+    const int CAVE_ATTEMPTS = 16;          // ...this many times, then it's rooms after all
+    const int MAZE_CHAMBERS = 6;
+
+    // Which tiles a room or the one-tile gap around it already covers. One
+    // word per row, so testing a candidate room is one AND per row instead of
+    // a pass over every room placed so far.
+    class Occupancy {
+    public:
+        static_assert(DungeonGrid::WIDTH <= 32, "One quint32 per row");
+
+        // Marks the room plus its one-tile border
+        void mark(int x, int y, int w, int h) {
+            const quint32 mask = span(x - 1, x + w);
+            for (int row = qMax(0, y - 1); row <= qMin(DungeonGrid::HEIGHT - 1, y + h); ++row) m_rows[row] |= mask;
+        }
+        bool overlaps(int x, int y, int w, int h) const {
+            const quint32 mask = span(x, x + w - 1);
+            for (int row = qMax(0, y); row <= qMin(DungeonGrid::HEIGHT - 1, y + h - 1); ++row) {
+                if (m_rows[row] & mask) return true;
+            }
+            return false;
+        }
+
+    private:
+        // Bits first..last (inclusive), clipped to the map
+        static quint32 span(int first, int last) {
+            first = qMax(0, first);
+            last = qMin(DungeonGrid::WIDTH - 1, last);
+            if (first > last) return 0;
+            return quint32(((quint64(1) << (last - first + 1)) - 1) << first);
+        }
+        std::array<quint32, DungeonGrid::HEIGHT> m_rows{};
+    };
+}
+
+QRandomGenerator LevelGenerator::seededRng(quint32 worldSeed, int level, Stream stream)
+{
+    // World 0 is the original dungeon: its layouts keep the old per-level seed
+    if (worldSeed == 0 && stream == LayoutStream) return QRandomGenerator(quint32(level + SEED_OFFSET));
+    const quint32 seeds[] = { worldSeed, quint32(level), quint32(stream) };
+    return QRandomGenerator(seeds);
+}
+
+LevelGenerator::LevelGenerator(quint32 worldSeed, int level)
+    : m_rng(seededRng(worldSeed, level, LayoutStream))
+    , m_treasureRng(seededRng(worldSeed, level, TreasureStream))
+{
+    m_grid.setLevel(level);
+}
+
+const char* LevelGenerator::layoutName(LevelLayout layout)
+{
+    switch (layout) {
+    case LevelLayout::RoomsAndCorridors: return "rooms";
+    case LevelLayout::Caves:             return "caves";
+    case LevelLayout::Maze:              return "maze";
+    default:                             return "?";
+    }
+}
+
+QSharedPointer<const GeneratedLevel> LevelGenerator::generate(quint32 worldSeed, int level, const QList<QVariantMap>& items,
+                                                               LevelLayout layout)
+{
+    // One carve step per LevelLayout, in enum order
+    static void (LevelGenerator::* const CARVE_STEPS[])() = {
+        &LevelGenerator::carveRooms,
+        &LevelGenerator::carveCaves,
+        &LevelGenerator::carveMaze,
+    };
+    static_assert(std::size(CARVE_STEPS) == size_t(LevelLayout::Count), "A carve step for every layout");
+
+    LevelGenerator generator(worldSeed, level);
+    QSharedPointer<GeneratedLevel> out(new GeneratedLevel);
+    out->worldSeed = worldSeed;
+    out->level = level;
+    out->layout = (layout >= LevelLayout::RoomsAndCorridors && layout < LevelLayout::Count) ? layout : LevelLayout::RoomsAndCorridors;
+    generator.m_level = out.data();
+
+    // Treasure goes last, once the rock is in place, so it only lands where the party can walk
+    (generator.*CARVE_STEPS[int(out->layout)])();
+    generator.placeStairs();
+    generator.placeSpecialTiles(SPECIAL_TILE_COUNT);
+    generator.placeTreasures(items);
+
+    out->tiles = generator.m_grid.snapshotLevel();
+    return out;
+}
+
+void LevelGenerator::placeTreasures(const QList<QVariantMap>& items)
+{
+    if (items.isEmpty()) return;
+    // 1. Every open tile except the start, the stairs and the gold pouches placeSpecialTiles() left
+    const QPair<int, int> start = m_level->start, up = m_level->stairsUp, down = m_level->stairsDown;
+    QList<QPair<int, int>> floorList;
+    for (int x = 0; x < SIZE; ++x)
+        for (int y = 0; y < SIZE; ++y) {
+            const QPair<int, int> pos = {x, y};
+            if (m_grid.has(pos, MapFeature::ROCK) || m_grid.has(pos, MapFeature::TREASURE)) continue;
+            if (pos != start && pos != up && pos != down) floorList.append(pos);
+        }
+    // 2. Draw distinct tiles with a partial Fisher-Yates; a small cave just gets fewer treasures
+    const int count = qMin(TREASURE_COUNT, int(floorList.size()));
+    for (int i = 0; i < count; ++i) {
+        floorList.swapItemsAt(i, i + int(m_treasureRng.bounded(int(floorList.size()) - i)));
+        const QPair<int, int> pos = floorList.at(i);
+        // 3. Pick a random item from the MDATA3 list
+        const QString itemName = items.at(m_treasureRng.bounded(items.size())).value("name").toString();
+        m_grid.place(pos, MapFeature::TREASURE, itemName);
+        m_level->treasures.append({pos.first, pos.second, itemName});
+    }
+}
+
+void LevelGenerator::carveRooms()
+{
+    // 1. Fill entire map with rock
+    for (int x = 0; x < SIZE; ++x)
+        for (int y = 0; y < SIZE; ++y)
+            m_grid.set(x, y, MapFeature::ROCK);
+    struct Room { int x, y, w, h; };
+    Occupancy occupied;
+    QList<Room> processingQueue;
+    // 2. Start Room in a random corner
+    int startX = m_rng.bounded(2) == 0 ? 1 : SIZE - 6;
+    int startY = m_rng.bounded(2) == 0 ? 1 : SIZE - 6;
+    Room seed = {startX, startY, m_rng.bounded(3, 5), m_rng.bounded(3, 5)};
+    for (int rx = seed.x; rx < seed.x + seed.w; ++rx)
+        for (int ry = seed.y; ry < seed.y + seed.h; ++ry)
+            m_grid.clear(rx, ry, MapFeature::ROCK);
+    occupied.mark(seed.x, seed.y, seed.w, seed.h);
+    processingQueue.append(seed);
+    int roomsCreated = 1;
+    // 3. Sprout until we hit the target count or run out of space
+    while (!processingQueue.isEmpty() && roomsCreated < ROOM_COUNT) {
+        // Pick a room from the queue (shuffling makes it more "web-like")
+        int idx = m_rng.bounded(processingQueue.size());
+        Room current = processingQueue.takeAt(idx);
+        // Try to sprout in all 4 directions
+        QList<int> directions = {0, 1, 2, 3};
+        for (int i = 0; i < 4; ++i) { // Randomize direction order
+            int swapIdx = m_rng.bounded(4);
+            directions.swapItemsAt(i, swapIdx);
+        }
+        for (int dir : directions) {
+            if (roomsCreated >= ROOM_COUNT) break;
+            int corridorLen = m_rng.bounded(2, 5); // Shorter corridors allow more rooms
+            int newW = m_rng.bounded(3, 6);
+            int newH = m_rng.bounded(3, 6);
+            int cX = current.x + current.w / 2;
+            int cY = current.y + current.h / 2;
+            int endX = cX, endY = cY;
+            int roomX = 0, roomY = 0;
+            // Direction Logic
+            if (dir == 0) { // North
+                endY = current.y - corridorLen;
+                roomX = endX - newW / 2; roomY = endY - newH;
+            } else if (dir == 1) { // East
+                endX = current.x + current.w + corridorLen;
+                roomY = endY - newH / 2; roomX = endX;
+            } else if (dir == 2) { // South
+                endY = current.y + current.h + corridorLen;
+                roomX = endX - newW / 2; roomY = endY;
+            } else { // West
+                endX = current.x - corridorLen;
+                roomY = endY - newH / 2; roomX = endX - newW;
+            }
+            // Boundary and Overlap Check
+            if (roomX > 0 && roomY > 0 && roomX + newW < MAX && roomY + newH < MAX) {
+                // Using 1-tile buffer to keep corridors distinct
+                if (!occupied.overlaps(roomX, roomY, newW, newH)) {
+                    // Carve Corridor
+                    int stepX = cX, stepY = cY;
+                    while (stepX != endX || stepY != endY) {
+                        if (stepX < endX) stepX++; else if (stepX > endX) stepX--;
+                        if (stepY < endY) stepY++; else if (stepY > endY) stepY--;
+                        m_grid.clear(stepX, stepY, MapFeature::ROCK);
+                    }
+                    // Carve Room
+                    Room nextRoom = {roomX, roomY, newW, newH};
+                    for (int rx = roomX; rx < roomX + newW; ++rx) {
+                        for (int ry = roomY; ry < roomY + newH; ++ry) {
+                            m_grid.clear(rx, ry, MapFeature::ROCK);
+                            m_grid.set(rx, ry, MapFeature::ROOM_FLOOR);
+                        }
+                    }
+                    occupied.mark(roomX, roomY, newW, newH);
+                    processingQueue.append(nextRoom);
+                    roomsCreated++;
+                }
+            }
+        }
+    }
+    // The player starts in the first room created
+    m_level->start = {seed.x + 1, seed.y + 1};
+}
+
+
+void LevelGenerator::carveCaves()
+{
+    std::array<bool, SIZE * SIZE> rock{};
+    auto rockAt = [&rock](int x, int y) { return !DungeonGrid::inBounds(x, y) || rock[y * SIZE + x]; };
+    static const int DX[] = { 0, 1, 0, -1 };
+    static const int DY[] = { -1, 0, 1, 0 };
+    QList<int> cave;
+    for (int attempt = 0; attempt < CAVE_ATTEMPTS && cave.size() < CAVE_MIN_TILES; ++attempt) {
+        // 1. Random rock with a solid border
+        for (int y = 0; y < SIZE; ++y)
+            for (int x = 0; x < SIZE; ++x)
+                rock[y * SIZE + x] = x == 0 || y == 0 || x == MAX || y == MAX || m_rng.bounded(100) < CAVE_FILL_PERCENT;
+        // 2. Smooth: 5+ rock neighbours turns a tile to rock, 3 or fewer to floor
+        for (int pass = 0; pass < CAVE_SMOOTHING_PASSES; ++pass) {
+            std::array<bool, SIZE * SIZE> next = rock;
+            for (int y = 1; y < MAX; ++y) {
+                for (int x = 1; x < MAX; ++x) {
+                    int neighbours = 0;
+                    for (int dy = -1; dy <= 1; ++dy)
+                        for (int dx = -1; dx <= 1; ++dx)
+                            if ((dx || dy) && rockAt(x + dx, y + dy)) ++neighbours;
+                    if (neighbours >= 5) next[y * SIZE + x] = true;
+                    else if (neighbours <= 3) next[y * SIZE + x] = false;
+                }
+            }
+            rock = next;
+        }
+        // 3. Find the biggest cave (4-connected, the way the party walks)
+        std::array<bool, SIZE * SIZE> seen{};
+        cave.clear();
+        for (int i = 0; i < SIZE * SIZE; ++i) {
+            if (rock[i] || seen[i]) continue;
+            QList<int> tiles = { i };
+            seen[i] = true;
+            for (int t = 0; t < tiles.size(); ++t) {
+                const int x = tiles[t] % SIZE, y = tiles[t] / SIZE;
+                for (int d = 0; d < 4; ++d) {
+                    const int nx = x + DX[d], ny = y + DY[d];
+                    if (!rockAt(nx, ny) && !seen[ny * SIZE + nx]) {
+                        seen[ny * SIZE + nx] = true;
+                        tiles.append(ny * SIZE + nx);
+                    }
+                }
+            }
+            if (tiles.size() > cave.size()) cave = tiles;
+        }
+    }
+    if (cave.size() < CAVE_MIN_TILES) {
+        carveRooms();
+        return;
+    }
+    // 4. Only that cave stays open
+    for (int x = 0; x < SIZE; ++x)
+        for (int y = 0; y < SIZE; ++y)
+            m_grid.set(x, y, MapFeature::ROCK);
+    for (int i : std::as_const(cave)) m_grid.clear(i % SIZE, i / SIZE, MapFeature::ROCK);
+    // 5. Tiles with open floor all around are the cave's "rooms" (where chutes and teleporters go)
+    for (int i : std::as_const(cave)) {
+        const int x = i % SIZE, y = i / SIZE;
+        bool open = true;
+        for (int dy = -1; dy <= 1 && open; ++dy)
+            for (int dx = -1; dx <= 1 && open; ++dx)
+                open = !m_grid.has(x + dx, y + dy, MapFeature::ROCK) && DungeonGrid::inBounds(x + dx, y + dy);
+        if (open) m_grid.set(x, y, MapFeature::ROOM_FLOOR);
+    }
+    // The player starts anywhere in the cave
+    const int startTile = cave.at(m_rng.bounded(cave.size()));
+    m_level->start = {startTile % SIZE, startTile / SIZE};
+}
+
+void LevelGenerator::carveMaze()
+{
+    // Maze cells sit on odd coordinates, the walls between them on even ones
+    const int CELLS = (SIZE - 1) / 2;
+    static const int DX[] = { 0, 1, 0, -1 };
+    static const int DY[] = { -1, 0, 1, 0 };
+    for (int x = 0; x < SIZE; ++x)
+        for (int y = 0; y < SIZE; ++y)
+            m_grid.set(x, y, MapFeature::ROCK);
+    // 1. Recursive backtracker, with an explicit stack
+    std::array<bool, CELLS * CELLS> visited{};
+    QList<int> stack;
+    const int first = m_rng.bounded(CELLS * CELLS);
+    visited[first] = true;
+    stack.append(first);
+    m_grid.clear(1 + 2 * (first % CELLS), 1 + 2 * (first / CELLS), MapFeature::ROCK);
+    while (!stack.isEmpty()) {
+        const int cx = stack.last() % CELLS, cy = stack.last() / CELLS;
+        int options[4];
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = cx + DX[d], ny = cy + DY[d];
+            if (nx >= 0 && nx < CELLS && ny >= 0 && ny < CELLS && !visited[ny * CELLS + nx]) options[count++] = d;
+        }
+        if (count == 0) {
+            stack.removeLast();
+            continue;
+        }
+        const int d = options[m_rng.bounded(count)];
+        const int nx = cx + DX[d], ny = cy + DY[d];
+        m_grid.clear(1 + 2 * cx + DX[d], 1 + 2 * cy + DY[d], MapFeature::ROCK); // The wall in between
+        m_grid.clear(1 + 2 * nx, 1 + 2 * ny, MapFeature::ROCK);
+        visited[ny * CELLS + nx] = true;
+        stack.append(ny * CELLS + nx);
+    }
+    // 2. Chambers of 3x3 around a cell; opening walls only adds paths, so the maze stays connected
+    for (int i = 0; i < MAZE_CHAMBERS; ++i) {
+        const int x = 1 + 2 * m_rng.bounded(CELLS - 1);
+        const int y = 1 + 2 * m_rng.bounded(CELLS - 1);
+        for (int rx = x; rx < x + 3; ++rx) {
+            for (int ry = y; ry < y + 3; ++ry) {
+                m_grid.clear(rx, ry, MapFeature::ROCK);
+                m_grid.set(rx, ry, MapFeature::ROOM_FLOOR);
+            }
+        }
+        // The player starts in the first chamber
+        if (i == 0) m_level->start = {x + 1, y + 1};
+    }
+}
+
+void LevelGenerator::placeStairs()
+{
+    const QPair<int, int> start = m_level->start;
+    QPair<int, int>& up = m_level->stairsUp;
+    QPair<int, int>& down = m_level->stairsDown;
+    do {
+        up = {m_rng.bounded(SIZE), m_rng.bounded(SIZE)};
+    } while (up == start || m_grid.has(up, MapFeature::ROCK));
+    do {
+        down = {m_rng.bounded(SIZE), m_rng.bounded(SIZE)};
+    } while (down == start || down == up || m_grid.has(down, MapFeature::ROCK));
+    m_grid.set(up, MapFeature::STAIRS_UP);
+    m_grid.set(down, MapFeature::STAIRS_DOWN);
+}
+
+void LevelGenerator::placeSpecialTiles(int tileCount)
+{
+    const QPair<int, int> playerPos = m_level->start;
+    const QPair<int, int> up = m_level->stairsUp;
+    const QPair<int, int> down = m_level->stairsDown;
+    // Room tiles don't change from here on; collect them once
+    QList<QPair<int, int>> roomList;
+    m_grid.forEach(MapFeature::ROOM_FLOOR, [&roomList](int x, int y) { roomList.append({x, y}); });
+    // Helper A: Get a tile ONLY from a room (No corridors!)
+    auto getValidRoomTile = [&]() -> QPair<int, int> {
+        if (roomList.isEmpty()) return {-1, -1};
+        for (int i = 0; i < 100; ++i) {
+            QPair<int, int> p = roomList.at(m_rng.bounded(roomList.size()));
+            if (p != up && p != down && p != playerPos) return p;
+        }
+        return {-1, -1};
+    };
+    // Helper: Get ANY floor tile (Rooms OR Corridors)
+    auto getAnyFloorTile = [&]() -> QPair<int, int> {
+        for (int i = 0; i < 500; ++i) {
+            QPair<int, int> p = {m_rng.bounded(SIZE), m_rng.bounded(SIZE)};
+            if (!m_grid.has(p, MapFeature::ROCK) && p != playerPos &&
+                p != up && p != down &&
+                !m_grid.has(p, MapFeature::TREASURE)) { // Also check if treasure is already there
+                return p;
+            }
+        }
+        return {-1, -1};
+    };
+    // 1. Guaranteed Room-Only Spawns (Chutes & Teleporters)
+    // We do these first so they get priority in the rooms
+    for (int i = 0; i < 4; ++i) {
+        QPair<int, int> cp = getValidRoomTile();
+        if (cp.first != -1) m_grid.set(cp, MapFeature::CHUTE);
+
+        QPair<int, int> tp = getValidRoomTile();
+        if (tp.first != -1) m_grid.set(tp, MapFeature::TELEPORTER);
+    }
+    // 2. General Population Loop
+    for (int i = 0; i < tileCount; ++i) {
+        int roll = m_rng.bounded(100); // Using 100 for better percentage control
+        QPair<int, int> pos;
+        if (roll < 15) { // 15% Monsters
+            pos = getAnyFloorTile();
+            if (pos.first != -1) m_grid.place(pos, MapFeature::MONSTER, "Orc");
+        }
+        else if (roll < 30) { // 15% Treasures
+            pos = getAnyFloorTile();
+            if (pos.first != -1) m_grid.place(pos, MapFeature::TREASURE, "Gold Pouch");
+        }
+        else if (roll < 55) { // 10% Water
+            pos = getAnyFloorTile();
+            if (pos.first != -1) m_grid.set(pos, MapFeature::WATER);
+        }
+        else if (roll < 65) { // 10% Anti-magic/Extinguisher
+            pos = getAnyFloorTile();
+            if (pos.first != -1) m_grid.set(pos, MapFeature::ANTIMAGIC);
+        }
+        // Extra Room-Only Chutes/Teleporters via random roll
+        else if (roll < 70) {
+            pos = getValidRoomTile();
+            if (pos.first != -1) m_grid.set(pos, MapFeature::CHUTE);
+        }
+        else if (roll < 75) { // 5% Pits
+            pos = getAnyFloorTile();
+            if (pos.first != -1) m_grid.set(pos, MapFeature::PIT);
+        }
+    }
+    // 3. Level 1 gets one hidden door in a wall next to the floor
+    if (m_level->level == 1) {
+        QList<QPair<int, int>> wallList;
+        m_grid.forEach(MapFeature::ROCK, [&wallList](int x, int y) { wallList.append({x, y}); });
+        bool placed = false;
+
+        // Shuffle wall list to get a random wall tile for the door. Fisher-Yates on m_rng rather than
+        // std::shuffle, whose draws are up to the standard library and would move the door between builds.
+        for (int i = int(wallList.size()) - 1; i > 0; --i) {
+            wallList.swapItemsAt(i, int(m_rng.bounded(i + 1)));
+        }
+
+        for (const auto& wallPos : wallList) {
+            // Check 4 cardinal directions for a floor tile
+            const QPair<int, int> neighbors[] = {
+                {wallPos.first, wallPos.second - 1}, // North
+                {wallPos.first, wallPos.second + 1}, // South
+                {wallPos.first - 1, wallPos.second}, // West
+                {wallPos.first + 1, wallPos.second}  // East
+            };
+            for (const auto& neighbor : neighbors) {
+                // Check boundaries and ensure neighbor is NOT a wall
+                if (DungeonGrid::inBounds(neighbor.first, neighbor.second) &&
+                    !m_grid.has(neighbor, MapFeature::ROCK)) {
+                    m_grid.set(wallPos, MapFeature::HIDDEN_DOOR);
+                    placed = true;
+                    break;
+                }
+            }
+            if (placed) break;
+        }
+    }
+}
+
+void LevelCache::setWorldSeed(quint32 worldSeed)
+{
+    if (worldSeed == m_worldSeed) return;
+    m_worldSeed = worldSeed;
+    m_pending.clear(); // Running jobs just finish unseen
+}
+
+void LevelCache::prefetchAround(int level, const QList<QVariantMap>& items)
+{
+    // 1. Forget what is no longer next door (a running job just finishes unseen)
+    for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+        if (qAbs(it.key() - level) > 1) it = m_pending.erase(it);
+        else ++it;
+    }
+    // 2. Start the neighbours that aren't on their way yet
+    for (int next : { level - 1, level + 1 }) {
+        if (next < 1 || next > DungeonGrid::LEVELS || m_pending.contains(next)) continue;
+        if (m_pending.size() >= MAX_LEVELS) break;
+        m_pending.insert(next, QtConcurrent::run(&LevelGenerator::generate, m_worldSeed, next, items,
+                                                 LevelLayout::RoomsAndCorridors));
+    }
+}
+
+QSharedPointer<const GeneratedLevel> LevelCache::take(int level, const QList<QVariantMap>& items)
+{
+    auto it = m_pending.find(level);
+    if (it == m_pending.end()) return LevelGenerator::generate(m_worldSeed, level, items);
+    QFuture<QSharedPointer<const GeneratedLevel>> future = *it;
+    m_pending.erase(it);
+    return future.result(); // Already done unless the player was very quick on the stairs
+}
@@ -0,0 +1,106 @@
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QSharedPointer>
+#include <QVariantMap>
+#include "DungeonGrid.h"
+
+// The shapes a level can be carved in (one carve step each in LevelGenerator)
+enum class LevelLayout {
+    RoomsAndCorridors,  // Rooms sprouting off each other through short corridors; the game's dungeon
+    Caves,              // Cellular-automaton caverns, cut down to the biggest connected cave
+    Maze,               // A perfect maze with a few chambers opened up in it
+    Count
+};
+
+// One dungeon level as the generator left it. Built on a worker thread and
+// never changed afterwards; DungeonDialog copies it into its grid.
+struct GeneratedLevel {
+    struct Treasure {
+        int x;
+        int y;
+        QString itemName;
+    };
+
+    quint32 worldSeed = 0;
+    int level = 1;
+    LevelLayout layout = LevelLayout::RoomsAndCorridors;
+    DungeonGrid::LevelSnapshot tiles;
+    QPair<int, int> stairsUp;
+    QPair<int, int> stairsDown;
+    QPair<int, int> start;          // Inside the first room
+    QList<Treasure> treasures;      // MDATA3 items placed on the level, for gameStateManager::addPlacedItem
+};
+
+/**
+ * @brief Builds a dungeon level: MDATA3 treasure, the layout (see
+ * LevelLayout), stairs and special tiles.
+ *
+ * The result depends on nothing but (world seed, level, layout) and the item
+ * list: the layout and the treasure each draw from their own generator seeded
+ * with those, so one can change without moving the other. World seed 0 is the
+ * original dungeon and keeps its old QRandomGenerator(level + 12345) layouts,
+ * which older saves' explored tiles line up with. The generator only touches
+ * its own grid and the item list it is given, which makes it safe to run on
+ * any thread.
+ */
+class LevelGenerator {
+public:
+    static const int SEED_OFFSET = 12345;
+    static const int ROOM_COUNT = 40;
+    static const int SPECIAL_TILE_COUNT = 20;
+    static const int TREASURE_COUNT = 100;
+
+    // 'items' are the MDATA3 rows to draw treasure from; empty means no treasure
+    static QSharedPointer<const GeneratedLevel> generate(quint32 worldSeed, int level, const QList<QVariantMap>& items,
+                                                         LevelLayout layout = LevelLayout::RoomsAndCorridors);
+    static const char* layoutName(LevelLayout layout);
+
+private:
+    // Independent random streams per level
+    enum Stream : quint32 { LayoutStream = 1, TreasureStream = 2 };
+    static QRandomGenerator seededRng(quint32 worldSeed, int level, Stream stream);
+
+    LevelGenerator(quint32 worldSeed, int level);
+
+    void placeTreasures(const QList<QVariantMap>& items);
+    void carveRooms();
+    void carveCaves();
+    void carveMaze();
+    void placeStairs();
+    void placeSpecialTiles(int tileCount);
+
+    DungeonGrid m_grid;
+    QRandomGenerator m_rng;          // Layout, stairs and special tiles
+    QRandomGenerator m_treasureRng;
+    GeneratedLevel* m_level = nullptr;
+};
+
+/**
+ * @brief Keeps the levels next to the current one generated ahead of time.
+ *
+ * prefetchAround(N) starts N-1 and N+1 on the thread pool and drops
+ * anything further away, so at most MAX_LEVELS are held. take() hands a
+ * level out once: a prefetched one is ready or nearly so, anything else is
+ * generated on the spot (with the same result, generation being seeded).
+ */
+class LevelCache {
+public:
+    static const int MAX_LEVELS = 4;
+
+    // Levels already on their way for another world are dropped
+    void setWorldSeed(quint32 worldSeed);
+    void prefetchAround(int level, const QList<QVariantMap>& items);
+    QSharedPointer<const GeneratedLevel> take(int level, const QList<QVariantMap>& items);
+
+private:
+    quint32 m_worldSeed = 0;
+    QHash<int, QFuture<QSharedPointer<const GeneratedLevel>>> m_pending;
+};
+
+#endif // LEVELGENERATOR_H
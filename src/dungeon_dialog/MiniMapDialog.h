@@ -33,6 +33,10 @@ public:
     { 
         return m_revealAllCheck->isChecked();
     }
+    QGraphicsScene* scene() const
+    {
+        return m_view->scene();
+    }
     void updateScene(QGraphicsScene *newScene) 
     {
         m_view->setScene(newScene);
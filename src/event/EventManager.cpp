@@ -3,6 +3,8 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QDebug>
+#include <QRandomGenerator>
+#include <algorithm>
 // Static instance for singleton
 EventManager* s_instance = nullptr;
 
@@ -17,28 +19,117 @@ EventManager::EventManager(QObject* parent)
     : QObject(parent)
 {
     qRegisterMetaType<GameEvent>("GameEvent");
+    m_clock.start();
+}
+
+bool EventCondition::matches(const QJsonObject& context) const
+{
+    const QJsonValue value = context.value(key);
+    switch (op) {
+    case Op::Equals:  return value.isDouble() && value.toInteger() == min;
+    case Op::InRange: return value.isDouble() && value.toInteger() >= min && value.toInteger() <= max;
+    case Op::IsTrue:  return value.toBool(false);
+    case Op::IsFalse: return !value.toBool(false);
+    }
+    return false;
+}
+
+// "conditions": { ... } -> predicates; unknown shapes are reported and skipped
+static QVector<EventCondition> compileConditions(const QString& eventId, const QJsonObject& conditions)
+{
+    QVector<EventCondition> compiled;
+    for (auto it = conditions.constBegin(); it != conditions.constEnd(); ++it) {
+        const QJsonValue value = it.value();
+        EventCondition condition;
+        condition.key = it.key();
+
+        if (it.key() == "flags" && value.isArray()) {
+            // 1. ["flag", "!otherFlag"]
+            for (const QJsonValue& flag : value.toArray()) {
+                QString name = flag.toString();
+                EventCondition flagCondition;
+                flagCondition.op = name.startsWith('!') ? EventCondition::Op::IsFalse : EventCondition::Op::IsTrue;
+                if (name.startsWith('!')) name.remove(0, 1);
+                if (name.isEmpty()) continue;
+                flagCondition.key = name;
+                compiled.append(flagCondition);
+            }
+            continue;
+        }
+        if (value.isDouble()) {
+            // 2. Exact value
+            condition.op = EventCondition::Op::Equals;
+            condition.min = value.toInteger();
+        } else if (value.isArray() && value.toArray().size() == 2) {
+            // 3. [min, max]
+            condition.op = EventCondition::Op::InRange;
+            condition.min = value.toArray().at(0).toInteger();
+            condition.max = value.toArray().at(1).toInteger();
+        } else if (value.isBool()) {
+            // 4. Flag
+            condition.op = value.toBool() ? EventCondition::Op::IsTrue : EventCondition::Op::IsFalse;
+        } else {
+            qWarning() << "Event" << eventId << "has an unsupported condition:" << it.key();
+            continue;
+        }
+        compiled.append(condition);
+    }
+    return compiled;
+}
+
+GameEvent EventManager::parseEvent(const QJsonObject& o)
+{
+    GameEvent event;
+    event.id = o["id"].toString();
+    event.type = o["type"].toString();
+    event.description = o["description"].toString();
+    event.trigger = o["trigger"].toString();
+    event.effect = o["effect"].toString();
+    event.resolved = o.value("resolved").toBool(false);
+    event.extraData = o["extraData"].toObject();
+    event.repeatable = o.value("repeatable").toBool(false);
+    event.priority = o.value("priority").toInt(0);
+    event.cooldownMs = qMax<qint64>(0, o.value("cooldownMs").toInteger(0));
+    event.conditions = compileConditions(event.id, event.extraData.value("conditions").toObject());
+    return event;
 }
 
 void EventManager::loadEvents(const QString& filename)
 {
-    m_allEvents.clear();
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Could not open events file:" << filename;
+        setEvents({});
         return;
     }
     QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVector<GameEvent> events;
     for (const auto& ev : doc.array()) {
-        QJsonObject o = ev.toObject();
-        GameEvent event;
-        event.id = o["id"].toString();
-        event.type = o["type"].toString();
-        event.description = o["description"].toString();
-        event.trigger = o["trigger"].toString();
-        event.effect = o["effect"].toString();
-        event.resolved = o.value("resolved").toBool(false);
-        event.extraData = o["extraData"].toObject();
-        m_allEvents.append(event);
+        events.append(parseEvent(ev.toObject()));
+    }
+    setEvents(events);
+}
+
+void EventManager::setEvents(const QVector<GameEvent>& events)
+{
+    m_allEvents = events;
+    buildIndex();
+}
+
+void EventManager::buildIndex()
+{
+    m_buckets.clear();
+    m_lastFired.fill(-1, m_allEvents.size());
+    for (int i = 0; i < m_allEvents.size(); ++i) {
+        const GameEvent& event = m_allEvents[i];
+        if (event.resolved && !event.repeatable) continue; // Already spent
+        m_buckets[event.trigger].append(i);
+    }
+    // Highest priority first; equal priorities keep file order
+    for (auto it = m_buckets.begin(); it != m_buckets.end(); ++it) {
+        std::stable_sort(it->begin(), it->end(), [this](int a, int b) {
+            return m_allEvents[a].priority > m_allEvents[b].priority;
+        });
     }
 }
 
@@ -47,19 +138,138 @@ void EventManager::update(const QString& trigger, QJsonObject context)
     checkEvents(trigger, context);
 }
 
-void EventManager::checkEvents(const QString& trigger, QJsonObject context)
+void EventManager::checkEvents(const QString& trigger, const QJsonObject& context)
 {
-    Q_UNUSED(context);
-    for (auto& event : m_allEvents) {
-        if (!event.resolved && event.trigger == trigger) {
-            m_activeEvents.append(event);
-            emit eventTriggered(event);
-            event.resolved = true; // To prevent retrigger; remove this for repeatable events
+    // 1. Only the events listening for this trigger
+    auto bucket = m_buckets.find(trigger);
+    if (bucket == m_buckets.end()) return;
+
+    // Copy: a slot may call update() again and change the buckets
+    const QVector<int> candidates = *bucket;
+    const qint64 now = m_clock.elapsed();
+    bool spent = false;
+
+    for (int index : candidates) {
+        GameEvent& event = m_allEvents[index];
+        if (event.resolved && !event.repeatable) continue;
+
+        // 2. Cooldown, then the compiled conditions
+        if (m_lastFired[index] >= 0 && now - m_lastFired[index] < event.cooldownMs) continue;
+        bool matches = true;
+        for (const EventCondition& condition : std::as_const(event.conditions)) {
+            if (!condition.matches(context)) {
+                matches = false;
+                break;
+            }
+        }
+        if (!matches) continue;
+
+        // 3. Fire
+        m_lastFired[index] = now;
+        if (!event.repeatable) {
+            event.resolved = true; // To prevent retrigger
+            spent = true;
+        }
+        m_activeEvents.append(event);
+        if (m_activeEvents.size() > MAX_ACTIVE_EVENTS) m_activeEvents.removeFirst();
+        emit eventTriggered(event);
+        // "extraData": { "script": "OnFoo" } starts the global Lua function OnFoo(id, context) as a coroutine
+        const QString script = event.extraData.value("script").toString();
+        if (!script.isEmpty()) {
+            gameStateManager::instance()->scheduler()->spawnGlobal(
+                script.toUtf8().constData(), { event.id, context.toVariantMap() });
         }
     }
+
+    // 4. Drop spent one-shot events so later updates don't look at them again
+    if (spent) {
+        bucket = m_buckets.find(trigger);
+        if (bucket == m_buckets.end()) return;
+        bucket->removeIf([this](int index) {
+            return m_allEvents[index].resolved && !m_allEvents[index].repeatable;
+        });
+        if (bucket->isEmpty()) m_buckets.erase(bucket);
+    }
 }
 
 QVector<GameEvent> EventManager::currentEvents() const
 {
     return m_activeEvents;
 }
+
+void EventManager::benchmarkDispatch(const QString& filename, int eventCount, int updates)
+{
+    if (eventCount <= 0 || updates <= 0) return;
+
+    // 1. Templates from the real file, cloned into 'eventCount' repeatable events
+    //    spread over TRIGGERS triggers, each with a level condition
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Event benchmark: could not open" << filename;
+        return;
+    }
+    QVector<GameEvent> templates;
+    for (const auto& ev : QJsonDocument::fromJson(file.readAll()).array()) {
+        templates.append(parseEvent(ev.toObject()));
+    }
+    if (templates.isEmpty()) return;
+
+    const int TRIGGERS = 1000;
+    const int LEVELS = 20;
+    QVector<GameEvent> events;
+    events.reserve(eventCount);
+    for (int i = 0; i < eventCount; ++i) {
+        GameEvent event = templates[i % templates.size()];
+        event.id = QString("%1_%2").arg(event.id).arg(i);
+        event.trigger = QString("%1_%2").arg(event.trigger).arg(i % TRIGGERS);
+        event.resolved = false;
+        event.repeatable = true;
+        event.priority = i % 3;
+        event.extraData.remove("script");
+        EventCondition level;
+        level.key = "level";
+        level.min = i % LEVELS;
+        event.conditions = { level };
+        events.append(event);
+    }
+
+    // Same random (trigger, level) sequence for both runs
+    QVector<QString> triggers(updates);
+    QVector<QJsonObject> contexts(updates);
+    QRandomGenerator rng(1234);
+    for (int i = 0; i < updates; ++i) {
+        const int e = rng.bounded(eventCount);
+        triggers[i] = events[e].trigger;
+        contexts[i] = QJsonObject{ { "level", rng.bounded(LEVELS) } };
+    }
+
+    // 2. Old path: scan every event, then test its conditions
+    qint64 linearFired = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < updates; ++i) {
+        for (const GameEvent& event : std::as_const(events)) {
+            if (event.trigger != triggers[i]) continue;
+            bool matches = true;
+            for (const EventCondition& condition : event.conditions) matches = matches && condition.matches(contexts[i]);
+            if (matches) ++linearFired;
+        }
+    }
+    const qint64 linearNs = timer.nsecsElapsed();
+
+    // 3. Indexed path on a scratch manager, counting what it emits
+    EventManager indexed;
+    indexed.setEvents(events);
+    qint64 indexedFired = 0;
+    QObject::connect(&indexed, &EventManager::eventTriggered, [&indexedFired](const GameEvent&) { ++indexedFired; });
+    timer.restart();
+    for (int i = 0; i < updates; ++i) {
+        indexed.checkEvents(triggers[i], contexts[i]);
+    }
+    const qint64 indexedNs = timer.nsecsElapsed();
+
+    qDebug() << "--- EVENT DISPATCH BENCHMARK ---" << eventCount << "events," << updates << "updates";
+    qDebug() << "  Linear scan:" << double(linearNs) / updates << "ns/update (" << linearFired << "fired)";
+    qDebug() << "  Buckets:" << double(indexedNs) / updates << "ns/update (" << indexedFired << "fired)";
+    qDebug() << "  Speedup:" << (indexedNs > 0 ? double(linearNs) / indexedNs : 0.0) << "x";
+}
@@ -3,9 +3,28 @@
 #include <QObject>
 #include <QVector>
 #include <QString>
+#include <QHash>
 #include <QJsonObject>
+#include <QElapsedTimer>
 #include "gameStateManager.h"
 
+// One test against the context passed to EventManager::update(), compiled from
+// the event's "conditions" at load time so dispatch never re-reads the JSON.
+//
+//     "extraData": { "conditions": { "level": 5, "x": [10, 14], "flags": ["inDungeon", "!onFire"] } }
+//
+// A number must match exactly, a [min, max] pair is an inclusive range, a
+// bool (or a "flags" entry, with ! for false) must match the context's flag.
+struct EventCondition {
+    enum class Op { Equals, InRange, IsTrue, IsFalse };
+    QString key;
+    Op op = Op::Equals;
+    qint64 min = 0;
+    qint64 max = 0;
+
+    bool matches(const QJsonObject& context) const;
+};
+
 // Simple struct for event data
 struct GameEvent {
     QString id;
@@ -15,6 +34,12 @@ struct GameEvent {
     QString effect;
     bool resolved;
     QJsonObject extraData;
+
+    // Optional dispatch settings
+    bool repeatable = false;   // Fires every time its conditions hold instead of once
+    int priority = 0;          // Higher fires first among events of the same trigger
+    qint64 cooldownMs = 0;     // Minimum time between two firings of a repeatable event
+    QVector<EventCondition> conditions;
 };
 
 Q_DECLARE_METATYPE(GameEvent) // Enables use in queued signals/slots
@@ -28,9 +53,16 @@ public:
     EventManager(QObject* parent = nullptr);
 
     void loadEvents(const QString& filename);
+    void setEvents(const QVector<GameEvent>& events);
     void update(const QString& trigger, QJsonObject context = QJsonObject());
     QVector<GameEvent> currentEvents() const;
 
+    static GameEvent parseEvent(const QJsonObject& o);
+
+    // Dispatch cost with 'eventCount' events cloned from 'filename', linear scan vs. trigger buckets.
+    // Run with BLACKLANDS_BENCH=1 to print the numbers at startup.
+    static void benchmarkDispatch(const QString& filename, int eventCount = 10000, int updates = 100000);
+
 signals:
     void eventTriggered(const GameEvent& event);
 
@@ -38,5 +70,13 @@ private:
     QVector<GameEvent> m_allEvents;
     QVector<GameEvent> m_activeEvents;
 
-    void checkEvents(const QString& trigger, QJsonObject context);
+    // Trigger -> indexes into m_allEvents, highest priority first. Spent one-shot events are dropped.
+    QHash<QString, QVector<int>> m_buckets;
+    QVector<qint64> m_lastFired;   // Per event, m_clock time of its last firing (-1 = never)
+    QElapsedTimer m_clock;
+
+    static constexpr int MAX_ACTIVE_EVENTS = 256; // Repeatable events would otherwise grow the list forever
+
+    void buildIndex();
+    void checkEvents(const QString& trigger, const QJsonObject& context);
 };
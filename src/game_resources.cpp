@@ -7,4 +7,6 @@
  *
  * This allocates the actual memory for the QHash. It MUST be done in ONE .cpp file.
  */
+QMutex GameResources::s_mutex;
 QHash<QString, QPixmap> GameResources::s_resources;
+QHash<QString, QPixmap> GameResources::s_scaledResources;
@@ -9,12 +9,10 @@
 #include <QSettings>
 #include <QEasingCurve> // Added for smooth animation curves
 #include <QPainter>
+#include <QtConcurrent>
 LoadingScreen::LoadingScreen(QWidget *parent) :
-    QDialog(parent),
-    m_currentFileIndex(0)
+    QDialog(parent)
 {
-    gameStateManager::instance()->initializeResources();
-    gameStateManager::instance()->setGameValue("ResourcesLoaded", true);
     setWindowTitle("Black land");
     setFixedSize(350, 480);
     // --- Widget Creation ---
@@ -51,7 +49,8 @@ LoadingScreen::LoadingScreen(QWidget *parent) :
     m_copyrightLabel->setAlignment(Qt::AlignCenter);
     m_copyrightLabel->setStyleSheet("color: gold;");
     // Image Setup
-    QPixmap originalPixmap = GameResources::getPixmap("mordor_art");
+    // Only this image is needed before the background load finishes
+    QPixmap originalPixmap = QPixmap::fromImage(GameResources::decodeImage("resources/images/mordor_art.png"));
     if (originalPixmap.isNull()) {
         m_imageLabel->setText("IMAGE NOT LOADED");
     } else {
@@ -67,21 +66,35 @@ LoadingScreen::LoadingScreen(QWidget *parent) :
     mainLayout->addWidget(m_copyrightLabel);
     mainLayout->addWidget(m_loadingMessageLabel);
     setLayout(mainLayout);
-    // File Scanning Logic
-    QDir currentDir = QDir::current();
-    QStringList fileList = currentDir.entryList(QDir::Files | QDir::NoDotAndDotDot | QDir::Dirs, QDir::Name);
-    for (const QString &itemName : fileList) {
-        m_loadingFiles << "Loading: " + itemName;
-    }
-    //checkSettingsFile();
-    // Timer Setup
-    m_messageTimer = new QTimer(this);
-    connect(m_messageTimer, &QTimer::timeout, this, &LoadingScreen::updateLoadingMessage);
-    m_messageTimer->start(100);
+    // Timer Setup: closes the dialog shortly after loading has finished
     m_closeTimer = new QTimer(this);
+    m_closeTimer->setSingleShot(true);
     connect(m_closeTimer, &QTimer::timeout, this, &LoadingScreen::closeDialogAutomatically);
-    m_closeTimer->start(100);
+
+    startLoading();
+}
+
+void LoadingScreen::startLoading()
+{
+    // 1. Decode every image to a QImage on the thread pool
+    const QList<GameResources::ImageJob> jobs = GameResources::imageJobs();
+    connect(&m_imageWatcher, &QFutureWatcherBase::progressValueChanged, this, &LoadingScreen::updateLoadingMessage);
+    connect(&m_imageWatcher, &QFutureWatcherBase::finished, this, &LoadingScreen::onLoadingStepFinished);
+    m_imageWatcher.setFuture(QtConcurrent::mapped(jobs, [](const GameResources::ImageJob& job) {
+        return qMakePair(job.key, GameResources::decodeImage(job.path));
+    }));
+
+    // 2. Meanwhile read game data, spells, monsters and items (the files are parsed in parallel).
+    //    The manager itself must be created here on the GUI thread, not by the worker.
+    gameStateManager* manager = gameStateManager::instance();
+    connect(&m_dataWatcher, &QFutureWatcherBase::finished, this, &LoadingScreen::onLoadingStepFinished);
+    m_dataWatcher.setFuture(QtConcurrent::run([manager] {
+        return manager->readStaticData();
+    }));
+
+    updateLoadingMessage();
 }
+
 /*
 void LoadingScreen::checkSettingsFile()
 {
@@ -93,18 +106,39 @@ void LoadingScreen::checkSettingsFile()
 */
 void LoadingScreen::updateLoadingMessage()
 {
-    if (m_closeTimer->remainingTime() < 500) { 
-        m_messageTimer->stop();
+    if (m_loadingFinished) {
         m_loadingMessageLabel->setText("Initialization complete. Starting game...");
         return;
     }
-    if (m_currentFileIndex < m_loadingFiles.size()) {
-        m_loadingMessageLabel->setText(m_loadingFiles.at(m_currentFileIndex++));
-    } else {
-        m_currentFileIndex = 0; 
+    QString message = QString("Loading images: %1/%2")
+                          .arg(m_imageWatcher.progressValue())
+                          .arg(m_imageWatcher.progressMaximum());
+    message += m_dataWatcher.isFinished() ? " - game data ready" : " - reading game data...";
+    m_loadingMessageLabel->setText(message);
+}
+
+void LoadingScreen::onLoadingStepFinished()
+{
+    updateLoadingMessage();
+    if (m_imageWatcher.isFinished() && m_dataWatcher.isFinished()) {
+        finishLoading();
+        m_closeTimer->start(100);
     }
 }
 
+void LoadingScreen::finishLoading()
+{
+    if (m_loadingFinished) return;
+    m_loadingFinished = true;
+
+    // QPixmaps can only be created here, on the GUI thread
+    m_loadingMessageLabel->setText("Preparing graphics...");
+    GameResources::adoptImages(m_imageWatcher.future().results());
+    gameStateManager::instance()->applyStaticData(m_dataWatcher.result());
+    gameStateManager::instance()->initializeResources();
+    updateLoadingMessage();
+}
+
 void LoadingScreen::closeDialogAutomatically()
 {
     m_closeTimer->stop();
@@ -117,4 +151,10 @@ void LoadingScreen::paintEvent(QPaintEvent *event)
 
     QPixmap fontSheet = gameStateManager::instance()->getFontSpriteSheet();
 }
-LoadingScreen::~LoadingScreen() {}
+LoadingScreen::~LoadingScreen()
+{
+    // Closed before the load finished: the game still needs the results
+    m_imageWatcher.waitForFinished();
+    m_dataWatcher.waitForFinished();
+    finishLoading();
+}
@@ -6,6 +6,10 @@
 #include <QVBoxLayout>
 #include <QTimer>
 #include <QStringList>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QPair>
+#include "../../gameStateManager.h"
 #include <QPropertyAnimation>    // Added for the animation system
 #include <QGraphicsOpacityEffect> // Added to allow opacity manipulation
 
@@ -18,16 +22,23 @@ public:
 private slots:
     void closeDialogAutomatically(); 
     void updateLoadingMessage(); 
+    void onLoadingStepFinished();
 private:
+    // Starts image decoding and data parsing on the thread pool
+    void startLoading();
+    // Hands the results to GameResources and gameStateManager (GUI thread)
+    void finishLoading();
+
     QLabel *m_gameTitleLabel;
     QLabel *m_versionLabel;
     QLabel *m_imageLabel;
     QLabel *m_copyrightLabel;
     QLabel *m_loadingMessageLabel; 
     QTimer *m_closeTimer;
-    QTimer *m_messageTimer; 
-    QStringList m_loadingFiles; 
-    int m_currentFileIndex;     
+    // Background loading: decoded images and parsed game data
+    QFutureWatcher<QPair<QString, QImage>> m_imageWatcher;
+    QFutureWatcher<gameStateManager::StaticData> m_dataWatcher;
+    bool m_loadingFinished = false;
     // Animation System Members
     QGraphicsOpacityEffect *m_titleOpacityEffect; // The "bridge" between the widget and animation
     QPropertyAnimation *m_titleFadeAnimation;     // The animation controller
@@ -5,6 +5,7 @@
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
+#include "src/core/savegameUtils.h"
 
 MorgueDialog::MorgueDialog(QWidget *parent) : QDialog(parent)
 {
@@ -45,76 +46,41 @@ void MorgueDialog::setupUi()
 
 QList<DeadCharacterInfo> MorgueDialog::fetchDeadCharacterData() const
 {
-    QDir dir("data/characters");
-    QStringList allFiles = dir.entryList({"*.txt"}, QDir::Files);
+    // Straight from the roster index; no character file is opened
     QList<DeadCharacterInfo> deadList;
-
-    for (const QString &fileName : allFiles) {
-        QFile file(dir.absoluteFilePath(fileName));
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&file);
-            DeadCharacterInfo info = {fileName, false, 0};
-            bool isDead = false;
-            while (!in.atEnd()) {
-                QString line = in.readLine().trimmed();
-                if (line.startsWith("isAlive: 0")) isDead = true;
-                else if (line.startsWith("inCity: 1")) info.inCity = true;
-                else if (line.startsWith("DungeonLevel:")) info.dungeonLevel = line.split(":")[1].trimmed().toInt();
-            }
-            if (isDead) deadList.append(info);
-            file.close();
-        }
+    const auto dead = gameStateManager::instance()->roster()->list(CharacterJournal::Status::Dead);
+    for (const CharacterJournal::Summary &summary : dead) {
+        deadList.append({summary.name + ".txt", summary.inCity, summary.dungeonLevel});
     }
     return deadList;
 }
 
-bool MorgueDialog::moveBodyToCityInFile(const QString &fileName)
+// Applies 'changes' to the roster entry, then rewrites the character's .txt export from it
+static bool updateRosterEntry(const QString &fileName, const CharacterJournal::Fields &changes)
 {
-    QString filePath = "data/characters/" + fileName;
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
-
-    QStringList lines;
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        if (line.startsWith("inCity:")) line = "inCity: 1";
-        else if (line.startsWith("DungeonLevel:")) line = "DungeonLevel: 0";
-        else if (line.startsWith("DungeonX:")) line = "DungeonX: 17";
-        else if (line.startsWith("DungeonY:")) line = "DungeonY: 12";
-        lines.append(line);
-    }
-    file.close();
+    QString name = fileName;
+    if (name.endsWith(".txt")) name.chop(4);
+
+    CharacterJournal* roster = gameStateManager::instance()->roster();
+    if (!roster->update(name, changes)) return false;
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
-    QTextStream out(&file);
-    for (const QString &l : lines) out << l << "\n";
-    file.close();
-    return true;
+    CharacterJournal::Fields fields;
+    if (!roster->get(name, fields)) return false;
+    return SavegameUtils::writeFileAtomic("data/characters/" + name + ".txt", CharacterJournal::toText(fields));
 }
 
-bool MorgueDialog::updateCharacterFile(const QString &fileName, bool resurrect)
+bool MorgueDialog::moveBodyToCityInFile(const QString &fileName)
 {
-    QString filePath = "data/characters/" + fileName;
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
-
-    QStringList lines;
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        if (resurrect && line.startsWith("isAlive:")) line = "isAlive: 1";
-        if (line.startsWith("inCity:")) line = "inCity: 1";
-        if (line.startsWith("DungeonLevel:")) line = "DungeonLevel: 0";
-        lines.append(line);
-    }
-    file.close();
+    return updateRosterEntry(fileName, {
+        {"inCity", "1"}, {"DungeonLevel", "0"}, {"DungeonX", "17"}, {"DungeonY", "12"}
+    });
+}
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
-    QTextStream out(&file);
-    for (const QString &l : lines) out << l << "\n";
-    file.close();
-    return true;
+bool MorgueDialog::updateCharacterFile(const QString &fileName, bool resurrect)
+{
+    CharacterJournal::Fields changes = {{"inCity", "1"}, {"DungeonLevel", "0"}};
+    if (resurrect) changes.insert("isAlive", "1");
+    return updateRosterEntry(fileName, changes);
 }
 
 int MorgueDialog::calculateRescueCost(int level) const { 
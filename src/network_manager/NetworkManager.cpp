@@ -3,7 +3,9 @@
 #include <QJsonDocument> // Included here instead of the header
 #include <QJsonObject>   // Included here instead of the header
 #include <QVariantMap>   // Included here instead of the header
+#include <QTimer>
 #include <QDebug>
+#include "../../gameStateManager.h"
 
 NetworkManager* NetworkManager::m_instance = nullptr;
 
@@ -14,10 +16,21 @@ NetworkManager* NetworkManager::instance() {
 
 NetworkManager::NetworkManager(QObject *parent) : QObject(parent) {
     m_socket = new QTcpSocket(this);
+    // Nothing about us is known until the game reports it (PlayerState defaults to all fields)
+    m_self.fields = 0;
 
     connect(m_socket, &QTcpSocket::connected, this, &NetworkManager::onConnected);
     connect(m_socket, &QTcpSocket::disconnected, this, &NetworkManager::onDisconnected);
     connect(m_socket, &QTcpSocket::readyRead, this, &NetworkManager::onReadyRead);
+
+    // A step changes X and Y (and sometimes the level) one after another; the short
+    // delay folds them into a single update
+    m_updateTimer = new QTimer(this);
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(20);
+    connect(m_updateTimer, &QTimer::timeout, this, &NetworkManager::flushPlayerUpdate);
+    connect(gameStateManager::instance(), &gameStateManager::gameValueChanged,
+            this, &NetworkManager::onGameValueChanged);
 }
 
 void NetworkManager::connectToServer(const QString &host, quint16 port) {
@@ -27,40 +40,89 @@ void NetworkManager::connectToServer(const QString &host, quint16 port) {
 }
 
 void NetworkManager::sendAction(const QString &action, const QVariantMap &data) {
-    if (m_socket->state() != QAbstractSocket::ConnectedState) return;
-
     QJsonObject obj = QJsonObject::fromVariantMap(data);
     obj["action"] = action;
+    sendMessage(WireProtocol::fromJson(obj));
+}
+
+void NetworkManager::enterZone(const QString &zone, int level, const QString &username) {
+    if (!username.isEmpty()) m_username = username;
+    QVariantMap data = { {"zone", zone}, {"username", m_username} };
+    if (level >= 0) data["level"] = level;
+    sendAction("enter_zone", data);
+}
+
+void NetworkManager::sendMessage(const WireProtocol::Message &message) {
+    if (m_socket->state() != QAbstractSocket::ConnectedState) return;
 
-    QJsonDocument doc(obj);
-    // Newline acting as packet delimiter
-    m_socket->write(doc.toJson(QJsonDocument::Compact) + "\n");
+    // JSON lines until the server has agreed to binary frames
+    m_socket->write(m_binary ? WireProtocol::encodeBinary(message)
+                             : WireProtocol::encodeJson(message, WireProtocol::Direction::ToServer));
 }
 
 void NetworkManager::onReadyRead() {
-    while (m_socket->canReadLine()) {
-        QByteArray line = m_socket->readLine();
-        QJsonDocument doc = QJsonDocument::fromJson(line);
-        if (doc.isNull()) continue;
-
-        QJsonObject obj = doc.object();
-        QString type = obj["type"].toString();
-
-        // Route incoming server packets to the correct signals
-        if (type == "chat") {
-            emit chatReceived(obj["sender"].toString(), obj["message"].toString());
-        } else if (type == "player_join") {
-            emit playerJoined(obj["username"].toString());
-        } else if (type == "player_leave") {
-            emit playerLeft(obj["username"].toString());
-        } else if (type == "zone_sync") {
-            emit zoneUpdateReceived(obj["data"].toVariant().toMap());
+    m_readBuffer += m_socket->readAll();
+
+    qsizetype pos = 0;
+    WireProtocol::Message message;
+    qsizetype consumed = 0;
+    while (true) {
+        const auto result = WireProtocol::decode(m_readBuffer.constData() + pos, m_readBuffer.size() - pos, message, consumed);
+        if (result == WireProtocol::DecodeResult::NeedMore) break;
+        if (result == WireProtocol::DecodeResult::Corrupt) {
+            qWarning() << "Corrupt packet from game server, disconnecting.";
+            m_readBuffer.clear();
+            m_socket->abort();
+            return;
         }
+        pos += consumed;
+        handleMessage(message);
+    }
+    m_readBuffer.remove(0, pos);
+}
+
+void NetworkManager::handleMessage(const WireProtocol::Message &message) {
+    using WireProtocol::MessageType;
+
+    // Route incoming server packets to the correct signals
+    switch (message.type) {
+    case MessageType::Hello:
+        m_binary = message.binary;
+        qDebug() << "Game server protocol:" << (m_binary ? "binary" : "json");
+        break;
+    case MessageType::Chat:
+        emit chatReceived(message.sender, message.text);
+        break;
+    case MessageType::PlayerJoin:
+        emit playerJoined(message.username);
+        break;
+    case MessageType::PlayerLeave:
+        emit playerLeft(message.username);
+        break;
+    case MessageType::ZoneSync:
+        emit zoneUpdateReceived(WireProtocol::toJson(message, WireProtocol::Direction::ToClient)["data"].toObject().toVariantMap());
+        break;
+    default:
+        break;
     }
 }
 
 void NetworkManager::onConnected() {
     qDebug() << "Connected to game server.";
+    m_binary = false;
+    m_readBuffer.clear();
+    // Offer binary frames; BLACKLANDS_NET_JSON keeps the connection readable for debugging
+    if (!qEnvironmentVariableIsSet("BLACKLANDS_NET_JSON")) {
+        WireProtocol::Message hello;
+        hello.type = WireProtocol::MessageType::Hello;
+        hello.version = WireProtocol::VERSION;
+        hello.binary = true;
+        sendMessage(hello);
+    }
+    // Whatever we know so far goes out once the connection is up
+    seedFromGameState();
+    m_dirtyFields = m_self.fields;
+    if (m_dirtyFields) m_updateTimer->start();
     emit connected();
 }
 
@@ -69,6 +131,66 @@ void NetworkManager::onDisconnected() {
     emit disconnected();
 }
 
+void NetworkManager::setFacing(quint8 facing) {
+    if (m_self.facing == facing && (m_self.fields & WireProtocol::Facing)) return;
+    m_self.facing = facing;
+    markDirty(WireProtocol::Facing);
+}
+
+void NetworkManager::onGameValueChanged(const QString &key, const QVariant &value) {
+    if (key == "DungeonX") {
+        m_self.x = qint16(value.toInt());
+        markDirty(WireProtocol::Position);
+    } else if (key == "DungeonY") {
+        m_self.y = qint16(value.toInt());
+        markDirty(WireProtocol::Position);
+    } else if (key == "DungeonLevel") {
+        m_self.level = qint16(value.toInt());
+        markDirty(WireProtocol::Position);
+    } else if (key == "CurrentCharacterHP") {
+        m_self.hp = value.toInt();
+        markDirty(WireProtocol::Health);
+    }
+}
+
+// Picks up the position and HP the game already has, so the first update
+// carries real values instead of the zeroed defaults
+void NetworkManager::seedFromGameState() {
+    gameStateManager* gsm = gameStateManager::instance();
+    if (gsm->dungeonLevel() > 0) {
+        m_self.x = qint16(gsm->dungeonX());
+        m_self.y = qint16(gsm->dungeonY());
+        m_self.level = qint16(gsm->dungeonLevel());
+        m_self.fields |= WireProtocol::Position;
+    }
+    if (gsm->getGameValue("CurrentCharacterHP").isValid()) {
+        m_self.hp = gsm->getGameValue("CurrentCharacterHP").toInt();
+        m_self.fields |= WireProtocol::Health;
+    }
+}
+
+void NetworkManager::markDirty(quint8 fields) {
+    m_self.fields |= fields;
+    m_dirtyFields |= fields;
+    if (m_socket->state() == QAbstractSocket::ConnectedState && !m_updateTimer->isActive()) {
+        m_updateTimer->start();
+    }
+}
+
+void NetworkManager::flushPlayerUpdate() {
+    if (!m_dirtyFields || m_socket->state() != QAbstractSocket::ConnectedState) return;
+
+    // Only the fields that changed; the server relays them with its next zone tick
+    WireProtocol::PlayerState update = m_self;
+    update.fields = m_dirtyFields;
+    m_dirtyFields = 0;
+
+    WireProtocol::Message message;
+    message.type = WireProtocol::MessageType::PlayerUpdate;
+    message.players.append(update);
+    sendMessage(message);
+}
+
 QAbstractSocket::SocketState NetworkManager::state() const {
     return m_socket->state();
 }
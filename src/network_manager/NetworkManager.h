@@ -6,10 +6,13 @@
 #include <QVariant>
 #include <QMap>
 #include <QString>
+#include <QByteArray>
+#include "WireProtocol.h"
 
 
 // Forward declarations to reduce header weight
 class QTcpSocket;
+class QTimer;
 class QString;
 template <typename K, typename V> class QMap;
 typedef QMap<QString, QVariant> QVariantMap;
@@ -22,7 +25,13 @@ public:
     
     void connectToServer(const QString &host, quint16 port);
     void sendAction(const QString &action, const QVariantMap &data);
+    void sendMessage(const WireProtocol::Message &message);
+    // Moves us to another zone on the server; a level >= 0 picks one dungeon level ("dungeon", 3 is
+    // the server's "dungeon_3"). The name given the first time is kept for every later zone change.
+    void enterZone(const QString &zone, int level = -1, const QString &username = QString());
     QAbstractSocket::SocketState state() const;
+    // 0 = North, 1 = East, 2 = South, 3 = West; only the compass knows which way we face
+    void setFacing(quint8 facing);
 
 signals:
     void connected();
@@ -37,11 +46,24 @@ private slots:
     void onReadyRead();
     void onConnected();
     void onDisconnected();
+    void onGameValueChanged(const QString &key, const QVariant &value);
+    void flushPlayerUpdate();
 
 private:
     explicit NetworkManager(QObject *parent = nullptr);
+    void handleMessage(const WireProtocol::Message &message);
+    void markDirty(quint8 fields);
+    void seedFromGameState();
     static NetworkManager* m_instance;
     QTcpSocket *m_socket;
+    QByteArray m_readBuffer;
+    bool m_binary = false; // Server acknowledged binary frames (see WireProtocol.h)
+    QString m_username;    // Sent with every enter_zone; the server takes the name from it
+
+    // Our own state, reported as one player_update per burst of changes
+    WireProtocol::PlayerState m_self;
+    quint8 m_dirtyFields = 0;
+    QTimer *m_updateTimer;
 };
 
 #endif // NETWORKMANAGER_H
@@ -0,0 +1,420 @@
+#include "WireProtocol.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <cstring>
+
+namespace WireProtocol {
+
+namespace {
+
+    struct TypeName {
+        MessageType type;
+        const char* name;
+    };
+
+    const TypeName TYPE_NAMES[] = {
+        { MessageType::Hello,       "hello" },
+        { MessageType::EnterZone,   "enter_zone" },
+        { MessageType::LeaveZone,   "leave_zone" },
+        { MessageType::Chat,        "chat" },
+        { MessageType::PlayerJoin,  "player_join" },
+        { MessageType::PlayerLeave, "player_leave" },
+        { MessageType::ZoneSync,    "zone_sync" },
+        { MessageType::PlayerUpdate, "player_update" },
+    };
+
+    QString typeName(const Message& message) {
+        if (message.type == MessageType::Action) return message.action;
+        for (const TypeName& entry : TYPE_NAMES) {
+            if (entry.type == message.type) return QString::fromLatin1(entry.name);
+        }
+        return QString();
+    }
+
+    MessageType typeFromName(const QString& name) {
+        for (const TypeName& entry : TYPE_NAMES) {
+            if (name == QLatin1String(entry.name)) return entry.type;
+        }
+        return MessageType::Action;
+    }
+
+    // --- Binary writing ---
+
+    void putVarint(QByteArray& out, quint32 value) {
+        while (value >= 0x80) {
+            out.append(char(value | 0x80));
+            value >>= 7;
+        }
+        out.append(char(value));
+    }
+
+    template<typename T>
+    void putFixed(QByteArray& out, T value) {
+        const T le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+    }
+
+    void putString(QByteArray& out, const QString& value) {
+        const QByteArray utf8 = value.toUtf8();
+        putVarint(out, quint32(utf8.size()));
+        out.append(utf8);
+    }
+
+    // --- Binary reading. Every read checks the end; a short payload fails the whole frame. ---
+
+    class Reader {
+    public:
+        Reader(const char* data, qsizetype size) : m_p(data), m_end(data + size) {}
+
+        bool ok() const { return m_ok; }
+        bool atEnd() const { return m_p == m_end; }
+
+        quint32 varint() {
+            quint32 value = 0;
+            for (int shift = 0; shift < 35; shift += 7) {
+                if (m_p == m_end) break;
+                const quint8 byte = quint8(*m_p++);
+                value |= quint32(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            m_ok = false;
+            return 0;
+        }
+
+        template<typename T>
+        T fixed() {
+            if (m_end - m_p < qsizetype(sizeof(T))) {
+                m_ok = false;
+                return T();
+            }
+            const T value = qFromLittleEndian<T>(m_p);
+            m_p += sizeof(T);
+            return value;
+        }
+
+        QString string() {
+            const quint32 size = varint();
+            if (!m_ok || m_end - m_p < qsizetype(size)) {
+                m_ok = false;
+                return QString();
+            }
+            const QString value = QString::fromUtf8(m_p, size);
+            m_p += size;
+            return value;
+        }
+
+    private:
+        const char* m_p;
+        const char* m_end;
+        bool m_ok = true;
+    };
+
+    void putPlayerFields(QByteArray& out, const PlayerState& player) {
+        out.append(char(player.fields));
+        if (player.fields & Position) {
+            putFixed<qint16>(out, player.x);
+            putFixed<qint16>(out, player.y);
+            putFixed<qint16>(out, player.level);
+        }
+        if (player.fields & Facing) out.append(char(player.facing));
+        if (player.fields & Health) putFixed<qint32>(out, player.hp);
+    }
+
+    void addPlayerFields(QJsonObject& obj, const PlayerState& player) {
+        if (player.fields & Position) {
+            obj["DungeonX"] = player.x;
+            obj["DungeonY"] = player.y;
+            obj["DungeonLevel"] = player.level;
+        }
+        if (player.fields & Facing) obj["facing"] = player.facing;
+        if (player.fields & Health) obj["hp"] = player.hp;
+        if (player.fields & Removed) obj["removed"] = true;
+    }
+
+    void readPlayerFields(Reader& in, PlayerState& player) {
+        player.fields = in.fixed<quint8>();
+        if (player.fields & Position) {
+            player.x = in.fixed<qint16>();
+            player.y = in.fixed<qint16>();
+            player.level = in.fixed<qint16>();
+        }
+        if (player.fields & Facing) player.facing = in.fixed<quint8>();
+        if (player.fields & Health) player.hp = in.fixed<qint32>();
+    }
+
+    QJsonObject playerToJson(const PlayerState& player) {
+        QJsonObject obj;
+        obj["username"] = player.username;
+        addPlayerFields(obj, player);
+        return obj;
+    }
+
+    PlayerState playerFromJson(const QJsonObject& obj) {
+        PlayerState player;
+        player.username = obj["username"].toString();
+        player.fields = 0;
+        if (obj.contains("DungeonX")) {
+            player.fields |= Position;
+            player.x = qint16(obj["DungeonX"].toInt());
+            player.y = qint16(obj["DungeonY"].toInt());
+            player.level = qint16(obj["DungeonLevel"].toInt());
+        }
+        if (obj.contains("facing")) {
+            player.fields |= Facing;
+            player.facing = quint8(obj["facing"].toInt());
+        }
+        if (obj.contains("hp")) {
+            player.fields |= Health;
+            player.hp = obj["hp"].toInt();
+        }
+        if (obj["removed"].toBool()) player.fields |= Removed;
+        return player;
+    }
+
+    DecodeResult decodeJsonLine(const char* data, qsizetype size, Message& message, qsizetype& consumed) {
+        const char* newline = static_cast<const char*>(memchr(data, '\n', size_t(size)));
+        if (!newline) return size > MAX_MESSAGE_SIZE ? DecodeResult::Corrupt : DecodeResult::NeedMore;
+
+        consumed = newline - data + 1;
+        const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(data, consumed - 1));
+        message = doc.isObject() ? fromJson(doc.object()) : Message();
+        return DecodeResult::Decoded;
+    }
+
+    DecodeResult decodeFrame(const char* data, qsizetype size, Message& message, qsizetype& consumed) {
+        // 1. Marker and length; the length varint itself may still be incomplete
+        Reader header(data + 1, qMin<qsizetype>(size - 1, 5));
+        const quint32 length = header.varint();
+        if (!header.ok()) return size - 1 >= 5 ? DecodeResult::Corrupt : DecodeResult::NeedMore;
+        if (length == 0 || length > quint32(MAX_MESSAGE_SIZE)) return DecodeResult::Corrupt;
+
+        qsizetype headerSize = 1;
+        while (quint8(data[headerSize]) & 0x80) ++headerSize;
+        ++headerSize;
+        if (size < headerSize + qsizetype(length)) return DecodeResult::NeedMore;
+
+        // 2. Payload
+        Reader in(data + headerSize, length);
+        Message m;
+        m.type = MessageType(in.fixed<quint8>());
+        switch (m.type) {
+        case MessageType::Hello:
+            m.version = in.varint();
+            m.binary = in.fixed<quint8>() != 0;
+            break;
+        case MessageType::EnterZone:
+            m.username = in.string();
+            m.zone = in.string();
+            m.level = in.fixed<qint32>();
+            break;
+        case MessageType::LeaveZone:
+            m.zone = in.string();
+            break;
+        case MessageType::Chat:
+            m.sender = in.string();
+            m.text = in.string();
+            break;
+        case MessageType::PlayerJoin:
+        case MessageType::PlayerLeave:
+            m.username = in.string();
+            break;
+        case MessageType::ZoneSync: {
+            m.zone = in.string();
+            m.fullSnapshot = in.fixed<quint8>() != 0;
+            const quint32 count = in.varint();
+            for (quint32 i = 0; i < count && in.ok(); ++i) {
+                PlayerState player;
+                player.username = in.string();
+                readPlayerFields(in, player);
+                m.players.append(player);
+            }
+            break;
+        }
+        case MessageType::PlayerUpdate: {
+            PlayerState player;
+            readPlayerFields(in, player);
+            m.players.append(player);
+            break;
+        }
+        case MessageType::Action: {
+            m.action = in.string();
+            const QByteArray json = in.string().toUtf8();
+            m.data = QJsonDocument::fromJson(json).object().toVariantMap();
+            break;
+        }
+        default:
+            return DecodeResult::Corrupt;
+        }
+        if (!in.ok() || !in.atEnd()) return DecodeResult::Corrupt;
+
+        message = std::move(m);
+        consumed = headerSize + length;
+        return DecodeResult::Decoded;
+    }
+
+} // namespace
+
+QByteArray encodeBinary(const Message& message) {
+    QByteArray payload;
+    payload.append(char(message.type));
+    switch (message.type) {
+    case MessageType::Hello:
+        putVarint(payload, message.version);
+        payload.append(char(message.binary ? 1 : 0));
+        break;
+    case MessageType::EnterZone:
+        putString(payload, message.username);
+        putString(payload, message.zone);
+        putFixed<qint32>(payload, message.level);
+        break;
+    case MessageType::LeaveZone:
+        putString(payload, message.zone);
+        break;
+    case MessageType::Chat:
+        putString(payload, message.sender);
+        putString(payload, message.text);
+        break;
+    case MessageType::PlayerJoin:
+    case MessageType::PlayerLeave:
+        putString(payload, message.username);
+        break;
+    case MessageType::ZoneSync:
+        putString(payload, message.zone);
+        payload.append(char(message.fullSnapshot ? 1 : 0));
+        putVarint(payload, quint32(message.players.size()));
+        for (const PlayerState& player : message.players) {
+            putString(payload, player.username);
+            putPlayerFields(payload, player);
+        }
+        break;
+    case MessageType::PlayerUpdate:
+        putPlayerFields(payload, message.players.value(0));
+        break;
+    case MessageType::Action:
+        putString(payload, message.action);
+        putString(payload, QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(message.data)).toJson(QJsonDocument::Compact)));
+        break;
+    case MessageType::Invalid:
+        return QByteArray();
+    }
+
+    QByteArray frame;
+    frame.reserve(payload.size() + 6);
+    frame.append(char(FRAME_MARKER));
+    putVarint(frame, quint32(payload.size()));
+    frame.append(payload);
+    return frame;
+}
+
+QJsonObject toJson(const Message& message, Direction direction) {
+    QJsonObject obj;
+    if (message.type == MessageType::Action) obj = QJsonObject::fromVariantMap(message.data);
+    obj[direction == Direction::ToServer ? "action" : "type"] = typeName(message);
+
+    switch (message.type) {
+    case MessageType::Hello:
+        obj["protocol"] = message.binary ? "binary" : "json";
+        obj["version"] = qint64(message.version);
+        break;
+    case MessageType::EnterZone:
+        obj["username"] = message.username;
+        obj["zone"] = message.zone;
+        if (message.level >= 0) obj["level"] = message.level;
+        break;
+    case MessageType::LeaveZone:
+        obj["zone"] = message.zone;
+        break;
+    case MessageType::Chat:
+        if (!message.sender.isEmpty()) obj["sender"] = message.sender;
+        obj["message"] = message.text;
+        break;
+    case MessageType::PlayerJoin:
+    case MessageType::PlayerLeave:
+        obj["username"] = message.username;
+        break;
+    case MessageType::ZoneSync: {
+        QJsonArray players;
+        for (const PlayerState& player : message.players) players.append(playerToJson(player));
+        QJsonObject data;
+        data["zone"] = message.zone;
+        data["full"] = message.fullSnapshot;
+        data["players"] = players;
+        obj["data"] = data;
+        break;
+    }
+    case MessageType::PlayerUpdate:
+        addPlayerFields(obj, message.players.value(0));
+        break;
+    case MessageType::Action:
+    case MessageType::Invalid:
+        break;
+    }
+    return obj;
+}
+
+QByteArray encodeJson(const Message& message, Direction direction) {
+    return QJsonDocument(toJson(message, direction)).toJson(QJsonDocument::Compact) + "\n";
+}
+
+Message fromJson(const QJsonObject& obj) {
+    Message message;
+    const QString name = obj.contains("action") ? obj["action"].toString() : obj["type"].toString();
+    if (name.isEmpty()) return message;
+    message.type = typeFromName(name);
+
+    switch (message.type) {
+    case MessageType::Hello:
+        message.binary = obj["protocol"].toString() == "binary";
+        message.version = quint32(obj["version"].toInteger());
+        break;
+    case MessageType::EnterZone:
+        message.username = obj["username"].toString();
+        message.zone = obj["zone"].toString();
+        message.level = obj.contains("level") ? obj["level"].toInt() : -1;
+        break;
+    case MessageType::LeaveZone:
+        message.zone = obj["zone"].toString();
+        break;
+    case MessageType::Chat:
+        message.sender = obj["sender"].toString();
+        message.text = obj["message"].toString();
+        break;
+    case MessageType::PlayerJoin:
+    case MessageType::PlayerLeave:
+        message.username = obj["username"].toString();
+        break;
+    case MessageType::ZoneSync: {
+        const QJsonObject data = obj["data"].toObject();
+        message.zone = data["zone"].toString();
+        message.fullSnapshot = data["full"].toBool();
+        const QJsonArray players = data["players"].toArray();
+        for (const QJsonValue& player : players) message.players.append(playerFromJson(player.toObject()));
+        break;
+    }
+    case MessageType::PlayerUpdate: {
+        PlayerState player = playerFromJson(obj);
+        player.username.clear();
+        message.players.append(player);
+        break;
+    }
+    case MessageType::Action: {
+        message.action = name;
+        message.data = obj.toVariantMap();
+        message.data.remove("action");
+        message.data.remove("type");
+        break;
+    }
+    case MessageType::Invalid:
+        break;
+    }
+    return message;
+}
+
+DecodeResult decode(const char* data, qsizetype size, Message& message, qsizetype& consumed) {
+    if (size <= 0) return DecodeResult::NeedMore;
+    if (quint8(data[0]) == FRAME_MARKER) return decodeFrame(data, size, message, consumed);
+    return decodeJsonLine(data, size, message, consumed);
+}
+
+} // namespace WireProtocol
@@ -0,0 +1,112 @@
+#ifndef WIREPROTOCOL_H
+#define WIREPROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief Messages exchanged by NetworkManager and the game server, and their
+ * two encodings.
+ *
+ * JSON: one compact object per line. Client messages carry "action", server
+ * messages carry "type". This is what every connection starts with, and what
+ * a client keeps using when BLACKLANDS_NET_JSON is set (handy with netcat).
+ *
+ * Binary: 0xB7, a varint payload length, then the payload: a one-byte
+ * MessageType followed by that type's fields. Integers are fixed-width
+ * little-endian, strings are a varint byte count plus UTF-8.
+ *
+ * zone_sync carries the players of one zone. A full snapshot lists every
+ * player with all known fields; a delta lists only the players that changed
+ * since the previous tick, each with the PlayerField bits of what changed.
+ *
+ * Negotiation: the client sends a JSON hello announcing binary support. The
+ * server answers with a hello and from then on sends that client binary
+ * frames; the client switches to binary once it sees the answer. Readers on
+ * both sides accept either encoding at any time, telling them apart by the
+ * first byte, so nothing sent during the switch is misread. A server that
+ * doesn't know hello just ignores it and the connection stays on JSON.
+ */
+namespace WireProtocol {
+
+    const quint8 FRAME_MARKER = 0xB7;
+    const quint32 VERSION = 1;
+    const qsizetype MAX_MESSAGE_SIZE = 1 << 20; // Longer lines or frames mean a broken peer
+
+    enum class MessageType : quint8 {
+        Invalid = 0,
+        Hello,       // protocol negotiation
+        EnterZone,   // client: username, zone, level
+        LeaveZone,   // client: zone
+        Chat,        // client: text / server: sender, text
+        PlayerJoin,  // server: username
+        PlayerLeave, // server: username
+        ZoneSync,    // server: zone, fullSnapshot, players
+        Action,      // anything else: action name plus its JSON data
+        PlayerUpdate // client: its own state, players[0] (username unused)
+    };
+
+    // Which PlayerState fields a ZoneSync entry carries
+    enum PlayerField : quint8 {
+        Position = 0x01, // x, y, level
+        Facing   = 0x02,
+        Health   = 0x04,
+        Removed  = 0x08, // Player left the zone
+        AllFields = Position | Facing | Health
+    };
+
+    struct PlayerState {
+        QString username;
+        quint8 fields = AllFields;
+        qint16 x = 0;
+        qint16 y = 0;
+        qint16 level = 0;
+        quint8 facing = 0;
+        qint32 hp = 0;
+
+        bool operator==(const PlayerState& other) const = default;
+    };
+
+    struct Message {
+        MessageType type = MessageType::Invalid;
+        QString username;          // EnterZone, PlayerJoin, PlayerLeave
+        QString zone;              // EnterZone, LeaveZone, ZoneSync
+        qint32 level = -1;         // EnterZone: dungeon level, -1 when not in the dungeon
+        QString sender;            // Chat (server to client)
+        QString text;              // Chat
+        quint32 version = 0;       // Hello
+        bool binary = false;       // Hello: binary frames supported
+        bool fullSnapshot = false; // ZoneSync
+        QList<PlayerState> players;// ZoneSync, PlayerUpdate
+        QString action;            // Action
+        QVariantMap data;          // Action
+
+        bool operator==(const Message& other) const = default;
+    };
+
+    // Client requests use "action", server messages use "type"
+    enum class Direction { ToServer, ToClient };
+
+    QByteArray encodeBinary(const Message& message);
+    QByteArray encodeJson(const Message& message, Direction direction);
+    QJsonObject toJson(const Message& message, Direction direction);
+    // Accepts both directions; unknown client actions become MessageType::Action
+    Message fromJson(const QJsonObject& obj);
+
+    enum class DecodeResult {
+        Decoded,  // 'message' holds the next message (type Invalid for an unreadable JSON line)
+        NeedMore, // Incomplete line or frame; wait for more bytes
+        Corrupt   // Bad frame; the stream can't be resynchronized
+    };
+
+    // Decodes the message, JSON line or binary frame, at the start of 'data'.
+    // On Decoded, 'consumed' is its length in bytes. Callers decode a whole
+    // read buffer this way and drop the consumed prefix once at the end.
+    DecodeResult decode(const char* data, qsizetype size, Message& message, qsizetype& consumed);
+
+} // namespace WireProtocol
+
+#endif // WIREPROTOCOL_H
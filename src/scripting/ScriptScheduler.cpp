@@ -0,0 +1,205 @@
+#include "ScriptScheduler.h"
+#include <QDebug>
+#include <QVariantMap>
+
+// What the wait functions hand to lua_yield: the kind of wait, then its argument
+static int yieldFor(lua_State* L, ScriptScheduler::Wait wait, lua_Integer argument) {
+    if (!lua_isyieldable(L)) {
+        return luaL_error(L, "wait functions can only be used in a scheduled script");
+    }
+    lua_pushinteger(L, lua_Integer(wait));
+    lua_pushinteger(L, argument);
+    return lua_yield(L, 2);
+}
+
+ScriptScheduler::ScriptScheduler(lua_State* L)
+    : m_L(L)
+{
+    m_onError = [](const QString& message) { qWarning().noquote() << "Lua script error:" << message; };
+}
+
+ScriptScheduler::~ScriptScheduler() {
+    for (const Task& task : std::as_const(m_tasks)) luaL_unref(m_L, LUA_REGISTRYINDEX, task.ref);
+}
+
+void ScriptScheduler::registerApi() {
+    lua_register(m_L, "wait", [](lua_State* L) -> int {
+        return yieldFor(L, Wait::Ticks, qMax<lua_Integer>(1, luaL_optinteger(L, 1, 1)));
+    });
+    lua_register(m_L, "wait_input", [](lua_State* L) -> int {
+        return yieldFor(L, Wait::Input, 0);
+    });
+    lua_register(m_L, "wait_combat", [](lua_State* L) -> int {
+        return yieldFor(L, Wait::CombatEnd, 0);
+    });
+}
+
+int ScriptScheduler::spawn(int nargs, const void* owner) {
+    // 1. A new coroutine, anchored in the registry so the GC keeps it while it sleeps
+    lua_State* thread = lua_newthread(m_L);
+    const int ref = luaL_ref(m_L, LUA_REGISTRYINDEX);
+    lua_xmove(m_L, thread, nargs + 1); // Function and arguments
+
+    const int id = m_nextId++;
+    Task task;
+    task.thread = thread;
+    task.ref = ref;
+    task.owner = owner;
+    m_tasks.insert(id, task);
+
+    // 2. Run it up to its first wait
+    resume(id, nargs);
+    return m_tasks.contains(id) ? id : 0;
+}
+
+int ScriptScheduler::spawnGlobal(const char* function, const QVariantList& args, const void* owner) {
+    lua_getglobal(m_L, function);
+    if (!lua_isfunction(m_L, -1)) {
+        lua_pop(m_L, 1);
+        m_onError(QString("no function named '%1'").arg(QString::fromUtf8(function)));
+        return 0;
+    }
+    for (const QVariant& arg : args) pushVariant(m_L, arg);
+    return spawn(int(args.size()), owner);
+}
+
+void ScriptScheduler::tick() {
+    ++m_tick;
+    while (!m_sleeping.empty() && m_sleeping.top().first <= m_tick) {
+        const Wake wake = m_sleeping.top();
+        m_sleeping.pop();
+
+        // Entries of cancelled or finished tasks are left in the heap and skipped here
+        auto it = m_tasks.constFind(wake.second);
+        if (it == m_tasks.constEnd() || it->wait != Wait::Ticks || it->wakeTick != wake.first) continue;
+        resume(wake.second, 0);
+    }
+}
+
+int ScriptScheduler::notify(Wait wait, const QVariant& value) {
+    // Take the list first; a resumed script that waits again goes onto a fresh one
+    QList<int> waiting;
+    waiting.swap(m_waiting[int(wait)]);
+
+    int resumed = 0;
+    for (int id : std::as_const(waiting)) {
+        auto it = m_tasks.constFind(id);
+        if (it == m_tasks.constEnd() || it->wait != wait) continue;
+        pushVariant(it->thread, value);
+        resume(id, 1);
+        ++resumed;
+    }
+    return resumed;
+}
+
+void ScriptScheduler::resume(int id, int nargs) {
+    lua_State* thread = m_tasks.value(id).thread;
+    int results = 0;
+    m_running.append(id);
+    const int status = lua_resume(thread, m_L, nargs, &results);
+    m_running.removeLast();
+
+    // Cancelled from inside its own run (e.g. the script closed the dungeon): drop it now
+    if (m_cancelled.remove(id)) {
+        finish(id);
+        return;
+    }
+
+    // The script may have spawned tasks meanwhile, so look it up again
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end()) return;
+
+    if (status == LUA_YIELD) {
+        // wait() and friends yield (kind, argument); a bare coroutine.yield() counts as wait(1)
+        Wait wait = Wait::Ticks;
+        lua_Integer argument = 1;
+        if (results == 2 && lua_isinteger(thread, -2)) {
+            wait = Wait(qBound<lua_Integer>(0, lua_tointeger(thread, -2), 2));
+            argument = lua_tointeger(thread, -1);
+        }
+        lua_pop(thread, results);
+
+        it->wait = wait;
+        if (wait == Wait::Ticks) {
+            it->wakeTick = m_tick + qMax<lua_Integer>(1, argument);
+            m_sleeping.push({ it->wakeTick, id });
+        } else {
+            m_waiting[int(wait)].append(id);
+        }
+        return;
+    }
+
+    if (status != LUA_OK) {
+        luaL_traceback(thread, thread, lua_tostring(thread, -1), 0);
+        m_onError(QString::fromUtf8(lua_tostring(thread, -1)));
+    }
+    finish(id);
+}
+
+void ScriptScheduler::finish(int id) {
+    const Task task = m_tasks.take(id);
+    luaL_unref(m_L, LUA_REGISTRYINDEX, task.ref);
+}
+
+void ScriptScheduler::cancel(int id) {
+    auto it = m_tasks.constFind(id);
+    if (it == m_tasks.constEnd()) return;
+    // A running coroutine can't be released under its own feet; resume() drops it when it returns
+    if (m_running.contains(id)) {
+        m_cancelled.insert(id);
+        return;
+    }
+    if (it->wait != Wait::Ticks) m_waiting[int(it->wait)].removeOne(id);
+    finish(id);
+}
+
+void ScriptScheduler::cancelOwner(const void* owner) {
+    QList<int> ids;
+    for (auto it = m_tasks.cbegin(); it != m_tasks.cend(); ++it) {
+        if (it->owner == owner) ids.append(it.key());
+    }
+    for (int id : std::as_const(ids)) cancel(id);
+}
+
+void ScriptScheduler::pushVariant(lua_State* L, const QVariant& value) {
+    switch (value.typeId()) {
+    case QMetaType::UnknownType:
+        lua_pushnil(L);
+        break;
+    case QMetaType::Bool:
+        lua_pushboolean(L, value.toBool());
+        break;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        lua_pushinteger(L, lua_Integer(value.toLongLong()));
+        break;
+    case QMetaType::Double:
+    case QMetaType::Float:
+        lua_pushnumber(L, value.toDouble());
+        break;
+    case QMetaType::QVariantList:
+    case QMetaType::QStringList: {
+        const QVariantList list = value.toList();
+        lua_createtable(L, int(list.size()), 0);
+        for (qsizetype i = 0; i < list.size(); ++i) {
+            pushVariant(L, list[i]);
+            lua_rawseti(L, -2, lua_Integer(i + 1));
+        }
+        break;
+    }
+    case QMetaType::QVariantMap: {
+        const QVariantMap map = value.toMap();
+        lua_createtable(L, 0, int(map.size()));
+        for (auto it = map.cbegin(); it != map.cend(); ++it) {
+            pushVariant(L, it.value());
+            lua_setfield(L, -2, it.key().toUtf8().constData());
+        }
+        break;
+    }
+    default:
+        lua_pushstring(L, value.toString().toUtf8().constData());
+        break;
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef SCRIPTSCHEDULER_H
+#define SCRIPTSCHEDULER_H
+
+extern "C" {
+    #include "lua.h"
+    #include "lauxlib.h"
+}
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVariant>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Runs Lua functions as coroutines that can pause and be resumed
+ * later by the game, all on the thread that owns the lua_State.
+ *
+ * A script pauses with one of the functions registerApi() installs:
+ *
+ *     wait(n)          -- resume after n ticks (default 1)
+ *     wait_input()     -- resume on the next player key press; returns the key text
+ *     wait_combat()    -- resume when the current fight ends; returns true if it was won
+ *
+ * tick() is called from the game's tick timer and resumes only the
+ * coroutines whose wait has run out (a min-heap on the wake-up tick), so a
+ * tick with thousands of sleeping scripts costs only what wakes up.
+ * notify() resumes everything waiting for input or for combat to end.
+ *
+ * A coroutine that errors is logged and dropped; the rest keep running.
+ * Tasks can carry an owner pointer so e.g. a closing dungeon can cancel all
+ * of its tile scripts at once.
+ */
+class ScriptScheduler {
+public:
+    enum class Wait { Ticks, Input, CombatEnd };
+
+    explicit ScriptScheduler(lua_State* L);
+    ~ScriptScheduler();
+
+    ScriptScheduler(const ScriptScheduler&) = delete;
+    ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+    // Installs wait(), wait_input() and wait_combat() as globals
+    void registerApi();
+
+    // Starts the function below 'nargs' arguments on top of the stack (both are popped)
+    // and runs it until it first waits. Returns the task id, or 0 if it already finished or failed.
+    int spawn(int nargs = 0, const void* owner = nullptr);
+
+    // Same, for a global function by name
+    int spawnGlobal(const char* function, const QVariantList& args = {}, const void* owner = nullptr);
+
+    // One game tick: resumes every coroutine whose wait(n) has run out
+    void tick();
+
+    // Resumes everything waiting for 'wait' (Input or CombatEnd), passing 'value' to it.
+    // Returns how many coroutines were resumed.
+    int notify(Wait wait, const QVariant& value = QVariant());
+
+    bool hasWaiting(Wait wait) const { return !m_waiting[int(wait)].isEmpty(); }
+
+    void cancel(int id);
+    void cancelOwner(const void* owner);
+
+    int taskCount() const { return m_tasks.size(); }
+    qint64 currentTick() const { return m_tick; }
+
+    // Lua error handler for every resume (default: qWarning with a traceback)
+    void setErrorHandler(std::function<void(const QString&)> handler) { m_onError = std::move(handler); }
+
+    static void pushVariant(lua_State* L, const QVariant& value);
+
+private:
+    struct Task {
+        lua_State* thread = nullptr;
+        int ref = LUA_NOREF;      // Registry anchor that keeps the thread alive
+        const void* owner = nullptr;
+        Wait wait = Wait::Ticks;
+        qint64 wakeTick = 0;
+    };
+
+    // Runs the task until it yields again or ends; drops it when it ends
+    void resume(int id, int nargs);
+    void finish(int id);
+
+    lua_State* m_L;
+    QHash<int, Task> m_tasks;
+    int m_nextId = 1;
+    qint64 m_tick = 0;
+
+    // (wake tick, task id), soonest first. Cancelled tasks are skipped when popped.
+    using Wake = std::pair<qint64, int>;
+    std::priority_queue<Wake, std::vector<Wake>, std::greater<Wake>> m_sleeping;
+    QList<int> m_waiting[3];      // Task ids per Wait::Input / Wait::CombatEnd (Ticks unused)
+    QList<int> m_running;         // Tasks inside lua_resume right now (nested when a script notifies)
+    QSet<int> m_cancelled;        // Cancelled while running
+
+    std::function<void(const QString&)> m_onError;
+};
+
+#endif // SCRIPTSCHEDULER_H
@@ -98,41 +98,26 @@ void SeerDialog::on_characterButton_clicked()
     if (!checkAndDeductSeerCost("monsters")) {
         return;
     }
-    // 1. Access the character save directory
-    QDir charDir("data/characters/");
-    QStringList files = charDir.entryList(QStringList() << "*.txt", QDir::Files);
+    // 1. Everyone on the roster, from the in-memory index
+    const QList<CharacterJournal::Summary> characters = gameStateManager::instance()->roster()->list();
 
-    if (files.isEmpty()) {
+    if (characters.isEmpty()) {
         QMessageBox::information(this, "The Seer", "The archives are empty. No souls reside in this realm yet.");
         return;
     }
     // 2. Determine success (60% chance)
     int randomChance = QRandomGenerator::global()->bounded(100);
     if (randomChance < 60) {
-        // 3. Pick a random character file
-        int randomIndex = QRandomGenerator::global()->bounded(files.size());
-        QFile file(charDir.absoluteFilePath(files.at(randomIndex)));
-        QString name, level, guild, dX, dY, dLevel;
-        bool isAlive = true; // Default to true
-        // 4. Parse the file
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&file);
-            while (!in.atEnd()) {
-                QString line = in.readLine().trimmed();
-                if (line.startsWith("Name: ")) name = line.mid(6).trimmed();
-                if (line.startsWith("Level: ")) level = line.mid(7).trimmed();
-                if (line.startsWith("Guild: ")) guild = line.mid(7).trimmed();
-                if (line.startsWith("DungeonX: ")) dX = line.mid(10).trimmed();
-                if (line.startsWith("DungeonY: ")) dY = line.mid(10).trimmed();
-                if (line.startsWith("DungeonLevel: ")) dLevel = line.mid(14).trimmed();
-                
-                // Check for the isAlive flag
-                if (line.startsWith("isAlive: ")) {
-                    isAlive = (line.mid(9).trimmed() == "1" || line.mid(9).toLower() == "true");
-                }
-            }
-            file.close();
-        }
+        // 3. Pick a random character
+        const CharacterJournal::Summary& picked = characters.at(QRandomGenerator::global()->bounded(int(characters.size())));
+        // 4. Everything the vision needs is already in the summary
+        const QString name = picked.name;
+        const QString level = QString::number(picked.level);
+        const QString guild = picked.guild;
+        const QString dX = QString::number(picked.dungeonX);
+        const QString dY = QString::number(picked.dungeonY);
+        const QString dLevel = QString::number(picked.dungeonLevel);
+        const bool isAlive = picked.status != CharacterJournal::Status::Dead;
         // 5. Build the vision description based on status
         QString statusText = isAlive ? "<b style='color:green;'>Living</b>" : "<b style='color:red;'>Deceased (Ghost)</b>";
         QString intro = isAlive ? "The mists part! You see a vision of a fellow explorer:" 
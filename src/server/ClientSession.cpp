@@ -0,0 +1,155 @@
+#include "ClientSession.h"
+#include "ZoneRegistry.h"
+#include <QDebug>
+#include <QTcpSocket>
+
+ClientSession::ClientSession(qintptr socketDescriptor, ZoneRegistry* zones)
+    : m_socketDescriptor(socketDescriptor)
+    , m_zones(zones)
+{
+}
+
+ClientSession::~ClientSession() {
+    // Server shutdown deletes sessions that never disconnected
+    if (!m_zone.isEmpty()) m_zones->leave(m_zone, this);
+}
+
+void ClientSession::start() {
+    // The socket is created here so it belongs to this worker's thread
+    m_socket = new QTcpSocket(this);
+    if (!m_socket->setSocketDescriptor(m_socketDescriptor)) {
+        qWarning() << "Could not adopt connection:" << m_socket->errorString();
+        deleteLater();
+        return;
+    }
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ClientSession::onReadyRead);
+    connect(m_socket, &QTcpSocket::disconnected, this, &ClientSession::onDisconnected);
+    qDebug() << "New connection from:" << m_socket->peerAddress().toString();
+}
+
+void ClientSession::send(const QByteArray& packet) {
+    if (m_socket && m_socket->state() == QAbstractSocket::ConnectedState) {
+        m_socket->write(packet);
+        m_zones->countSent(packet.size());
+    }
+}
+
+void ClientSession::sendMessage(const WireProtocol::Message& message) {
+    send(m_binary ? WireProtocol::encodeBinary(message)
+                  : WireProtocol::encodeJson(message, WireProtocol::Direction::ToClient));
+}
+
+void ClientSession::onReadyRead() {
+    m_readBuffer += m_socket->readAll();
+
+    // JSON lines and binary frames may be mixed while the protocol switches
+    qsizetype pos = 0;
+    WireProtocol::Message message;
+    qsizetype consumed = 0;
+    while (true) {
+        const auto result = WireProtocol::decode(m_readBuffer.constData() + pos, m_readBuffer.size() - pos, message, consumed);
+        if (result == WireProtocol::DecodeResult::NeedMore) break;
+        if (result == WireProtocol::DecodeResult::Corrupt) {
+            qWarning() << "Corrupt packet from" << m_username << ", closing the connection.";
+            m_readBuffer.clear();
+            m_socket->disconnectFromHost();
+            return;
+        }
+        pos += consumed;
+        handleMessage(message);
+    }
+    m_readBuffer.remove(0, pos);
+}
+
+void ClientSession::handleMessage(const WireProtocol::Message& message) {
+    using WireProtocol::MessageType;
+
+    switch (message.type) {
+    // Protocol negotiation: answer first, then switch, so the answer itself is still JSON
+    case MessageType::Hello: {
+        WireProtocol::Message hello;
+        hello.type = MessageType::Hello;
+        hello.version = WireProtocol::VERSION;
+        hello.binary = message.binary && message.version >= WireProtocol::VERSION;
+        sendMessage(hello);
+        m_binary = hello.binary;
+        break;
+    }
+    // LOGIC: Player joins a zone
+    case MessageType::EnterZone: {
+        QString username = message.username;
+        if (username.isEmpty()) username = "Unknown Hero";
+        enterZone(zoneFor(message), username);
+        break;
+    }
+    case MessageType::LeaveZone:
+        leaveZone();
+        break;
+    // LOGIC: Chat relay, only to players in the same zone
+    case MessageType::Chat: {
+        if (m_zone.isEmpty()) return;
+        WireProtocol::Message chat;
+        chat.type = MessageType::Chat;
+        chat.sender = m_username;
+        chat.text = message.text;
+        m_zones->broadcast(m_zone, chat);
+        break;
+    }
+    // Position, facing and HP go into the zone state and out with the next tick
+    case MessageType::PlayerUpdate:
+        if (!m_zone.isEmpty() && !message.players.isEmpty()) {
+            m_zones->updatePlayer(m_zone, m_username, message.players.first());
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void ClientSession::enterZone(const QString& zone, const QString& username) {
+    if (!m_zone.isEmpty()) leaveZone();
+    m_username = username;
+    m_zone = zone;
+    qDebug() << "Player Identified:" << username << "in" << zone;
+
+    // 1. Tell the NEW player about everyone who is ALREADY here
+    WireProtocol::Message join;
+    join.type = WireProtocol::MessageType::PlayerJoin;
+    const QStringList present = m_zones->join(zone, this, username);
+    for (const QString& other : present) {
+        join.username = other;
+        sendMessage(join);
+    }
+
+    // 2. Tell everyone in the zone (including the new player) to add this player
+    join.username = username;
+    m_zones->broadcast(zone, join);
+}
+
+void ClientSession::leaveZone() {
+    if (m_zone.isEmpty()) return;
+    const QString zone = m_zone;
+    m_zones->leave(zone, this);
+    m_zone.clear();
+
+    WireProtocol::Message leave;
+    leave.type = WireProtocol::MessageType::PlayerLeave;
+    leave.username = m_username;
+    m_zones->broadcast(zone, leave);
+}
+
+void ClientSession::onDisconnected() {
+    // Must be out of the registry before the object goes away (see ZoneRegistry)
+    leaveZone();
+    qDebug() << "Player disconnected:" << m_username << ". Online:" << m_zones->sessionCount();
+    deleteLater();
+}
+
+QString ClientSession::zoneFor(const WireProtocol::Message& message) {
+    // The zone names the place; dungeon levels are separate zones ("dungeon_3")
+    QString zone = message.zone;
+    if (zone.isEmpty()) zone = "theCity";
+    if (message.level >= 0) zone += "_" + QString::number(message.level);
+    return zone;
+}
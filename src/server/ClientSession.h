@@ -0,0 +1,55 @@
+#ifndef CLIENTSESSION_H
+#define CLIENTSESSION_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include "WireProtocol.h"
+
+class QTcpSocket;
+class ZoneRegistry;
+
+/**
+ * @brief One connected player. Lives on a worker thread and owns its socket.
+ *
+ * GameServer creates the session on the listening thread, moves it to a
+ * worker and then calls start(), which adopts the socket descriptor there so
+ * all reads and writes happen on that worker's event loop.
+ */
+class ClientSession : public QObject {
+    Q_OBJECT
+public:
+    ClientSession(qintptr socketDescriptor, ZoneRegistry* zones);
+    ~ClientSession() override;
+
+public slots:
+    void start();
+    // Writes an already-serialized packet. Called on this session's thread.
+    void send(const QByteArray& packet);
+
+public:
+    // Whether this client negotiated binary frames. Read on this session's thread only.
+    bool usesBinary() const { return m_binary; }
+
+private slots:
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    void handleMessage(const WireProtocol::Message& message);
+    void sendMessage(const WireProtocol::Message& message);
+    void enterZone(const QString& zone, const QString& username);
+    void leaveZone();
+
+    static QString zoneFor(const WireProtocol::Message& message);
+
+    qintptr m_socketDescriptor;
+    ZoneRegistry* m_zones;
+    QTcpSocket* m_socket = nullptr;
+    QString m_username;
+    QString m_zone;        // Empty until enter_zone
+    QByteArray m_readBuffer;
+    bool m_binary = false;
+};
+
+#endif // CLIENTSESSION_H
@@ -0,0 +1,85 @@
+#include "GameServer.h"
+#include "ClientSession.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <QThread>
+
+GameServer::GameServer(int threadCount, QObject* parent)
+    : QTcpServer(parent)
+{
+    if (threadCount <= 0) threadCount = qMax(1, QThread::idealThreadCount());
+    for (int i = 0; i < threadCount; ++i) {
+        QThread* worker = new QThread(this);
+        worker->setObjectName(QString("worker-%1").arg(i));
+        worker->start();
+        m_workers << worker;
+    }
+}
+
+GameServer::~GameServer() {
+    close();
+    for (QThread* worker : m_workers) {
+        worker->quit();
+        worker->wait();
+    }
+}
+
+void GameServer::incomingConnection(qintptr socketDescriptor) {
+    // Round-robin over the workers; the session adopts the socket on its own thread
+    QThread* worker = m_workers[m_nextWorker];
+    m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+
+    ClientSession* session = new ClientSession(socketDescriptor, &m_zones);
+    session->moveToThread(worker);
+    connect(worker, &QThread::finished, session, &QObject::deleteLater);
+    QMetaObject::invokeMethod(session, &ClientSession::start, Qt::QueuedConnection);
+}
+
+void GameServer::startTicking(int tickMs, int snapshotInterval, int statsSeconds) {
+    m_snapshotInterval = qMax(1, snapshotInterval);
+    m_statsSeconds = qMax(1, statsSeconds);
+    m_tickTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_tickTimer, &QTimer::timeout, this, &GameServer::onTick, Qt::UniqueConnection);
+    m_tickTimer.start(qMax(1, tickMs));
+    m_statsTimer.start();
+}
+
+void GameServer::onTick() {
+    QElapsedTimer timer;
+    timer.start();
+
+    // Every snapshotInterval-th tick resends whole zones, so a client that missed a delta recovers
+    const bool fullSnapshot = (++m_tickCount % m_snapshotInterval) == 0;
+    m_lastTick = m_zones.tick(fullSnapshot);
+
+    const qint64 ns = timer.nsecsElapsed();
+    ++m_statsTicks;
+    m_statsTickNs += ns;
+    m_statsMaxTickNs = qMax(m_statsMaxTickNs, ns);
+    m_statsPackets += m_lastTick.packets;
+
+    if (m_statsTimer.elapsed() >= m_statsSeconds * 1000) logStats();
+}
+
+void GameServer::logStats() {
+    const double seconds = m_statsTimer.nsecsElapsed() / 1e9;
+    const qint64 bytes = m_zones.takeBytesSent();
+    const int clients = m_zones.sessionCount();
+
+    qInfo().noquote() << QString("Zone sync: %1 ticks, %2 us avg / %3 us max per tick, %4 zones, %5 players, "
+                                 "%6 packets/s, out %7 KB/s (%8 bytes/s per client)")
+                             .arg(m_statsTicks)
+                             .arg(m_statsTicks ? m_statsTickNs / m_statsTicks / 1000.0 : 0.0, 0, 'f', 1)
+                             .arg(m_statsMaxTickNs / 1000.0, 0, 'f', 1)
+                             .arg(m_lastTick.zones)
+                             .arg(m_lastTick.players)
+                             .arg(m_statsPackets / seconds, 0, 'f', 0)
+                             .arg(bytes / seconds / 1024.0, 0, 'f', 1)
+                             .arg(clients ? bytes / seconds / clients : 0.0, 0, 'f', 0);
+
+    m_statsTimer.restart();
+    m_statsTicks = 0;
+    m_statsTickNs = 0;
+    m_statsMaxTickNs = 0;
+    m_statsPackets = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include "ZoneRegistry.h"
+#include <QElapsedTimer>
+#include <QList>
+#include <QTcpServer>
+#include <QTimer>
+
+class QThread;
+
+/**
+ * @brief Accepts connections on the main thread and hands each one to a
+ * pool of worker threads, one event loop per core.
+ *
+ * Players are grouped into zones by ZoneRegistry, so a chat line or a
+ * join/leave only goes to the players in the same zone, and is serialized
+ * once no matter how many receive it.
+ *
+ * Player state is replicated on a fixed tick: every tick each client gets at
+ * most one zone_sync with what changed in its zone, and every
+ * snapshotInterval ticks a full snapshot instead. Tick cost and outgoing
+ * bandwidth are logged every statsSeconds seconds.
+ */
+class GameServer : public QTcpServer {
+    Q_OBJECT
+public:
+    // threadCount <= 0 uses one worker per core
+    explicit GameServer(int threadCount = 0, QObject* parent = nullptr);
+    ~GameServer() override;
+
+    int workerCount() const { return m_workers.size(); }
+    const ZoneRegistry& zones() const { return m_zones; }
+
+    // Defaults: 10 ticks per second, a full snapshot every 5 seconds, stats every 10 seconds
+    void startTicking(int tickMs = 100, int snapshotInterval = 50, int statsSeconds = 10);
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private slots:
+    void onTick();
+
+private:
+    void logStats();
+
+    QList<QThread*> m_workers;
+    int m_nextWorker = 0;
+    ZoneRegistry m_zones;
+
+    // Replication tick
+    QTimer m_tickTimer;
+    int m_snapshotInterval = 50;
+    int m_statsSeconds = 10;
+    qint64 m_tickCount = 0;
+
+    // Accumulated since the last stats line
+    QElapsedTimer m_statsTimer;
+    qint64 m_statsTicks = 0;
+    qint64 m_statsTickNs = 0;
+    qint64 m_statsMaxTickNs = 0;
+    qint64 m_statsPackets = 0;
+    ZoneRegistry::TickStats m_lastTick;
+};
+
+#endif // GAMESERVER_H
@@ -5,9 +5,18 @@ TARGET = Server
 CONFIG += console
 CONFIG -= app_bundle
 TEMPLATE = app
+CONFIG += c++20
 
-SOURCES += main.cpp
+# Wire protocol shared with the game client
+INCLUDEPATH += ../network_manager
 
-# This allows the use of signals/slots inside the main.cpp 
-# without a separate header file for the Server class.
-CONFIG += moc
+SOURCES += main.cpp \
+    GameServer.cpp \
+    ClientSession.cpp \
+    ZoneRegistry.cpp \
+    ../network_manager/WireProtocol.cpp
+
+HEADERS += GameServer.h \
+    ClientSession.h \
+    ZoneRegistry.h \
+    ../network_manager/WireProtocol.h
@@ -0,0 +1,191 @@
+#include "ZoneRegistry.h"
+#include "ClientSession.h"
+#include <QMetaObject>
+#include <algorithm>
+
+using WireProtocol::Message;
+using WireProtocol::MessageType;
+using WireProtocol::PlayerState;
+
+QStringList ZoneRegistry::join(const QString& zone, ClientSession* session, const QString& username) {
+    QWriteLocker locker(&m_lock);
+    std::shared_ptr<Zone>& entry = m_zones[zone];
+    if (!entry) entry = std::make_shared<Zone>();
+
+    QStringList present;
+    present.reserve(entry->members.size());
+    for (const Member& member : entry->members) present << member.username;
+    entry->members.append({ session, username });
+
+    // The newcomer gets the whole zone on the next tick
+    QMutexLocker stateLocker(&entry->mutex);
+    entry->needsSnapshot.insert(session);
+    if (!entry->players.contains(username)) {
+        PlayerState state;
+        state.username = username;
+        state.fields = 0; // Nothing reported yet
+        entry->players.insert(username, state);
+    }
+    return present;
+}
+
+void ZoneRegistry::leave(const QString& zone, ClientSession* session) {
+    QWriteLocker locker(&m_lock);
+    auto it = m_zones.find(zone);
+    if (it == m_zones.end()) return;
+    Zone& entry = **it;
+
+    QString username;
+    entry.members.removeIf([session, &username](const Member& member) {
+        if (member.session != session) return false;
+        username = member.username;
+        return true;
+    });
+    if (entry.members.isEmpty()) {
+        m_zones.erase(it);
+        return;
+    }
+
+    // Dropped from the state; the others learn it from the next delta
+    QMutexLocker stateLocker(&entry.mutex);
+    entry.needsSnapshot.remove(session);
+    const bool stillPresent = std::any_of(entry.members.cbegin(), entry.members.cend(),
+                                          [&username](const Member& member) { return member.username == username; });
+    if (!username.isEmpty() && !stillPresent) {
+        entry.players.remove(username);
+        entry.dirty[username] = WireProtocol::Removed;
+    }
+}
+
+void ZoneRegistry::post(ClientSession* session, const QByteArray& json, const QByteArray& binary) {
+    // Each session writes on its own thread; the QByteArrays are shared, not copied
+    QMetaObject::invokeMethod(session, [session, json, binary]() {
+        session->send(session->usesBinary() ? binary : json);
+    }, Qt::QueuedConnection);
+}
+
+void ZoneRegistry::broadcast(const QString& zone, const Message& message) const {
+    const QByteArray json = WireProtocol::encodeJson(message, WireProtocol::Direction::ToClient);
+    const QByteArray binary = WireProtocol::encodeBinary(message);
+
+    QReadLocker locker(&m_lock);
+    auto it = m_zones.constFind(zone);
+    if (it == m_zones.constEnd()) return;
+
+    for (const Member& member : (*it)->members) post(member.session, json, binary);
+}
+
+void ZoneRegistry::updatePlayer(const QString& zone, const QString& username, const PlayerState& update) {
+    QReadLocker locker(&m_lock);
+    auto it = m_zones.constFind(zone);
+    if (it == m_zones.constEnd()) return;
+    Zone& entry = **it;
+
+    QMutexLocker stateLocker(&entry.mutex);
+    auto player = entry.players.find(username);
+    if (player == entry.players.end()) return;
+
+    // Only fields whose value actually changed go into the delta
+    quint8 changed = 0;
+    if ((update.fields & WireProtocol::Position)
+        && (!(player->fields & WireProtocol::Position)
+            || player->x != update.x || player->y != update.y || player->level != update.level)) {
+        player->x = update.x;
+        player->y = update.y;
+        player->level = update.level;
+        changed |= WireProtocol::Position;
+    }
+    if ((update.fields & WireProtocol::Facing)
+        && (!(player->fields & WireProtocol::Facing) || player->facing != update.facing)) {
+        player->facing = update.facing;
+        changed |= WireProtocol::Facing;
+    }
+    if ((update.fields & WireProtocol::Health)
+        && (!(player->fields & WireProtocol::Health) || player->hp != update.hp)) {
+        player->hp = update.hp;
+        changed |= WireProtocol::Health;
+    }
+    if (changed) {
+        player->fields |= changed;
+        entry.dirty[username] |= changed;
+    }
+}
+
+ZoneRegistry::TickStats ZoneRegistry::tick(bool fullSnapshot) {
+    TickStats stats;
+    QReadLocker locker(&m_lock);
+
+    for (auto it = m_zones.cbegin(); it != m_zones.cend(); ++it) {
+        Zone& entry = **it;
+        ++stats.zones;
+
+        Message delta;
+        Message full;
+        QSet<ClientSession*> needsSnapshot;
+        {
+            QMutexLocker stateLocker(&entry.mutex);
+            stats.players += entry.players.size();
+
+            // 1. Changes since the last tick
+            for (auto d = entry.dirty.cbegin(); d != entry.dirty.cend(); ++d) {
+                PlayerState state;
+                if (d.value() & WireProtocol::Removed) {
+                    state.username = d.key();
+                    state.fields = WireProtocol::Removed;
+                } else {
+                    state = entry.players.value(d.key());
+                    state.fields = d.value();
+                }
+                delta.players.append(state);
+            }
+            entry.dirty.clear();
+
+            // 2. The whole zone, if anyone needs it
+            needsSnapshot.swap(entry.needsSnapshot);
+            if (fullSnapshot || !needsSnapshot.isEmpty()) {
+                for (const PlayerState& state : entry.players) {
+                    if (state.fields) full.players.append(state);
+                }
+            }
+        }
+
+        // 3. One packet per member, each encoding built once per zone
+        QByteArray deltaJson, deltaBinary, fullJson, fullBinary;
+        if (!delta.players.isEmpty()) {
+            delta.type = MessageType::ZoneSync;
+            delta.zone = it.key();
+            deltaJson = WireProtocol::encodeJson(delta, WireProtocol::Direction::ToClient);
+            deltaBinary = WireProtocol::encodeBinary(delta);
+        }
+        if (fullSnapshot || !needsSnapshot.isEmpty()) {
+            full.type = MessageType::ZoneSync;
+            full.zone = it.key();
+            full.fullSnapshot = true;
+            fullJson = WireProtocol::encodeJson(full, WireProtocol::Direction::ToClient);
+            fullBinary = WireProtocol::encodeBinary(full);
+        }
+
+        for (const Member& member : entry.members) {
+            if (fullSnapshot || needsSnapshot.contains(member.session)) {
+                post(member.session, fullJson, fullBinary);
+                ++stats.packets;
+            } else if (!deltaJson.isEmpty()) {
+                post(member.session, deltaJson, deltaBinary);
+                ++stats.packets;
+            }
+        }
+    }
+    return stats;
+}
+
+int ZoneRegistry::zoneCount() const {
+    QReadLocker locker(&m_lock);
+    return m_zones.size();
+}
+
+int ZoneRegistry::sessionCount() const {
+    QReadLocker locker(&m_lock);
+    int count = 0;
+    for (const auto& entry : m_zones) count += entry->members.size();
+    return count;
+}
@@ -0,0 +1,84 @@
+#ifndef ZONEREGISTRY_H
+#define ZONEREGISTRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include "WireProtocol.h"
+
+class ClientSession;
+
+/**
+ * @brief Which players are in which zone ("theCity", "dungeon_3", ...), and
+ * the authoritative state of every player in it.
+ *
+ * Shared by every worker thread. The zone map and member lists are guarded by
+ * one read/write lock; each zone's player state has its own mutex, so state
+ * updates from different zones don't contend. broadcast() and tick() only post
+ * already-serialized packets to each member's own thread, in the format that
+ * session negotiated; no lock is held while a socket is written.
+ *
+ * A session must leave() before it is deleted. Deletion happens later on the
+ * session's thread, so a packet posted while the session was still listed is
+ * either delivered or discarded together with the object.
+ */
+class ZoneRegistry {
+public:
+    // What one tick() did
+    struct TickStats {
+        int zones = 0;
+        int players = 0;
+        int packets = 0;
+    };
+
+    // Adds the session and returns the names of the players who were already there
+    QStringList join(const QString& zone, ClientSession* session, const QString& username);
+    void leave(const QString& zone, ClientSession* session);
+
+    // Encodes 'message' once per wire format and queues it on every session in the zone
+    void broadcast(const QString& zone, const WireProtocol::Message& message) const;
+
+    // Merges a player's reported fields into the zone state; sent with the next tick
+    void updatePlayer(const QString& zone, const QString& username, const WireProtocol::PlayerState& update);
+
+    // Sends each zone's changes since the last tick as one zone_sync per member.
+    // With 'fullSnapshot' (and always for members who just joined) the whole zone is sent instead.
+    TickStats tick(bool fullSnapshot);
+
+    int zoneCount() const;
+    int sessionCount() const;
+
+    // Outgoing traffic, counted by ClientSession::send() on every worker
+    void countSent(qint64 bytes) { m_bytesSent.fetch_add(bytes, std::memory_order_relaxed); }
+    qint64 takeBytesSent() { return m_bytesSent.exchange(0, std::memory_order_relaxed); }
+
+private:
+    struct Member {
+        ClientSession* session;
+        QString username;
+    };
+
+    struct Zone {
+        QList<Member> members;             // Guarded by m_lock
+
+        QMutex mutex;                      // Guards everything below
+        QHash<QString, WireProtocol::PlayerState> players; // 'fields' = what the player has ever reported
+        QHash<QString, quint8> dirty;      // PlayerField bits changed since the last tick
+        QSet<ClientSession*> needsSnapshot;
+    };
+
+    static void post(ClientSession* session, const QByteArray& json, const QByteArray& binary);
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, std::shared_ptr<Zone>> m_zones;
+    std::atomic<qint64> m_bytesSent { 0 };
+};
+
+#endif // ZONEREGISTRY_H
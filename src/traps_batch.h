@@ -0,0 +1,126 @@
+#pragma once
+#include "traps_calculations.h"
+#include <cstddef>
+// Batch versions of the trap and thieving formulas, for whole parties or
+// simulation batches at once.
+//
+// Inputs are structure-of-arrays: one array per parameter, all 'count' long.
+// Every log/exp term depends on a single small integer (guild, monster or
+// dungeon level, monster DEX), so they come from tables built once with the
+// exact expressions the scalar functions use. What's left per element is
+// plain arithmetic the compiler can vectorize.
+//
+// The results are bit-for-bit those of the scalar functions in
+// traps_calculations.h, as long as both are built with the same
+// floating-point flags (no -ffast-math; FMA contraction the same in both).
+// tools/trapbench checks this over every valid input.
+//
+// Indices past the tables are clamped inside the vector loop and then
+// recomputed with the scalar function, so any input gives the scalar result.
+
+namespace TrapTables {
+    const int SIZE = 256;
+
+    struct Tables {
+        double log[SIZE];          // log(i)
+        double logPlusOne[SIZE];   // log(i + 1)
+        double guildTerm[SIZE];    // 4.5 + exp(log(i + 1) / log(15))
+        double logSquared[SIZE];   // pow(log(i), 2)
+    };
+
+    inline const Tables& tables()
+    {
+        static const Tables t = [] {
+            Tables built;
+            for (int i = 0; i < SIZE; ++i) {
+                built.log[i] = std::log(i);
+                built.logPlusOne[i] = std::log(i + 1);
+                built.guildTerm[i] = 4.5 + std::exp(std::log(i + 1) / LOG_15);
+                built.logSquared[i] = std::pow(std::log(i), 2);
+            }
+            return built;
+        }();
+        return t;
+    }
+
+    inline bool inRange(int i) { return unsigned(i) < unsigned(SIZE); }
+    inline int index(int i) { return inRange(i) ? i : 0; }
+}
+
+// The parameters of disarmTrapChance() / identifyTrapChance(), one array each
+struct TrapInputs {
+    const int* dex = nullptr;
+    const int* wis = nullptr;
+    const int* guildLevel = nullptr;
+    const double* thiefMod = nullptr;
+    const int* monsterLevel = nullptr;
+    const int* monsterDex = nullptr;     // identify only
+    const int* dungeonLevel = nullptr;   // disarm only
+    std::size_t count = 0;
+};
+
+// 1. disarmTrapChanceUncapped() for every element
+inline void disarmTrapChanceUncappedBatch(const TrapInputs& in, double* out)
+{
+    const TrapTables::Tables& t = TrapTables::tables();
+    for (std::size_t i = 0; i < in.count; ++i) {
+        double part1 = in.dex[i] / 2.0 + in.wis[i] / 4.0;
+        double part2 = t.guildTerm[TrapTables::index(in.guildLevel[i])];
+        double part3 = in.thiefMod[i] * 1.4;
+        double part4 = t.log[TrapTables::index(in.monsterLevel[i])] * t.logPlusOne[TrapTables::index(in.dungeonLevel[i])] * 9.375;
+        out[i] = part1 + part2 * part3 - part4;
+    }
+    // Outside the tables: the scalar formula
+    for (std::size_t i = 0; i < in.count; ++i) {
+        if (!TrapTables::inRange(in.guildLevel[i]) || !TrapTables::inRange(in.monsterLevel[i]) || !TrapTables::inRange(in.dungeonLevel[i])) {
+            out[i] = disarmTrapChanceUncapped(in.dex[i], in.wis[i], in.guildLevel[i], in.thiefMod[i], in.monsterLevel[i], in.dungeonLevel[i]);
+        }
+    }
+}
+
+// 2. disarmTrapChance() for every element
+inline void disarmTrapChanceBatch(const TrapInputs& in, double* out)
+{
+    disarmTrapChanceUncappedBatch(in, out);
+    for (std::size_t i = 0; i < in.count; ++i) out[i] = clamp(out[i], 5.0, 98.0);
+}
+
+// 3. identifyTrapChance() for every element, given the uncapped disarm chances
+inline void identifyTrapChanceBatch(const TrapInputs& in, const double* uncappedDisarmChance, double* out)
+{
+    const TrapTables::Tables& t = TrapTables::tables();
+    for (std::size_t i = 0; i < in.count; ++i) {
+        double base = std::floor(in.wis[i] / 4.0) - std::floor(t.log[TrapTables::index(in.monsterLevel[i])] * t.log[TrapTables::index(in.monsterDex[i])] * 2.5);
+        double percent = std::floor(std::floor(base + (uncappedDisarmChance[i] / 1.2)) + t.logSquared[TrapTables::index(in.guildLevel[i])]);
+        out[i] = clamp(percent, 2.0, 98.0);
+    }
+    for (std::size_t i = 0; i < in.count; ++i) {
+        if (!TrapTables::inRange(in.guildLevel[i]) || !TrapTables::inRange(in.monsterLevel[i]) || !TrapTables::inRange(in.monsterDex[i])) {
+            out[i] = identifyTrapChance(in.wis[i], in.monsterLevel[i], in.monsterDex[i], in.guildLevel[i], uncappedDisarmChance[i]);
+        }
+    }
+}
+
+// 4. Both chances in one go ('disarm' capped, as disarmTrapChance() returns it)
+inline void trapChancesBatch(const TrapInputs& in, double* disarm, double* identify)
+{
+    disarmTrapChanceUncappedBatch(in, disarm);
+    identifyTrapChanceBatch(in, disarm, identify);
+    for (std::size_t i = 0; i < in.count; ++i) disarm[i] = clamp(disarm[i], 5.0, 98.0);
+}
+
+// 5. thievingParam() for every element
+inline void thievingParamBatch(const int* dex, const int* wis, const int* guildLevel, const double* thiefMod,
+                               double* out, std::size_t count)
+{
+    const TrapTables::Tables& t = TrapTables::tables();
+    for (std::size_t i = 0; i < count; ++i) {
+        double part1 = dex[i] / 2.0 + wis[i] / 2.0;
+        double part2 = t.guildTerm[TrapTables::index(guildLevel[i])];
+        double part3 = thiefMod[i] * 1.4;
+        out[i] = part1 + part2 * part3 - THIEVING_LEVEL_PENALTY;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!TrapTables::inRange(guildLevel[i])) out[i] = thievingParam(dex[i], wis[i], guildLevel[i], thiefMod[i]);
+    }
+}
@@ -6,15 +6,24 @@ inline double clamp(double value, double minval, double maxval)
 {
     return std::max(minval, std::min(value, maxval));
 }
+// Constants the formulas share, evaluated once instead of on every call
+inline const double LOG_15 = std::log(15.0);
+inline const double THIEVING_LEVEL_PENALTY = std::log(2.0) * std::log(2.0) * 9.375;
+
 // 1. Chance to disarm a trap
-// Returns a percentage (double between 5 and 98)
-inline double disarmTrapChance(int DEX, int WIS, int gLvl, double thiefMod, int mLvl, int dLvl)
+// Uncapped, as identifyTrapChance() wants it
+inline double disarmTrapChanceUncapped(int DEX, int WIS, int gLvl, double thiefMod, int mLvl, int dLvl)
 {
     double part1 = DEX / 2.0 + WIS / 4.0;
-    double part2 = 4.5 + std::exp(std::log(gLvl + 1) / std::log(15.0));
+    double part2 = 4.5 + std::exp(std::log(gLvl + 1) / LOG_15);
     double part3 = thiefMod * 1.4;
     double part4 = std::log(mLvl) * std::log(dLvl + 1) * 9.375;
-    double result = part1 + part2 * part3 - part4;
+    return part1 + part2 * part3 - part4;
+}
+// Returns a percentage (double between 5 and 98)
+inline double disarmTrapChance(int DEX, int WIS, int gLvl, double thiefMod, int mLvl, int dLvl)
+{
+    double result = disarmTrapChanceUncapped(DEX, WIS, gLvl, thiefMod, mLvl, dLvl);
     // Clamp result to min = 5%, max = 98%
     return clamp(result, 5.0, 98.0);
 }
@@ -40,8 +49,7 @@ inline double thievingAbility(double X, double Y, double Z)
 inline double thievingParam(int DEX, int WIS, int gLvl, double thiefMod)
 {
     double part1 = DEX / 2.0 + WIS / 2.0;
-    double part2 = 4.5 + std::exp(std::log(gLvl + 1) / std::log(15.0));
+    double part2 = 4.5 + std::exp(std::log(gLvl + 1) / LOG_15);
     double part3 = thiefMod * 1.4;
-    double part4 = std::log(2.0) * std::log(2.0) * 9.375;
-    return part1 + part2 * part3 - part4;
+    return part1 + part2 * part3 - THIEVING_LEVEL_PENALTY;
 }
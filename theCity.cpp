@@ -77,10 +77,7 @@ theCity::theCity(QWidget *parent) :
         
         // Register with server
         quint32 randomId = QRandomGenerator::global()->bounded(1000);
-        NetworkManager::instance()->sendAction("enter_zone", {
-            {"zone", "theCity"}, 
-            {"username", "Hero_" + QString::number(randomId)}
-        });
+        NetworkManager::instance()->enterZone("theCity", -1, "Hero_" + QString::number(randomId));
     });
 
     // 3. Try to connect
@@ -369,44 +366,16 @@ void theCity::startOfflineMode() {
         playerList->addItem(selfItem);
     }
 
-    // 2. SCAN FOR OTHER SAVED CHARACTERS
-    QDir charDir("data/characters/");
-    if (charDir.exists()) {
-        QStringList saveFiles = charDir.entryList({"*.txt"}, QDir::Files);
-        QString currentHero = gameStateManager::instance()->getGameValue("CurrentCharacterName").toString();
-
-        for (const QString& fileName : saveFiles) {
-            QString charName = fileName.left(fileName.lastIndexOf('.'));
-
-            // Skip the character we are currently playing
-            if (charName == currentHero) continue;
-            
-        // If verification fails, try to repair it
-            if (!SavegameUtils::verifySaveGame(charName)) {
-                qDebug() << "Attempting to repair broken savegame:" << charName;
-                if (!SavegameUtils::repairSaveGame(charName)) {
-                    continue; // Skip if repair also fails
-                }
-            }
-            // Peek into the file to check position
-            QFile file(charDir.absoluteFilePath(fileName));
-            if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                QTextStream in(&file);
-                int x = -1, y = -1, lvl = -1;
-
-                while (!in.atEnd()) {
-                    QString line = in.readLine();
-                    if (line.startsWith("DungeonX:")) x = line.split(": ")[1].toInt();
-                    else if (line.startsWith("DungeonY:")) y = line.split(": ")[1].toInt();
-                    else if (line.startsWith("DungeonLevel:")) lvl = line.split(": ")[1].toInt();
-                }
-
-                // Only add if they are at the City Entrance coordinates
-                if (lvl == 1 && x == 17 && y == 12) {
-                    playerList->addItem(charName);
-                }
-                file.close();
-            }
+    // 2. OTHER SAVED CHARACTERS, straight from the roster index
+    QString currentHero = gameStateManager::instance()->getGameValue("CurrentCharacterName").toString();
+    const auto characters = gameStateManager::instance()->roster()->list();
+    for (const CharacterJournal::Summary& character : characters) {
+        // Skip the character we are currently playing
+        if (character.name == currentHero) continue;
+
+        // Only add if they are at the City Entrance coordinates
+        if (character.dungeonLevel == 1 && character.dungeonX == 17 && character.dungeonY == 12) {
+            playerList->addItem(character.name);
         }
     }
     
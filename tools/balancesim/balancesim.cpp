@@ -0,0 +1,316 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include "combat/CombatEngine.h"
+#include "traps_calculations.h"
+#include "ComplicationCalculator.h"
+
+// Monte Carlo balance sweep. For every dungeon level and guild it fights
+// seeded encounters with the game's CombatEngine against the MDATA5 monsters
+// found on that level, rolls the trap formulas on the chest each won fight
+// leaves, and writes one CSV row per (level, guild) plus an "all" row per
+// guild. Work is split into fixed chunks with their own seeds, so the
+// numbers don't depend on how many threads ran them.
+//
+// What the game doesn't define yet is decided here, in one place:
+//   - the hero is (level * --char-levels) with the guild's minimum stats + 3,
+//     and AH hit points per level plus Con
+//   - a monster is worth (hits + att + def) * levelFound XP and
+//     goldFactor * levelFound * 5..15 gold
+//   - every won fight leaves one trapped chest: one identify roll, one disarm roll
+//   - each encounter also costs --walk-seconds, each death --death-seconds,
+//     and each death risks a complication (ComplicationCalculator) at --age
+
+struct Guild {
+    const char* name;
+    int hpPerLevel;                            // AH
+    int str, intel, wis, con, cha, dex;        // Minimum stats
+    double thiefMod;                           // Tuning guess: the guild tables don't list one
+};
+
+// AH and minimum stats as shown in MordorStatistics
+static const Guild GUILDS[] = {
+    { "Nomad",     5,  8,  1,  1,  1,  1,  1, 1.0 },
+    { "Warrior",   6, 14,  7,  5, 10,  3,  8, 1.0 },
+    { "Paladin",   5, 14,  9,  9, 10, 16, 15, 1.0 },
+    { "Ninja",     4, 13, 11,  7,  9,  3, 15, 3.0 },
+    { "Villain",   4, 15, 14, 14, 11,  6, 16, 3.0 },
+    { "Seeker",    4, 10, 13, 13, 11,  5, 13, 2.0 },
+    { "Thief",     3,  8, 12,  8,  6,  5, 17, 5.0 },
+    { "Scavenger", 4, 11,  8,  8,  9,  4, 14, 3.0 },
+    { "Mage",      3,  6, 11, 13,  8, 10, 14, 1.0 },
+    { "Sorcerer",  2,  6, 14, 13, 11,  5,  8, 1.0 },
+    { "Wizard",    2,  8, 18, 18, 13,  6, 14, 1.0 },
+    { "Healer",    2,  8, 14, 14,  8,  7, 14, 1.0 },
+};
+static const int GUILD_COUNT = int(sizeof(GUILDS) / sizeof(GUILDS[0]));
+
+struct Options {
+    int levels = 15;
+    int encounters = 20000;       // Per (level, guild)
+    int charLevels = 2;           // Hero levels per dungeon level
+    double walkSeconds = 20.0;
+    double deathSeconds = 300.0;
+    int age = 20;
+    int raceMaxAge = 100;         // Human
+    quint32 seed = 1;
+};
+
+struct MonsterInfo {
+    CombatEngine::Combatant combatant;
+    int levelFound = 1;
+    int dex = 1;
+    int groups = 1;
+    int xp = 0;
+    int goldFactor = 0;
+};
+
+struct Stats {
+    qint64 encounters = 0, won = 0, lost = 0, timedOut = 0;
+    qint64 fightTicks = 0;
+    qint64 xp = 0, gold = 0;
+    qint64 traps = 0, identified = 0, disarmed = 0;
+
+    void add(const Stats& o) {
+        encounters += o.encounters; won += o.won; lost += o.lost; timedOut += o.timedOut;
+        fightTicks += o.fightTicks; xp += o.xp; gold += o.gold;
+        traps += o.traps; identified += o.identified; disarmed += o.disarmed;
+    }
+};
+
+struct Job {
+    int level;
+    int guild;
+    int chunk;
+    int count;
+    Stats stats;
+};
+
+static const int CHUNK = 5000;
+
+// MDATA5.csv rows as the maps CombatEngine::Combatant::fromMonster() reads
+static QList<QVariantMap> loadMonsters(const QString& path) {
+    QList<QVariantMap> rows;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return rows;
+    const QList<QByteArray> header = file.readLine().trimmed().split(',');
+    while (!file.atEnd()) {
+        const QList<QByteArray> fields = file.readLine().trimmed().split(',');
+        if (fields.size() < header.size()) continue;
+        QVariantMap row;
+        for (int i = 0; i < header.size(); ++i) {
+            row.insert(QString::fromLatin1(header[i]), QString::fromLatin1(fields[i]));
+        }
+        rows.append(row);
+    }
+    return rows;
+}
+
+// Monsters met on each level: levelFound within two levels above it
+static QVector<QVector<MonsterInfo>> buildPools(const QList<QVariantMap>& rows, int levels) {
+    QVector<QVector<MonsterInfo>> pools(levels + 1);
+    for (const QVariantMap& row : rows) {
+        MonsterInfo info;
+        info.combatant = CombatEngine::Combatant::fromMonster(row);
+        info.combatant.name.clear(); // Fights on many threads; no shared string refcounts to bounce around
+        info.levelFound = qMax(1, row.value("levelFound").toInt());
+        info.dex = qMax(1, row.value("StatDex").toInt());
+        info.groups = qBound(1, row.value("numGroups").toInt(), 4);
+        info.xp = (info.combatant.maxHp + qMax(0, info.combatant.attack) + info.combatant.defense) * info.levelFound;
+        info.goldFactor = qMax(0, row.value("goldFactor").toInt());
+        for (int level = info.levelFound; level <= qMin(levels, info.levelFound + 2); ++level) {
+            pools[level].append(info);
+        }
+    }
+    return pools;
+}
+
+static Character heroFor(const Guild& guild, int level, const Options& options) {
+    Character hero;
+    hero.level = qMax(1, level * options.charLevels);
+    hero.strength = guild.str + 3;
+    hero.intelligence = guild.intel + 3;
+    hero.wisdom = guild.wis + 3;
+    hero.constitution = guild.con + 3;
+    hero.charisma = guild.cha + 3;
+    hero.dexterity = guild.dex + 3;
+    hero.hp = hero.maxHp = guild.hpPerLevel * hero.level + hero.constitution;
+    return hero;
+}
+
+static quint32 mix(quint32 a, quint32 b) {
+    quint32 h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u + (a << 6) + (a >> 2));
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h;
+}
+
+static void runJob(Job& job, const QVector<QVector<MonsterInfo>>& pools, const Options& options) {
+    const QVector<MonsterInfo>& pool = pools[job.level];
+    if (pool.isEmpty()) return;
+    const Guild& guild = GUILDS[job.guild];
+    const Character hero = heroFor(guild, job.level, options);
+    const CombatEngine::Combatant heroCombatant = CombatEngine::Combatant::fromCharacter(hero);
+
+    const quint32 jobSeed = mix(mix(mix(options.seed, quint32(job.level)), quint32(job.guild)), quint32(job.chunk));
+    QRandomGenerator rng(jobSeed);
+    Stats& s = job.stats;
+
+    for (int i = 0; i < job.count; ++i) {
+        // 1. The encounter: one monster type, 1..numGroups of them
+        const MonsterInfo& monster = pool[rng.bounded(int(pool.size()))];
+        const int count = 1 + rng.bounded(monster.groups);
+
+        CombatEngine engine(rng.generate());
+        engine.setRecordEvents(false);
+        engine.add(heroCombatant);
+        for (int m = 0; m < count; ++m) engine.add(monster.combatant);
+
+        ++s.encounters;
+        switch (engine.run()) {
+        case CombatEngine::Outcome::PartyWon:  ++s.won; break;
+        case CombatEngine::Outcome::PartyLost: ++s.lost; break;
+        default:                               ++s.timedOut; break;
+        }
+        s.fightTicks += engine.ticks();
+        if (engine.outcome() != CombatEngine::Outcome::PartyWon) continue;
+
+        // 2. Rewards
+        s.xp += qint64(monster.xp) * count;
+        s.gold += qint64(monster.goldFactor) * monster.levelFound * (5 + rng.bounded(11)) * count;
+
+        // 3. The chest's trap
+        const double uncapped = disarmTrapChanceUncapped(hero.dexterity, hero.wisdom, hero.level, guild.thiefMod,
+                                                         monster.levelFound, job.level);
+        const double identify = identifyTrapChance(hero.wisdom, monster.levelFound, monster.dex, hero.level, uncapped);
+        const double disarm = clamp(uncapped, 5.0, 98.0);
+        ++s.traps;
+        if (rng.generateDouble() * 100.0 < identify) ++s.identified;
+        if (rng.generateDouble() * 100.0 < disarm) ++s.disarmed;
+    }
+}
+
+static void writeRow(QTextStream& out, const QString& level, const Guild& guild, const Stats& s, const Options& options) {
+    if (s.encounters == 0) return;
+    const double fightSeconds = s.fightTicks * (CombatEngine::TICK_MS / 1000.0);
+    const double hours = (fightSeconds + s.encounters * options.walkSeconds + s.lost * options.deathSeconds) / 3600.0;
+    const double complication = calculateComplicationChance(options.age, options.raceMaxAge) / 100.0;
+    const double n = double(s.encounters);
+    out << level << ',' << guild.name << ',' << s.encounters << ','
+        << QString::number(s.won / n, 'f', 4) << ','
+        << QString::number(s.timedOut / n, 'f', 4) << ','
+        << QString::number(fightSeconds / n, 'f', 2) << ','
+        << QString::number(hours > 0 ? s.xp / hours : 0.0, 'f', 0) << ','
+        << QString::number(hours > 0 ? s.gold / hours : 0.0, 'f', 0) << ','
+        << QString::number(s.traps ? double(s.identified) / s.traps : 0.0, 'f', 4) << ','
+        << QString::number(s.traps ? double(s.disarmed) / s.traps : 0.0, 'f', 4) << ','
+        << QString::number(hours > 0 ? s.lost * complication / hours : 0.0, 'f', 3) << '\n';
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("BalanceSim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Monte Carlo balance sweep: survival, XP/gold per hour and trap success per dungeon level and guild, as CSV.");
+    parser.addHelpOption();
+    QCommandLineOption monstersOption("monsters", "MDATA5 monster table (default ../monsterconverter/data/MDATA5.csv).", "file", "../monsterconverter/data/MDATA5.csv");
+    QCommandLineOption levelsOption("levels", "Dungeon levels to sweep (default 15).", "n", "15");
+    QCommandLineOption encountersOption("encounters", "Encounters per level and guild (default 20000).", "n", "20000");
+    QCommandLineOption charLevelsOption("char-levels", "Hero levels per dungeon level (default 2).", "n", "2");
+    QCommandLineOption walkOption("walk-seconds", "Time between encounters (default 20).", "s", "20");
+    QCommandLineOption deathOption("death-seconds", "Time lost per death (default 300).", "s", "300");
+    QCommandLineOption ageOption("age", "Hero age for the complication chance (default 20).", "years", "20");
+    QCommandLineOption maxAgeOption("race-max-age", "Race maximum age (default 100, Human).", "years", "100");
+    QCommandLineOption seedOption("seed", "Base seed (default 1).", "n", "1");
+    QCommandLineOption threadsOption("threads", "Worker threads (default: all cores).", "n", "0");
+    QCommandLineOption outOption("out", "CSV file (default: stdout).", "file");
+    for (const QCommandLineOption* option : { &monstersOption, &levelsOption, &encountersOption, &charLevelsOption, &walkOption,
+                                              &deathOption, &ageOption, &maxAgeOption, &seedOption, &threadsOption, &outOption }) {
+        parser.addOption(*option);
+    }
+    parser.process(app);
+
+    Options options;
+    options.levels = qBound(1, parser.value(levelsOption).toInt(), 16);
+    options.encounters = qMax(1, parser.value(encountersOption).toInt());
+    options.charLevels = qMax(1, parser.value(charLevelsOption).toInt());
+    options.walkSeconds = qMax(0.0, parser.value(walkOption).toDouble());
+    options.deathSeconds = qMax(0.0, parser.value(deathOption).toDouble());
+    options.age = parser.value(ageOption).toInt();
+    options.raceMaxAge = parser.value(maxAgeOption).toInt();
+    options.seed = parser.value(seedOption).toUInt();
+    if (const int threads = parser.value(threadsOption).toInt(); threads > 0) {
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+    }
+
+    // 1. Monster pools per level
+    const QList<QVariantMap> rows = loadMonsters(parser.value(monstersOption));
+    if (rows.isEmpty()) {
+        qCritical() << "No monsters loaded from" << parser.value(monstersOption);
+        return 1;
+    }
+    const QVector<QVector<MonsterInfo>> pools = buildPools(rows, options.levels);
+
+    // 2. Fixed-size chunks per (level, guild), spread over the pool
+    QVector<Job> jobs;
+    for (int level = 1; level <= options.levels; ++level) {
+        for (int guild = 0; guild < GUILD_COUNT; ++guild) {
+            for (int first = 0, chunk = 0; first < options.encounters; first += CHUNK, ++chunk) {
+                jobs.append({ level, guild, chunk, qMin(CHUNK, options.encounters - first), Stats() });
+            }
+        }
+    }
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(jobs, [&pools, &options](Job& job) { runJob(job, pools, options); });
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    // 3. Merge and write
+    QVector<Stats> perCell((options.levels + 1) * GUILD_COUNT);
+    QVector<Stats> perGuild(GUILD_COUNT);
+    qint64 total = 0;
+    for (const Job& job : std::as_const(jobs)) {
+        perCell[job.level * GUILD_COUNT + job.guild].add(job.stats);
+        perGuild[job.guild].add(job.stats);
+        total += job.stats.encounters;
+    }
+
+    QFile outFile;
+    if (parser.isSet(outOption)) {
+        outFile.setFileName(parser.value(outOption));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qCritical() << "Cannot write" << outFile.fileName();
+            return 1;
+        }
+    } else if (!outFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text)) {
+        return 1;
+    }
+    QTextStream out(&outFile);
+    out << "level,guild,encounters,survival_rate,timeout_rate,avg_fight_seconds,xp_per_hour,gold_per_hour,"
+           "trap_identify_rate,trap_disarm_rate,complications_per_hour\n";
+    for (int level = 1; level <= options.levels; ++level) {
+        for (int guild = 0; guild < GUILD_COUNT; ++guild) {
+            writeRow(out, QString::number(level), GUILDS[guild], perCell[level * GUILD_COUNT + guild], options);
+        }
+    }
+    for (int guild = 0; guild < GUILD_COUNT; ++guild) {
+        writeRow(out, "all", GUILDS[guild], perGuild[guild], options);
+    }
+    out.flush();
+
+    qInfo().noquote() << QString("%1 encounters in %2 s on %3 threads (%4 encounters/s)")
+                             .arg(total)
+                             .arg(seconds, 0, 'f', 2)
+                             .arg(QThreadPool::globalInstance()->maxThreadCount())
+                             .arg(seconds > 0 ? total / seconds : 0.0, 0, 'f', 0);
+    return 0;
+}
@@ -0,0 +1,12 @@
+QT += core concurrent
+QT -= gui
+
+# Shared combat engine, trap formulas and complication formula (CombatEngine.h pulls in the game's Character)
+INCLUDEPATH += ../.. ../../src ../complication_calculator
+HEADERS += ../../src/combat/CombatEngine.h ../../src/traps_calculations.h ../../character.h \
+           ../complication_calculator/ComplicationCalculator.h
+SOURCES += balancesim.cpp ../../src/combat/CombatEngine.cpp ../../character.cpp \
+           ../complication_calculator/ComplicationCalculator.cpp
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
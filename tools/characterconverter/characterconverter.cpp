@@ -123,95 +123,8 @@ typedef std::vector<class Spell> Spells;
 typedef std::vector<class Item> Items;
 typedef std::vector<class Character> Characters;
 
-// --- RecordReader.h Integration (The binary file reading class) ---
-// Note: In a real project, this would be in a separate .h file and included.
-template <size_t RECORD_LENGTH> class RecordReader {
-	uint8_t buffer[RECORD_LENGTH];
-	std::ifstream file;
-	size_t cursor;
-
-        public:
-	      RecordReader(const std::string& filename) : buffer{ 0 } {
-	        	file.open(filename, std::ios::binary);
-	        	if (!file) throw "Unable to open file";
-	      }
-	      ~RecordReader() { file.close(); }
-
-	      void checklength(int length) 
-	      {
-	        //qInfo() << "length:" << RECORD_LENGTH;
-	        if (RECORD_LENGTH == 0) { read(length); }
-	        else { assert(cursor + length <= RECORD_LENGTH); }
-	      }
-
-	      void read(int length = RECORD_LENGTH) {
-	        	cursor = 0;
-	        	if (length == 0) return;
-	        	file.read((char*)buffer, length);
-	          	if (file.fail() && !file.eof()) throw "File Read Error";
-	      }
-
-              std::string getString(uint16_t len = 0) {
-	        	std::string var;
-	        	if (!len) len = getWord();
-	        	checklength(len);
-	        	var = std::string(reinterpret_cast<char*>(buffer + cursor), len);
-	        	cursor += len;
-	        	return var;
-	      }
-
-	      // Basic raw read functions for various types
-	      template<typename T>
-	      T& get(T & var) 
-	      {
-	        checklength(sizeof(T));
-                // Simple little-endian conversion assuming a fixed structure
-                uint8_t *ptr = buffer + cursor;
-                if constexpr (sizeof(T) == 1) 
-                {
-                  var = *reinterpret_cast<T*>(ptr);
-                } else if constexpr (sizeof(T) == 2) 
-                {
-                  uint16_t val = ptr[0] | (ptr[1] << 8);
-                  var = *reinterpret_cast<T*>(&val);
-                } else if constexpr (sizeof(T) == 4) 
-                {
-                  uint32_t val = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
-                  var = *reinterpret_cast<T*>(&val);
-                } else if constexpr (sizeof(T) == 8) // <-- ADDED 8-BYTE HANDLING
-                {
-                  uint64_t val = (uint64_t)ptr[0] | 
-                                 ((uint64_t)ptr[1] << 8) | 
-                                 ((uint64_t)ptr[2] << 16) | 
-                                 ((uint64_t)ptr[3] << 24) |
-                                 ((uint64_t)ptr[4] << 32) | 
-                                 ((uint64_t)ptr[5] << 40) | 
-                                 ((uint64_t)ptr[6] << 48) | 
-                                 ((uint64_t)ptr[7] << 56);
-                  var = *reinterpret_cast<T*>(&val);
-                } else 
-                {
-                  // Fallback for types not explicitly defined in snippet (e.g. 8-byte)
-                  throw "Type size not implemented in get() template";
-                }
-		cursor += sizeof(T);
-		return var;
-	}
-    
-	// Named Get functions that return the values
-	int16_t getWord() { int16_t var; return get(var); }
-	int32_t getDword() { int32_t var; return get(var); }
-	float getFloat() { float f; return get(f); }
-// <-- ADDED NAMED 8-BYTE FUNCTIONS
-	int64_t getInt64() { int64_t var; return get(var); } 
-	uint64_t getUint64() { uint64_t var; return get(var); }
-	template<typename T>
-	void getArray(T * var, size_t len) {
-		for (size_t i = 0; i < len; i++) {
-			get(var[i]);
-		}
-	}
-};
+// --- RecordReader (shared MDR decoder, data/RecordReader.h) ---
+#include "RecordReader.h"
 
 //--------------------------------------------------------------------------
 void writeCharacterToDumbo(const Character& m) {
@@ -702,8 +615,8 @@ int main(int argc, char *argv[]) {
     Characters characters;
     try {
         characters = loadCharacter(inPath.toStdString()); // Call the C++ loader
-    } catch (const char* msg) {
-        qCritical() << "Error loading characters from file:" << msg;
+    } catch (const std::exception& e) {
+        qCritical() << "Error loading characters from file:" << e.what();
         return 1;
     } catch (...) {
         qCritical() << "An unknown error occurred during file loading.";
@@ -1,6 +1,10 @@
 QT += core
 
+# Shared MDR decoder
+INCLUDEPATH += ../../data
+HEADERS += ../../data/RecordReader.h
+
 SOURCES += characterconverter.cpp
 
-# Enable C++11 features for standard libraries used (std::vector, std::string, etc.)
-CONFIG += c++11
+# C++20 for the shared RecordReader (std::span, std::bit_cast)
+CONFIG += c++20
@@ -20,118 +20,45 @@ struct Dungeon {
 //typedef std::vector<Dungeon> Dungeon;
 typedef std::vector<class Dungeon> Dungeons;
 
-// --- RecordReader.h Integration (The binary file reading class) ---
-// Note: In a real project, this would be in a separate .h file and included.
-template <size_t RECORD_LENGTH> class RecordReader {
-	uint8_t buffer[RECORD_LENGTH];
-	std::ifstream file;
-	size_t cursor;
-
-        public:
-	      RecordReader(const std::string& filename) : buffer{ 0 } {
-	        	file.open(filename, std::ios::binary);
-	        	if (!file) throw "Unable to open file";
-	      }
-	      ~RecordReader() { file.close(); }
-
-	      void checklength(int length) 
-	      {
-	        //qInfo() << "length:" << RECORD_LENGTH;
-	        if (RECORD_LENGTH == 0) { read(length); }
-	        else { assert(cursor + length <= RECORD_LENGTH); }
-	      }
-
-	      void read(int length = RECORD_LENGTH) {
-	        	cursor = 0;
-	        	if (length == 0) return;
-	        	file.read((char*)buffer, length);
-	          	if (file.fail() && !file.eof()) throw "File Read Error";
-	      }
-
-              std::string getString(uint16_t len = 0) {
-	        	std::string var;
-	        	if (!len) len = getWord();
-	        	checklength(len);
-	        	var = std::string(reinterpret_cast<char*>(buffer + cursor), len);
-	        	cursor += len;
-	        	return var;
-	      }
-
-	      // Basic raw read functions for various types
-	      template<typename T>
-	      T& get(T & var) 
-	      {
-	        checklength(sizeof(T));
-                // Simple little-endian conversion assuming a fixed structure
-                uint8_t *ptr = buffer + cursor;
-                if constexpr (sizeof(T) == 1) 
-                {
-                  var = *reinterpret_cast<T*>(ptr);
-                } else if constexpr (sizeof(T) == 2) 
-                {
-                  uint16_t val = ptr[0] | (ptr[1] << 8);
-                  var = *reinterpret_cast<T*>(&val);
-                } else if constexpr (sizeof(T) == 4) 
-                {
-                  uint32_t val = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
-                  var = *reinterpret_cast<T*>(&val);
-                } else if constexpr (sizeof(T) == 8) // <-- ADDED 8-BYTE HANDLING
-                {
-                  uint64_t val = (uint64_t)ptr[0] | 
-                                 ((uint64_t)ptr[1] << 8) | 
-                                 ((uint64_t)ptr[2] << 16) | 
-                                 ((uint64_t)ptr[3] << 24) |
-                                 ((uint64_t)ptr[4] << 32) | 
-                                 ((uint64_t)ptr[5] << 40) | 
-                                 ((uint64_t)ptr[6] << 48) | 
-                                 ((uint64_t)ptr[7] << 56);
-                  var = *reinterpret_cast<T*>(&val);
-                } else 
-                {
-                  // Fallback for types not explicitly defined in snippet (e.g. 8-byte)
-                  throw "Type size not implemented in get() template";
-                }
-		cursor += sizeof(T);
-		return var;
-	}
-    
-	// Named Get functions that return the values
-	int16_t getWord() { int16_t var; return get(var); }
-	int32_t getDword() { int32_t var; return get(var); }
-	float getFloat() { float f; return get(f); }
-        int64_t getInt64() { int64_t var; return get(var); } 
-	uint64_t getUint64() { uint64_t var; return get(var); }
-	template<typename T>
-	void getArray(T * var, size_t len) {
-		for (size_t i = 0; i < len; i++) {
-			get(var[i]);
-		}
-	}
-};
+// --- RecordReader and the MDR record layouts (data/RecordReader.h, data/MdrSchema.h) ---
+#include "MdrSchema.h"
 // --------------------------------------------------------------------------
 
+// Record 4 of MDATA11: the first floor's header (mdr::FLOOR_HEADER_FIELDS)
+struct FloorHeader {
+    uint16_t width = 0;
+    uint16_t height = 0;
+    uint16_t levelNumber = 0;
+    uint16_t areaCount = 0;
+    uint16_t chuteCount = 0;
+    uint16_t teleporterCount = 0;
+};
+
     // --- MLoader.cpp Integration (The loadMonsters function) ---
     Dungeons loadDungeon(std::string filename) {
     Dungeons dungeons;
-    // Dungeon record size is 160 bytes, inferred from MSaver.cpp
-    RecordReader<20> rr(filename);
-    rr.read();
-	// Assuming 'version' here is actually the 'Number of Levels' as per file spec.
-    uint16_t number_of_levels = rr.getWord();
-    rr.read();
-    rr.read();
-    rr.read();
-// The pointer is now exactly at the start of Level 1 data.
-    // Read the first 20-byte record of the level (Level Header starts here).
-    rr.read(); 
+    static const auto headerBinding = mdr::Binding<FloorHeader>(mdr::FLOOR_HEADER_FIELDS)
+        .field("Width", &FloorHeader::width)
+        .field("Height", &FloorHeader::height)
+        .field("LevelNumber", &FloorHeader::levelNumber)
+        .field("AreaCount", &FloorHeader::areaCount)
+        .field("ChuteCount", &FloorHeader::chuteCount)
+        .field("TeleporterCount", &FloorHeader::teleporterCount);
+
+    RecordReader<mdr::MDATA11_SCHEMA.recordLength> rr(filename);
+    // Record 0: the number of levels
+    uint16_t number_of_levels = mdr::headerValue<uint16_t>(mdr::MDATA11_SCHEMA, "FloorCount", rr.bytes());
 
     // --- Level Header Record 1 ---
-    uint16_t x_dim = rr.getWord();
-    uint16_t y_dim = rr.getWord();
-    uint16_t level_number = rr.getWord();
-    uint16_t num_areas = rr.getWord();
-    uint16_t num_chutes = rr.getWord();
-    uint16_t num_teleports = rr.getWord();
+    const std::vector<FloorHeader> headers = mdr::decodeSection(mdr::MDATA11_SCHEMA, "FloorHeader", rr.bytes(), headerBinding);
+    if (headers.empty()) throw std::runtime_error("Unexpected end of file or incomplete record read.");
+    const FloorHeader& header = headers.front();
+    uint16_t x_dim = header.width;
+    uint16_t y_dim = header.height;
+    uint16_t level_number = header.levelNumber;
+    uint16_t num_areas = header.areaCount;
+    uint16_t num_chutes = header.chuteCount;
+    uint16_t num_teleports = header.teleporterCount;
 
     qInfo() << "x_dim:" << x_dim;	
     qInfo() << "y_dim:" << y_dim;	
@@ -625,8 +552,8 @@ int main(int argc, char *argv[]) {
     Dungeons dungeons;
     try {
         dungeons = loadDungeon(inPath.toStdString()); // Call the C++ loader
-    } catch (const char* msg) {
-        qCritical() << "Error loading dungeons from file:" << msg;
+    } catch (const std::exception& e) {
+        qCritical() << "Error loading dungeons from file:" << e.what();
         return 1;
     } catch (...) {
         qCritical() << "An unknown error occurred during file loading.";
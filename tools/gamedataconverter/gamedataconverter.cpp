@@ -98,71 +98,8 @@ struct GameData {
     short_t numMonsterTypes;
 };
 
-// --- RecordReader.h Integration ---
-template <size_t RECORD_LENGTH> class RecordReader {
-	uint8_t buffer[RECORD_LENGTH];
-	std::ifstream file;
-	size_t cursor;
-
-public:
-	RecordReader(const std::string& filename) : buffer{ 0 } {
-		file.open(filename, std::ios::binary);
-		if (!file) throw "Unable to open file";
-	}
-	~RecordReader() { file.close(); }
-
-	void checklength(int length) {
-		if (RECORD_LENGTH == 0) { read(length); }
-		else { assert(cursor + length <= RECORD_LENGTH); }
-	}
-
-	void read(int length = RECORD_LENGTH) {
-		cursor = 0;
-		if (length == 0) return;
-		file.read((char*)buffer, length);
-		if (file.fail() && !file.eof()) throw "File Read Error";
-	}
-
-	template<typename T>
-	T& get(T & var) {
-        checklength(sizeof(T));
-        uint8_t *ptr = buffer + cursor;
-        if constexpr (sizeof(T) == 1) {
-            var = *reinterpret_cast<T*>(ptr);
-        } else if constexpr (sizeof(T) == 2) {
-            uint16_t val = ptr[0] | (ptr[1] << 8);
-            var = *reinterpret_cast<T*>(&val);
-        } else if constexpr (sizeof(T) == 4) {
-            uint32_t val = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
-            var = *reinterpret_cast<T*>(&val);
-        } else {
-            throw "Type size not implemented in get() template";
-        }
-		cursor += sizeof(T);
-		return var;
-	}
-
-	std::string& get(std::string & str, uint16_t length = 0) {
-		if (!length) {
-			length = getWord();
-		}
-		checklength(length);
-		str = std::string(reinterpret_cast<char*>(buffer + cursor), reinterpret_cast<char*>(buffer + cursor + length));
-		cursor = cursor + length;
-		return str;
-	}
-
-	short_t getWord() { short_t var; return get(var); } // Same as short
-	long_t getDword() { long_t var; return get(var); } // Same as long
-	float_t getFloat() { float_t var; return get(var); } // Same as float
-	
-	template<typename T>
-	void getArray(T * var, size_t len) {
-		for (size_t i = 0; i < len; i++) {
-			get(var[i]);
-		}
-	}
-};
+// --- RecordReader (shared MDR decoder, data/RecordReader.h) ---
+#include "RecordReader.h"
 // --------------------------------------------------------------------------
 
 // --- Load Function (MDATA1.MDR) ---
@@ -391,8 +328,8 @@ int main(int argc, char *argv[]) {
     GameData gd;
     try {
         gd = loadGameData(inPath.toStdString());
-    } catch (const char* msg) {
-        qCritical() << "Error loading game data from file:" << msg;
+    } catch (const std::exception& e) {
+        qCritical() << "Error loading game data from file:" << e.what();
         return 1;
     } catch (...) {
         qCritical() << "An unknown error occurred during file loading.";
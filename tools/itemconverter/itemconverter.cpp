@@ -23,7 +23,7 @@ struct Item {
     int16_t floor, rarity;
     int32_t abilities;
     int16_t swings, specialType, spellIndex, spellID;
-    int32_t charges; // Note: increased to 32bit to match rr.getDword() in your loader
+    int32_t charges; // A Long in mdr::ITEM_FIELDS
     int32_t guilds;
     int16_t levelScale;
     float damageMod;
@@ -54,103 +54,45 @@ struct Item {
     }
 };
 
-// --- Improved RecordReader ---
-
-template <size_t RECORD_LENGTH> 
-class RecordReader {
-    uint8_t buffer[RECORD_LENGTH];
-    std::ifstream file;
-    size_t cursor = 0;
-
-public:
-    RecordReader(const std::string& filename) {
-        file.open(filename, std::ios::binary);
-        if (!file.is_open()) throw std::runtime_error("Could not open file: " + filename);
-    }
-
-    void read(size_t length = RECORD_LENGTH) {
-        cursor = 0;
-        if (length == 0) return;
-        file.read(reinterpret_cast<char*>(buffer), length);
-        if (file.fail() && !file.eof()) throw std::runtime_error("Binary read failure");
-    }
-
-    int16_t getWord() {
-        if (cursor + 2 > RECORD_LENGTH) return 0;
-        int16_t var = buffer[cursor] | (buffer[cursor + 1] << 8);
-        cursor += 2;
-        return var;
-    }
-
-    int32_t getDword() {
-        if (cursor + 4 > RECORD_LENGTH) return 0;
-        uint32_t var = 0;
-        for (int i = 0; i < 4; i++) var |= (buffer[cursor + i] << (8 * i));
-        cursor += 4;
-        return static_cast<int32_t>(var);
-    }
-
-    float getFloat() {
-        int32_t raw = getDword();
-        return *reinterpret_cast<float*>(&raw);
-    }
-
-    std::string getString() {
-        uint16_t len = static_cast<uint16_t>(getWord());
-        if (cursor + len > RECORD_LENGTH) return "";
-        std::string str(reinterpret_cast<char*>(buffer + cursor), len);
-        cursor += len;
-        return str;
-    }
-};
+// --- RecordReader and the MDR record layouts (data/RecordReader.h, data/MdrSchema.h) ---
+#include "MdrSchema.h"
 
 // --- Loading Logic ---
 
+// Field order and types come from mdr::ITEM_FIELDS; this only says which member gets which field
 std::vector<Item> loadItems(const std::string& filename) {
-    RecordReader<125> rr(filename);
-    
-    rr.read();
-    if (rr.getString() != "1.1") throw std::runtime_error("Unsupported MDR version");
-    
-    rr.read(); // storeCode
-    rr.read();
-    uint16_t nItems = rr.getWord();
-    
-    std::vector<Item> items;
-    items.reserve(nItems);
-
-    for (size_t i = 0; i < nItems; i++) {
-        rr.read();
-        Item it;
-        it.name = rr.getString();
-        it.ID = rr.getWord();
-        it.att = rr.getWord();
-        it.def = rr.getWord();
-        it.price = rr.getDword();
-        it.floor = rr.getWord();
-        it.rarity = rr.getWord();
-        it.abilities = rr.getDword();
-        it.swings = rr.getWord();
-        it.specialType = rr.getWord();
-        it.spellIndex = rr.getWord();
-        it.spellID = rr.getWord();
-        it.charges = rr.getDword();
-        // Skip 'deleted' field implicitly via cursor or explicitly if needed
-        it.guilds = rr.getDword();
-        it.levelScale = rr.getWord();
-        it.damageMod = rr.getFloat();
-        it.alignmentFlags = rr.getDword();
-        it.nHands = rr.getWord();
-        it.type = rr.getWord();
-        it.resistanceFlags = rr.getDword();
-        for (int s = 0; s < 7; s++) it.statsRequired[s] = rr.getWord();
-        for (int s = 0; s < 7; s++) it.statsMod[s] = rr.getWord();
-        it.cursed = rr.getWord();
-        it.spellLvl = rr.getWord();
-        it.classRestricted = rr.getWord();
-        items.push_back(it);
+    static const auto binding = mdr::Binding<Item>(mdr::ITEM_FIELDS)
+        .field("Name", &Item::name)
+        .field("ID", &Item::ID)
+        .field("Att", &Item::att)
+        .field("Def", &Item::def)
+        .field("Price", &Item::price)
+        .field("Floor", &Item::floor)
+        .field("Rarity", &Item::rarity)
+        .field("Abilities", &Item::abilities)
+        .field("Swings", &Item::swings)
+        .field("SpecialType", &Item::specialType)
+        .field("SpellIndex", &Item::spellIndex)
+        .field("SpellID", &Item::spellID)
+        .field("Charges", &Item::charges)
+        .field("Guilds", &Item::guilds)
+        .field("LevelScale", &Item::levelScale)
+        .field("DamageMod", &Item::damageMod)
+        .field("AlignmentFlags", &Item::alignmentFlags)
+        .field("Hands", &Item::nHands)
+        .field("Type", &Item::type)
+        .field("ResistanceFlags", &Item::resistanceFlags)
+        .field("StatsRequired", &Item::statsRequired)
+        .field("StatsMod", &Item::statsMod)
+        .field("Cursed", &Item::cursed)
+        .field("SpellLevel", &Item::spellLvl)
+        .field("ClassRestricted", &Item::classRestricted);
+
+    RecordReader<mdr::MDATA3_SCHEMA.recordLength> rr(filename);
+    if (mdr::headerValue<std::string>(mdr::MDATA3_SCHEMA, "Version", rr.bytes()) != "1.1") {
+        throw std::runtime_error("Unsupported MDR version");
     }
-    return items;
+    return mdr::decodeSection(mdr::MDATA3_SCHEMA, "Items", rr.bytes(), binding);
 }
 
 // --- Main Application ---
@@ -1,6 +1,10 @@
 QT += core
 
+# Shared MDR decoder
+INCLUDEPATH += ../../data
+HEADERS += ../../data/RecordReader.h ../../data/MdrSchema.h
+
 SOURCES += itemconverter.cpp
 
-# CONFIG: Use C++11 or later features if necessary
-CONFIG += c++11
+# C++20 for the shared RecordReader (std::span, std::bit_cast)
+CONFIG += c++20
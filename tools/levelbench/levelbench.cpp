@@ -0,0 +1,134 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <array>
+
+#include "LevelGenerator.h"
+
+// Generation benchmark for the dungeon's LevelGenerator. For every layout it
+// generates --levels levels (world seeds counting up from --seed, dungeon
+// levels 1..15 in turn) and reports levels/s. Every level is then checked:
+//   - the stairs down (and the start tile) can be walked to from the stairs up
+//   - every treasure lies on a tile the party can walk onto (not rock)
+//   - generating it a second time gives the same tiles, stairs and treasure
+//
+// Exit code 0 only if every level passed.
+
+namespace {
+    const int ITEM_COUNT = 400;  // Stand-in for MDATA3, so treasure placement is timed too
+
+    bool sameLevel(const GeneratedLevel& a, const GeneratedLevel& b)
+    {
+        if (a.stairsUp != b.stairsUp || a.stairsDown != b.stairsDown || a.start != b.start) return false;
+        if (a.tiles.names != b.tiles.names || a.treasures.size() != b.treasures.size()) return false;
+        for (int i = 0; i < int(a.tiles.cells.size()); ++i) {
+            if (a.tiles.cells[i].fieldBitmask != b.tiles.cells[i].fieldBitmask) return false;
+        }
+        for (int i = 0; i < a.treasures.size(); ++i) {
+            const GeneratedLevel::Treasure& ta = a.treasures.at(i);
+            const GeneratedLevel::Treasure& tb = b.treasures.at(i);
+            if (ta.x != tb.x || ta.y != tb.y || ta.itemName != tb.itemName) return false;
+        }
+        return true;
+    }
+
+    // Flood fill over everything that isn't rock, four ways like the party moves
+    bool connected(const GeneratedLevel& level)
+    {
+        const int W = DungeonGrid::WIDTH, H = DungeonGrid::HEIGHT;
+        const quint32 rock = DungeonGrid::bit(MapFeature::ROCK);
+        auto tile = [W](const QPair<int, int>& p) { return p.second * W + p.first; };
+        std::array<bool, DungeonGrid::WIDTH * DungeonGrid::HEIGHT> seen{};
+        QList<int> open = { tile(level.stairsUp) };
+        seen[open.first()] = true;
+        for (int next = 0; next < open.size(); ++next) {
+            const int x = open[next] % W, y = open[next] / W;
+            const QPair<int, int> neighbours[] = { {x, y - 1}, {x + 1, y}, {x, y + 1}, {x - 1, y} };
+            for (const QPair<int, int>& n : neighbours) {
+                if (n.first < 0 || n.first >= W || n.second < 0 || n.second >= H) continue;
+                const int i = tile(n);
+                if (seen[i] || (level.tiles.cells[i].fieldBitmask & rock)) continue;
+                seen[i] = true;
+                open.append(i);
+            }
+        }
+        return seen[tile(level.stairsDown)] && seen[tile(level.start)];
+    }
+
+    // Treasure buried in rock can never be picked up
+    bool treasureReachable(const GeneratedLevel& level)
+    {
+        const quint32 rock = DungeonGrid::bit(MapFeature::ROCK);
+        for (const GeneratedLevel::Treasure& t : level.treasures) {
+            if (level.tiles.cells[t.y * DungeonGrid::WIDTH + t.x].fieldBitmask & rock) return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("LevelBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Dungeon level generation: levels/s per layout, with connectivity and reproducibility checks.");
+    parser.addHelpOption();
+    QCommandLineOption levelsOption("levels", "Levels per layout (default 10000).", "n", "10000");
+    QCommandLineOption seedOption("seed", "First world seed (default 1).", "n", "1");
+    QCommandLineOption layoutOption("layout", "rooms, caves or maze (default: all three).", "name");
+    for (const QCommandLineOption* option : { &levelsOption, &seedOption, &layoutOption }) {
+        parser.addOption(*option);
+    }
+    parser.process(app);
+
+    const int count = qMax(1, parser.value(levelsOption).toInt());
+    const quint32 firstSeed = parser.value(seedOption).toUInt();
+
+    QList<QVariantMap> items;
+    for (int i = 0; i < ITEM_COUNT; ++i) {
+        items.append({ { "name", QString("Item %1").arg(i) } });
+    }
+
+    bool ok = true;
+    for (int l = 0; l < int(LevelLayout::Count); ++l) {
+        const LevelLayout layout = static_cast<LevelLayout>(l);
+        if (parser.isSet(layoutOption) && parser.value(layoutOption) != LevelGenerator::layoutName(layout)) continue;
+
+        // 1. Timed: generation only
+        QList<QSharedPointer<const GeneratedLevel>> levels;
+        levels.reserve(count);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            levels.append(LevelGenerator::generate(firstSeed + quint32(i), 1 + i % DungeonGrid::LEVELS, items, layout));
+        }
+        const double seconds = timer.nsecsElapsed() / 1e9;
+
+        // 2. Checked afterwards
+        int disconnected = 0, buried = 0, differing = 0;
+        for (const QSharedPointer<const GeneratedLevel>& level : std::as_const(levels)) {
+            if (!connected(*level)) {
+                if (disconnected++ < 5) qWarning() << "Disconnected: world" << level->worldSeed << "level" << level->level;
+            }
+            if (!treasureReachable(*level)) {
+                if (buried++ < 5) qWarning() << "Treasure in rock: world" << level->worldSeed << "level" << level->level;
+            }
+            if (!sameLevel(*level, *LevelGenerator::generate(level->worldSeed, level->level, items, layout))) {
+                if (differing++ < 5) qWarning() << "Not reproducible: world" << level->worldSeed << "level" << level->level;
+            }
+        }
+        ok = ok && disconnected == 0 && buried == 0 && differing == 0;
+
+        qInfo().noquote() << QString("%1: %2 levels in %3 s (%4 levels/s), %5 disconnected, %6 with buried treasure, %7 not reproducible")
+                                 .arg(QString::fromLatin1(LevelGenerator::layoutName(layout)), -6)
+                                 .arg(count)
+                                 .arg(seconds, 0, 'f', 3)
+                                 .arg(seconds > 0 ? count / seconds : 0.0, 0, 'f', 0)
+                                 .arg(disconnected)
+                                 .arg(buried)
+                                 .arg(differing);
+    }
+    return ok ? 0 : 1;
+}
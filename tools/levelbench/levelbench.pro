@@ -0,0 +1,10 @@
+QT += core concurrent
+QT -= gui
+
+# Shared level generator (LevelCache in the same file needs QtConcurrent)
+INCLUDEPATH += ../../src/dungeon_dialog
+HEADERS += ../../src/dungeon_dialog/LevelGenerator.h ../../src/dungeon_dialog/DungeonGrid.h ../../maploader/MapLoader.h
+SOURCES += levelbench.cpp ../../src/dungeon_dialog/LevelGenerator.cpp
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
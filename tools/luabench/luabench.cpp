@@ -0,0 +1,287 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+extern "C" {
+    #include "lua.h"
+    #include "lualib.h"
+    #include "lauxlib.h"
+}
+
+#include "LuaDataLoader.h"
+#include "LuaRecords.h"
+#include "LuaScriptCache.h"
+
+// 1. Times the game's Lua heartbeat the old way (luaL_dofile every tick) and
+//    through LuaScriptCache (compiled once, lua_pcall every tick), in a Lua host
+//    set up like gameStateManager's, with SetTitle and print stubbed out.
+// 2. Loads every Lua data file (MonsterData.lua and the character saves) the
+//    old way (a new lua_State per file, walked into a QVariant tree) and with
+//    LuaDataLoader (one VM, typed schemas), sequentially and in parallel, and
+//    reports the time per full load, the Lua heap peak and how much memory
+//    (results plus any VMs still alive) is left allocated afterwards.
+
+static int s_titleCalls = 0;
+
+static lua_State* newHost() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    lua_pushstring(L, "vBench");
+    lua_setglobal(L, "GameVersion");
+    lua_register(L, "SetTitle", [](lua_State*) -> int { ++s_titleCalls; return 0; });
+    lua_register(L, "print", [](lua_State*) -> int { return 0; });
+    return L;
+}
+
+template<typename Tick>
+static bool benchmark(const char* label, int ticks, Tick tick) {
+    lua_State* L = newHost();
+    s_titleCalls = 0;
+    int failures = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    {
+        // The cache, if any, lives inside 'tick' and must be gone before lua_close
+        auto run = tick(L);
+        for (int i = 0; i < ticks; ++i) {
+            if (!run()) ++failures;
+        }
+    }
+    const double ns = double(timer.nsecsElapsed());
+    const int stack = lua_gettop(L);
+    lua_close(L);
+
+    qInfo().noquote() << QString("%1: %2 us/tick, %3 ticks/s (%4 SetTitle calls, %5 failures, stack %6)")
+                             .arg(QString::fromLatin1(label), -7)
+                             .arg(ns / ticks / 1000.0, 0, 'f', 2)
+                             .arg(ticks / (ns / 1e9), 0, 'f', 0)
+                             .arg(s_titleCalls)
+                             .arg(failures)
+                             .arg(stack);
+    return failures == 0 && stack == 0;
+}
+
+// Lua allocator that keeps track of the live and peak heap of the states using it
+struct LuaHeap {
+    std::atomic<qint64> inUse { 0 };
+    std::atomic<qint64> peak { 0 };
+};
+
+static void* countingAlloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    LuaHeap* heap = static_cast<LuaHeap*>(ud);
+    if (!ptr) osize = 0; // For new blocks osize is the object type, not a size
+    const qint64 delta = qint64(nsize) - qint64(osize);
+    const qint64 now = heap->inUse.fetch_add(delta) + delta;
+    qint64 peak = heap->peak.load();
+    while (now > peak && !heap->peak.compare_exchange_weak(peak, now)) {}
+    if (nsize == 0) {
+        std::free(ptr);
+        return nullptr;
+    }
+    return std::realloc(ptr, nsize);
+}
+
+// Bytes currently allocated with malloc (glibc only; 0 elsewhere)
+static qint64 mallocInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks + info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+// The loader gameStateManager used before LuaDataLoader, kept as the baseline
+static QVariant legacyToVariant(lua_State* L, int index) {
+    switch (lua_type(L, index)) {
+    case LUA_TNUMBER:
+        return lua_tonumber(L, index);
+    case LUA_TSTRING:
+        return QString::fromUtf8(lua_tostring(L, index));
+    case LUA_TBOOLEAN:
+        return (bool)lua_toboolean(L, index);
+    case LUA_TTABLE: {
+        QVariantMap map;
+        QVariantList list;
+        bool isArray = true;
+        int n = 0;
+        lua_pushnil(L);
+        while (lua_next(L, index < 0 ? index - 1 : index) != 0) {
+            if (isArray) {
+                if (lua_type(L, -2) == LUA_TNUMBER) {
+                    n++;
+                    if (lua_tonumber(L, -2) != n) isArray = false;
+                } else {
+                    isArray = false;
+                }
+            }
+            QVariant val = legacyToVariant(L, -1);
+            if (!isArray) map[QString::fromUtf8(lua_tostring(L, -2))] = val;
+            else list.append(val);
+            lua_pop(L, 1);
+        }
+        return isArray ? QVariant(list) : QVariant(map);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+static QVariant legacyLoad(LuaHeap* heap, const QString& path, const char* table) {
+    lua_State* L = lua_newstate(countingAlloc, heap, luaL_makeseed(nullptr));
+    luaL_openlibs(L);
+    QVariant result;
+    if (luaL_dofile(L, QFile::encodeName(path).constData()) == LUA_OK) {
+        lua_getglobal(L, table);
+        if (lua_istable(L, -1)) result = legacyToVariant(L, -1);
+    }
+    lua_close(L);
+    return result;
+}
+
+struct DataResult {
+    QList<QVariant> legacy;              // Old loader: one tree per file
+    QList<QList<MonsterRecord>> monsters;
+    QList<Character> characters;
+    int rows = 0;
+};
+
+static void report(const char* label, qint64 ns, int loads, int rows, const LuaHeap* heap, qint64 retained) {
+    qInfo().noquote() << QString("%1: %2 ms per full load, %3 rows, Lua heap peak %4 KB, %5 KB still allocated after the loads")
+                             .arg(QString::fromLatin1(label), -8)
+                             .arg(ns / 1e6 / loads, 0, 'f', 3)
+                             .arg(rows)
+                             .arg(heap ? QString::number(heap->peak.load() / 1024.0, 'f', 1) : QStringLiteral("-"))
+                             .arg(retained / 1024.0, 0, 'f', 1);
+}
+
+static void benchmarkData(const QString& dataDir, int loads) {
+    const QString monsterFile = QDir(dataDir).filePath("MonsterData.lua");
+    QStringList characterFiles;
+    const QDir characterDir(QDir(dataDir).filePath("characters"));
+    for (const QString& name : characterDir.entryList({ "*.lua" }, QDir::Files, QDir::Name)) {
+        characterFiles << characterDir.filePath(name);
+    }
+    qInfo() << "Data files: 1 monster table," << characterFiles.size() << "character saves," << loads << "loads each.";
+
+    // 1. Old: fresh lua_State with every library per file, QVariant tree out
+    {
+        LuaHeap heap;
+        const qint64 before = mallocInUse();
+        DataResult result;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < loads; ++i) {
+            result = DataResult();
+            result.legacy << legacyLoad(&heap, monsterFile, "Monsters");
+            for (const QString& file : characterFiles) result.legacy << legacyLoad(&heap, file, "SaveData");
+            result.rows = result.legacy.first().toList().size() + characterFiles.size();
+        }
+        const qint64 ns = timer.nsecsElapsed();
+        report("old", ns, loads, result.rows, &heap, mallocInUse() - before);
+    }
+
+    // 2. New: one VM, a fresh environment per file, schemas straight into structs
+    {
+        LuaHeap heap;
+        const qint64 before = mallocInUse();
+        DataResult result;
+        LuaDataLoader loader(countingAlloc, &heap);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < loads; ++i) {
+            result = DataResult();
+            result.monsters << loader.loadList(monsterFile, "Monsters", MonsterRecord::schema());
+            for (const QString& file : characterFiles) {
+                Character c;
+                if (loader.loadRecord(file, "SaveData", characterSaveSchema(), c)) result.characters << c;
+            }
+            result.rows = result.monsters.first().size() + result.characters.size();
+        }
+        const qint64 ns = timer.nsecsElapsed();
+        report("shared", ns, loads, result.rows, &heap, mallocInUse() - before);
+    }
+
+    // 3. New, the character saves spread over the thread pool, one VM per worker
+    {
+        const qint64 before = mallocInUse();
+        DataResult result;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < loads; ++i) {
+            result = DataResult();
+            result.monsters = LuaDataLoader::loadParallel(QStringList{ monsterFile }, "Monsters", MonsterRecord::schema());
+            result.characters = QtConcurrent::blockingMapped<QList<Character>>(characterFiles, [](const QString& file) {
+                Character c;
+                LuaDataLoader::forThisThread().loadRecord(file, "SaveData", characterSaveSchema(), c);
+                return c;
+            });
+            result.rows = result.monsters.first().size() + result.characters.size();
+        }
+        const qint64 ns = timer.nsecsElapsed();
+        report("parallel", ns, loads, result.rows, nullptr, mallocInUse() - before);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("LuaBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Lua host costs: heartbeat ticks (luaL_dofile vs. the script cache) and data file loading (per-file VM vs. LuaDataLoader).");
+    parser.addHelpOption();
+    QCommandLineOption ticksOption("ticks", "Heartbeats per run (default 100000).", "n", "100000");
+    QCommandLineOption dataDirOption("data-dir", "Directory with the Lua data files (default ../../data).", "dir", "../../data");
+    QCommandLineOption loadsOption("loads", "Full data loads per loader (default 50).", "n", "50");
+    parser.addOption(ticksOption);
+    parser.addOption(dataDirOption);
+    parser.addOption(loadsOption);
+    parser.addPositionalArgument("script", "Heartbeat script (default ../../data/scripts/heartbeat.lua).");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QString script = args.isEmpty() ? QStringLiteral("../../data/scripts/heartbeat.lua") : args.first();
+    const int ticks = qMax(1, parser.value(ticksOption).toInt());
+    if (!QFile::exists(script)) {
+        qCritical() << "Script not found:" << script;
+        return 1;
+    }
+    const QByteArray path = QFile::encodeName(script);
+
+    // 1. Old path: read and compile the file on every tick
+    bool ok = benchmark("dofile", ticks, [&path](lua_State* L) {
+        return [L, &path]() {
+            if (luaL_dofile(L, path.constData()) == LUA_OK) return true;
+            lua_pop(L, 1);
+            return false;
+        };
+    });
+
+    // 2. Cached: one compile, then lua_pcall (plus an mtime check once a second)
+    int compiles = 0;
+    ok = benchmark("cached", ticks, [&script, &compiles](lua_State* L) {
+        auto cache = std::make_shared<LuaScriptCache>(L);
+        return [cache, &script, &compiles]() {
+            const bool ran = cache->run(script);
+            compiles = cache->compileCount();
+            return ran;
+        };
+    }) && ok;
+    qInfo() << "Cached run compiled the script" << compiles << "time(s).";
+
+    benchmarkData(parser.value(dataDirOption), qMax(1, parser.value(loadsOption).toInt()));
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+QT += core concurrent
+QT -= gui
+
+# Shared script cache and data loader (LuaRecords.h pulls in the game's Character)
+INCLUDEPATH += ../../src/core ../..
+HEADERS += ../../src/core/LuaScriptCache.h ../../src/core/LuaDataLoader.h ../../src/core/LuaRecords.h ../../character.h
+SOURCES += luabench.cpp ../../src/core/LuaScriptCache.cpp ../../src/core/LuaDataLoader.cpp ../../character.cpp
+
+# Lua 5.5 from 3rdparty (lua.c and luac.c left out, they have their own main())
+INCLUDEPATH += ../../3rdparty/lua
+LUA_SOURCES = lapi lcode lctype ldebug ldo ldump lfunc lgc llex lmem lobject lopcodes \
+              lparser lstate lstring ltable ltm lundump lvm lzio lauxlib lbaselib lcorolib \
+              ldblib liolib lmathlib loadlib loslib lstrlib ltablib lutf8lib linit
+for(file, LUA_SOURCES): SOURCES += ../../3rdparty/lua/$${file}.c
+QMAKE_CFLAGS += -std=c11
+DEFINES += LUA_COMPAT_5_3
+linux: DEFINES += LUA_USE_LINUX
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
@@ -0,0 +1,94 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "MdrSchema.h"
+
+// The files MdrSchema.h describes; the others have no layout to decode by and are left out
+static const mdr::FileSchema* const MDR_SCHEMAS[] = {
+    &mdr::MDATA2_SCHEMA,
+    &mdr::MDATA3_SCHEMA,
+    &mdr::MDATA5_SCHEMA,
+    &mdr::MDATA11_SCHEMA,
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("MdrBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decodes the MDR files described in MdrSchema.h and reports throughput.");
+    parser.addHelpOption();
+    QCommandLineOption iterationsOption("iterations", "Decode passes per file (default 200).", "n", "200");
+    parser.addOption(iterationsOption);
+    parser.addPositionalArgument("datadir", "Directory with the MDR files (default ../../data).");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QDir dataDir(args.isEmpty() ? QStringLiteral("../../data") : args.first());
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    qint64 totalBytes = 0; // Decoded bytes over all passes
+    qint64 totalNs = 0;
+    quint64 checksum = 0;
+
+    for (const mdr::FileSchema* schema : MDR_SCHEMAS) {
+        QFile file(dataDir.filePath(schema->fileName));
+        if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+            qInfo().noquote() << QString("%1  skipped").arg(schema->fileName, -12);
+            continue;
+        }
+
+        // 1. Map the file once; the passes below only decode
+        const qint64 size = file.size();
+        QByteArray fallback;
+        const uchar* data = file.map(0, size);
+        if (!data) {
+            fallback = file.readAll();
+            data = reinterpret_cast<const uchar*>(fallback.constData());
+        }
+        const std::span<const std::byte> bytes(reinterpret_cast<const std::byte*>(data), static_cast<size_t>(size));
+
+        // 2. Decode it 'iterations' times, folding every value into a checksum
+        size_t records = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            records = mdr::decodeFile(*schema, bytes, [&checksum](const mdr::Field&, uint16_t, auto value) {
+                if constexpr (std::is_same_v<decltype(value), std::string_view>) {
+                    checksum += value.size();
+                } else {
+                    checksum += static_cast<quint64>(static_cast<qint64>(value));
+                }
+            });
+        }
+        const qint64 ns = qMax<qint64>(1, timer.nsecsElapsed());
+
+        // Throughput counts the records the schema covers, not the whole file
+        const qint64 decodedBytes = qMin<qint64>(size, qint64(records) * qint64(schema->recordLength));
+        const double mbPerSec = (double(decodedBytes) * iterations / (1024.0 * 1024.0)) / (ns / 1e9);
+        qInfo().noquote() << QString("%1 %2 bytes  %3 records  %4 MB/s")
+                                 .arg(schema->fileName, -12)
+                                 .arg(size, 8)
+                                 .arg(records, 6)
+                                 .arg(mbPerSec, 9, 'f', 1);
+        totalBytes += decodedBytes * iterations;
+        totalNs += ns;
+    }
+
+    if (totalNs > 0) {
+        qInfo().noquote() << QString("Total: %1 MB/s over %2 passes (checksum %3)")
+                                 .arg((double(totalBytes) / (1024.0 * 1024.0)) / (totalNs / 1e9), 0, 'f', 1)
+                                 .arg(iterations)
+                                 .arg(checksum);
+    }
+    return 0;
+}
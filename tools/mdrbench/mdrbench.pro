@@ -0,0 +1,10 @@
+QT += core
+
+# Shared MDR decoder
+INCLUDEPATH += ../../data
+HEADERS += ../../data/RecordReader.h ../../data/MdrSchema.h
+
+SOURCES += mdrbench.cpp
+
+# C++20 for the shared RecordReader (std::span, std::bit_cast)
+CONFIG += c++20 console
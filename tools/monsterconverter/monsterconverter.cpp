@@ -62,144 +62,51 @@ typedef std::vector<class Spell> Spells;
 typedef std::vector<class Item> Items; 
 typedef std::vector<class Character> Characters;
 
-// --- RecordReader.h Integration (The binary file reading class) ---
-// Note: In a real project, this would be in a separate .h file and included.
-template <size_t RECORD_LENGTH> class RecordReader {
-	uint8_t buffer[RECORD_LENGTH];
-	std::ifstream file;
-	size_t cursor;
-
-public:
-	RecordReader(const std::string& filename) : buffer{ 0 } {
-		file.open(filename, std::ios::binary);
-		if (!file) throw "Unable to open file";
-	}
-	~RecordReader() { file.close(); }
-
-	void checklength(int length) {
-		if (RECORD_LENGTH == 0) { read(length); }
-		else { assert(cursor + length <= RECORD_LENGTH); }
-	}
-
-	void read(int length = RECORD_LENGTH) {
-		cursor = 0;
-		if (length == 0) return;
-		file.read((char*)buffer, length);
-		if (file.fail() && !file.eof()) throw "File Read Error";
-	}
-
-	std::string getString(uint16_t len = 0) {
-		std::string var;
-		if (!len) len = getWord();
-		checklength(len);
-		var = std::string(reinterpret_cast<char*>(buffer + cursor), len);
-		cursor += len;
-		return var;
-	}
-
-	// Basic raw read functions for various types
-	template<typename T>
-	T& get(T & var) {
-        checklength(sizeof(T));
-        // Simple little-endian conversion assuming a fixed structure
-        uint8_t *ptr = buffer + cursor;
-        if constexpr (sizeof(T) == 1) {
-            var = *reinterpret_cast<T*>(ptr);
-        } else if constexpr (sizeof(T) == 2) {
-            uint16_t val = ptr[0] | (ptr[1] << 8);
-            var = *reinterpret_cast<T*>(&val);
-        } else if constexpr (sizeof(T) == 4) {
-            uint32_t val = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
-            var = *reinterpret_cast<T*>(&val);
-        } else {
-            // Fallback for types not explicitly defined in snippet (e.g. 8-byte)
-            throw "Type size not implemented in get() template";
-        }
-		cursor += sizeof(T);
-		return var;
-	}
-    
-	// Named Get functions that return the values
-	int16_t getWord() { int16_t var; return get(var); }
-	int32_t getDword() { int32_t var; return get(var); }
-	float getFloat() { float f; return get(f); }
-
-	template<typename T>
-	void getArray(T * var, size_t len) {
-		for (size_t i = 0; i < len; i++) {
-			get(var[i]);
-		}
-	}
-};
+// --- RecordReader and the MDR record layouts (data/RecordReader.h, data/MdrSchema.h) ---
+#include "MdrSchema.h"
 // --------------------------------------------------------------------------
 
 // --- MLoader.cpp Integration (The loadMonsters function) ---
+// Field order and types come from mdr::MONSTER_FIELDS; this only says which member gets which field
 Monsters loadMonsters(std::string filename) {
-	Monsters monsters;
-	// Monster record size is 160 bytes, inferred from MSaver.cpp
-	RecordReader<160> rr(filename); 
-	
-	// Read Header Records
-	rr.read();
-	std::string version = rr.getString();
-	assert(version == "1.1");
-	rr.read();
-	rr.getWord(); //uint16_t storeCode (or unused)
-	rr.read();
-	uint16_t nMonsters = rr.getWord();
-	monsters.reserve(nMonsters);
-	
-	// Read Monster Records
-	for (size_t i = 0; i < nMonsters; i++) {
-		rr.read();
-		Monster m;
-		m.name = rr.getString();
-		m.att = rr.getWord();
-		m.def = rr.getWord();
-		m.id = rr.getWord();
-		m.hits = rr.getWord();
-		m.numGroups = rr.getWord();
-		m.picID = rr.getWord();
-		m.lockedChance = rr.getWord();
-		m.levelFound = rr.getWord();
-
-		// Resistances (12 elements)
-		rr.getArray(m.resistances, 12);
-
-		m.specialPropertyFlags = rr.getDword();
-		m.specialAttackFlags = rr.getDword();
-		m.spellFlags = rr.getDword();
-
-		m.chance = rr.getWord();
-		
-		// boxChance (4 elements)
-		rr.getArray(m.boxChance, 4);
+	static const auto binding = mdr::Binding<Monster>(mdr::MONSTER_FIELDS)
+		.field("Name", &Monster::name)
+		.field("Att", &Monster::att)
+		.field("Def", &Monster::def)
+		.field("ID", &Monster::id)
+		.field("Hits", &Monster::hits)
+		.field("NumGroups", &Monster::numGroups)
+		.field("PicID", &Monster::picID)
+		.field("LockedChance", &Monster::lockedChance)
+		.field("LevelFound", &Monster::levelFound)
+		.field("Resistances", &Monster::resistances)
+		.field("SpecialPropertyFlags", &Monster::specialPropertyFlags)
+		.field("SpecialAttackFlags", &Monster::specialAttackFlags)
+		.field("SpellFlags", &Monster::spellFlags)
+		.field("Chance", &Monster::chance)
+		.field("BoxChance", &Monster::boxChance)
+		.field("Alignment", &Monster::alignment)
+		.field("InGroup", &Monster::ingroup)
+		.field("GoldFactor", &Monster::goldFactor)
+		.field("TrapFlags", &Monster::trapFlags)
+		.field("GuildLevel", &Monster::guildlevel)
+		.field("Stats", &Monster::stats)
+		.field("Type", &Monster::type)
+		.field("DamageMod", &Monster::damageMod)
+		.field("CompanionType", &Monster::companionType)
+		.field("CompanionSpawnMode", &Monster::companionSpawnMode)
+		.field("CompanionID", &Monster::companionID)
+		.field("Items", &Monster::items)
+		.field("SubType", &Monster::subtype)
+		.field("CompanionSubType", &Monster::companionSubtype)
+		.field("Deleted", &Monster::deleted);
 
-		m.alignment = rr.getWord();
-		m.ingroup = rr.getWord();
-		m.goldFactor = rr.getDword();
-		m.trapFlags = rr.getDword();
-		m.guildlevel = rr.getWord();
-
-		// Stats (7 elements)
-		rr.getArray(m.stats, 7);
-
-		m.type = rr.getWord();
-		m.damageMod = rr.getFloat();
-		m.companionType = rr.getWord();
-		m.companionSpawnMode = rr.getWord();
-		m.companionID = rr.getWord();
-
-		// Items (11 elements)
-		rr.getArray(m.items, 11);
-
-		m.subtype = rr.getWord();
-		m.companionSubtype = rr.getWord();
-		m.deleted = rr.getWord();
+	// Monster record size is 160 bytes, inferred from MSaver.cpp
+	RecordReader<mdr::MDATA5_SCHEMA.recordLength> rr(filename);
 
-		monsters.push_back(m);
-	}
-	return monsters;
+	// Header records: version, an unused Integer, then the count
+	assert(mdr::headerValue<std::string>(mdr::MDATA5_SCHEMA, "Version", rr.bytes()) == "1.1");
+	return mdr::decodeSection(mdr::MDATA5_SCHEMA, "Monsters", rr.bytes(), binding);
 }
 // --------------------------------------------------------------------------
 
@@ -260,8 +167,8 @@ int main(int argc, char *argv[]) {
     Monsters monsters;
     try {
         monsters = loadMonsters(inPath.toStdString()); // Call the C++ loader
-    } catch (const char* msg) {
-        qCritical() << "Error loading monsters from file:" << msg;
+    } catch (const std::exception& e) {
+        qCritical() << "Error loading monsters from file:" << e.what();
         return 1;
     } catch (...) {
         qCritical() << "An unknown error occurred during file loading.";
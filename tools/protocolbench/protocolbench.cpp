@@ -0,0 +1,243 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <iterator>
+
+#include "WireProtocol.h"
+
+using namespace WireProtocol;
+
+// Round-trip check and codec benchmark for WireProtocol.
+//
+// The check encodes seeded random messages of every type in both formats,
+// decodes them whole, split at random points and with flipped bytes, and
+// exits with 1 on the first mismatch. The benchmark then times encode+decode
+// for the same messages as JSON lines and as binary frames.
+
+static QString randomString(QRandomGenerator& rng, int maxLength) {
+    static const char32_t EXTRA[] = { U'é', U'ö', U'ß', U'Ж', U'龍', U'😀', U'"', U'\\', U'\n' };
+    QString s;
+    const int length = rng.bounded(maxLength + 1);
+    for (int i = 0; i < length; ++i) {
+        if (rng.bounded(8) == 0) {
+            const char32_t c = EXTRA[rng.bounded(int(std::size(EXTRA)))];
+            s += QString::fromUcs4(&c, 1);
+        } else {
+            s += QChar(char16_t('a' + rng.bounded(26)));
+        }
+    }
+    return s;
+}
+
+static Message randomMessage(QRandomGenerator& rng, MessageType type) {
+    Message m;
+    m.type = type;
+    switch (type) {
+    case MessageType::Hello:
+        m.version = rng.bounded(1, 1000);
+        m.binary = rng.bounded(2) == 1;
+        break;
+    case MessageType::EnterZone:
+        m.username = "Hero_" + randomString(rng, 8);
+        m.zone = rng.bounded(2) ? "theCity" : "dungeon";
+        m.level = rng.bounded(-1, 16);
+        break;
+    case MessageType::LeaveZone:
+        m.zone = randomString(rng, 12);
+        break;
+    case MessageType::Chat:
+        m.sender = rng.bounded(2) ? randomString(rng, 10) : QString();
+        m.text = randomString(rng, 120);
+        break;
+    case MessageType::PlayerJoin:
+    case MessageType::PlayerLeave:
+        m.username = randomString(rng, 16);
+        break;
+    case MessageType::ZoneSync: {
+        m.zone = "dungeon_" + QString::number(rng.bounded(16));
+        m.fullSnapshot = rng.bounded(2) == 1;
+        const int count = rng.bounded(40);
+        for (int i = 0; i < count; ++i) {
+            PlayerState p;
+            p.username = "Hero_" + QString::number(i);
+            p.fields = quint8(rng.bounded(16));
+            if (p.fields & Position) {
+                p.x = qint16(rng.bounded(30));
+                p.y = qint16(rng.bounded(30));
+                p.level = qint16(rng.bounded(16));
+            }
+            if (p.fields & Facing) p.facing = quint8(rng.bounded(4));
+            if (p.fields & Health) p.hp = rng.bounded(-50, 5000);
+            m.players.append(p);
+        }
+        break;
+    }
+    case MessageType::PlayerUpdate: {
+        PlayerState p;
+        p.fields = quint8(rng.bounded(1, 8));
+        if (p.fields & Position) {
+            p.x = qint16(rng.bounded(30));
+            p.y = qint16(rng.bounded(30));
+            p.level = qint16(rng.bounded(16));
+        }
+        if (p.fields & Facing) p.facing = quint8(rng.bounded(4));
+        if (p.fields & Health) p.hp = rng.bounded(-50, 5000);
+        m.players.append(p);
+        break;
+    }
+    case MessageType::Action: {
+        m.action = "act_" + randomString(rng, 8);
+        const int count = rng.bounded(5);
+        for (int i = 0; i < count; ++i) m.data.insert("key" + QString::number(i), randomString(rng, 20));
+        break;
+    }
+    case MessageType::Invalid:
+        break;
+    }
+    return m;
+}
+
+static const MessageType ALL_TYPES[] = {
+    MessageType::Hello, MessageType::EnterZone, MessageType::LeaveZone, MessageType::Chat,
+    MessageType::PlayerJoin, MessageType::PlayerLeave, MessageType::ZoneSync, MessageType::Action,
+    MessageType::PlayerUpdate
+};
+
+static bool isServerMessage(MessageType type) {
+    return type == MessageType::PlayerJoin || type == MessageType::PlayerLeave || type == MessageType::ZoneSync;
+}
+
+// Decodes every message in 'stream', feeding it in chunks of at most 'chunk' bytes
+static bool decodeStream(const QByteArray& stream, int chunk, QList<Message>& out) {
+    QByteArray buffer;
+    for (qsizetype fed = 0; fed < stream.size(); fed += chunk) {
+        buffer += stream.mid(fed, chunk);
+        qsizetype pos = 0, consumed = 0;
+        Message message;
+        while (true) {
+            const DecodeResult result = decode(buffer.constData() + pos, buffer.size() - pos, message, consumed);
+            if (result == DecodeResult::NeedMore) break;
+            if (result == DecodeResult::Corrupt) return false;
+            pos += consumed;
+            out.append(message);
+        }
+        buffer.remove(0, pos);
+    }
+    return buffer.isEmpty();
+}
+
+static bool roundTrip(quint32 seed, int rounds) {
+    QRandomGenerator rng(seed);
+    QList<Message> sent;
+    QByteArray jsonStream, binaryStream, mixedStream;
+
+    // 1. Whole messages, both formats
+    for (int r = 0; r < rounds; ++r) {
+        for (MessageType type : ALL_TYPES) {
+            const Message m = randomMessage(rng, type);
+            const Direction direction = isServerMessage(type) ? Direction::ToClient : Direction::ToServer;
+            const QByteArray json = encodeJson(m, direction);
+            const QByteArray binary = encodeBinary(m);
+
+            for (const QByteArray& encoded : { json, binary }) {
+                Message decoded;
+                qsizetype consumed = 0;
+                if (decode(encoded.constData(), encoded.size(), decoded, consumed) != DecodeResult::Decoded
+                    || consumed != encoded.size() || !(decoded == m)) {
+                    qCritical() << "Round trip failed for type" << int(type) << "seed" << seed << ":" << encoded.toHex();
+                    return false;
+                }
+            }
+            sent.append(m);
+            jsonStream += json;
+            binaryStream += binary;
+            mixedStream += rng.bounded(2) ? json : binary;
+        }
+    }
+
+    // 2. The same messages as streams cut at random points
+    for (const QByteArray* stream : { &jsonStream, &binaryStream, &mixedStream }) {
+        QList<Message> received;
+        if (!decodeStream(*stream, 1 + rng.bounded(64), received) || received != sent) {
+            qCritical() << "Stream decode failed, seed" << seed;
+            return false;
+        }
+    }
+
+    // 3. Damaged frames must be rejected or decoded, never read out of bounds
+    for (int r = 0; r < rounds; ++r) {
+        QByteArray frame = encodeBinary(randomMessage(rng, ALL_TYPES[rng.bounded(int(std::size(ALL_TYPES)))]));
+        frame[1 + rng.bounded(int(frame.size() - 1))] = char(rng.bounded(256));
+        frame.truncate(1 + rng.bounded(int(frame.size())));
+        Message ignored;
+        qsizetype consumed = 0;
+        if (decode(frame.constData(), frame.size(), ignored, consumed) == DecodeResult::Decoded && consumed > frame.size()) {
+            qCritical() << "Damaged frame over-read, seed" << seed;
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Encode>
+static void benchmark(const char* label, const QList<Message>& messages, int iterations, Encode encode) {
+    qint64 bytes = 0;
+    int decoded = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        for (const Message& m : messages) {
+            const QByteArray encoded = encode(m);
+            Message out;
+            qsizetype consumed = 0;
+            if (decode(encoded.constData(), encoded.size(), out, consumed) == DecodeResult::Decoded) ++decoded;
+            bytes += encoded.size();
+        }
+    }
+    const double ns = double(timer.nsecsElapsed());
+    const double count = double(messages.size()) * iterations;
+    qInfo().noquote() << QString("%1: %2 ns/msg, %3 bytes/msg, %4 MB/s (%5 decoded)")
+                             .arg(QString::fromLatin1(label), -6)
+                             .arg(ns / count, 0, 'f', 1)
+                             .arg(bytes / count, 0, 'f', 1)
+                             .arg(bytes / (ns / 1e9) / (1024.0 * 1024.0), 0, 'f', 1)
+                             .arg(decoded);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ProtocolBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Round-trip check and encode/decode benchmark for the client/server wire protocol.");
+    parser.addHelpOption();
+    QCommandLineOption seedsOption("seeds", "Random seeds for the round-trip check (default 50).", "n", "50");
+    QCommandLineOption iterationsOption("iterations", "Benchmark passes over the message set (default 2000).", "n", "2000");
+    parser.addOption(seedsOption);
+    parser.addOption(iterationsOption);
+    parser.process(app);
+
+    // 1. Round trips
+    const int seeds = qMax(1, parser.value(seedsOption).toInt());
+    for (int seed = 1; seed <= seeds; ++seed) {
+        if (!roundTrip(quint32(seed), 20)) return 1;
+    }
+    qInfo() << "Round trip OK:" << seeds << "seeds, every message type, JSON, binary and mixed streams.";
+
+    // 2. Benchmark on a fixed, typical mix: mostly player updates and small zone syncs
+    QRandomGenerator rng(42);
+    QList<Message> messages;
+    for (int i = 0; i < 100; ++i) {
+        messages.append(randomMessage(rng, i % 3 == 0 ? MessageType::ZoneSync : MessageType::PlayerUpdate));
+        messages.append(randomMessage(rng, ALL_TYPES[i % std::size(ALL_TYPES)]));
+    }
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+    benchmark("json", messages, iterations, [](const Message& m) {
+        return encodeJson(m, isServerMessage(m.type) ? Direction::ToClient : Direction::ToServer);
+    });
+    benchmark("binary", messages, iterations, [](const Message& m) { return encodeBinary(m); });
+    return 0;
+}
@@ -0,0 +1,10 @@
+QT += core
+QT -= gui
+
+# Wire protocol shared by the game client and src/server
+INCLUDEPATH += ../../src/network_manager
+HEADERS += ../../src/network_manager/WireProtocol.h
+SOURCES += protocolbench.cpp ../../src/network_manager/WireProtocol.cpp
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
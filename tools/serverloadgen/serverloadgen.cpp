@@ -0,0 +1,215 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Headless load generator for src/server: opens many loopback clients spread
+// over dungeon-level zones, has each one chat at a fixed rate and measures
+// how long the server takes to echo a client's own line back to it.
+
+static qint64 nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Settings {
+    QString host;
+    quint16 port;
+    int zones;
+    double rate;       // Chat lines per client per second
+};
+
+// Everything one thread measured. Only read after that thread has stopped.
+struct WorkerStats {
+    int connected = 0;
+    int failed = 0;
+    qint64 sent = 0;
+    qint64 received = 0;
+    std::vector<qint64> latenciesNs;
+};
+
+/**
+ * @brief A group of clients driven by one thread's event loop.
+ */
+class LoadWorker {
+public:
+    LoadWorker(const Settings& settings, int firstId, int count)
+        : m_settings(settings), m_firstId(firstId), m_count(count) {}
+
+    QObject* context() { return &m_context; }
+    const WorkerStats& stats() const { return m_stats; }
+
+    // Runs on the worker thread
+    void start() {
+        for (int i = 0; i < m_count; ++i) addClient(m_firstId + i);
+    }
+
+    void stop() {
+        m_running = false;
+        for (QTcpSocket* socket : m_sockets) socket->abort();
+    }
+
+private:
+    void addClient(int id) {
+        QTcpSocket* socket = new QTcpSocket(&m_context);
+        m_sockets << socket;
+        // The echo of this client's own chat line contains this tag
+        const QByteArray tag = "ping:" + QByteArray::number(id) + ":";
+
+        QObject::connect(socket, &QTcpSocket::connected, &m_context, [this, socket, id, tag]() {
+            ++m_stats.connected;
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            const QByteArray enter = "{\"action\":\"enter_zone\",\"zone\":\"dungeon\",\"level\":"
+                + QByteArray::number(id % m_settings.zones)
+                + ",\"username\":\"Bot_" + QByteArray::number(id) + "\"}\n";
+            socket->write(enter);
+
+            // Spread the first lines over one interval so clients don't chat in lockstep
+            const int interval = qMax(1, int(1000.0 / m_settings.rate));
+            QTimer* timer = new QTimer(socket);
+            QObject::connect(timer, &QTimer::timeout, socket, [this, socket, tag]() {
+                if (!m_running || socket->state() != QAbstractSocket::ConnectedState) return;
+                socket->write("{\"action\":\"chat\",\"message\":\"" + tag + QByteArray::number(nowNs()) + "\"}\n");
+                ++m_stats.sent;
+            });
+            QTimer::singleShot(QRandomGenerator::global()->bounded(interval), timer, [timer, interval]() {
+                timer->start(interval);
+            });
+        });
+
+        QObject::connect(socket, &QTcpSocket::errorOccurred, &m_context, [this](QAbstractSocket::SocketError) {
+            if (m_running) ++m_stats.failed;
+        });
+
+        QObject::connect(socket, &QTcpSocket::readyRead, &m_context, [this, socket, tag]() {
+            while (socket->canReadLine()) {
+                const QByteArray line = socket->readLine();
+                ++m_stats.received;
+                const qsizetype at = line.indexOf(tag);
+                if (at < 0) continue;
+                const qsizetype start = at + tag.size();
+                const qsizetype end = line.indexOf('"', start);
+                bool ok = false;
+                const qint64 sentAt = line.mid(start, end - start).toLongLong(&ok);
+                if (ok) m_stats.latenciesNs.push_back(nowNs() - sentAt);
+            }
+        });
+
+        socket->connectToHost(m_settings.host, m_settings.port);
+    }
+
+    Settings m_settings;
+    int m_firstId;
+    int m_count;
+    bool m_running = true;
+    QObject m_context;
+    QList<QTcpSocket*> m_sockets;
+    WorkerStats m_stats;
+};
+
+static double percentileMs(const std::vector<qint64>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const size_t index = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+    return sorted[index] / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ServerLoadGen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Opens many loopback clients against the game server and reports messages/sec and latency.");
+    parser.addHelpOption();
+    QCommandLineOption hostOption("host", "Server address (default 127.0.0.1).", "host", "127.0.0.1");
+    QCommandLineOption portOption("port", "Server port (default 12345).", "port", "12345");
+    QCommandLineOption clientsOption("clients", "Number of clients (default 2000).", "n", "2000");
+    QCommandLineOption zonesOption("zones", "Dungeon-level zones to spread them over (default 20).", "n", "20");
+    QCommandLineOption rateOption("rate", "Chat lines per client per second (default 1).", "n", "1");
+    QCommandLineOption threadsOption("threads", "Client threads (default: one per core).", "n", "0");
+    QCommandLineOption durationOption("duration", "Measured seconds after connecting (default 10).", "s", "10");
+    parser.addOption(hostOption);
+    parser.addOption(portOption);
+    parser.addOption(clientsOption);
+    parser.addOption(zonesOption);
+    parser.addOption(rateOption);
+    parser.addOption(threadsOption);
+    parser.addOption(durationOption);
+    parser.process(app);
+
+    const Settings settings {
+        parser.value(hostOption),
+        parser.value(portOption).toUShort(),
+        qMax(1, parser.value(zonesOption).toInt()),
+        qMax(0.01, parser.value(rateOption).toDouble())
+    };
+    const int clients = qMax(1, parser.value(clientsOption).toInt());
+    int threads = parser.value(threadsOption).toInt();
+    if (threads <= 0) threads = qMax(1, QThread::idealThreadCount());
+    threads = qMin(threads, clients);
+    const int duration = qMax(1, parser.value(durationOption).toInt());
+
+    qInfo() << "Connecting" << clients << "clients in" << settings.zones << "zones on" << threads
+            << "threads to" << settings.host << settings.port;
+
+    // 1. Spread the clients over the threads
+    std::vector<std::unique_ptr<LoadWorker>> workers;
+    std::vector<std::unique_ptr<QThread>> workerThreads;
+    for (int t = 0; t < threads; ++t) {
+        const int first = clients * t / threads;
+        const int count = clients * (t + 1) / threads - first;
+        workers.push_back(std::make_unique<LoadWorker>(settings, first, count));
+        workerThreads.push_back(std::make_unique<QThread>());
+        workers.back()->context()->moveToThread(workerThreads.back().get());
+        workerThreads.back()->start();
+        LoadWorker* worker = workers.back().get();
+        QMetaObject::invokeMethod(worker->context(), [worker]() { worker->start(); }, Qt::QueuedConnection);
+    }
+
+    // 2. Run for the requested time, then stop every client on its own thread
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QTimer::singleShot(duration * 1000, &app, [&]() {
+        const double seconds = elapsed.nsecsElapsed() / 1e9;
+        for (size_t t = 0; t < workers.size(); ++t) {
+            LoadWorker* worker = workers[t].get();
+            QMetaObject::invokeMethod(worker->context(), [worker]() { worker->stop(); }, Qt::BlockingQueuedConnection);
+            workerThreads[t]->quit();
+            workerThreads[t]->wait();
+        }
+
+        // 3. Merge and report
+        WorkerStats total;
+        for (const auto& worker : workers) {
+            const WorkerStats& s = worker->stats();
+            total.connected += s.connected;
+            total.failed += s.failed;
+            total.sent += s.sent;
+            total.received += s.received;
+            total.latenciesNs.insert(total.latenciesNs.end(), s.latenciesNs.begin(), s.latenciesNs.end());
+        }
+        std::sort(total.latenciesNs.begin(), total.latenciesNs.end());
+
+        qInfo() << "Clients connected:" << total.connected << "failed:" << total.failed;
+        qInfo() << "Sent:" << total.sent << "(" << qRound64(total.sent / seconds) << "msgs/sec )";
+        qInfo() << "Received:" << total.received << "(" << qRound64(total.received / seconds) << "msgs/sec )";
+        qInfo() << "Echo latency ms - p50:" << percentileMs(total.latenciesNs, 0.50)
+                << "p99:" << percentileMs(total.latenciesNs, 0.99)
+                << "max:" << (total.latenciesNs.empty() ? 0.0 : total.latenciesNs.back() / 1e6)
+                << "samples:" << total.latenciesNs.size();
+        if (total.failed > 0) {
+            qInfo() << "Some clients failed; raise the open file limit (ulimit -n) for large client counts.";
+        }
+        app.quit();
+    });
+
+    return app.exec();
+}
@@ -0,0 +1,7 @@
+QT += core network
+QT -= gui
+
+SOURCES += serverloadgen.cpp
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
@@ -13,24 +13,23 @@
 #include <fstream>
 #include <cassert>
 
-// --- MTypes.h / Spell Definition (Corrected) ---
-// Structure corrected to match the field reading sequence in the MLoader.cpp snippet,
-// which is the source of truth for the binary file layout.
+// --- MTypes.h / Spell Definition ---
+// The record layout itself is mdr::SPELL_FIELDS (data/MdrSchema.h); this is only where it lands.
 struct Spell {
 	std::string name; // vbstring spellname
-	int16_t ID; // Corresponds to MLoader.cpp s.ID
-	int16_t category; // Corresponds to MLoader.cpp s.category (class)
-	int16_t level; // Corresponds to MLoader.cpp s.level (spellLevel)
-	int16_t u4; // Corresponds to MLoader.cpp s.u4
-	// Removed m_alwaysZero to fix alignment
-	int16_t killEffect; // Corresponds to MLoader.cpp s.killEffect
-	int16_t affectMonster; // Corresponds to MLoader.cpp s.affectMonster
-	int16_t affectGroup; // Corresponds to MLoader.cpp s.affectGroup
-	int16_t damage1; // Corresponds to MLoader.cpp s.damage1
-	int16_t damage2; // Corresponds to MLoader.cpp s.damage2
-	int16_t specialEffect; // Corresponds to MLoader.cpp s.specialEffect
+	int16_t ID;
+	int16_t category; // Class
+	int16_t level;
+	int16_t u4;
+	// AlwaysZero (after u4) is decoded but not kept
+	int16_t killEffect;
+	int16_t affectMonster;
+	int16_t affectGroup;
+	int16_t damage1;
+	int16_t damage2;
+	int16_t specialEffect;
 	int16_t required[7]; // Required Stats (7 elements)
-	int16_t resistedBy; // Final field (resistedBy)
+	int16_t resistedBy;
 };
 typedef std::vector<Spell> Spells;
 
@@ -39,120 +38,34 @@ typedef std::vector<class Item> Items;
 typedef std::vector<class Character> Characters;
 typedef std::vector<class Monster> Monsters;
 
-// --- RecordReader.h Integration (The binary file reading class) ---
-// (Implementation unchanged, relying on external RecordReader.h)
-template <size_t RECORD_LENGTH> class RecordReader {
-	uint8_t buffer[RECORD_LENGTH];
-	std::ifstream file;
-	size_t cursor;
-
-public:
-	RecordReader(const std::string& filename) : buffer{ 0 } {
-		file.open(filename, std::ios::binary);
-		if (!file) throw "Unable to open file";
-	}
-	~RecordReader() { file.close(); }
-
-	void checklength(int length) {
-		if (RECORD_LENGTH == 0) { read(length); }
-		else { assert(cursor + length <= RECORD_LENGTH); }
-	}
-
-	void read(int length = RECORD_LENGTH) {
-		cursor = 0;
-		if (length == 0) return;
-		file.read((char*)buffer, length);
-		if (file.fail() && !file.eof()) throw "File Read Error";
-	}
-
-	// The 4 basic raw reading functions (Simplified for typical types)
-	template<typename T>
-	T& get(T & var) {
-        checklength(sizeof(T));
-        // Simple little-endian conversion
-        uint8_t *ptr = buffer + cursor;
-        if constexpr (sizeof(T) == 1) {
-            var = *reinterpret_cast<T*>(ptr);
-        } else if constexpr (sizeof(T) == 2) {
-            uint16_t val = ptr[0] | (ptr[1] << 8);
-            var = *reinterpret_cast<T*>(&val);
-        } else if constexpr (sizeof(T) == 4) {
-            uint32_t val = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
-            var = *reinterpret_cast<T*>(&val);
-        } else {
-            // Fallback for types not explicitly defined in snippet (e.g. 8-byte)
-            throw "Type size not implemented in get() template";
-        }
-		cursor += sizeof(T);
-		return var;
-	}
-
-	// Read string (VB string: reads 16-bit length first)
-	std::string& get(std::string & str, uint16_t length = 0) {
-		if (!length) {
-			length = getWord();
-		}
-		checklength(length);
-		// This line is the source of the assertion failure if length is too large
-		str = std::string(reinterpret_cast<char*>(buffer + cursor), reinterpret_cast<char*>(buffer + cursor + length));
-		cursor = cursor + length;
-		return str;
-	}
-
-	// Named Get functions
-	int16_t getWord() { int16_t var; return get(var); }
-	
-	template<typename T>
-	void getArray(T * var, size_t len) {
-		for (size_t i = 0; i < len; i++) {
-			get(var[i]);
-		}
-	}
-};
+// --- RecordReader and the MDR record layouts (data/RecordReader.h, data/MdrSchema.h) ---
+#include "MdrSchema.h"
 // --------------------------------------------------------------------------
 
 // --- MLoader.cpp Integration (The loadSpells function) ---
 Spells loadSpells(std::string filename) {
-	RecordReader<75> buff(filename);
-	Spells spells;
-	
+	static const auto binding = mdr::Binding<Spell>(mdr::SPELL_FIELDS)
+		.field("Name", &Spell::name)
+		.field("ID", &Spell::ID)
+		.field("Class", &Spell::category)
+		.field("Level", &Spell::level)
+		.field("U4", &Spell::u4)
+		.field("KillEffect", &Spell::killEffect)
+		.field("AffectMonster", &Spell::affectMonster)
+		.field("AffectGroup", &Spell::affectGroup)
+		.field("Damage1", &Spell::damage1)
+		.field("Damage2", &Spell::damage2)
+		.field("SpecialEffect", &Spell::specialEffect)
+		.field("Required", &Spell::required)
+		.field("ResistedBy", &Spell::resistedBy);
+
+	RecordReader<mdr::MDATA2_SCHEMA.recordLength> buff(filename);
+
 	// rec1: vbstring fileversion
-	buff.read();
-	std::string version;
-    buff.get(version); // Use ref version matching MLoader.cpp
-	assert(version == "1.1");
-	
-	// rec2: short NumSpells
-	buff.read();
-	uint16_t numSpells;
-    buff.get(numSpells);
-	
-	spells.reserve(numSpells);
-	for (size_t i = 0; i < numSpells; i++) {
-		Spell s;
-		buff.read(); // Read the 75-byte record for the spell
-        
-		buff.get(s.name); // Read vbstring name
-		buff.get(s.ID);
-		buff.get(s.category);
-		buff.get(s.level);
-		buff.get(s.u4);
-		// Skip the field that was causing misalignment
-		buff.get(s.killEffect);
-		buff.get(s.affectMonster);
-		buff.get(s.affectGroup);
-		buff.get(s.damage1);
-		buff.get(s.damage2);
-		buff.get(s.specialEffect);
-		
-        // Read required stats array
-		buff.getArray(s.required, 7); 
-        
-		buff.get(s.resistedBy);
-		
-		spells.push_back(s);
-	}
-	return spells;
+	assert(mdr::headerValue<std::string>(mdr::MDATA2_SCHEMA, "Version", buff.bytes()) == "1.1");
+
+	// rec2 holds the count, the spells follow
+	return mdr::decodeSection(mdr::MDATA2_SCHEMA, "Spells", buff.bytes(), binding);
 }
 // --------------------------------------------------------------------------
 
@@ -208,8 +121,8 @@ int main(int argc, char *argv[]) {
     Spells spells;
     try {
         spells = loadSpells(inPath.toStdString()); // Call the C++ loader
-    } catch (const char* msg) {
-        qCritical() << "Error loading spells from file: " << msg;
+    } catch (const std::exception& e) {
+        qCritical() << "Error loading spells from file:" << e.what();
         return 1;
     } catch (...) {
         qCritical() << "An unknown error occurred during file loading.";
@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "traps_calculations.h"
+#include "traps_batch.h"
+
+// 1. Runs the batch trap formulas (traps_batch.h) against the scalar ones
+//    (traps_calculations.h) over every input in the ranges below and counts
+//    results that aren't bit-for-bit identical (two NaNs count as equal).
+// 2. Times both on one large random batch.
+//
+// Exit code 0 only if nothing differed.
+
+namespace {
+    // The game's valid ranges, with guild levels run past the lookup tables
+    // so the scalar fallback is checked too
+    const int STAT_MIN = 3, STAT_MAX = 25;                 // DEX, WIS (race limits)
+    const int GUILD_LEVELS[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 15, 20, 25, 30, 40, 50, 60, 75, 100,
+                                 150, 200, 254, 255, 256, 257, 300, 500, 1000 };
+    const double THIEF_MODS[] = { 0.0, 0.5, 1.0, 1.5, 2.0, 3.0, 5.0 };
+    const int MONSTER_LEVEL_MAX = 16;                      // MDATA5 levelFound
+    const int MONSTER_DEX_MAX = 30;
+    const int DUNGEON_LEVEL_MAX = 15;
+
+    struct Check {
+        const char* name;
+        long long compared = 0;
+        long long mismatches = 0;
+        double maxDifference = 0.0;
+
+        void compare(double scalar, double batch) {
+            ++compared;
+            if (std::memcmp(&scalar, &batch, sizeof(double)) == 0) return;
+            if (std::isnan(scalar) && std::isnan(batch)) return;
+            if (mismatches++ < 5) std::printf("  %s: scalar %.17g, batch %.17g\n", name, scalar, batch);
+            if (std::isfinite(scalar) && std::isfinite(batch)) maxDifference = std::max(maxDifference, std::fabs(scalar - batch));
+        }
+        bool report() const {
+            std::printf("%-10s %12lld compared, %lld differ (max difference %g)\n", name, compared, mismatches, maxDifference);
+            return mismatches == 0;
+        }
+    };
+
+    // One SoA batch, filled by the loops below
+    struct Batch {
+        std::vector<int> dex, wis, guildLevel, monsterLevel, monsterDex, dungeonLevel;
+        std::vector<double> thiefMod, uncapped;
+
+        void clear() {
+            dex.clear(); wis.clear(); guildLevel.clear(); monsterLevel.clear();
+            monsterDex.clear(); dungeonLevel.clear(); thiefMod.clear(); uncapped.clear();
+        }
+        void add(int d, int w, int g, double t, int ml, int md, int dl, double u = 0.0) {
+            dex.push_back(d); wis.push_back(w); guildLevel.push_back(g); thiefMod.push_back(t);
+            monsterLevel.push_back(ml); monsterDex.push_back(md); dungeonLevel.push_back(dl); uncapped.push_back(u);
+        }
+        TrapInputs inputs() const {
+            TrapInputs in;
+            in.dex = dex.data(); in.wis = wis.data(); in.guildLevel = guildLevel.data(); in.thiefMod = thiefMod.data();
+            in.monsterLevel = monsterLevel.data(); in.monsterDex = monsterDex.data(); in.dungeonLevel = dungeonLevel.data();
+            in.count = dex.size();
+            return in;
+        }
+    };
+
+    double seconds(std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t benchCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    Check disarm { "disarm" }, uncapped { "uncapped" }, identify { "identify" }, thieving { "thieving" };
+    Batch batch;
+    std::vector<double> out, out2;
+
+    // 1a. Disarm (capped and uncapped), one batch per guild level
+    for (int g : GUILD_LEVELS) {
+        batch.clear();
+        for (int d = STAT_MIN; d <= STAT_MAX; ++d)
+            for (int w = STAT_MIN; w <= STAT_MAX; ++w)
+                for (double t : THIEF_MODS)
+                    for (int ml = 1; ml <= MONSTER_LEVEL_MAX; ++ml)
+                        for (int dl = 0; dl <= DUNGEON_LEVEL_MAX; ++dl)
+                            batch.add(d, w, g, t, ml, 0, dl);
+        const TrapInputs in = batch.inputs();
+        out.resize(in.count);
+        out2.resize(in.count);
+        disarmTrapChanceBatch(in, out.data());
+        disarmTrapChanceUncappedBatch(in, out2.data());
+        for (std::size_t i = 0; i < in.count; ++i) {
+            disarm.compare(disarmTrapChance(in.dex[i], in.wis[i], g, in.thiefMod[i], in.monsterLevel[i], in.dungeonLevel[i]), out[i]);
+            uncapped.compare(disarmTrapChanceUncapped(in.dex[i], in.wis[i], g, in.thiefMod[i], in.monsterLevel[i], in.dungeonLevel[i]), out2[i]);
+        }
+    }
+
+    // 1b. Identify, over the uncapped disarm range the game produces (-40..140)
+    for (int g : GUILD_LEVELS) {
+        batch.clear();
+        for (int w = STAT_MIN; w <= STAT_MAX; ++w)
+            for (int ml = 1; ml <= MONSTER_LEVEL_MAX; ++ml)
+                for (int md = 0; md <= MONSTER_DEX_MAX; ++md)
+                    for (double u = -40.0; u <= 140.0; u += 2.5)
+                        batch.add(0, w, g, 0.0, ml, md, 0, u);
+        const TrapInputs in = batch.inputs();
+        out.resize(in.count);
+        identifyTrapChanceBatch(in, batch.uncapped.data(), out.data());
+        for (std::size_t i = 0; i < in.count; ++i) {
+            identify.compare(identifyTrapChance(in.wis[i], in.monsterLevel[i], in.monsterDex[i], g, batch.uncapped[i]), out[i]);
+        }
+    }
+
+    // 1c. Thieving parameter
+    batch.clear();
+    for (int g : GUILD_LEVELS)
+        for (int d = STAT_MIN; d <= STAT_MAX; ++d)
+            for (int w = STAT_MIN; w <= STAT_MAX; ++w)
+                for (double t : THIEF_MODS)
+                    batch.add(d, w, g, t, 0, 0, 0);
+    out.resize(batch.dex.size());
+    thievingParamBatch(batch.dex.data(), batch.wis.data(), batch.guildLevel.data(), batch.thiefMod.data(), out.data(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        thieving.compare(thievingParam(batch.dex[i], batch.wis[i], batch.guildLevel[i], batch.thiefMod[i]), out[i]);
+    }
+
+    bool ok = disarm.report();
+    ok = uncapped.report() && ok;
+    ok = identify.report() && ok;
+    ok = thieving.report() && ok;
+
+    // 2. Timing: one random batch of party/simulation-sized inputs, both chances per element
+    std::mt19937 rng(1234);
+    batch.clear();
+    for (std::size_t i = 0; i < benchCount; ++i) {
+        batch.add(STAT_MIN + int(rng() % (STAT_MAX - STAT_MIN + 1)), STAT_MIN + int(rng() % (STAT_MAX - STAT_MIN + 1)),
+                  1 + int(rng() % 100), THIEF_MODS[rng() % 7], 1 + int(rng() % MONSTER_LEVEL_MAX),
+                  1 + int(rng() % MONSTER_DEX_MAX), int(rng() % (DUNGEON_LEVEL_MAX + 1)));
+    }
+    const TrapInputs in = batch.inputs();
+    std::vector<double> scalarDisarm(in.count), scalarIdentify(in.count), batchDisarm(in.count), batchIdentify(in.count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < in.count; ++i) {
+        const double u = disarmTrapChanceUncapped(in.dex[i], in.wis[i], in.guildLevel[i], in.thiefMod[i], in.monsterLevel[i], in.dungeonLevel[i]);
+        scalarIdentify[i] = identifyTrapChance(in.wis[i], in.monsterLevel[i], in.monsterDex[i], in.guildLevel[i], u);
+        scalarDisarm[i] = clamp(u, 5.0, 98.0);
+    }
+    const double scalarSeconds = seconds(start);
+
+    TrapTables::tables(); // Built once per process; not part of the timing
+    start = std::chrono::steady_clock::now();
+    trapChancesBatch(in, batchDisarm.data(), batchIdentify.data());
+    const double batchSeconds = seconds(start);
+
+    const bool same = std::memcmp(scalarDisarm.data(), batchDisarm.data(), in.count * sizeof(double)) == 0
+                   && std::memcmp(scalarIdentify.data(), batchIdentify.data(), in.count * sizeof(double)) == 0;
+    std::printf("\n%zu characters, disarm + identify:\n", in.count);
+    std::printf("  Scalar: %.2f ns/character\n", scalarSeconds * 1e9 / in.count);
+    std::printf("  Batch:  %.2f ns/character (%.1fx, results %s)\n", batchSeconds * 1e9 / in.count,
+                batchSeconds > 0 ? scalarSeconds / batchSeconds : 0.0, same ? "identical" : "DIFFER");
+
+    return ok && same ? 0 : 1;
+}
@@ -0,0 +1,7 @@
+# Plain C++: the trap formulas have no Qt dependency
+CONFIG -= qt app_bundle
+CONFIG += c++20 console
+
+INCLUDEPATH += ../../src
+HEADERS += ../../src/traps_calculations.h ../../src/traps_batch.h
+SOURCES += trapbench.cpp